@@ -11,6 +11,7 @@
 #include <userver/clients/dns/resolver_fwd.hpp>
 #include <userver/components/component_fwd.hpp>
 
+#include <userver/storages/clickhouse/cursor.hpp>
 #include <userver/storages/clickhouse/fwd.hpp>
 #include <userver/storages/clickhouse/impl/insertion_request.hpp>
 #include <userver/storages/clickhouse/impl/pool.hpp>
@@ -60,6 +61,19 @@ class Cluster final {
   ExecutionResult Execute(OptionalCommandControl, const Query& query,
                           const Args&... args) const;
 
+  /// @brief Execute a statement at some host of the cluster
+  /// with args as query parameters, the result is read block by block
+  /// with storages::clickhouse::Cursor.
+  template <typename... Args>
+  Cursor ExecuteCursor(const Query& query, const Args&... args) const;
+
+  /// @brief Execute a statement with specified command control settings
+  /// at some host of the cluster with args as query parameters, the result
+  /// is read block by block with storages::clickhouse::Cursor.
+  template <typename... Args>
+  Cursor ExecuteCursor(OptionalCommandControl, const Query& query,
+                       const Args&... args) const;
+
   /// @brief Insert data at some host of the cluster;
   /// `T` is expected to be a struct of vectors of same length.
   /// @param table_name table to insert into
@@ -131,6 +145,8 @@ class Cluster final {
 
   ExecutionResult DoExecute(OptionalCommandControl, const Query& query) const;
 
+  Cursor DoExecuteCursor(OptionalCommandControl, const Query& query) const;
+
   const impl::Pool& GetPool() const;
 
   std::vector<impl::Pool> pools_;
@@ -189,6 +205,18 @@ ExecutionResult Cluster::Execute(OptionalCommandControl optional_cc,
   return DoExecute(optional_cc, formatted_query);
 }
 
+template <typename... Args>
+Cursor Cluster::ExecuteCursor(const Query& query, const Args&... args) const {
+  return ExecuteCursor(OptionalCommandControl{}, query, args...);
+}
+
+template <typename... Args>
+Cursor Cluster::ExecuteCursor(OptionalCommandControl optional_cc,
+                              const Query& query, const Args&... args) const {
+  const auto formatted_query = query.WithArgs(args...);
+  return DoExecuteCursor(optional_cc, formatted_query);
+}
+
 }  // namespace storages::clickhouse
 
 USERVER_NAMESPACE_END
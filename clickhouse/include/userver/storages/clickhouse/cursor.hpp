@@ -0,0 +1,61 @@
+#pragma once
+
+/// @file userver/storages/clickhouse/cursor.hpp
+/// @brief @copybrief storages::clickhouse::Cursor
+
+#include <memory>
+#include <optional>
+
+#include <userver/storages/clickhouse/execution_result.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::clickhouse {
+
+namespace impl {
+class CursorImpl;
+}
+
+// clang-format off
+
+/// @brief Cursor over the result of a query, returned by
+/// storages::clickhouse::Cluster ExecuteCursor methods.
+///
+/// Blocks of the result are handed out as soon as ClickHouse sends them, at
+/// most a few of them are buffered: the query is paused while the buffer is
+/// full, so the whole result never resides in memory at once.
+///
+/// storages::clickhouse::CommandControl limits the time of reading the whole
+/// result, including the time the blocks wait for the user in the buffer.
+///
+/// The cursor holds a connection of the pool until the result is read to the
+/// end or the cursor is destroyed. Destroying the cursor before the end
+/// cancels the query.
+///
+/// ## Usage example:
+///
+/// @snippet storages/tests/cursor_chtest.cpp  Sample Cursor usage
+
+// clang-format on
+class Cursor final {
+ public:
+  explicit Cursor(std::unique_ptr<impl::CursorImpl>&&);
+  ~Cursor();
+
+  Cursor(Cursor&&) noexcept;
+  Cursor& operator=(Cursor&&) noexcept;
+
+  /// @brief Waits for the next non-empty block of the result.
+  ///
+  /// Returns std::nullopt once the whole result is read, rethrows the error
+  /// if the query failed. Each block is converted to C++ types separately
+  /// with ExecutionResult methods.
+  std::optional<ExecutionResult> NextBlock();
+
+ private:
+  std::unique_ptr<impl::CursorImpl> impl_;
+};
+
+}  // namespace storages::clickhouse
+
+USERVER_NAMESPACE_END
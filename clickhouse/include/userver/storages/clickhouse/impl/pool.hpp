@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include <userver/storages/clickhouse/cursor.hpp>
 #include <userver/storages/clickhouse/execution_result.hpp>
 #include <userver/storages/clickhouse/options.hpp>
 
@@ -29,6 +30,8 @@ class Pool final {
 
   ExecutionResult Execute(OptionalCommandControl, const Query& query) const;
 
+  Cursor ExecuteCursor(OptionalCommandControl, const Query& query) const;
+
   void Insert(OptionalCommandControl, const InsertionRequest& request) const;
 
   void WriteStatistics(
@@ -104,6 +104,26 @@ ExecutionResult Connection::Execute(OptionalCommandControl optional_cc,
   return ExecutionResult{BlockWrapperPtr{result_ptr.release()}};
 }
 
+void Connection::ExecuteStreaming(OptionalCommandControl optional_cc,
+                                  const Query& query,
+                                  const BlockConsumer& consumer) {
+  clickhouse_cpp::Query native_query{query.QueryText()};
+
+  bool is_consumer_alive = true;
+  native_query.OnDataCancelable(
+      [&is_consumer_alive, &consumer](const NativeBlock& data) {
+        // the server sends a header block without rows first
+        if (is_consumer_alive && data.GetRowCount() != 0) {
+          auto block_ptr = std::make_unique<BlockWrapper>(NativeBlock{data});
+          is_consumer_alive = consumer(BlockWrapperPtr{block_ptr.release()});
+        }
+        // we must return 'true' if we don't want to cancel query
+        return is_consumer_alive && !engine::current_task::ShouldCancel();
+      });
+
+  DoExecute(optional_cc, native_query);
+}
+
 void Connection::Insert(OptionalCommandControl optional_cc,
                         const InsertionRequest& request) {
   const auto& block = request.GetBlock();
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <functional>
+
 #include <storages/clickhouse/impl/wrap_clickhouse_cpp.hpp>
 
 #include <userver/clients/dns/resolver_fwd.hpp>
 #include <userver/storages/clickhouse/execution_result.hpp>
+#include <userver/storages/clickhouse/impl/block_wrapper_fwd.hpp>
 #include <userver/storages/clickhouse/options.hpp>
 
 #include <storages/clickhouse/impl/native_client_factory.hpp>
@@ -28,6 +31,13 @@ class Connection final {
 
   ExecutionResult Execute(OptionalCommandControl, const Query&);
 
+  /// Returns false to stop receiving the result
+  using BlockConsumer = std::function<bool(BlockWrapperPtr&&)>;
+
+  /// Hands the non-empty blocks of the result to the consumer as they arrive
+  void ExecuteStreaming(OptionalCommandControl, const Query&,
+                        const BlockConsumer& consumer);
+
   void Insert(OptionalCommandControl, const InsertionRequest&);
 
   void Ping();
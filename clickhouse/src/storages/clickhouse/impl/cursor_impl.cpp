@@ -0,0 +1,41 @@
+#include <storages/clickhouse/impl/cursor_impl.hpp>
+
+#include <userver/engine/task/cancel.hpp>
+
+#include <storages/clickhouse/impl/block_wrapper.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::clickhouse::impl {
+
+CursorImpl::CursorImpl(BlocksQueue::Consumer&& consumer,
+                       engine::TaskWithResult<void>&& execute_task)
+    : consumer_{std::move(consumer)}, execute_task_{std::move(execute_task)} {}
+
+CursorImpl::~CursorImpl() {
+  // Without a consumer the query gets cancelled on the next block, so that
+  // the connection returns to the pool instead of being dropped.
+  consumer_.reset();
+  if (execute_task_.IsValid()) {
+    engine::TaskCancellationBlocker blocker;
+    execute_task_.Wait();
+  }
+}
+
+std::optional<ExecutionResult> CursorImpl::NextBlock() {
+  if (!consumer_) return std::nullopt;
+
+  BlockWrapperPtr block;
+  if (consumer_->Pop(block)) {
+    return ExecutionResult{std::move(block)};
+  }
+
+  // The queue is drained and the query is over, rethrow its error if any
+  consumer_.reset();
+  execute_task_.Get();
+  return std::nullopt;
+}
+
+}  // namespace storages::clickhouse::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+
+#include <userver/concurrent/queue.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/storages/clickhouse/execution_result.hpp>
+#include <userver/storages/clickhouse/impl/block_wrapper_fwd.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace storages::clickhouse::impl {
+
+class CursorImpl final {
+ public:
+  using BlocksQueue = concurrent::SpscQueue<BlockWrapperPtr>;
+
+  /// Count of the received blocks that are not handed to the user yet
+  static constexpr std::size_t kMaxBufferedBlocks = 2;
+
+  CursorImpl(BlocksQueue::Consumer&& consumer,
+             engine::TaskWithResult<void>&& execute_task);
+  ~CursorImpl();
+
+  std::optional<ExecutionResult> NextBlock();
+
+ private:
+  std::optional<BlocksQueue::Consumer> consumer_;
+  engine::TaskWithResult<void> execute_task_;
+};
+
+}  // namespace storages::clickhouse::impl
+
+USERVER_NAMESPACE_END
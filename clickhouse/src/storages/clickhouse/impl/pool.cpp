@@ -4,9 +4,11 @@
 
 #include <userver/tracing/span.hpp>
 #include <userver/tracing/tags.hpp>
+#include <userver/utils/async.hpp>
 
 #include <storages/clickhouse/impl/connection.hpp>
 #include <storages/clickhouse/impl/connection_ptr.hpp>
+#include <storages/clickhouse/impl/cursor_impl.hpp>
 #include <storages/clickhouse/impl/pool_impl.hpp>
 #include <storages/clickhouse/impl/tracing_tags.hpp>
 #include <userver/formats/json/value_builder.hpp>
@@ -45,6 +47,34 @@ ExecutionResult Pool::Execute(OptionalCommandControl optional_cc,
   return conn_ptr->Execute(optional_cc, query);
 }
 
+Cursor Pool::ExecuteCursor(OptionalCommandControl optional_cc,
+                           const Query& query) const {
+  auto conn_ptr = impl_->Acquire();
+
+  auto queue = CursorImpl::BlocksQueue::Create(CursorImpl::kMaxBufferedBlocks);
+  auto consumer = queue->GetConsumer();
+  auto execute_task = USERVER_NAMESPACE::utils::Async(
+      "clickhouse_cursor",
+      [pool_impl = impl_, conn_ptr = std::move(conn_ptr),
+       producer = queue->GetProducer(), optional_cc, query]() mutable {
+        // the cursor stops waiting for blocks once the producer is destroyed
+        const auto local_producer = std::move(producer);
+
+        auto span = PrepareExecutionSpan(impl::scopes::kQuery,
+                                         pool_impl->GetHostName());
+        query.FillSpanTags(span);
+
+        const auto timer = pool_impl->GetExecuteTimer();
+        conn_ptr->ExecuteStreaming(
+            optional_cc, query, [&local_producer](BlockWrapperPtr&& block) {
+              return local_producer.Push(std::move(block));
+            });
+      });
+
+  return Cursor{std::make_unique<CursorImpl>(std::move(consumer),
+                                             std::move(execute_task))};
+}
+
 void Pool::Insert(OptionalCommandControl optional_cc,
                   const InsertionRequest& request) const {
   auto conn_ptr = impl_->Acquire();
@@ -0,0 +1,92 @@
+#include <userver/utest/utest.hpp>
+
+#include <userver/storages/clickhouse/cluster.hpp>
+#include <userver/storages/clickhouse/cursor.hpp>
+#include <userver/storages/clickhouse/query.hpp>
+
+#include "utils_test.hpp"
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+struct NumberRow final {
+  uint64_t number;
+  std::string string;
+};
+
+}  // namespace
+
+namespace storages::clickhouse::io {
+
+template <>
+struct CppToClickhouse<NumberRow> final {
+  using mapped_type = std::tuple<columns::UInt64Column, columns::StringColumn>;
+};
+
+}  // namespace storages::clickhouse::io
+
+UTEST(Cursor, ReadsAllBlocks) {
+  ClusterWrapper cluster{};
+
+  constexpr uint64_t kRowsCount = 1'000'000;
+  const storages::clickhouse::Query query{
+      "SELECT c.number, randomString(10) FROM numbers(0, {}) c"};
+  const storages::clickhouse::CommandControl cc{std::chrono::seconds{10}};
+
+  /// [Sample Cursor usage]
+  auto cursor = cluster->ExecuteCursor(cc, query, kRowsCount);
+
+  size_t blocks_count = 0;
+  uint64_t rows_count = 0;
+  uint64_t sum = 0;
+  while (auto block = cursor.NextBlock()) {
+    ++blocks_count;
+    for (const auto& row : std::move(*block).AsRows<NumberRow>()) {
+      ++rows_count;
+      sum += row.number;
+    }
+  }
+  /// [Sample Cursor usage]
+
+  EXPECT_GT(blocks_count, 1);
+  EXPECT_EQ(rows_count, kRowsCount);
+  EXPECT_EQ(sum, kRowsCount * (kRowsCount - 1) / 2);
+  EXPECT_FALSE(cursor.NextBlock().has_value());
+}
+
+UTEST(Cursor, EmptyResult) {
+  ClusterWrapper cluster{};
+
+  auto cursor = cluster->ExecuteCursor(
+      "SELECT c.number, randomString(10) FROM numbers(0, 0) c");
+  EXPECT_FALSE(cursor.NextBlock().has_value());
+}
+
+UTEST(Cursor, DestroyedBeforeEnd) {
+  ClusterWrapper cluster{};
+
+  const storages::clickhouse::CommandControl cc{std::chrono::seconds{10}};
+  {
+    auto cursor = cluster->ExecuteCursor(
+        cc, "SELECT c.number, randomString(10) FROM numbers(0, 100000000) c");
+    ASSERT_TRUE(cursor.NextBlock().has_value());
+  }
+
+  const auto stats = cluster.GetStatistics("clickhouse.connections");
+  EXPECT_EQ(stats.SingleMetric("busy").AsInt(), 0);
+
+  const auto result = cluster->Execute("SELECT toUInt64(1), 'a'")
+                          .AsContainer<std::vector<NumberRow>>();
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result.front().number, 1);
+}
+
+UTEST(Cursor, RethrowsErrors) {
+  ClusterWrapper cluster{};
+
+  auto cursor = cluster->ExecuteCursor("SELECT * FROM non_existing_table");
+  UEXPECT_THROW(cursor.NextBlock(), std::exception);
+}
+
+USERVER_NAMESPACE_END
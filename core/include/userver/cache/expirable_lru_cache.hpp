@@ -5,7 +5,11 @@
 
 #include <atomic>
 #include <chrono>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <userver/cache/lru_cache_config.hpp>
 #include <userver/cache/lru_cache_statistics.hpp>
@@ -61,6 +65,11 @@ template <typename Key, typename Value, typename Hash = std::hash<Key>,
 class ExpirableLruCache final {
  public:
   using UpdateValueFunc = std::function<Value(const Key&)>;
+  using ValuesMap = std::unordered_map<Key, Value, Hash, Equal>;
+  /// Loads values for a batch of keys, keys missing in the result are
+  /// considered absent and are not cached
+  using BatchUpdateValueFunc =
+      std::function<ValuesMap(const std::vector<Key>&)>;
 
   /// Cache read mode
   enum class ReadMode {
@@ -69,7 +78,8 @@ class ExpirableLruCache final {
   };
 
   ExpirableLruCache(size_t ways, size_t way_size, const Hash& hash = Hash(),
-                    const Equal& equal = Equal());
+                    const Equal& equal = Equal(),
+                    CachePolicy policy = CachePolicy::kLRU);
 
   ~ExpirableLruCache();
 
@@ -94,6 +104,25 @@ class ExpirableLruCache final {
   Value Get(const Key& key, const UpdateValueFunc& update_func,
             ReadMode read_mode = ReadMode::kUseCache);
 
+  /**
+   * Batch version of Get. Values of "keys" that are in cache and not expired
+   * are taken from cache, all the other keys are loaded with a single
+   * "batch_update_func" call and stored in cache if "read_mode" is kUseCache.
+   *
+   * Concurrent Get and GetMany calls share in-flight loads: a key that is
+   * being loaded by someone else is not passed to "batch_update_func", its
+   * value is waited for instead.
+   *
+   * Expiring values are updated in background with a single
+   * "batch_update_func" call if background update mode is kEnabled.
+   *
+   * @returns values by keys, a key is missing in the result if it is missing
+   * in the result of "batch_update_func"
+   */
+  ValuesMap GetMany(const std::vector<Key>& keys,
+                    const BatchUpdateValueFunc& batch_update_func,
+                    ReadMode read_mode = ReadMode::kUseCache);
+
   /**
    * Update value in cache by "update_func" if background update mode is
    * kEnabled and "key" is in cache and not expired but its lifetime ends soon.
@@ -140,6 +169,11 @@ class ExpirableLruCache final {
   /// Add async task for updating value by update_func(key)
   void UpdateInBackground(const Key& key, UpdateValueFunc update_func);
 
+  /// Add async task for updating values by a single batch_update_func(keys)
+  /// call
+  void UpdateManyInBackground(std::vector<Key> keys,
+                              BatchUpdateValueFunc batch_update_func);
+
   void Write(dump::Writer& writer) const;
 
   void Read(dump::Reader& reader);
@@ -155,6 +189,15 @@ class ExpirableLruCache final {
   bool ShouldUpdate(std::chrono::steady_clock::time_point update_time,
                     std::chrono::steady_clock::time_point now) const;
 
+  // Loads the keys that are not being loaded by anyone else with a single
+  // batch_update_func call and moves them out of "keys". The rest are left in
+  // "keys".
+  void LoadManyNotLocked(std::vector<Key>& keys,
+                         const BatchUpdateValueFunc& batch_update_func,
+                         ReadMode read_mode,
+                         std::chrono::steady_clock::time_point now,
+                         ValuesMap& result);
+
   cache::NWayLRU<Key, impl::ExpirableValue<Value>, Hash, Equal> lru_;
   std::atomic<std::chrono::milliseconds> max_lifetime_{
       std::chrono::milliseconds(0)};
@@ -167,8 +210,9 @@ class ExpirableLruCache final {
 
 template <typename Key, typename Value, typename Hash, typename Equal>
 ExpirableLruCache<Key, Value, Hash, Equal>::ExpirableLruCache(
-    size_t ways, size_t way_size, const Hash& hash, const Equal& equal)
-    : lru_(ways, way_size, hash, equal),
+    size_t ways, size_t way_size, const Hash& hash, const Equal& equal,
+    CachePolicy policy)
+    : lru_(ways, way_size, hash, equal, policy),
       mutex_set_{ways, way_size, hash, equal} {}
 
 template <typename Key, typename Value, typename Hash, typename Equal>
@@ -224,6 +268,109 @@ Value ExpirableLruCache<Key, Value, Hash, Equal>::Get(
   return value;
 }
 
+template <typename Key, typename Value, typename Hash, typename Equal>
+typename ExpirableLruCache<Key, Value, Hash, Equal>::ValuesMap
+ExpirableLruCache<Key, Value, Hash, Equal>::GetMany(
+    const std::vector<Key>& keys, const BatchUpdateValueFunc& batch_update_func,
+    ReadMode read_mode) {
+  auto now = utils::datetime::SteadyNow();
+  ValuesMap result;
+  std::unordered_set<Key, Hash, Equal> seen_keys;
+  std::vector<Key> missing_keys;
+  std::vector<Key> expiring_keys;
+
+  for (const auto& key : keys) {
+    if (!seen_keys.insert(key).second) continue;
+
+    auto old_value = lru_.Get(key);
+    if (old_value) {
+      if (!IsExpired(old_value->update_time, now)) {
+        impl::CacheHit(stats_);
+        if (ShouldUpdate(old_value->update_time, now)) {
+          expiring_keys.push_back(key);
+        }
+        result.emplace(key, std::move(old_value->value));
+        continue;
+      }
+      impl::CacheStale(stats_);
+    }
+    impl::CacheMiss(stats_);
+    missing_keys.push_back(key);
+  }
+
+  if (!expiring_keys.empty()) {
+    UpdateManyInBackground(std::move(expiring_keys), batch_update_func);
+  }
+
+  while (!missing_keys.empty()) {
+    LoadManyNotLocked(missing_keys, batch_update_func, read_mode, now, result);
+
+    // The rest of the keys are being loaded by concurrent Get or GetMany.
+    // Mutexes are locked one by one without holding any other of them, so
+    // concurrent batches can not deadlock.
+    std::vector<Key> still_missing_keys;
+    for (auto& key : missing_keys) {
+      auto mutex = mutex_set_.GetMutexForKey(key);
+      std::lock_guard lock(mutex);
+      auto old_value = lru_.Get(key);
+      if (old_value && !IsExpired(old_value->update_time, now)) {
+        result.emplace(std::move(key), std::move(old_value->value));
+      } else {
+        // The concurrent load did not cache the value, load it ourselves
+        still_missing_keys.push_back(std::move(key));
+      }
+    }
+    missing_keys = std::move(still_missing_keys);
+  }
+
+  return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename Equal>
+void ExpirableLruCache<Key, Value, Hash, Equal>::LoadManyNotLocked(
+    std::vector<Key>& keys, const BatchUpdateValueFunc& batch_update_func,
+    ReadMode read_mode, std::chrono::steady_clock::time_point now,
+    ValuesMap& result) {
+  using Mutex = decltype(mutex_set_.GetMutexForKey(keys.front()));
+
+  std::vector<Mutex> mutexes;
+  mutexes.reserve(keys.size());
+  std::vector<std::unique_lock<Mutex>> locks;
+  locks.reserve(keys.size());
+  std::vector<Key> keys_to_load;
+  std::vector<Key> locked_keys;
+
+  for (auto& key : keys) {
+    auto& mutex = mutexes.emplace_back(mutex_set_.GetMutexForKey(key));
+    std::unique_lock lock(mutex, std::try_to_lock);
+    if (!lock) {
+      locked_keys.push_back(std::move(key));
+      continue;
+    }
+
+    // Test one more time - concurrent Get() or GetMany() might have put
+    // the value
+    auto old_value = lru_.Get(key);
+    if (old_value && !IsExpired(old_value->update_time, now)) {
+      result.emplace(std::move(key), std::move(old_value->value));
+      continue;
+    }
+    locks.push_back(std::move(lock));
+    keys_to_load.push_back(std::move(key));
+  }
+  keys = std::move(locked_keys);
+
+  if (keys_to_load.empty()) return;
+
+  auto values = batch_update_func(keys_to_load);
+  for (auto& [key, value] : values) {
+    if (read_mode == ReadMode::kUseCache) {
+      lru_.Put(key, {value, now});
+    }
+    result.insert_or_assign(key, std::move(value));
+  }
+}
+
 template <typename Key, typename Value, typename Hash, typename Equal>
 std::optional<Value> ExpirableLruCache<Key, Value, Hash, Equal>::GetOptional(
     const Key& key, const UpdateValueFunc& update_func) {
@@ -361,6 +508,42 @@ void ExpirableLruCache<Key, Value, Hash, Equal>::UpdateInBackground(
   }).Detach();
 }
 
+template <typename Key, typename Value, typename Hash, typename Equal>
+void ExpirableLruCache<Key, Value, Hash, Equal>::UpdateManyInBackground(
+    std::vector<Key> keys, BatchUpdateValueFunc batch_update_func) {
+  stats_.total.background_updates += keys.size();
+  stats_.recent.GetCurrentCounter().background_updates += keys.size();
+
+  // cache will wait for all detached tasks in ~ExpirableLruCache()
+  engine::AsyncNoSpan([token = wait_token_storage_.GetToken(), this,
+                       keys = std::move(keys),
+                       batch_update_func = std::move(batch_update_func)] {
+    using Mutex = decltype(mutex_set_.GetMutexForKey(keys.front()));
+
+    std::vector<Mutex> mutexes;
+    mutexes.reserve(keys.size());
+    std::vector<std::unique_lock<Mutex>> locks;
+    locks.reserve(keys.size());
+    std::vector<Key> keys_to_update;
+
+    for (const auto& key : keys) {
+      auto& mutex = mutexes.emplace_back(mutex_set_.GetMutexForKey(key));
+      std::unique_lock lock(mutex, std::try_to_lock);
+      // skip the keys someone is updating right now
+      if (!lock) continue;
+      locks.push_back(std::move(lock));
+      keys_to_update.push_back(key);
+    }
+    if (keys_to_update.empty()) return;
+
+    auto now = utils::datetime::SteadyNow();
+    auto values = batch_update_func(keys_to_update);
+    for (auto& [key, value] : values) {
+      lru_.Put(key, {std::move(value), now});
+    }
+  }).Detach();
+}
+
 template <typename Key, typename Value, typename Hash, typename Equal>
 bool ExpirableLruCache<Key, Value, Hash, Equal>::IsExpired(
     std::chrono::steady_clock::time_point update_time,
@@ -386,14 +569,32 @@ class LruCacheWrapper final {
   using ReadMode = typename Cache::ReadMode;
 
   LruCacheWrapper(std::shared_ptr<Cache> cache,
-                  typename Cache::UpdateValueFunc update_func)
-      : cache_(std::move(cache)), update_func_(std::move(update_func)) {}
+                  typename Cache::UpdateValueFunc update_func,
+                  typename Cache::BatchUpdateValueFunc batch_update_func = {})
+      : cache_(std::move(cache)),
+        update_func_(std::move(update_func)),
+        batch_update_func_(std::move(batch_update_func)) {
+    if (!batch_update_func_) {
+      batch_update_func_ = [update_func = update_func_](
+                               const std::vector<Key>& keys) {
+        typename Cache::ValuesMap values;
+        for (const auto& key : keys) values.emplace(key, update_func(key));
+        return values;
+      };
+    }
+  }
 
   /// Get cached value or evaluates if "key" is missing in cache
   Value Get(const Key& key, ReadMode read_mode = ReadMode::kUseCache) {
     return cache_->Get(key, update_func_, read_mode);
   }
 
+  /// Get cached values, the keys missing in cache are evaluated in one batch
+  typename Cache::ValuesMap GetMany(const std::vector<Key>& keys,
+                                    ReadMode read_mode = ReadMode::kUseCache) {
+    return cache_->GetMany(keys, batch_update_func_, read_mode);
+  }
+
   /// Get cached value or "nullopt" if "key" is missing in cache
   std::optional<Value> GetOptional(const Key& key) {
     return cache_->GetOptional(key, update_func_);
@@ -412,6 +613,7 @@ class LruCacheWrapper final {
  private:
   std::shared_ptr<Cache> cache_;
   typename Cache::UpdateValueFunc update_func_;
+  typename Cache::BatchUpdateValueFunc batch_update_func_;
 };
 
 template <typename Key, typename Value, typename Hash, typename Equal>
@@ -0,0 +1,271 @@
+#pragma once
+
+/// @file userver/cache/impl/base_sql_cache.hpp
+/// @brief Driver-independent policy traits and update helpers shared by
+/// components::PostgreCache and components::MySqlCache
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <userver/cache/caching_component_base.hpp>
+#include <userver/formats/parse/to.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/tracing/scope_time.hpp>
+#include <userver/utils/cpu_relax.hpp>
+#include <userver/utils/meta.hpp>
+#include <userver/utils/void_t.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace components::sql_cache::detail {
+
+template <typename T>
+using ValueType = typename T::ValueType;
+template <typename T>
+inline constexpr bool kHasValueType = meta::kIsDetected<ValueType, T>;
+
+template <typename T>
+using RawValueTypeImpl = typename T::RawValueType;
+template <typename T>
+inline constexpr bool kHasRawValueType = meta::kIsDetected<RawValueTypeImpl, T>;
+template <typename T>
+using RawValueType = meta::DetectedOr<ValueType<T>, RawValueTypeImpl, T>;
+
+template <typename CachePolicy>
+auto ExtractValue(RawValueType<CachePolicy>&& raw) {
+  if constexpr (kHasRawValueType<CachePolicy>) {
+    return Convert(std::move(raw),
+                   formats::parse::To<ValueType<CachePolicy>>());
+  } else {
+    return std::move(raw);
+  }
+}
+
+// Component name in policy
+template <typename T>
+using HasNameImpl = std::enable_if_t<!std::string_view{T::kName}.empty()>;
+template <typename T>
+inline constexpr bool kHasName = meta::kIsDetected<HasNameImpl, T>;
+
+// Component query in policy
+template <typename T>
+using HasQueryImpl = decltype(T::kQuery);
+template <typename T>
+inline constexpr bool kHasQuery = meta::kIsDetected<HasQueryImpl, T>;
+
+// Component GetQuery in policy
+template <typename T>
+using HasGetQueryImpl = decltype(T::GetQuery());
+template <typename T>
+inline constexpr bool kHasGetQuery = meta::kIsDetected<HasGetQueryImpl, T>;
+
+// Component kWhere in policy
+template <typename T>
+using HasWhere = decltype(T::kWhere);
+template <typename T>
+inline constexpr bool kHasWhere = meta::kIsDetected<HasWhere, T>;
+
+// Update field
+template <typename T>
+using HasUpdatedField = decltype(T::kUpdatedField);
+template <typename T>
+inline constexpr bool kHasUpdatedField = meta::kIsDetected<HasUpdatedField, T>;
+
+template <typename T>
+using WantIncrementalUpdates =
+    std::enable_if_t<!std::string_view{T::kUpdatedField}.empty()>;
+template <typename T>
+inline constexpr bool kWantIncrementalUpdates =
+    meta::kIsDetected<WantIncrementalUpdates, T>;
+
+// Key member in policy
+template <typename T>
+using KeyMemberTypeImpl =
+    std::decay_t<std::invoke_result_t<decltype(T::kKeyMember), ValueType<T>>>;
+template <typename T>
+inline constexpr bool kHasKeyMember = meta::kIsDetected<KeyMemberTypeImpl, T>;
+template <typename T>
+using KeyMemberType = meta::DetectedType<KeyMemberTypeImpl, T>;
+
+// Data container for cache
+template <typename T, typename = USERVER_NAMESPACE::utils::void_t<>>
+struct DataCacheContainer {
+  static_assert(meta::kIsStdHashable<KeyMemberType<T>>,
+                "With default CacheContainer, key type must be std::hash-able");
+
+  using type = std::unordered_map<KeyMemberType<T>, ValueType<T>>;
+};
+
+template <typename T>
+struct DataCacheContainer<
+    T, USERVER_NAMESPACE::utils::void_t<typename T::CacheContainer>> {
+  using type = typename T::CacheContainer;
+};
+
+template <typename T>
+using DataCacheContainerType = typename DataCacheContainer<T>::type;
+
+// We have to whitelist container types, for which we perform by-element
+// copying, because it's not correct for certain custom containers.
+template <typename T>
+inline constexpr bool kIsContainerCopiedByElement =
+    meta::kIsInstantiationOf<std::unordered_map, T> ||
+    meta::kIsInstantiationOf<std::map, T>;
+
+template <typename T>
+std::unique_ptr<T> CopyContainer(
+    const T& container, [[maybe_unused]] std::size_t cpu_relax_iterations,
+    tracing::ScopeTime& scope) {
+  if constexpr (kIsContainerCopiedByElement<T>) {
+    auto copy = std::make_unique<T>();
+    if constexpr (meta::kIsReservable<T>) {
+      copy->reserve(container.size());
+    }
+
+    utils::CpuRelax relax{cpu_relax_iterations, &scope};
+    for (const auto& kv : container) {
+      relax.Relax();
+      copy->insert(kv);
+    }
+    return copy;
+  } else {
+    return std::make_unique<T>(container);
+  }
+}
+
+template <typename Container, typename Value, typename KeyMember,
+          typename... Args>
+void CacheInsertOrAssign(Container& container, Value&& value,
+                         const KeyMember& key_member, Args&&... /*args*/) {
+  // Args are only used to de-prioritize this default overload.
+  static_assert(sizeof...(Args) == 0);
+  // Copy 'key' to avoid aliasing issues in 'insert_or_assign'.
+  auto key = std::invoke(key_member, value);
+  container.insert_or_assign(std::move(key), std::forward<Value>(value));
+}
+
+template <typename T>
+using HasOnWritesDoneImpl = decltype(std::declval<T&>().OnWritesDone());
+
+template <typename T>
+void OnWritesDone(T& container) {
+  if constexpr (meta::kIsDetected<HasOnWritesDoneImpl, T>) {
+    container.OnWritesDone();
+  }
+}
+
+template <typename T>
+using HasCustomUpdatedImpl =
+    decltype(T::GetLastKnownUpdated(std::declval<DataCacheContainerType<T>>()));
+
+template <typename T>
+inline constexpr bool kHasCustomUpdated =
+    meta::kIsDetected<HasCustomUpdatedImpl, T>;
+
+template <typename T>
+using UpdatedFieldTypeImpl = typename T::UpdatedFieldType;
+template <typename T>
+inline constexpr bool kHasUpdatedFieldType =
+    meta::kIsDetected<UpdatedFieldTypeImpl, T>;
+
+// May return null policy
+template <typename T>
+using HasMayReturnNull = decltype(T::kMayReturnNull);
+
+template <typename T>
+constexpr bool MayReturnNull() {
+  if constexpr (meta::kIsDetected<HasMayReturnNull, T>) {
+    return T::kMayReturnNull;
+  } else {
+    return false;
+  }
+}
+
+// Checks the policy members that do not depend on the database driver
+template <typename CachePolicy, typename Query>
+struct PolicyChecker {
+  // Static assertions for cache traits
+  static_assert(kHasName<CachePolicy>,
+                "The cache policy must contain a static member `kName`");
+  static_assert(kHasValueType<CachePolicy>,
+                "The cache policy must define a type alias `ValueType`");
+  static_assert(
+      kHasKeyMember<CachePolicy>,
+      "The cache policy must contain a static member `kKeyMember` "
+      "with a pointer to a data or a function member with the object's key");
+  static_assert(kHasQuery<CachePolicy> || kHasGetQuery<CachePolicy>,
+                "The cache policy must contain a static data member "
+                "`kQuery` with a select statement or a static member function "
+                "`GetQuery` returning the query");
+  static_assert(!(kHasQuery<CachePolicy> && kHasGetQuery<CachePolicy>),
+                "The cache policy must define `kQuery` or "
+                "`GetQuery`, not both");
+  static_assert(
+      kHasUpdatedField<CachePolicy>,
+      "The cache policy must contain a static member "
+      "`kUpdatedField`. If you don't want to use incremental updates, "
+      "please set its value to `nullptr`");
+
+  static Query GetQuery() {
+    if constexpr (kHasGetQuery<CachePolicy>) {
+      return CachePolicy::GetQuery();
+    } else {
+      return CachePolicy::kQuery;
+    }
+  }
+
+  using BaseType = CachingComponentBase<DataCacheContainerType<CachePolicy>>;
+};
+
+inline constexpr std::chrono::minutes kDefaultFullUpdateTimeout{1};
+inline constexpr std::chrono::seconds kDefaultIncrementalUpdateTimeout{1};
+inline constexpr std::chrono::milliseconds kCpuRelaxThreshold{10};
+inline constexpr std::chrono::milliseconds kCpuRelaxInterval{2};
+
+inline constexpr std::string_view kCopyStage = "copy_data";
+inline constexpr std::string_view kFetchStage = "fetch";
+
+inline constexpr std::size_t kDefaultChunkSize = 1000;
+
+// If processing `items_count` items at `stage` took longer than
+// kCpuRelaxThreshold, makes the next update relax the CPU every
+// `iterations`, so that it yields about every kCpuRelaxInterval
+inline void UpdateCpuRelaxIterations(std::size_t& iterations,
+                                     std::size_t items_count,
+                                     const tracing::ScopeTime& scope,
+                                     std::string_view stage,
+                                     std::string_view cache_name) {
+  if (items_count == 0) return;
+
+  const auto elapsed = scope.ElapsedTotal(std::string{stage});
+  if (elapsed <= kCpuRelaxThreshold) return;
+
+  iterations = static_cast<std::size_t>(static_cast<double>(items_count) /
+                                        (elapsed / kCpuRelaxInterval));
+  LOG_TRACE() << "Elapsed time for " << stage << " of " << cache_name << " "
+              << elapsed.count() << " for " << items_count
+              << " data items is over threshold. Will relax CPU every "
+              << iterations << " iterations";
+}
+
+}  // namespace components::sql_cache::detail
+
+namespace utils::impl::projected_set {
+
+template <typename Set, typename Value, typename KeyMember>
+void CacheInsertOrAssign(Set& set, Value&& value,
+                         const KeyMember& /*key_member*/) {
+  DoInsert(set, std::forward<Value>(value));
+}
+
+}  // namespace utils::impl::projected_set
+
+USERVER_NAMESPACE_END
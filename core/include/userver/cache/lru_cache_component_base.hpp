@@ -48,6 +48,9 @@ yaml_config::Schema GetLruCacheComponentBaseSchema();
 ///
 /// Provides facilities for creating LRU caches.
 /// You need to override LruCacheComponent::DoGetByKey to handle cache misses.
+/// Override LruCacheComponent::DoGetByKeys to load the misses of
+/// CacheWrapper::GetMany with a single request, by default DoGetByKey is
+/// called for each of them.
 ///
 /// Caching components must be configured in service config (see options below)
 /// and may be reconfigured dynamically via components::DynamicConfig.
@@ -62,6 +65,7 @@ yaml_config::Schema GetLruCacheComponentBaseSchema();
 /// ways | number of ways for associative cache | --
 /// lifetime | TTL for cache entries (0 is unlimited) | 0
 /// config-settings | enables dynamic reconfiguration with CacheConfigSet | true
+/// policy | eviction policy, `lru` or `tiny-lfu`, see cache::CachePolicy | lru
 ///
 /// ## Example usage:
 ///
@@ -95,11 +99,16 @@ class LruCacheComponent : public components::LoggableComponentBase,
  protected:
   virtual Value DoGetByKey(const Key& key) = 0;
 
+  /// Loads a batch of keys, the keys missing in the result are not cached
+  virtual typename Cache::ValuesMap DoGetByKeys(const std::vector<Key>& keys);
+
  private:
   void DropCache();
 
   Value GetByKey(const Key& key);
 
+  typename Cache::ValuesMap GetByKeys(const std::vector<Key>& keys);
+
   void OnConfigUpdate(const dynamic_config::Snapshot& cfg);
 
   void UpdateConfig(const LruCacheConfig& config);
@@ -131,7 +140,8 @@ LruCacheComponent<Key, Value, Hash, Equal>::LruCacheComponent(
       name_(components::GetCurrentComponentName(config)),
       static_config_(config),
       cache_(std::make_shared<Cache>(static_config_.ways,
-                                     static_config_.GetWaySize())) {
+                                     static_config_.GetWaySize(), Hash{},
+                                     Equal{}, static_config_.policy)) {
   if (impl::IsDumpSupportEnabled(config)) {
     dumper_ = std::make_shared<dump::Dumper>(
         config, context, static_cast<dump::DumpableEntity&>(*this));
@@ -178,7 +188,9 @@ LruCacheComponent<Key, Value, Hash, Equal>::~LruCacheComponent() {
 template <typename Key, typename Value, typename Hash, typename Equal>
 typename LruCacheComponent<Key, Value, Hash, Equal>::CacheWrapper
 LruCacheComponent<Key, Value, Hash, Equal>::GetCache() {
-  return CacheWrapper(cache_, [this](const Key& key) { return GetByKey(key); });
+  return CacheWrapper(
+      cache_, [this](const Key& key) { return GetByKey(key); },
+      [this](const std::vector<Key>& keys) { return GetByKeys(keys); });
 }
 
 template <typename Key, typename Value, typename Hash, typename Equal>
@@ -191,6 +203,24 @@ Value LruCacheComponent<Key, Value, Hash, Equal>::GetByKey(const Key& key) {
   return DoGetByKey(key);
 }
 
+template <typename Key, typename Value, typename Hash, typename Equal>
+typename LruCacheComponent<Key, Value, Hash, Equal>::Cache::ValuesMap
+LruCacheComponent<Key, Value, Hash, Equal>::GetByKeys(
+    const std::vector<Key>& keys) {
+  return DoGetByKeys(keys);
+}
+
+template <typename Key, typename Value, typename Hash, typename Equal>
+typename LruCacheComponent<Key, Value, Hash, Equal>::Cache::ValuesMap
+LruCacheComponent<Key, Value, Hash, Equal>::DoGetByKeys(
+    const std::vector<Key>& keys) {
+  typename Cache::ValuesMap values;
+  for (const auto& key : keys) {
+    values.emplace(key, DoGetByKey(key));
+  }
+  return values;
+}
+
 template <typename Key, typename Value, typename Hash, typename Equal>
 void LruCacheComponent<Key, Value, Hash, Equal>::OnConfigUpdate(
     const dynamic_config::Snapshot& cfg) {
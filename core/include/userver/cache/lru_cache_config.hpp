@@ -5,6 +5,7 @@
 #include <optional>
 #include <unordered_map>
 
+#include <userver/cache/policy.hpp>
 #include <userver/components/component_fwd.hpp>
 #include <userver/dynamic_config/snapshot.hpp>
 #include <userver/formats/json_fwd.hpp>
@@ -44,6 +45,7 @@ struct LruCacheConfigStatic final {
   LruCacheConfig config;
   std::size_t ways;
   bool use_dynamic_config;
+  CachePolicy policy;
 };
 
 extern const dynamic_config::Key<
@@ -2,24 +2,94 @@
 
 #include <functional>
 #include <optional>
+#include <variant>
 #include <vector>
 
 #include <userver/cache/lru_map.hpp>
+#include <userver/cache/policy.hpp>
 #include <userver/dump/dumper.hpp>
 #include <userver/dump/operations.hpp>
 #include <userver/engine/mutex.hpp>
+#include <userver/utils/assert.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace cache {
 
+namespace impl {
+
+// cache::LruMap with the policy chosen at runtime
+template <typename T, typename U, typename Hash, typename Equal>
+class PolicyLruMap final {
+ public:
+  PolicyLruMap(std::size_t max_size, const Hash& hash, const Equal& equal,
+               CachePolicy policy)
+      : impl_(MakeImpl(max_size, hash, equal, policy)) {}
+
+  bool Put(const T& key, U value) {
+    return std::visit(
+        [&](auto& map) { return map.Put(key, std::move(value)); }, impl_);
+  }
+
+  void Erase(const T& key) {
+    std::visit([&](auto& map) { map.Erase(key); }, impl_);
+  }
+
+  U* Get(const T& key) {
+    return std::visit([&](auto& map) { return map.Get(key); }, impl_);
+  }
+
+  U GetOr(const T& key, const U& default_value) {
+    return std::visit(
+        [&](auto& map) { return map.GetOr(key, default_value); }, impl_);
+  }
+
+  void SetMaxSize(std::size_t new_max_size) {
+    std::visit([&](auto& map) { map.SetMaxSize(new_max_size); }, impl_);
+  }
+
+  void Clear() {
+    std::visit([](auto& map) { map.Clear(); }, impl_);
+  }
+
+  template <typename Function>
+  void VisitAll(Function&& func) const {
+    std::visit([&](const auto& map) { map.VisitAll(func); }, impl_);
+  }
+
+  std::size_t GetSize() const {
+    return std::visit([](const auto& map) { return map.GetSize(); }, impl_);
+  }
+
+ private:
+  using Impl =
+      std::variant<LruMap<T, U, Hash, Equal, CachePolicy::kLRU>,
+                   LruMap<T, U, Hash, Equal, CachePolicy::kTinyLFU>>;
+
+  static Impl MakeImpl(std::size_t max_size, const Hash& hash,
+                       const Equal& equal, CachePolicy policy) {
+    switch (policy) {
+      case CachePolicy::kLRU:
+        return Impl{std::in_place_index<0>, max_size, hash, equal};
+      case CachePolicy::kTinyLFU:
+        return Impl{std::in_place_index<1>, max_size, hash, equal};
+    }
+    UINVARIANT(false, "Unexpected cache policy");
+  }
+
+  Impl impl_;
+};
+
+}  // namespace impl
+
 /// @ingroup userver_containers
 template <typename T, typename U, typename Hash = std::hash<T>,
           typename Equal = std::equal_to<T>>
 class NWayLRU final {
  public:
   NWayLRU(size_t ways, size_t way_size, const Hash& hash = Hash(),
-          const Equal& equal = Equal());
+          const Equal& equal = Equal(),
+          CachePolicy policy = CachePolicy::kLRU);
 
   void Put(const T& key, U value);
 
@@ -56,10 +126,11 @@ class NWayLRU final {
     Way(Way&& other) noexcept : cache(std::move(other.cache)) {}
 
     // max_size is not used, will be reset by Resize() in NWayLRU::NWayLRU
-    Way(const Hash& hash, const Equal& equal) : cache(1, hash, equal) {}
+    Way(const Hash& hash, const Equal& equal, CachePolicy policy)
+        : cache(1, hash, equal, policy) {}
 
     mutable engine::Mutex mutex;
-    LruMap<T, U, Hash, Equal> cache;
+    impl::PolicyLruMap<T, U, Hash, Equal> cache;
   };
 
   Way& GetWay(const T& key);
@@ -73,10 +144,10 @@ class NWayLRU final {
 
 template <typename T, typename U, typename Hash, typename Eq>
 NWayLRU<T, U, Hash, Eq>::NWayLRU(size_t ways, size_t way_size, const Hash& hash,
-                                 const Eq& equal)
+                                 const Eq& equal, CachePolicy policy)
     : caches_(), hash_fn_(hash) {
   caches_.reserve(ways);
-  for (size_t i = 0; i < ways; ++i) caches_.emplace_back(hash, equal);
+  for (size_t i = 0; i < ways; ++i) caches_.emplace_back(hash, equal, policy);
   if (ways == 0) throw std::logic_error("Ways must be positive");
 
   for (auto& way : caches_) way.cache.SetMaxSize(way_size);
@@ -352,6 +352,8 @@ class Request final {
   std::string ExtractData();
 
  private:
+  friend class RequestBatch;
+
   std::shared_ptr<RequestState> pimpl_;
 };
 
@@ -0,0 +1,55 @@
+#pragma once
+
+/// @file userver/clients/http/request_batch.hpp
+/// @brief @copybrief clients::http::RequestBatch
+
+#include <vector>
+
+#include <userver/clients/http/request.hpp>
+#include <userver/clients/http/response_future.hpp>
+#include <userver/utils/impl/source_location.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace clients::http {
+
+/// @brief Performs multiple prepared requests at once.
+///
+/// Starting a request with Request::async_perform wakes up the event loop of
+/// the HTTP client thread that serves the request. RequestBatch groups the
+/// requests by those threads and wakes up each of them only once for the whole
+/// batch, which saves a lot of context switches for fan-out workloads.
+///
+/// Perform() returns a ResponseFuture per request in the order the requests
+/// were added. The futures work the same way as the ones returned from
+/// Request::async_perform, e.g. with engine::WaitAny and
+/// engine::WaitAllChecked:
+/// @snippet src/clients/http/client_test.cpp  HTTP Client - request batch
+///
+/// Requests that resolve their target addresses with clients::dns::Resolver
+/// and retries of the requests are started one by one.
+class RequestBatch final {
+ public:
+  RequestBatch() = default;
+
+  /// Adds a request to the batch, the request should be completely set up
+  void Add(Request request);
+
+  /// Returns the number of requests in the batch
+  std::size_t Size() const noexcept { return requests_.size(); }
+
+  /// @brief Starts all the requests of the batch, leaving the batch empty.
+  ///
+  /// Requests objects could be reused after retrieval of data from the
+  /// corresponding ResponseFuture.
+  [[nodiscard]] std::vector<ResponseFuture> Perform(
+      utils::impl::SourceLocation location =
+          utils::impl::SourceLocation::Current());
+
+ private:
+  std::vector<Request> requests_;
+};
+
+}  // namespace clients::http
+
+USERVER_NAMESPACE_END
@@ -33,6 +33,9 @@ class Manager;
 /// coro_pool.initial_size | amount of coroutines to preallocate on startup | 1000
 /// coro_pool.max_size | max amount of coroutines to keep preallocated | 4000
 /// coro_pool.stack_size | size of a single coroutine | 256 * 1024
+/// coro_pool.local_cache_size | max amount of idle coroutines to keep in a per-thread cache in front of the shared pool, 0 disables the cache; the cached coroutines are reclaimed by idle_stack_reclaim_timeout as well | 0
+/// coro_pool.idle_stack_reclaim_timeout | return the stack memory of coroutines that were idle for longer than this to the OS (MADV_DONTNEED); 0 disables the reclamation | 0
+/// coro_pool.profile_stack_usage | measure the stack usage of each task and report it as the `coro-stack-usage-kb` histogram of the task processor; adds a scan of the used stack part on every task completion | false
 /// event_thread_pool.threads | number of threads to process low level IO system calls (number of ev loops to start in libev) | 2
 /// event_thread_pool.thread_name | set OS thread name to this value | 'event-worker'
 /// components | dictionary of "component name": "options" | -
@@ -0,0 +1,138 @@
+#pragma once
+
+/// @file userver/dump/mapped_array.hpp
+/// @brief @copybrief dump::MappedArray
+///
+/// @ingroup userver_dump_read_write
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <userver/dump/common.hpp>
+#include <userver/dump/operations.hpp>
+#include <userver/dump/unsafe.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace dump {
+
+namespace impl {
+
+struct MappedBytes final {
+  const void* data{nullptr};
+  std::shared_ptr<const void> storage;
+  bool is_mapped{false};
+};
+
+void WriteAlignmentPadding(Writer& writer, std::size_t alignment);
+
+void SkipAlignmentPadding(Reader& reader);
+
+/// Returns the bytes in place if `reader` is a dump::MmapFileReader and the
+/// data is suitably aligned, otherwise copies them into a new buffer
+MappedBytes ReadMappedBytes(Reader& reader, std::size_t count,
+                            std::size_t element_size, std::size_t alignment);
+
+}  // namespace impl
+
+/// @brief An immutable array of trivially copyable elements that is written
+/// to a dump as a single block of bytes.
+///
+/// When the dump is read with dump::MmapFileReader (`mmap: true` in the
+/// static config of the dump), reading a `MappedArray` costs O(1): the
+/// elements are served directly from the mapped pages of the dump file,
+/// which are kept alive for as long as the `MappedArray` or its copies exist.
+/// Otherwise the elements are copied from the dump with a single `memcpy`.
+///
+/// @warning The binary layout of `T` is written as-is, so the dump is not
+/// portable between platforms, and any change to `T` requires bumping
+/// the `format-version` of the dump.
+template <typename T>
+class MappedArray final {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "MappedArray is only suitable for trivially copyable types");
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "Over-aligned types are not supported by MappedArray");
+
+ public:
+  using value_type = T;
+  using const_iterator = const T*;
+  using iterator = const_iterator;
+
+  MappedArray() = default;
+
+  explicit MappedArray(std::vector<T>&& data)
+      : MappedArray(std::make_shared<const std::vector<T>>(std::move(data))) {}
+
+  /// @cond
+  // For internal use only
+  MappedArray(std::size_t size, impl::MappedBytes&& bytes)
+      : data_(static_cast<const T*>(bytes.data)),
+        size_(size),
+        storage_(std::move(bytes.storage)),
+        is_mapped_(bytes.is_mapped) {}
+  /// @endcond
+
+  const T* data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  const T* begin() const noexcept { return data_; }
+  const T* end() const noexcept { return data_ + size_; }
+
+  const T& operator[](std::size_t index) const noexcept {
+    return data_[index];
+  }
+
+  /// Returns `true` if the elements reside in the mapped dump file
+  bool IsMapped() const noexcept { return is_mapped_; }
+
+ private:
+  explicit MappedArray(std::shared_ptr<const std::vector<T>> data)
+      : data_(data->data()), size_(data->size()), storage_(std::move(data)) {}
+
+  const T* data_{nullptr};
+  std::size_t size_{0};
+  std::shared_ptr<const void> storage_;
+  bool is_mapped_{false};
+};
+
+/// @brief dump::MappedArray serialization support
+template <typename T>
+void Write(Writer& writer, const MappedArray<T>& array) {
+  writer.Write(array.size());
+  impl::WriteAlignmentPadding(writer, alignof(T));
+  WriteStringViewUnsafe(
+      writer, std::string_view{reinterpret_cast<const char*>(array.data()),
+                               array.size() * sizeof(T)});
+}
+
+/// @brief dump::MappedArray deserialization support
+template <typename T>
+MappedArray<T> Read(Reader& reader, To<MappedArray<T>>) {
+  const auto size = reader.Read<std::size_t>();
+  impl::SkipAlignmentPadding(reader);
+  if (size == 0) return {};
+
+  return MappedArray<T>{
+      size, impl::ReadMappedBytes(reader, size, sizeof(T), alignof(T))};
+}
+
+template <typename T>
+bool operator==(const MappedArray<T>& lhs, const MappedArray<T>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T>
+bool operator!=(const MappedArray<T>& lhs, const MappedArray<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace dump
+
+USERVER_NAMESPACE_END
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 
 #include <boost/filesystem/operations.hpp>
 
@@ -25,6 +26,10 @@ class FileWriter final : public Writer {
 
   void Finish() override;
 
+  /// @brief Returns the amount of bytes written so far
+  /// @throws `Error` on a filesystem error
+  std::size_t GetPosition() const;
+
  private:
   void WriteRaw(std::string_view data) override;
 
@@ -52,9 +57,35 @@ class FileReader final : public Reader {
   std::string curr_chunk_;
 };
 
+/// @brief A handle to a dump file that is mapped into memory as a whole.
+/// Data is returned from `ReadRaw` without copying.
+///
+/// Types like dump::MappedArray may keep referencing the mapped pages after
+/// the reader is destroyed, see `GetMapping`.
+class MmapFileReader final : public Reader {
+ public:
+  /// @brief Opens and maps an existing dump file
+  /// @throws `Error` on a filesystem error
+  explicit MmapFileReader(std::string path);
+
+  void Finish() override;
+
+  /// @brief Returns a handle that keeps the mapping alive
+  const std::shared_ptr<const void>& GetMapping() const noexcept;
+
+ private:
+  std::string_view ReadRaw(std::size_t max_size) override;
+
+  std::string path_;
+  std::shared_ptr<const void> mapping_;
+  std::string_view unread_data_;
+  std::size_t file_size_{0};
+};
+
 class FileOperationsFactory final : public OperationsFactory {
  public:
-  explicit FileOperationsFactory(boost::filesystem::perms perms);
+  explicit FileOperationsFactory(boost::filesystem::perms perms,
+                                 bool use_mmap = false);
 
   std::unique_ptr<Reader> CreateReader(std::string full_path) override;
 
@@ -63,6 +94,7 @@ class FileOperationsFactory final : public OperationsFactory {
 
  private:
   const boost::filesystem::perms perms_;
+  const bool use_mmap_;
 };
 
 }  // namespace dump
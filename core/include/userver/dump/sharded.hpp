@@ -0,0 +1,194 @@
+#pragma once
+
+/// @file userver/dump/sharded.hpp
+/// @brief Parallel sharded dump format for large containers
+///
+/// @ingroup userver_dump_read_write
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <userver/engine/get_all.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/meta.hpp>
+
+#include <userver/dump/common.hpp>
+#include <userver/dump/common_containers.hpp>
+#include <userver/dump/meta_containers.hpp>
+#include <userver/dump/operations.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace dump {
+
+namespace impl {
+
+/// A `Writer` that appends to an in-memory buffer, used to build shards
+class BufferWriter final : public Writer {
+ public:
+  BufferWriter();
+
+  void Finish() override;
+
+  std::string Extract() &&;
+
+ private:
+  void WriteRaw(std::string_view data) override;
+
+  std::string data_;
+};
+
+/// A `Reader` that reads from an in-memory buffer, used to parse shards
+class BufferReader final : public Reader {
+ public:
+  explicit BufferReader(std::string data);
+
+  void Finish() override;
+
+ private:
+  std::string_view ReadRaw(std::size_t max_size) override;
+
+  std::string data_;
+  std::string_view unread_data_;
+};
+
+void WriteShardedHeader(Writer& writer, std::size_t shard_count);
+
+std::size_t ReadShardedHeader(Reader& reader);
+
+template <typename T>
+using MergeResult =
+    decltype(std::declval<T&>().merge(std::declval<T&>()));
+
+template <typename T>
+inline constexpr bool kIsMergeable = meta::kIsDetected<MergeResult, T>;
+
+template <typename T, typename Iterator>
+std::string WriteShard(Iterator begin, Iterator end, std::size_t size) {
+  BufferWriter writer;
+  // Same layout as a plain container, so that a shard can be read back
+  // with the usual `Read(Reader&, To<T>)`
+  writer.Write(size);
+  for (; begin != end; ++begin) {
+    // explicit cast for vector<bool> shenanigans
+    writer.Write(static_cast<const meta::RangeValueType<T>&>(*begin));
+  }
+  writer.Finish();
+  return std::move(writer).Extract();
+}
+
+template <typename T>
+T ReadShard(std::string data) {
+  BufferReader reader(std::move(data));
+  T result = reader.Read<T>();
+  reader.Finish();
+  return result;
+}
+
+template <typename T>
+void MergeShard(T& result, T&& shard) {
+  if constexpr (kIsMergeable<T>) {
+    // Node-based containers relink nodes without moving the elements
+    result.merge(shard);
+  } else {
+    for (auto&& item : shard) {
+      dump::Insert(result, static_cast<meta::RangeValueType<T>&&>(item));
+    }
+  }
+}
+
+}  // namespace impl
+
+/// The maximum count of segments in a dump written by dump::WriteSharded
+inline constexpr std::size_t kMaxShardCount = 4096;
+
+/// @brief Writes a container as `shard_count` independent segments that are
+/// serialized concurrently on the current engine::TaskProcessor
+///
+/// `shard_count` is clamped to the container size and to
+/// dump::kMaxShardCount.
+///
+/// The whole container is serialized into memory before being written, so
+/// the peak memory usage is about the size of the dump.
+///
+/// The resulting layout differs from the one produced by `Write` for
+/// the container, so switching a cache to or from sharded dumps requires
+/// bumping the `format-version` of the dump.
+///
+/// @see dump::ReadSharded
+template <typename T>
+std::enable_if_t<kIsContainer<T> && kIsWritable<meta::RangeValueType<T>>>
+WriteSharded(Writer& writer, const T& container, std::size_t shard_count) {
+  const std::size_t size = std::size(container);
+  if (shard_count > kMaxShardCount) shard_count = kMaxShardCount;
+  if (shard_count > size) shard_count = size;
+  if (shard_count == 0) shard_count = 1;
+
+  using Iterator = decltype(std::begin(container));
+  std::vector<engine::TaskWithResult<std::string>> tasks;
+  tasks.reserve(shard_count);
+
+  Iterator shard_begin = std::begin(container);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    const std::size_t shard_size =
+        size / shard_count + (i < size % shard_count ? 1 : 0);
+    Iterator shard_end = std::next(shard_begin, shard_size);
+    tasks.push_back(utils::Async(
+        "dump-write-shard", [shard_begin, shard_end, shard_size] {
+          return impl::WriteShard<T>(shard_begin, shard_end, shard_size);
+        }));
+    shard_begin = shard_end;
+  }
+
+  auto shards = engine::GetAll(tasks);
+
+  impl::WriteShardedHeader(writer, shard_count);
+  for (const auto& shard : shards) {
+    writer.Write(shard);
+  }
+}
+
+/// @brief Reads a container written by dump::WriteSharded, parsing all
+/// the segments concurrently on the current engine::TaskProcessor and merging
+/// them afterwards
+///
+/// @throws dump::Error if the dump was not written by dump::WriteSharded
+template <typename T>
+std::enable_if_t<kIsContainer<T> && kIsReadable<meta::RangeValueType<T>>, T>
+ReadSharded(Reader& reader) {
+  const std::size_t shard_count = impl::ReadShardedHeader(reader);
+
+  std::vector<engine::TaskWithResult<T>> tasks;
+  tasks.reserve(shard_count);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    tasks.push_back(utils::Async(
+        "dump-read-shard", [data = reader.Read<std::string>()]() mutable {
+          return impl::ReadShard<T>(std::move(data));
+        }));
+  }
+
+  auto shards = engine::GetAll(tasks);
+  if (shards.empty()) return T{};
+
+  T result = std::move(shards.front());
+  if constexpr (meta::kIsReservable<T>) {
+    std::size_t total_size = 0;
+    for (const auto& shard : shards) total_size += std::size(shard);
+    result.reserve(total_size);
+  }
+  for (std::size_t i = 1; i < shards.size(); ++i) {
+    impl::MergeShard(result, std::move(shards[i]));
+  }
+  return result;
+}
+
+}  // namespace dump
+
+USERVER_NAMESPACE_END
@@ -97,8 +97,15 @@ class Source final {
     return VariableSnapshotPtr{GetSnapshot(), key};
   }
 
+  /// @brief Returns a copy of a single config variable.
+  ///
+  /// Each thread keeps the last snapshot it has seen, so while the config is
+  /// not updated GetCopy() only checks the config version instead of
+  /// acquiring a new snapshot. Prefer it to GetSnapshot() for reading a few
+  /// cheap-to-copy variables on hot paths.
   template <typename VariableType>
   VariableType GetCopy(const Key<VariableType>& key) const {
+    if (const auto* cached = GetThreadCachedSnapshot()) return (*cached)[key];
     const auto snapshot = GetSnapshot();
     return snapshot[key];
   }
@@ -235,6 +242,9 @@ class Source final {
       concurrent::FunctionId id, std::string_view name,
       DiffEventSource::Function&& func);
 
+  // The result must not be used after a context switch
+  const Snapshot* GetThreadCachedSnapshot() const;
+
   impl::StorageData* storage_;
 };
 
@@ -5,6 +5,7 @@
 
 #include <sys/socket.h>
 
+#include <cstdint>
 #include <initializer_list>
 
 #include <userver/engine/deadline.hpp>
@@ -108,6 +109,17 @@ class [[nodiscard]] Socket final : public RwBase {
   /// @note Can return less than len if socket is closed by peer.
   [[nodiscard]] size_t SendAll(const void* buf, size_t len, Deadline deadline);
 
+  /// @brief Sends exactly len bytes of the file starting at the offset to
+  /// the socket, without copying the data to the userspace if the platform
+  /// allows it (`sendfile` on Linux).
+  /// @note Can return less than len if socket is closed by peer or if the file
+  /// ends earlier.
+  /// @note Reading the file may block the current thread, so prefer files that
+  /// are in the page cache or on a fast local disk.
+  /// @snippet src/engine/io/socket_test.cpp send file in socket
+  [[nodiscard]] size_t SendFile(int file_fd, std::uint64_t offset, size_t len,
+                                Deadline deadline);
+
   /// @brief Accepts a connection from a listening socket.
   /// @see engine::io::Listen
   [[nodiscard]] Socket Accept(Deadline);
@@ -0,0 +1,103 @@
+#pragma once
+
+/// @file userver/engine/io/tls_session_cache.hpp
+/// @brief TLS session caches for engine::io::TlsWrapper
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <userver/utils/statistics/fwd.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::io {
+
+class TlsWrapper;
+
+/// Counters of full and resumed TLS handshakes
+struct TlsResumptionStatistics final {
+  std::atomic<std::uint64_t> full_handshakes{0};
+  std::atomic<std::uint64_t> resumed_handshakes{0};
+};
+
+void DumpMetric(utils::statistics::Writer& writer,
+                const TlsResumptionStatistics& stats);
+
+/// @brief In-process cache of server side TLS sessions shared by connections
+///
+/// Lets clients skip the full handshake on reconnect: sessions are cached by
+/// id for the clients that do not support session tickets, tickets are
+/// encrypted with keys shared by all the connections.
+///
+/// Pass it to TlsWrapper::StartTlsServer, it must outlive the connections.
+///
+/// Thread safe.
+class TlsServerSessionCache final {
+ public:
+  /// @param max_size max count of sessions cached by id
+  /// @param session_timeout lifetime of the sessions and tickets
+  TlsServerSessionCache(std::size_t max_size,
+                        std::chrono::seconds session_timeout);
+  ~TlsServerSessionCache();
+
+  TlsServerSessionCache(const TlsServerSessionCache&) = delete;
+  TlsServerSessionCache& operator=(const TlsServerSessionCache&) = delete;
+
+  /// @brief Sets the keys to encrypt session tickets with.
+  ///
+  /// Each key has the format of nginx `ssl_session_ticket_key` files: 80 bytes
+  /// of key name, HMAC secret and AES key. The first key is used to issue new
+  /// tickets, the rest only to resume sessions, so the keys are rotated by
+  /// prepending a new one. The key that issued tickets before the call is
+  /// kept to resume sessions until the next call, so the keys may be swapped
+  /// at once without breaking the resumption of the recent sessions.
+  ///
+  /// By default a random key is generated and rotated every session timeout.
+  /// Set the same keys on all the instances of a service to resume sessions
+  /// on any of them.
+  void SetTicketKeys(const std::vector<std::string>& keys);
+
+  const TlsResumptionStatistics& GetStatistics() const;
+
+  class Impl;
+
+ private:
+  friend class TlsWrapper;
+
+  std::unique_ptr<Impl> impl_;
+};
+
+/// @brief In-process store of client side TLS sessions keyed by server name
+///
+/// Pass it to TlsWrapper::StartTlsClient to resume the sessions of previous
+/// connections to the same server. Connections without a server name are
+/// keyed by the peer address. The store must outlive the connections.
+///
+/// Thread safe.
+class TlsClientSessionCache final {
+ public:
+  /// @param max_size max count of servers to keep sessions for
+  explicit TlsClientSessionCache(std::size_t max_size);
+  ~TlsClientSessionCache();
+
+  TlsClientSessionCache(const TlsClientSessionCache&) = delete;
+  TlsClientSessionCache& operator=(const TlsClientSessionCache&) = delete;
+
+  const TlsResumptionStatistics& GetStatistics() const;
+
+  class Impl;
+
+ private:
+  friend class TlsWrapper;
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace engine::io
+
+USERVER_NAMESPACE_END
@@ -11,12 +11,24 @@
 #include <userver/engine/deadline.hpp>
 #include <userver/engine/io/common.hpp>
 #include <userver/engine/io/socket.hpp>
+#include <userver/engine/io/tls_session_cache.hpp>
 #include <userver/utils/fast_pimpl.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::io {
 
+/// Kernel TLS offload mode of TlsWrapper::StartTlsServer
+enum class KernelTlsMode {
+  /// Records are framed and encrypted by OpenSSL in userspace
+  kDisabled,
+
+  /// After the handshake encryption of the sent data is handed to the kernel
+  /// (kTLS) if both OpenSSL and the kernel support it. Sends become plain
+  /// vectored socket writes then.
+  kIfAvailable,
+};
+
 /// Class for TLS communications over a Socket.
 ///
 /// Not thread safe.
@@ -25,16 +37,20 @@ namespace engine::io {
 /// @snippet src/engine/io/tls_wrapper_test.cpp TLS wrapper usage
 class [[nodiscard]] TlsWrapper final : public RwBase {
  public:
-  /// Starts a TLS client on an opened socket
-  static TlsWrapper StartTlsClient(Socket&& socket,
-                                   const std::string& server_name,
-                                   Deadline deadline);
-
-  /// Starts a TLS server on an opened socket
+  /// Starts a TLS client on an opened socket. If session_cache is set, the
+  /// session of the previous connection to the same server is resumed.
+  static TlsWrapper StartTlsClient(
+      Socket&& socket, const std::string& server_name, Deadline deadline,
+      TlsClientSessionCache* session_cache = nullptr);
+
+  /// Starts a TLS server on an opened socket. If session_cache is set,
+  /// clients may resume their sessions from the previous connections.
   static TlsWrapper StartTlsServer(
       Socket&& socket, const crypto::Certificate& cert,
       const crypto::PrivateKey& key, Deadline deadline,
-      const std::vector<crypto::Certificate>& cert_authorities = {});
+      const std::vector<crypto::Certificate>& cert_authorities = {},
+      KernelTlsMode kernel_tls = KernelTlsMode::kDisabled,
+      TlsServerSessionCache* session_cache = nullptr);
 
   ~TlsWrapper() override;
 
@@ -66,11 +82,23 @@ class [[nodiscard]] TlsWrapper final : public RwBase {
   /// @note Can return less than len if socket is closed by peer.
   [[nodiscard]] size_t SendAll(const void* buf, size_t len, Deadline deadline);
 
+  /// @brief Sends exactly list_size IoData to the socket.
+  /// Small buffers are packed into full-size TLS records instead of being
+  /// sent as a record per buffer.
+  /// @note Can return less than the total size if socket is closed by peer.
+  [[nodiscard]] size_t SendAll(const IoData* list, std::size_t list_size,
+                               Deadline deadline);
+
   /// @brief Finishes TLS session and returns the socket.
   /// @warning Wrapper becomes invalid on entry and can only be used to retry
   ///   socket extraction if interrupted.
+  /// @note If kernel TLS offload is in use, the kernel keeps encrypting the
+  ///   data sent to the returned socket, it should only be closed.
   [[nodiscard]] Socket StopTls(Deadline deadline);
 
+  /// Whether encryption of the sent data is offloaded to the kernel
+  bool IsKernelTlsSendEnabled() const;
+
   /// @brief Receives at least one byte from the socket.
   /// @returns 0 if connection is closed on one side and no data could be
   /// received any more, received bytes count otherwise.
@@ -93,6 +121,13 @@ class [[nodiscard]] TlsWrapper final : public RwBase {
     return SendAll(buf, len, deadline);
   }
 
+  /// @brief Writes exactly the total size of the list to the socket.
+  /// @note Can return less than the total size if socket is closed by peer.
+  [[nodiscard]] size_t WriteAll(std::initializer_list<IoData> list,
+                                Deadline deadline) override {
+    return SendAll(list.begin(), list.size(), deadline);
+  }
+
   int GetRawFd();
 
  private:
@@ -3,10 +3,15 @@
 /// @file userver/rcu/rcu.hpp
 /// @brief Implementation of hazard pointer
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <cstdlib>
 #include <list>
+#include <memory>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include <userver/compiler/thread_local.hpp>
 #include <userver/engine/async.hpp>
@@ -15,6 +20,7 @@
 #include <userver/rcu/fwd.hpp>
 #include <userver/utils/assert.hpp>
 #include <userver/utils/impl/wait_token_storage.hpp>
+#include <userver/utils/meta_light.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -25,6 +31,18 @@ USERVER_NAMESPACE_BEGIN
 /// with modified API
 namespace rcu {
 
+/// @brief Can be set as `RcuTraits::kReclamationType` to customize how
+/// rcu::Variable finds out that an old value is no longer read.
+///
+/// - `kHazardPointers` (default) - every reader publishes the pointer it reads
+///   in a hazard pointer record. Reads are cheap, but each write scans all the
+///   records ever created for the variable.
+/// - `kEpochs` - readers increment a counter of the current epoch in one of
+///   per-thread sharded slots. Writes only check a fixed number of slots and
+///   free old values in batches, which makes frequent writes cheaper at the
+///   cost of a few KB of memory per variable.
+enum class ReclamationType { kHazardPointers, kEpochs };
+
 namespace impl {
 
 // Hazard pointer implementation. Pointers form a linked list. \p ptr points
@@ -53,8 +71,74 @@ struct HazardPointerRecord final {
 
   // Simple operation that marks this hazard pointer as no longer used.
   void Release() { ptr = nullptr; }
+
+  const Variable<T, RcuTraits>& GetOwner() const noexcept { return owner; }
+};
+
+// Reader counter of a single epoch parity in a slot, used instead of
+// the hazard pointer records in ReclamationType::kEpochs mode. A reader
+// increments it on Read() and may decrement it from any other thread.
+template <typename T, typename RcuTraits>
+struct EpochReaderRecord final {
+  std::atomic<std::uint64_t> readers{0};
+  const Variable<T, RcuTraits>* owner{nullptr};
+
+  void Release() { readers.fetch_sub(1); }
+
+  const Variable<T, RcuTraits>& GetOwner() const noexcept {
+    UASSERT(owner);
+    return *owner;
+  }
 };
 
+// Readers from different threads use different slots, so that they do not
+// contend on the same cache line. Records of both epoch parities share
+// the slot as a reader touches just one of them.
+template <typename T, typename RcuTraits>
+struct alignas(64) EpochReaderSlot final {
+  std::array<EpochReaderRecord<T, RcuTraits>, 2> records;
+};
+
+inline constexpr std::size_t kEpochReaderSlots = 64;
+
+template <typename RcuTraits>
+using ReclamationTypeOf = decltype(RcuTraits::kReclamationType);
+
+template <typename RcuTraits>
+constexpr ReclamationType GetReclamationType() noexcept {
+  if constexpr (meta::kIsDetected<ReclamationTypeOf, RcuTraits>) {
+    return RcuTraits::kReclamationType;
+  } else {
+    return ReclamationType::kHazardPointers;
+  }
+}
+
+template <typename RcuTraits>
+inline constexpr bool kUsesEpochs =
+    GetReclamationType<RcuTraits>() == ReclamationType::kEpochs;
+
+template <typename T, typename RcuTraits>
+using ReaderRecord = std::conditional_t<kUsesEpochs<RcuTraits>,
+                                        EpochReaderRecord<T, RcuTraits>,
+                                        HazardPointerRecord<T, RcuTraits>>;
+
+// ReclamationType::kEpochs state of a Variable, readers of an epoch use
+// the records of its parity
+template <typename T, typename RcuTraits>
+struct EpochState final {
+  std::atomic<std::uint64_t> reader_epoch{0};
+  std::unique_ptr<EpochReaderSlot<T, RcuTraits>[]> reader_slots;
+  // may be accessed only with held Variable::mutex_
+  std::array<std::vector<std::unique_ptr<T>>, 2> retired;
+};
+
+struct NoEpochState final {};
+
+template <typename T, typename RcuTraits>
+using EpochStateFor = std::conditional_t<kUsesEpochs<RcuTraits>,
+                                         EpochState<T, RcuTraits>,
+                                         NoEpochState>;
+
 template <typename T, typename RcuTraits>
 struct CachedData {
   impl::HazardPointerRecord<T, RcuTraits>* hp{nullptr};
@@ -69,16 +153,32 @@ inline compiler::ThreadLocal local_cached_data =
 
 uint64_t GetNextEpoch() noexcept;
 
+std::size_t GetNextEpochReaderSlot() noexcept;
+
+inline compiler::ThreadLocal local_epoch_reader_slot = [] {
+  return GetNextEpochReaderSlot();
+};
+
 }  // namespace impl
 
 /// Default Rcu traits.
 /// - `MutexType` is a writer's mutex type that has to be used to protect
 /// structure on update
+/// - `kReclamationType` is an optional rcu::ReclamationType constant,
+/// rcu::ReclamationType::kHazardPointers if not specified
 template <typename T>
 struct DefaultRcuTraits {
   using MutexType = engine::Mutex;
 };
 
+/// Rcu traits for variables that are updated frequently, e.g. several times
+/// per second, see rcu::ReclamationType::kEpochs
+template <typename T>
+struct EpochRcuTraits {
+  using MutexType = engine::Mutex;
+  static constexpr auto kReclamationType = ReclamationType::kEpochs;
+};
+
 /// Reader smart pointer for rcu::Variable<T>. You may use operator*() or
 /// operator->() to do something with the stored value. Once created,
 /// ReadablePtr references the same immutable value: if Variable's value is
@@ -89,16 +189,22 @@ class [[nodiscard]] ReadablePtr final {
  public:
   explicit ReadablePtr(const Variable<T, RcuTraits>& ptr)
       : hp_record_(&ptr.MakeHazardPointer()) {
-    // This cycle guarantees that at the end of it both t_ptr_ and
-    // hp_record_->ptr will both be set to
-    // 1. something meaningful
-    // 2. and that this meaningful value was not removed between assigning to
-    //    t_ptr_ and storing  it in a hazard pointer
-    do {
+    if constexpr (impl::kUsesEpochs<RcuTraits>) {
+      // The values that were current after entering the epoch are not freed
+      // until the reader leaves it
       t_ptr_ = ptr.GetCurrent();
-
-      hp_record_->ptr.store(t_ptr_);
-    } while (t_ptr_ != ptr.GetCurrent());
+    } else {
+      // This cycle guarantees that at the end of it both t_ptr_ and
+      // hp_record_->ptr will both be set to
+      // 1. something meaningful
+      // 2. and that this meaningful value was not removed between assigning
+      //    to t_ptr_ and storing  it in a hazard pointer
+      do {
+        t_ptr_ = ptr.GetCurrent();
+
+        hp_record_->ptr.store(t_ptr_);
+      } while (t_ptr_ != ptr.GetCurrent());
+    }
   }
 
   ReadablePtr(ReadablePtr<T, RcuTraits>&& other) noexcept
@@ -150,7 +256,7 @@ class [[nodiscard]] ReadablePtr final {
   }
 
   ReadablePtr(const ReadablePtr<T, RcuTraits>& other)
-      : ReadablePtr(other.hp_record_->owner) {}
+      : ReadablePtr(other.hp_record_->GetOwner()) {}
 
   ReadablePtr& operator=(const ReadablePtr<T, RcuTraits>& other) {
     if (this != &other) *this = ReadablePtr<T, RcuTraits>{other};
@@ -191,7 +297,9 @@ class [[nodiscard]] ReadablePtr final {
   // Invariant is this: if t_ptr_ is not nullptr, then hp_record_ is also
   // not nullptr and points to hazard pointer containing same T*.
   // Thus, if t_ptr_ is nullptr, then hp_record_ is undefined.
-  impl::HazardPointerRecord<T, RcuTraits>* hp_record_;
+  // In ReclamationType::kEpochs mode it is the reader counter of the epoch
+  // that keeps t_ptr_ alive.
+  impl::ReaderRecord<T, RcuTraits>* hp_record_;
 };
 
 /// Smart pointer for rcu::Variable<T> for changing RCU value. It stores a
@@ -297,6 +405,10 @@ enum class DestructionType { kSync, kAsync };
 /// be eventually freed when a subsequent writer identifies that nobody works
 /// with this version.
 ///
+/// Use rcu::EpochRcuTraits or a custom `RcuTraits::kReclamationType` to
+/// switch to the epoch-based reclamation for frequently updated values, see
+/// rcu::ReclamationType.
+///
 /// @note There is no way to create a "null" `Variable`.
 ///
 /// ## Example usage:
@@ -321,7 +433,9 @@ class Variable final {
                               ? DestructionType::kSync
                               : DestructionType::kAsync),
         epoch_(impl::GetNextEpoch()),
-        current_(new T(std::forward<Args>(initial_value_args)...)) {}
+        current_(new T(std::forward<Args>(initial_value_args)...)) {
+    InitEpochReaderSlots();
+  }
 
   /// Create a new `Variable` with an in-place constructed initial value.
   /// @param destruction_type controls whether destruction of old values should
@@ -332,7 +446,9 @@ class Variable final {
   Variable(DestructionType destruction_type, Args&&... initial_value_args)
       : destruction_type_(destruction_type),
         epoch_(impl::GetNextEpoch()),
-        current_(new T(std::forward<Args>(initial_value_args)...)) {}
+        current_(new T(std::forward<Args>(initial_value_args)...)) {
+    InitEpochReaderSlots();
+  }
 
   Variable(const Variable&) = delete;
   Variable(Variable&&) = delete;
@@ -341,6 +457,14 @@ class Variable final {
 
   ~Variable() {
     delete current_.load();
+    if constexpr (impl::kUsesEpochs<RcuTraits>) {
+      for (std::size_t i = 0; i < impl::kEpochReaderSlots; ++i) {
+        for (const auto& record : epochs_.reader_slots[i].records) {
+          UASSERT_MSG(record.readers.load() == 0,
+                      "RCU variable is destroyed while being used");
+        }
+      }
+    }
 
     auto* hp = hp_record_head_.load();
     while (hp) {
@@ -404,7 +528,12 @@ class Variable final {
       return;
     }
 
-    ScanRetiredList(CollectHazardPtrs(lock));
+    if constexpr (impl::kUsesEpochs<RcuTraits>) {
+      // The values retired in the current epoch need two epoch changes
+      if (TryAdvanceEpoch(lock)) TryAdvanceEpoch(lock);
+    } else {
+      ScanRetiredList(CollectHazardPtrs(lock));
+    }
   }
 
  private:
@@ -442,7 +571,15 @@ class Variable final {
     return nullptr;
   }
 
-  impl::HazardPointerRecord<T, RcuTraits>& MakeHazardPointer() const {
+  impl::ReaderRecord<T, RcuTraits>& MakeHazardPointer() const {
+    if constexpr (impl::kUsesEpochs<RcuTraits>) {
+      return EnterEpoch();
+    } else {
+      return MakeHazardPointerTracked();
+    }
+  }
+
+  impl::HazardPointerRecord<T, RcuTraits>& MakeHazardPointerTracked() const {
     auto cache = impl::local_cached_data<T, RcuTraits>.Use();
     auto* hp = MakeHazardPointerCached(*cache);
     if (!hp) {
@@ -469,8 +606,67 @@ class Variable final {
     return hp;
   }
 
+  void InitEpochReaderSlots() {
+    if constexpr (impl::kUsesEpochs<RcuTraits>) {
+      epochs_.reader_slots =
+          std::make_unique<impl::EpochReaderSlot<T, RcuTraits>[]>(
+              impl::kEpochReaderSlots);
+      for (std::size_t i = 0; i < impl::kEpochReaderSlots; ++i) {
+        for (auto& record : epochs_.reader_slots[i].records) {
+          record.owner = this;
+        }
+      }
+    }
+  }
+
+  impl::EpochReaderRecord<T, RcuTraits>& EnterEpoch() const {
+    auto& slot =
+        epochs_.reader_slots[*impl::local_epoch_reader_slot.Use() %
+                            impl::kEpochReaderSlots];
+    while (true) {
+      const auto epoch = epochs_.reader_epoch.load();
+      auto& record = slot.records[epoch % 2];
+      record.readers.fetch_add(1);
+      // A writer may have advanced the epoch twice between the load and
+      // the increment. Such an increment is not waited for, so retry.
+      if (epochs_.reader_epoch.load() == epoch) return record;
+      record.Release();
+    }
+  }
+
+  // Frees the values retired in the previous epoch and starts a new one
+  // if there are no readers left in the previous epoch. All the values
+  // that were current during the previous epoch are retired by now, so
+  // new readers never get them.
+  bool TryAdvanceEpoch(std::unique_lock<MutexType>&) {
+    const auto epoch = epochs_.reader_epoch.load();
+    const auto previous_parity = (epoch + 1) % 2;
+    for (std::size_t i = 0; i < impl::kEpochReaderSlots; ++i) {
+      if (epochs_.reader_slots[i].records[previous_parity].readers.load() !=
+          0) {
+        return false;
+      }
+    }
+
+    auto& retired = epochs_.retired[previous_parity];
+    if (!retired.empty()) {
+      LOG_TRACE() << "Retire " << retired.size() << " values of epoch "
+                  << epoch - 1;
+      DeleteAsync(std::exchange(retired, {}));
+    }
+    epochs_.reader_epoch.store(epoch + 1);
+    return true;
+  }
+
   void Retire(std::unique_ptr<T> old_ptr, std::unique_lock<MutexType>& lock) {
     LOG_TRACE() << "Retiring ptr=" << old_ptr.get();
+    if constexpr (impl::kUsesEpochs<RcuTraits>) {
+      auto& retired = epochs_.retired[epochs_.reader_epoch.load() % 2];
+      retired.push_back(std::move(old_ptr));
+      if (TryAdvanceEpoch(lock)) TryAdvanceEpoch(lock);
+      return;
+    }
+
     auto hazard_ptrs = CollectHazardPtrs(lock);
 
     if (hazard_ptrs.count(old_ptr.get()) > 0) {
@@ -511,17 +707,20 @@ class Variable final {
     return hazard_ptrs;
   }
 
-  void DeleteAsync(std::unique_ptr<T> ptr) {
+  // Destroys the pointers in a single task in case of kAsync destruction
+  template <typename Ptr>
+  void DeleteAsync(Ptr ptr) {
     switch (destruction_type_) {
-      case DestructionType::kSync:
-        ptr.reset();
+      case DestructionType::kSync: {
+        [[maybe_unused]] const auto to_delete = std::move(ptr);
         break;
+      }
       case DestructionType::kAsync:
         engine::CriticalAsyncNoSpan([ptr = std::move(ptr),
                                      token = wait_token_storage_
                                                  .GetToken()]() mutable {
           // Make sure *ptr is deleted before token is destroyed
-          ptr.reset();
+          [[maybe_unused]] const auto to_delete = std::move(ptr);
         }).Detach();
         break;
     }
@@ -537,6 +736,9 @@ class Variable final {
   // may be read without mutex_ locked, but must be changed with held mutex_
   std::atomic<T*> current_;
   std::list<std::unique_ptr<T>> retire_list_head_;
+
+  // empty unless ReclamationType::kEpochs is used
+  [[no_unique_address]] impl::EpochStateFor<T, RcuTraits> epochs_;
   utils::impl::WaitTokenStorage wait_token_storage_;
 
   friend class ReadablePtr<T, RcuTraits>;
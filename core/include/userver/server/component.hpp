@@ -6,6 +6,7 @@
 #include <memory>
 
 #include <userver/components/loggable_component_base.hpp>
+#include <userver/concurrent/async_event_source.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/server/server.hpp>
 #include <userver/utils/statistics/entry.hpp>
@@ -64,6 +65,10 @@ namespace components {
 /// tls.cert | path to TLS certificate | -
 /// tls.private-key | path to TLS certificate private key | -
 /// tls.private-key-passphrase-name | passphrase name located in secdist's "passphrases" section | -
+/// tls.kernel-tls | offload encryption of responses to the kernel (kTLS) if OpenSSL and the kernel support it, see engine::io::KernelTlsMode | false
+/// tls.session-cache-size | max count of TLS sessions cached by id, enables session resumption by id and by tickets if not zero, see engine::io::TlsServerSessionCache | 0
+/// tls.session-timeout | lifetime in seconds of resumable TLS sessions and tickets | 3600
+/// tls.session-ticket-keys-name | name of the list of base64 encoded 80 byte session ticket keys located in secdist's "tls_session_ticket_keys" section; the first key issues tickets, the rest only resume sessions; the keys are updated along with the secdist, the previous key keeps resuming sessions until the next update | random key rotated every session-timeout
 /// handler-defaults.max_url_size | max path/URL size or empty to not limit | 8192
 /// handler-defaults.max_request_size | max size of the whole request | 1024 * 1024
 /// handler-defaults.max_headers_size | max request headers size | 65536
@@ -74,6 +79,7 @@ namespace components {
 /// connection.in_buffer_size | size of the buffer to preallocate for request receive: bigger values use more RAM and less CPU | 32 * 1024
 /// connection.requests_queue_size_threshold | drop requests from handlers that allow throttling if there's more pending requests than allowed by this value | 100
 /// connection.keepalive_timeout | timeout in seconds to drop connection if there's not data received from it | 600
+/// connection.request_parser | HTTP request parser: 'http_parser' or 'simd' that scans the input in 16 byte blocks and copies headers less | http_parser
 /// shards | how many concurrent tasks harvest data from a single socket; do not set if not sure what it is doing | -
 ///
 /// @see @ref scripts/docs/en/userver/http_server.md
@@ -107,9 +113,12 @@ class Server final : public LoggableComponentBase {
  private:
   void WriteStatistics(utils::statistics::Writer& writer);
 
+  void OnSecdistUpdate(const storages::secdist::SecdistConfig& secdist);
+
   std::unique_ptr<server::Server> server_;
   utils::statistics::Entry server_statistics_holder_;
   utils::statistics::Entry handler_statistics_holder_;
+  concurrent::AsyncEventSubscriberScope secdist_subscriber_;
 };
 
 template <>
@@ -40,6 +40,7 @@ struct HandlerConfig {
   bool decompress_request{true};
   bool throttling_enabled{true};
   bool response_body_stream{false};
+  bool request_body_stream{false};
   std::optional<bool> set_response_server_hostname;
   bool set_tracing_headers{true};
   bool deadline_propagation_enabled{true};
@@ -82,6 +82,10 @@ class HttpHandlerBase : public HandlerBase {
 
   // For internal use only.
   HttpRequestStatistics& GetRequestStatistics() const;
+
+  // For internal use only. Accounts the request in the handler statistics as
+  // throttled and fills the response as for HandlerErrorCode::kTooManyRequests.
+  void ReportThrottledRequest(request::RequestBase& request) const;
   /// @endcond
 
   /// Override it if you need a custom logging level for messages about finish
@@ -19,6 +19,9 @@ namespace server::handlers {
 /// @brief Handler that returns HTTP 200 if file exist
 /// and returns file data with mapped content/type
 ///
+/// Range requests are served with HTTP 206, see
+/// server::http::HttpResponse::ApplyRanges.
+///
 /// ## Dynamic config
 /// * @ref USERVER_FILES_CONTENT_TYPE_MAP
 ///
@@ -3,7 +3,10 @@
 /// @file userver/server/handlers/server_monitor.hpp
 /// @brief @copybrief server::handlers::ServerMonitor
 
+#include <memory>
+
 #include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/utils/statistics/entry.hpp>
 #include <userver/utils/statistics/fwd.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -18,8 +21,12 @@ namespace server::handlers {
 ///
 /// Additionally to the
 /// @ref userver_http_handlers "common handler options" the component has
-/// 'common-labels' option that should be a map of label name to label value.
-/// Items of the map are added to each metric.
+/// the following options:
+///
+/// Name | Description | Default value
+/// ---- | ----------- | -------------
+/// common-labels | a map of label name to label value, items of the map are added to each metric | {}
+/// prometheus-cache-interval | reuse the Prometheus output of each metrics writer for this time, see utils::statistics::PrometheusFormatCache | 0 (no caching)
 ///
 /// ## Static configuration example:
 ///
@@ -45,6 +52,7 @@ class ServerMonitor final : public HttpHandlerBase {
  public:
   ServerMonitor(const components::ComponentConfig& config,
                 const components::ComponentContext& component_context);
+  ~ServerMonitor() override;
 
   /// @ingroup userver_component_names
   /// @brief The default name of server::handlers::ServerMonitor
@@ -64,6 +72,9 @@ class ServerMonitor final : public HttpHandlerBase {
 
   using CommonLabels = std::unordered_map<std::string, std::string>;
   const CommonLabels common_labels_;
+
+  std::unique_ptr<utils::statistics::PrometheusFormatCache> prometheus_cache_;
+  utils::statistics::Entry prometheus_cache_statistics_holder_;
 };
 
 }  // namespace server::handlers
@@ -0,0 +1,46 @@
+#pragma once
+
+/// @file userver/server/http/http_range.hpp
+/// @brief HTTP Range header parsing
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+/// @brief A satisfiable range of bytes of a representation, both ends are
+/// inclusive.
+struct ByteRange {
+  std::uint64_t first{0};
+  std::uint64_t last{0};
+
+  std::uint64_t Size() const { return last - first + 1; }
+
+  bool operator==(const ByteRange&) const = default;
+};
+
+/// Maximum count of ranges in a Range header, headers with more ranges are
+/// ignored to protect from the requests that cost a lot to serve.
+inline constexpr std::size_t kMaxByteRanges = 16;
+
+/// @brief Parses the value of the Range header (RFC 9110, section 14.2) for a
+/// representation of the given size.
+///
+/// Overlapping and adjacent ranges are merged, the result is sorted.
+///
+/// @returns std::nullopt if the header must be ignored: it is not a valid
+/// "bytes" range set or it has more than kMaxByteRanges ranges;
+/// an empty vector if none of the ranges is satisfiable, which should be
+/// answered with HTTP 416; the satisfiable ranges otherwise.
+///
+/// @snippet server/http/http_range_test.cpp  Sample
+std::optional<std::vector<ByteRange>> ParseByteRanges(std::string_view range,
+                                                      std::uint64_t size);
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -28,6 +28,7 @@ class Sockaddr;
 namespace server::http {
 
 class HttpRequestImpl;
+class RequestBodyStream;
 
 /// @brief HTTP Request data
 class HttpRequest final {
@@ -187,9 +188,18 @@ class HttpRequest final {
   /// @return List of cookies names.
   CookiesMapKeys GetCookieNames() const;
 
-  /// @return HTTP body.
+  /// @return HTTP body. Empty for handlers with `request-body-stream: true`,
+  /// use GetRequestBodyStream() in them.
   const std::string& RequestBody() const;
 
+  /// @return true if the body is received while the handler is running, see
+  /// `request-body-stream` option of server::handlers::HandlerBase
+  bool IsRequestBodyStreamed() const;
+
+  /// @return the body that is received while the handler is running
+  /// @throws std::logic_error if IsRequestBodyStreamed() is `false`
+  RequestBodyStream& GetRequestBodyStream() const;
+
   /// @return HTTP headers.
   const HeadersMap& RequestHeaders() const;
 
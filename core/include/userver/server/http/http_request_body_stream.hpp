@@ -0,0 +1,64 @@
+#pragma once
+
+/// @file userver/server/http/http_request_body_stream.hpp
+/// @brief @copybrief server::http::RequestBodyStream
+
+#include <stdexcept>
+#include <string>
+
+#include <userver/concurrent/queue.hpp>
+#include <userver/engine/deadline.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+/// @brief Thrown by server::http::RequestBodyStream if the client closed
+/// the connection or sent a malformed body before the body was fully received
+class RequestBodyStreamError final : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/// @brief Request body, that is received from the socket while the handler
+/// is already running.
+///
+/// Available via server::http::HttpRequest::GetRequestBodyStream() in
+/// handlers with `request-body-stream: true` in the static config.
+///
+/// The amount of data buffered between the socket and the handler is limited,
+/// the connection stops reading from the socket until the handler consumes
+/// the buffered chunks. The unread part of the body is discarded after
+/// the response is sent.
+class RequestBodyStream final {
+ public:
+  /// @cond
+  using Queue = concurrent::StringStreamQueue;
+
+  // For internal use only
+  explicit RequestBodyStream(Queue::Consumer&& consumer);
+  /// @endcond
+
+  RequestBodyStream(RequestBodyStream&&) noexcept = default;
+
+  /// @brief Waits for the next part of the body.
+  /// @returns `false` if the whole body was read, `chunk` is left empty
+  /// @throws RequestBodyStreamError if the body was not received completely,
+  /// the deadline expired or the task was cancelled
+  bool ReadChunk(std::string& chunk, engine::Deadline deadline = {});
+
+  /// @brief Reads the rest of the body.
+  /// @throws RequestBodyStreamError if the body was not received completely
+  std::string ReadAll(engine::Deadline deadline = {});
+
+  /// @returns `true` if the whole body was read
+  bool IsComplete() const noexcept { return is_complete_; }
+
+ private:
+  Queue::Consumer consumer_;
+  bool is_complete_{false};
+};
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -4,13 +4,19 @@
 /// @brief @copybrief server::http::HttpResponse
 
 #include <chrono>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <userver/concurrent/queue.hpp>
 #include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
 #include <userver/http/content_type.hpp>
 #include <userver/http/header_map.hpp>
+#include <userver/server/http/http_range.hpp>
 #include <userver/server/http/http_response_cookie.hpp>
 #include <userver/server/request/response_base.hpp>
 #include <userver/utils/impl/projecting_view.hpp>
@@ -137,12 +143,84 @@ class HttpResponse final : public request::ResponseBase {
   // Can be called only once
   Queue::Producer GetBodyProducer();
 
+  /// @brief Sets a part of the file as the response body, the file is not
+  /// read into memory.
+  ///
+  /// On TLS connections the file is read in chunks on `fs_task_processor`,
+  /// and the chunks are written from the task that sends the response. On
+  /// plain connections the data is sent with `sendfile`. The Content-Length
+  /// header is set to `length`. The file is closed after the response is
+  /// sent.
+  ///
+  /// The file is sent only if the response data is empty, so the error body
+  /// of an exception thrown from the handler takes precedence.
+  /// @warning On plain connections `sendfile` reads the file right on the
+  /// thread that sends the response, `fs_task_processor` is not used. Serve
+  /// only files that are in the page cache this way, e.g. the ones that were
+  /// just written or are read often, otherwise a slow disk read stalls all
+  /// the tasks of the task processor.
+  void SetFileBody(engine::TaskProcessor& fs_task_processor,
+                   fs::blocking::FileDescriptor file, std::uint64_t offset,
+                   std::uint64_t length);
+
+  /// @overload
+  /// Sends the whole file.
+  void SetFileBody(engine::TaskProcessor& fs_task_processor,
+                   fs::blocking::FileDescriptor file);
+
+  /// @return true if the body was set with SetFileBody
+  bool HasFileBody() const { return file_body_.has_value(); }
+
+  /// @brief Serves the Range request (RFC 9110, section 14) for the body.
+  ///
+  /// For GET requests with a satisfiable Range header sets HTTP 206 Partial
+  /// Content and returns a single range or a multipart/byteranges body, or
+  /// sets HTTP 416 Range Not Satisfiable and returns an empty body. Otherwise
+  /// returns the whole body. Also sets the "Accept-Ranges: bytes" header.
+  ///
+  /// Call it after the status (only 200 OK responses are ranged), the
+  /// Content-Type, and the ETag or Last-Modified headers are set: the
+  /// If-Range header is matched against the latter.
+  /// @returns the body to return from the handler
+  ///
+  /// @snippet server/http/http_response_test.cpp  Ranges
+  [[nodiscard]] std::string ApplyRanges(std::string body);
+
+  /// @brief Sets the file as the response body, serving the Range request
+  /// for it, see ApplyRanges and SetFileBody.
+  /// @warning The page cache requirement of SetFileBody applies.
+  void SetFileBodyWithRanges(engine::TaskProcessor& fs_task_processor,
+                             fs::blocking::FileDescriptor file);
+
  private:
   // Returns total size of the response
   std::size_t SetBodyStreamed(
       engine::io::RwBase& socket,
       USERVER_NAMESPACE::http::headers::HeadersString& header);
 
+  struct FileBodyPart {
+    // Sent before the part of the file, e.g. multipart headers
+    std::string prefix;
+    std::uint64_t offset;
+    std::uint64_t length;
+  };
+
+  struct FileBody {
+    engine::TaskProcessor* fs_task_processor;
+    fs::blocking::FileDescriptor file;
+    std::vector<FileBodyPart> parts;
+    // Sent after all the parts
+    std::string suffix;
+    std::uint64_t size;
+  };
+
+  // Returns the ranges to send, std::nullopt for the whole body
+  std::optional<std::vector<ByteRange>> GetRequestedRanges(
+      std::uint64_t size);
+
+  // Returns the count of the sent body bytes
+  std::size_t SendFileBody(engine::io::RwBase& socket);
+
   // Returns total size of the response
   std::size_t SetBodyNotStreamed(
       engine::io::RwBase& socket,
@@ -156,6 +234,7 @@ class HttpResponse final : public request::ResponseBase {
   engine::SingleConsumerEvent headers_end_;
   std::optional<Queue::Consumer> body_stream_;
   std::optional<Queue::Producer> body_stream_producer_;
+  std::optional<FileBody> file_body_;
 };
 
 void SetThrottleReason(http::HttpResponse& http_response,
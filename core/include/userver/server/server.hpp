@@ -61,6 +61,10 @@ class Server final : public congestion_control::Limitee {
 
   void SetRpsRatelimitStatusCode(http::HttpStatus status_code);
 
+  /// Sets the TLS session ticket keys from the updated secdist, the key that
+  /// issued tickets before is kept to resume their sessions
+  void UpdateTlsTicketKeys(const storages::secdist::SecdistConfig& secdist);
+
  private:
   std::unique_ptr<ServerImpl> pimpl;
 };
@@ -0,0 +1,150 @@
+#pragma once
+
+/// @file userver/server/websocket/broadcast_group.hpp
+/// @brief @copybrief server::websocket::BroadcastGroup
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include <userver/server/websocket/server.hpp>
+#include <userver/utils/span.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::websocket {
+
+namespace impl {
+class BroadcastGroupImpl;
+class BroadcastMember;
+}  // namespace impl
+
+/// @brief BroadcastGroup options
+struct BroadcastGroupConfig final {
+  /// Max messages waiting to be written into a single connection. Connections
+  /// that fall behind further are evicted from the group and closed.
+  std::size_t max_queued_messages = 64;
+
+  /// Compress each message once for all the connections that negotiated
+  /// permessage-deflate with server_no_context_takeover. Other connections
+  /// receive the message uncompressed.
+  bool compress = true;
+  /// log2 of the compression window, 9..15. Connections that negotiated
+  /// a smaller server_max_window_bits receive messages uncompressed.
+  int compression_window_bits = 15;
+  /// zlib memLevel for compression, 1..9
+  int compression_mem_level = 8;
+  /// Messages smaller than this are not compressed
+  std::size_t compression_min_message_size = 64;
+};
+
+// clang-format off
+
+/// @brief Sends the same messages to many websocket connections.
+///
+/// Each message is framed (and compressed, see BroadcastGroupConfig) only
+/// once, all the connections of the group write the same buffer. The writes
+/// are done by a separate task per connection, so that a slow connection
+/// does not delay the others. A connection that has more than
+/// BroadcastGroupConfig::max_queued_messages messages waiting is evicted: it
+/// is removed from the group, its pending messages are dropped and the
+/// connection is closed with CloseStatus::kPolicyViolation.
+///
+/// Broadcast messages are never fragmented and may be interleaved with the
+/// messages sent by WebSocketConnection::Send() from other coroutines.
+///
+/// ## Example usage:
+///
+/// @code
+/// void Handle(WebSocketConnection& websocket,
+///             server::request::RequestContext&) const override {
+///   const auto membership = group_.Join(websocket);
+///   Message message;
+///   while (!message.close_status) {
+///     websocket.Recv(message);
+///     if (!message.close_status) group_.SendText(message.data);
+///   }
+/// }
+/// @endcode
+///
+/// All the methods are thread-safe.
+
+// clang-format on
+class BroadcastGroup final {
+ public:
+  class Membership;
+
+  explicit BroadcastGroup(const BroadcastGroupConfig& config = {});
+  ~BroadcastGroup();
+
+  BroadcastGroup(BroadcastGroup&&) = delete;
+  BroadcastGroup& operator=(BroadcastGroup&&) = delete;
+
+  /// @brief Adds the connection to the group.
+  ///
+  /// The connection stays in the group until the returned Membership is
+  /// destroyed or the connection is evicted. Messages are written from the
+  /// task processor of the calling coroutine.
+  [[nodiscard]] Membership Join(WebSocketConnection& connection);
+
+  /// @brief Queues a text message for every connection of the group.
+  void SendText(std::string_view message);
+
+  /// @brief Queues a binary message for every connection of the group.
+  template <typename ContiguousContainer>
+  void SendBinary(const ContiguousContainer& message) {
+    static_assert(sizeof(typename ContiguousContainer::value_type) == 1,
+                  "SendBinary() should send either std::bytes or chars");
+    DoSend(utils::span(
+               reinterpret_cast<const std::byte*>(message.data()),
+               reinterpret_cast<const std::byte*>(message.data() +
+                                                  message.size())),
+           false);
+  }
+
+  /// @returns the number of connections in the group
+  std::size_t GetSize() const;
+
+  /// @returns the number of connections evicted for being too slow or
+  /// because of write errors
+  std::uint64_t GetEvictedCount() const noexcept;
+
+ private:
+  void DoSend(utils::span<const std::byte> message, bool is_text);
+
+  std::shared_ptr<impl::BroadcastGroupImpl> impl_;
+};
+
+/// @brief Keeps the connection in BroadcastGroup, see BroadcastGroup::Join()
+///
+/// The destructor removes the connection from the group, drops the pending
+/// messages and waits for the message that is being written, if any. If the
+/// destroying task is cancelled, the write is cancelled too and nothing can be
+/// sent into the connection after that. Destroy the Membership before the
+/// connection, e.g. before returning from WebsocketHandlerBase::Handle().
+class BroadcastGroup::Membership final {
+ public:
+  Membership(Membership&&) noexcept;
+  Membership& operator=(Membership&&) noexcept;
+  ~Membership();
+
+  /// @returns true if the connection was evicted from the group for being
+  /// too slow or because of a write error
+  bool IsEvicted() const;
+
+ private:
+  friend class BroadcastGroup;
+
+  Membership(std::shared_ptr<impl::BroadcastGroupImpl> group,
+             std::shared_ptr<impl::BroadcastMember> member);
+
+  void Leave() noexcept;
+
+  std::shared_ptr<impl::BroadcastGroupImpl> group_;
+  std::shared_ptr<impl::BroadcastMember> member_;
+};
+
+}  // namespace server::websocket
+
+USERVER_NAMESPACE_END
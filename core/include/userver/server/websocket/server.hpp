@@ -45,9 +45,28 @@ struct Message {
 
 class WebSocketConnectionImpl;
 
+namespace impl {
+struct PreparedMessage;
+}  // namespace impl
+
+/// @brief permessage-deflate extension options, see RFC 7692
+struct DeflateConfig final {
+  bool enabled = false;
+  bool server_no_context_takeover = false;
+  bool client_no_context_takeover = false;
+  int server_max_window_bits = 15;
+  int client_max_window_bits = 15;
+  int mem_level = 8;
+  unsigned min_message_size = 64;  // smaller messages are sent uncompressed
+};
+
+DeflateConfig Parse(const yaml_config::YamlConfig&,
+                    formats::parse::To<DeflateConfig>);
+
 struct Config final {
   unsigned max_remote_payload = 65536;
   unsigned fragment_size = 65536;  // 0 - do not fragment
+  DeflateConfig deflate;
 };
 
 Config Parse(const yaml_config::YamlConfig&, formats::parse::To<Config>);
@@ -83,7 +102,8 @@ class WebSocketConnection {
 
   /// @brief Send a message to websocket.
   /// @param message message to send
-  /// @throws engine::io::IoException in case of socket errors
+  /// @throws engine::io::IoException in case of socket errors, also if
+  /// a previous write failed or was cancelled in the middle of a frame
   /// @note Send() is not thread-safe by itself (you may not call Send() from
   /// multiple coroutines at once), but it is safe to call Recv() and Send()
   /// from different coroutines at once thus implementing full-duplex socket
@@ -107,6 +127,12 @@ class WebSocketConnection {
   virtual void AddFinalTags(tracing::Span& span) const = 0;
   virtual void AddStatistics(Statistics& stats) const = 0;
 
+  /// @cond
+  // For internal use only, see BroadcastGroup. Sends a message framed
+  // beforehand; it is never fragmented. Default implementation calls Send().
+  virtual void SendPrepared(const impl::PreparedMessage& message);
+  /// @endcond
+
  protected:
   virtual void DoSendBinary(utils::span<const std::byte> message) = 0;
 };
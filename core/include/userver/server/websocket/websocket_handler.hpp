@@ -28,6 +28,18 @@ namespace server::websocket {
 /// status-codes-log-level | map of "status": log_level items to override span log level for specific status codes | {}
 /// max-remote-payload | max remote payload size | 65536
 /// fragment-size | max output fragment size | 65536
+/// permessage-deflate.enabled | accept the permessage-deflate extension (RFC 7692) if the client offers it | false
+/// permessage-deflate.server-no-context-takeover | reset the compression context after each outgoing message | false
+/// permessage-deflate.client-no-context-takeover | ask the client to reset the compression context after each message | false
+/// permessage-deflate.server-max-window-bits | log2 of the compression window for outgoing messages, 9..15 | 15
+/// permessage-deflate.client-max-window-bits | log2 of the compression window to ask from the client, if it allows that, 8..15 | 15
+/// permessage-deflate.mem-level | zlib memLevel for compression, 1..9 | 8
+/// permessage-deflate.min-message-size | messages smaller than this are sent uncompressed | 64
+///
+/// With permessage-deflate each connection uses about
+/// `2^(server-max-window-bits + 2) + 2^(mem-level + 9)` bytes for compression
+/// and `2^client-max-window-bits` bytes for decompression, so lower the
+/// window bits and mem-level to limit the memory usage with many connections.
 ///
 /// ## Example usage:
 ///
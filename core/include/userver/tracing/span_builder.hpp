@@ -20,7 +20,7 @@ class SpanBuilder final {
                            utils::impl::SourceLocation::Current());
 
   void SetTraceId(std::string trace_id);
-  const std::string& GetTraceId() const noexcept;
+  const std::string& GetTraceId() const;
   void SetSpanId(std::string span_id);
   void SetParentSpanId(std::string parent_span_id);
   void SetParentLink(std::string parent_link);
@@ -20,6 +20,7 @@ class Request;
 
 class Entry;
 class Writer;
+class PrometheusFormatCache;
 
 class MetricsStorage;
 using MetricsStoragePtr = std::shared_ptr<MetricsStorage>;
@@ -0,0 +1,124 @@
+#pragma once
+
+/// @file userver/utils/statistics/log_linear_histogram.hpp
+/// @brief @copybrief utils::statistics::LogLinearHistogram
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+
+#include <userver/utils/span.hpp>
+#include <userver/utils/statistics/fwd.hpp>
+#include <userver/utils/statistics/histogram.hpp>
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+/// @brief A histogram of non-negative integer values with log-linear
+/// ("HDR-like") buckets, which require no upfront choice of bounds.
+///
+/// Values below `2 ^ (precision_bits + 1)` are stored exactly. Each further
+/// power of two is split into `2 ^ precision_bits` equal buckets, so any
+/// accounted value is reproduced with a relative error of at most
+/// `2 ^ -precision_bits` (1.6% with the default precision).
+///
+/// Account is O(1) and lock-free. Just like in
+/// utils::statistics::ShardedCounter, threads record values into their own
+/// shards. Counters are allocated lazily per shard and per power of two, so
+/// the memory is only spent for the ranges of values that actually occur.
+///
+/// Histograms with equal precision are summable, which makes LogLinearHistogram
+/// usable in utils::statistics::RecentPeriod.
+///
+/// ## Serialization
+///
+/// By default LogLinearHistogram is serialized as percentiles, in the same
+/// format as utils::statistics::Percentile. To get a summable native histogram
+/// in the formats that support utils::statistics::Histogram (e.g. Solomon),
+/// convert it with ToHistogram:
+/// @snippet utils/statistics/log_linear_histogram_test.cpp  native histogram
+///
+/// ## Usage of LogLinearHistogram
+///
+/// @snippet utils/statistics/log_linear_histogram_test.cpp  sample
+class LogLinearHistogram final {
+ public:
+  static constexpr std::uint8_t kDefaultPrecisionBits = 6;
+  static constexpr std::uint8_t kMaxPrecisionBits = 10;
+
+  /// @param precision_bits in [1, kMaxPrecisionBits], the count of buckets
+  /// per power of two is `2 ^ precision_bits`
+  explicit LogLinearHistogram(
+      std::uint8_t precision_bits = kDefaultPrecisionBits);
+
+  LogLinearHistogram(LogLinearHistogram&&) noexcept;
+  LogLinearHistogram(const LogLinearHistogram&);
+  LogLinearHistogram& operator=(LogLinearHistogram&&) noexcept;
+  LogLinearHistogram& operator=(const LogLinearHistogram&);
+  ~LogLinearHistogram();
+
+  /// Atomically increment the bucket corresponding to the given value.
+  void Account(std::uint64_t value, std::uint64_t count = 1) noexcept;
+
+  /// Returns the total count of accounted values, O(number of buckets).
+  std::uint64_t GetCount() const noexcept;
+
+  /// @brief Get X percentile - min value P, such that number of accounted
+  /// values that are less or equal to P is no less than X percent.
+  ///
+  /// The highest value of the bucket is returned. If `percent` is 100 or more,
+  /// returns the highest value of the last non-empty bucket.
+  std::uint64_t GetPercentile(double percent) const noexcept;
+
+  /// Returns the maximum relative error of GetPercentile.
+  double GetRelativeError() const noexcept;
+
+  /// @brief Add the counts of `other` to this histogram.
+  /// @throws utils::InvariantError if the precisions do not match.
+  void Add(const LogLinearHistogram& other);
+
+  /// @overload
+  /// For utils::statistics::RecentPeriod.
+  template <typename Duration = std::chrono::seconds>
+  void Add(const LogLinearHistogram& other,
+           [[maybe_unused]] Duration this_epoch_duration,
+           [[maybe_unused]] Duration before_this_epoch_duration) {
+    Add(other);
+  }
+
+  /// Atomically reset all counters to zero, allocated memory is kept.
+  void Reset() noexcept;
+
+  /// @brief Sums up the buckets into a utils::statistics::Histogram with the
+  /// given bounds.
+  ///
+  /// Each bucket is accounted by its highest value, so the result is exact if
+  /// every bound is the highest value of some bucket, e.g. `2 ^ k - 1`.
+  /// Otherwise the values near a bound may fall into the next bucket.
+  Histogram ToHistogram(utils::span<const double> upper_bounds) const;
+
+ private:
+  struct Shard;
+
+  template <typename Func>
+  void ForEachBucket(Func func) const;
+
+  std::uint8_t precision_bits_;
+  std::array<std::atomic<Shard*>, impl::kCounterShardCount> shards_{};
+};
+
+/// Atomically reset all counters to zero.
+void ResetMetric(LogLinearHistogram& histogram) noexcept;
+
+/// Metric serialization support for LogLinearHistogram, writes percentiles.
+void DumpMetric(Writer& writer, const LogLinearHistogram& histogram,
+                std::initializer_list<double> percents = {
+                    0, 50, 90, 95, 98, 99, 99.6, 99.9, 100});
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
@@ -3,6 +3,8 @@
 /// @file userver/utils/statistics/prometheus.hpp
 /// @brief Statistics output in Prometheus format.
 
+#include <chrono>
+#include <memory>
 #include <string>
 
 #include <userver/utils/statistics/storage.hpp>
@@ -35,6 +37,43 @@ std::string ToPrometheusFormatUntyped(
     const utils::statistics::Storage& statistics,
     const utils::statistics::Request& request = {});
 
+/// @brief Outputs statistics in Prometheus format, reusing the formatted
+/// metrics of each utils::statistics::Storage entry for some time.
+///
+/// Formatting hundreds of thousands of metrics takes a lot of CPU. With the
+/// cache each output calls the writers of only those entries that were
+/// formatted more than `min_render_interval` ago. The output of the other
+/// entries is copied from the previous calls, so the values of their metrics
+/// are at most `min_render_interval` old.
+///
+/// The cache remembers the output for a single utils::statistics::Request,
+/// a request with other parameters drops the cached output.
+///
+/// The cost of the outputs is reported by the DumpMetric function.
+class PrometheusFormatCache final {
+ public:
+  explicit PrometheusFormatCache(std::chrono::milliseconds min_render_interval);
+  ~PrometheusFormatCache();
+
+  /// Same as utils::statistics::ToPrometheusFormat, but uses the cache.
+  std::string ToPrometheusFormat(
+      const utils::statistics::Storage& statistics,
+      const utils::statistics::Request& request = {});
+
+  /// Same as utils::statistics::ToPrometheusFormatUntyped, but uses the cache.
+  std::string ToPrometheusFormatUntyped(
+      const utils::statistics::Storage& statistics,
+      const utils::statistics::Request& request = {});
+
+  /// Writes the count of outputs and of rendered and cached entries, and the
+  /// duration of the last output.
+  friend void DumpMetric(Writer& writer, const PrometheusFormatCache& cache);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace utils::statistics
 
 USERVER_NAMESPACE_END
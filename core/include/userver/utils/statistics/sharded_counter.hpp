@@ -0,0 +1,177 @@
+#pragma once
+
+/// @file userver/utils/statistics/sharded_counter.hpp
+/// @brief @copybrief utils::statistics::ShardedCounter
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include <userver/utils/statistics/fwd.hpp>
+#include <userver/utils/statistics/rate.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+namespace impl {
+
+inline constexpr std::size_t kCounterShardCount = 16;
+
+// Not using std::hardware_destructive_interference_size, because it is not
+// ABI-stable
+inline constexpr std::size_t kCounterShardAlignment = 128;
+
+/// Returns a shard index in [0, kCounterShardCount), which is fixed for
+/// the current thread. Threads are assigned shards in round-robin fashion.
+std::size_t GetCounterShardIndex() noexcept;
+
+template <typename T>
+struct alignas(kCounterShardAlignment) CounterShard final {
+  std::atomic<T> value{T{}};
+};
+
+}  // namespace impl
+
+/// @brief Atomic counter of type T, which is split into multiple cache lines,
+/// each one being incremented by its own subset of threads
+///
+/// Increments from different threads do not contend for the same cache line,
+/// which makes the counter suitable for very hot paths on many-core machines,
+/// at the cost of a slower `Load` and of using ~2KB of memory per counter.
+///
+/// Otherwise it is a drop-in replacement for utils::statistics::RelaxedCounter.
+///
+/// @warning `Store` is not atomic with regard to concurrent increments
+template <typename T>
+class ShardedCounter final {
+ public:
+  using ValueType = T;
+
+  ShardedCounter() noexcept = default;
+  ShardedCounter(T desired) noexcept { Store(desired); }
+
+  ShardedCounter(const ShardedCounter& other) noexcept { Store(other.Load()); }
+
+  ShardedCounter& operator=(const ShardedCounter& other) noexcept {
+    if (this == &other) return *this;
+
+    Store(other.Load());
+    return *this;
+  }
+
+  ShardedCounter& operator=(T desired) noexcept {
+    Store(desired);
+    return *this;
+  }
+
+  void Store(T desired) noexcept {
+    shards_[0].value.store(desired, std::memory_order_relaxed);
+    for (std::size_t i = 1; i < shards_.size(); ++i) {
+      shards_[i].value.store(T{}, std::memory_order_relaxed);
+    }
+  }
+
+  /// Sums up all the shards, O(number of shards)
+  T Load() const noexcept {
+    T result{};
+    for (const auto& shard : shards_) {
+      result += shard.value.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  operator T() const noexcept { return Load(); }
+
+  void Add(T arg) noexcept {
+    shards_[impl::GetCounterShardIndex()].value.fetch_add(
+        arg, std::memory_order_relaxed);
+  }
+
+  ShardedCounter& operator++() noexcept {
+    Add(1);
+    return *this;
+  }
+
+  void operator++(int) noexcept { Add(1); }
+
+  ShardedCounter& operator--() noexcept {
+    Add(-1);
+    return *this;
+  }
+
+  void operator--(int) noexcept { Add(-1); }
+
+  ShardedCounter& operator+=(T arg) noexcept {
+    Add(arg);
+    return *this;
+  }
+
+  ShardedCounter& operator-=(T arg) noexcept {
+    Add(-arg);
+    return *this;
+  }
+
+ private:
+  static_assert(std::atomic<T>::is_always_lock_free);
+
+  std::array<impl::CounterShard<T>, impl::kCounterShardCount> shards_{};
+};
+
+template <typename T>
+void DumpMetric(Writer& writer, const ShardedCounter<T>& value) {
+  writer = value.Load();
+}
+
+template <typename T>
+void ResetMetric(ShardedCounter<T>& value) {
+  value.Store(T{});
+}
+
+/// @brief Sharded counter of type Rate, see utils::statistics::ShardedCounter
+///
+/// This class is represented as Rate metric when serializing to statistics.
+/// Otherwise it is a drop-in replacement for utils::statistics::RateCounter.
+class ShardedRateCounter final {
+ public:
+  using ValueType = Rate;
+
+  ShardedRateCounter() noexcept = default;
+  explicit ShardedRateCounter(Rate desired) noexcept : impl_(desired.value) {}
+  explicit ShardedRateCounter(Rate::ValueType desired) noexcept
+      : impl_(desired) {}
+
+  ShardedRateCounter& operator=(Rate desired) noexcept {
+    Store(desired);
+    return *this;
+  }
+
+  void Store(Rate desired) noexcept { impl_.Store(desired.value); }
+
+  Rate Load() const noexcept { return Rate{impl_.Load()}; }
+
+  void Add(Rate arg) noexcept { impl_.Add(arg.value); }
+
+  ShardedRateCounter& operator++() noexcept {
+    ++impl_;
+    return *this;
+  }
+
+  void operator++(int) noexcept { ++impl_; }
+
+  ShardedRateCounter& operator+=(Rate arg) noexcept {
+    Add(arg);
+    return *this;
+  }
+
+ private:
+  ShardedCounter<Rate::ValueType> impl_;
+};
+
+void DumpMetric(Writer& writer, const ShardedRateCounter& value);
+
+void ResetMetric(ShardedRateCounter& value);
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
@@ -4,6 +4,7 @@
 /// @brief @copybrief utils::statistics::Storage
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <list>
@@ -95,6 +96,8 @@ struct MetricsSource final {
 
   WriterFunc writer;
   std::vector<Label> writer_labels;
+
+  std::uint64_t id{0};
 };
 
 using StorageData = std::list<MetricsSource>;
@@ -112,6 +115,29 @@ class BaseFormatBuilder {
                             const MetricValue& value) = 0;
 };
 
+namespace impl {
+
+/// Id of the pseudo-entry of all the legacy extenders in
+/// BaseEntryVisitor::StartEntry, ids of the other entries are never reused.
+inline constexpr std::uint64_t kLegacyExtendersEntryId = 0;
+
+/// Receives the metrics of each Storage entry separately, see
+/// Storage::VisitMetricsByEntry.
+class BaseEntryVisitor {
+ public:
+  virtual ~BaseEntryVisitor();
+
+  /// Returns the builder for the metrics of the entry, or nullptr if the entry
+  /// should not be written.
+  virtual BaseFormatBuilder* StartEntry(std::uint64_t entry_id) = 0;
+
+  /// Called after the metrics of the entry were written to the builder
+  /// returned from StartEntry.
+  virtual void FinishEntry(std::uint64_t entry_id) = 0;
+};
+
+}  // namespace impl
+
 /// @ingroup userver_clients
 ///
 /// Storage of metrics, usually retrieved from components::StatisticsStorage.
@@ -132,6 +158,13 @@ class Storage final {
   /// Visits all the metrics and calls `out.HandleMetric` for each metric.
   void VisitMetrics(BaseFormatBuilder& out, const Request& request = {}) const;
 
+  /// @cond
+  /// Same as VisitMetrics, but lets the `visitor` skip writing the entries,
+  /// e.g. to reuse the previously formatted metrics.
+  void VisitMetricsByEntry(impl::BaseEntryVisitor& visitor,
+                           const Request& request = {}) const;
+  /// @endcond
+
   /// @cond
   /// Must be called from StatisticsStorage only. Don't call it from user
   /// components.
@@ -154,6 +187,7 @@ class Storage final {
 
   std::atomic<bool> may_register_extenders_;
   impl::StorageData metrics_sources_;
+  std::uint64_t next_entry_id_{impl::kLegacyExtendersEntryId + 1};
   mutable engine::SharedMutex mutex_;
 };
 
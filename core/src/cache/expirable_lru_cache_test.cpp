@@ -4,6 +4,8 @@
 
 #include <userver/cache/expirable_lru_cache.hpp>
 #include <userver/dump/operations_mock.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/single_consumer_event.hpp>
 #include <userver/engine/sleep.hpp>
 #include <userver/utils/mock_now.hpp>
 
@@ -330,6 +332,71 @@ UTEST(ExpirableLruCache, BackgroundUpdate) {
   EXPECT_EQ(2, cache.Get(key, UpdateNever()));
 }
 
+UTEST(ExpirableLruCache, GetMany) {
+  SimpleCache cache(1, 10);
+  cache.Put("a", 1);
+
+  std::vector<std::vector<SimpleCacheKey>> batches;
+  const auto load = [&batches](const std::vector<SimpleCacheKey>& keys) {
+    batches.push_back(keys);
+    SimpleCache::ValuesMap values;
+    for (const auto& key : keys) {
+      if (key != "missing") values.emplace(key, static_cast<int>(key.size()));
+    }
+    return values;
+  };
+
+  const auto values = cache.GetMany({"a", "bb", "ccc", "bb", "missing"}, load);
+  const SimpleCache::ValuesMap expected{{"a", 1}, {"bb", 2}, {"ccc", 3}};
+  EXPECT_EQ(values, expected);
+
+  // Misses are loaded with a single call
+  ASSERT_EQ(batches.size(), 1);
+  EXPECT_EQ(batches[0],
+            (std::vector<SimpleCacheKey>{"bb", "ccc", "missing"}));
+
+  batches.clear();
+  EXPECT_EQ(cache.GetMany({"a", "bb", "ccc"}, load), expected);
+  EXPECT_TRUE(batches.empty());
+  EXPECT_EQ(std::nullopt, cache.GetOptionalNoUpdate("missing"));
+}
+
+UTEST(ExpirableLruCache, GetManySharesInFlightLoads) {
+  SimpleCache cache(1, 10);
+  engine::SingleConsumerEvent loaded_event;
+
+  auto get_task = engine::AsyncNoSpan([&] {
+    return cache.Get("a", [&](const SimpleCacheKey&) {
+      EXPECT_TRUE(loaded_event.WaitForEvent());
+      return 1;
+    });
+  });
+  EngineYield();
+
+  std::vector<std::vector<SimpleCacheKey>> batches;
+  auto get_many_task = engine::AsyncNoSpan([&] {
+    return cache.GetMany(
+        {"a", "b"}, [&batches](const std::vector<SimpleCacheKey>& keys) {
+          batches.push_back(keys);
+          SimpleCache::ValuesMap values;
+          for (const auto& key : keys) values.emplace(key, 2);
+          return values;
+        });
+  });
+  EngineYield();
+
+  // "a" is being loaded by Get, GetMany waits for it
+  ASSERT_EQ(batches.size(), 1);
+  EXPECT_EQ(batches[0], std::vector<SimpleCacheKey>{"b"});
+  EXPECT_FALSE(get_many_task.IsFinished());
+
+  loaded_event.Send();
+  EXPECT_EQ(get_task.Get(), 1);
+  const SimpleCache::ValuesMap expected{{"a", 1}, {"b", 2}};
+  EXPECT_EQ(get_many_task.Get(), expected);
+  EXPECT_EQ(batches.size(), 1);
+}
+
 UTEST(ExpirableLruCache, Example) {
   /// [Sample ExpirableLruCache]
   using Key = std::string;
@@ -72,6 +72,13 @@ properties:
         type: boolean
         description: enables dynamic reconfiguration with CacheConfigSet
         defaultDescription: true
+    policy:
+        type: string
+        description: eviction policy, see cache::CachePolicy
+        defaultDescription: lru
+        enum:
+          - lru
+          - tiny-lfu
 )");
 }
 
@@ -54,6 +54,28 @@ UTEST(NWayLRU, SetMultipleWays) {
   EXPECT_EQ(1, cache.Get(1));
 }
 
+UTEST(NWayLRU, TinyLfu) {
+  Cache cache(2, 50, {}, {}, cache::CachePolicy::kTinyLFU);
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 10; ++i) {
+      if (!cache.Get(i)) cache.Put(i, i);
+    }
+  }
+
+  // A scan does not evict the frequently used keys
+  for (int i = 100; i < 1000; ++i) cache.Put(i, i);
+  EXPECT_LE(cache.GetSize(), 100);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, cache.Get(i));
+  }
+
+  cache.UpdateWaySize(5);
+  EXPECT_LE(cache.GetSize(), 10);
+
+  cache.Invalidate();
+  EXPECT_EQ(0, cache.GetSize());
+}
+
 UTEST(NWayLRU, HashCombine) {
   for (const auto seed : std::vector<std::size_t>{0, 1, 7, 42, 100, 1000}) {
     /// @note: checking for seed used in way selection to not be equal after
@@ -11,6 +11,7 @@
 #include <engine/task/task_processor.hpp>
 #include <userver/clients/dns/resolver.hpp>
 #include <userver/clients/http/connect_to.hpp>
+#include <userver/clients/http/request_batch.hpp>
 #include <userver/clients/http/request_tracing_editor.hpp>
 #include <userver/clients/http/streamed_response.hpp>
 #include <userver/concurrent/queue.hpp>
@@ -18,6 +19,7 @@
 #include <userver/crypto/private_key.hpp>
 #include <userver/engine/async.hpp>
 #include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/wait_all_checked.hpp>
 #include <userver/engine/sleep.hpp>
 #include <userver/fs/blocking/temp_file.hpp>
 #include <userver/fs/blocking/write.hpp>
@@ -612,6 +614,33 @@ UTEST(HttpClient, PostEcho) {
   }
 }
 
+UTEST(HttpClient, RequestBatch) {
+  constexpr std::size_t kRequestsCount = 10;
+
+  EchoCallback cb;
+  const utest::SimpleServer http_server{cb};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  /// [HTTP Client - request batch]
+  clients::http::RequestBatch batch;
+  for (std::size_t i = 0; i < kRequestsCount; ++i) {
+    batch.Add(http_client_ptr->CreateRequest()
+                  .post(http_server.GetBaseUrl(), std::to_string(i))
+                  .retry(1)
+                  .timeout(kTimeout));
+  }
+
+  auto futures = batch.Perform();
+  engine::WaitAllChecked(futures);
+  for (std::size_t i = 0; i < futures.size(); ++i) {
+    EXPECT_EQ(futures[i].Get()->body(), std::to_string(i));
+  }
+  /// [HTTP Client - request batch]
+
+  EXPECT_EQ(batch.Size(), 0);
+  EXPECT_EQ(*cb.responses_200, kRequestsCount);
+}
+
 UTEST(HttpClient, StatsOnTimeout) {
   const int kRetries = 5;
   const utest::SimpleServer http_server{&sleep_callback};
@@ -0,0 +1,76 @@
+#include <userver/clients/http/request_batch.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <clients/http/request_state.hpp>
+#include <curl-ev/multi.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace clients::http {
+
+namespace {
+
+struct MultiBatch final {
+  const curl::multi* multi;
+  std::shared_ptr<RequestState> first_request;
+  RequestState::DeferredPerforms deferred;
+};
+
+void Submit(MultiBatch& batch) {
+  if (batch.deferred.empty()) return;
+
+  batch.first_request->AccountBatch(batch.deferred.size());
+  batch.first_request->easy().GetThreadControl().RunInEvLoopDeferred(
+      [deferred = std::move(batch.deferred)]() mutable {
+        for (auto& perform : deferred) perform();
+      });
+}
+
+}  // namespace
+
+void RequestBatch::Add(Request request) {
+  requests_.push_back(std::move(request));
+}
+
+std::vector<ResponseFuture> RequestBatch::Perform(
+    utils::impl::SourceLocation location) {
+  auto requests = std::move(requests_);
+  requests_.clear();
+
+  std::vector<ResponseFuture> futures;
+  futures.reserve(requests.size());
+
+  // There are only a few multis in a client, linear search is the fastest
+  std::vector<MultiBatch> batches;
+  try {
+    for (auto& request : requests) {
+      auto& state = request.pimpl_;
+      const auto* multi = state->easy().GetMulti();
+
+      auto it = std::find_if(
+          batches.begin(), batches.end(),
+          [multi](const MultiBatch& batch) { return batch.multi == multi; });
+      if (it == batches.end()) {
+        batches.push_back(MultiBatch{multi, state, {}});
+        it = std::prev(batches.end());
+      }
+
+      futures.emplace_back(state->async_perform(location, it->deferred),
+                           state);
+    }
+  } catch (...) {
+    // Do not leave the already started requests hanging
+    for (auto& batch : batches) Submit(batch);
+    throw;
+  }
+
+  for (auto& batch : batches) Submit(batch);
+  return futures;
+}
+
+}  // namespace clients::http
+
+USERVER_NAMESPACE_END
@@ -640,6 +640,16 @@ const std::string& RequestState::GetLoggedOriginalUrl() const noexcept {
 
 engine::Future<std::shared_ptr<Response>> RequestState::async_perform(
     utils::impl::SourceLocation location) {
+  return DoAsyncPerform(location, nullptr);
+}
+
+engine::Future<std::shared_ptr<Response>> RequestState::async_perform(
+    utils::impl::SourceLocation location, DeferredPerforms& deferred) {
+  return DoAsyncPerform(location, &deferred);
+}
+
+engine::Future<std::shared_ptr<Response>> RequestState::DoAsyncPerform(
+    utils::impl::SourceLocation location, DeferredPerforms* deferred) {
   data_.emplace<FullBufferedData>();
 
   StartNewSpan(location);
@@ -654,9 +664,11 @@ engine::Future<std::shared_ptr<Response>> RequestState::async_perform(
   auto future = std::get_if<FullBufferedData>(&data_)->promise_.get_future();
 
   if (UpdateTimeoutFromDeadlineAndCheck()) {
-    perform_request([holder = shared_from_this()](std::error_code err) mutable {
-      RequestState::on_retry(std::move(holder), err);
-    });
+    perform_request(
+        [holder = shared_from_this()](std::error_code err) mutable {
+          RequestState::on_retry(std::move(holder), err);
+        },
+        deferred);
   }
 
   return future;
@@ -688,7 +700,8 @@ engine::Future<void> RequestState::async_perform_stream(
   return future;
 }
 
-void RequestState::perform_request(curl::easy::handler_type handler) {
+void RequestState::perform_request(curl::easy::handler_type handler,
+                                   DeferredPerforms* deferred) {
   UASSERT_MSG(!cert_ || pkey_,
               "Setting certificate is useless without setting private key");
 
@@ -719,6 +732,8 @@ void RequestState::perform_request(curl::easy::handler_type handler) {
         }
       }
     }).Detach();
+  } else if (deferred) {
+    deferred->push_back(easy().prepare_async_perform(std::move(handler)));
   } else {
     easy().async_perform(std::move(handler));
   }
@@ -1003,6 +1018,10 @@ void RequestState::StartNewSpan(utils::impl::SourceLocation location) {
   span.DetachFromCoroStack();
 }
 
+void RequestState::AccountBatch(std::size_t size) {
+  stats_->AccountBatch(size);
+}
+
 void RequestState::StartStats() {
   if (!dest_req_stats_) {
     dest_req_stats_ =
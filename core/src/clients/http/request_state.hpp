@@ -6,6 +6,7 @@
 #include <optional>
 #include <string>
 #include <system_error>
+#include <vector>
 
 #include <userver/clients/dns/resolver_fwd.hpp>
 #include <userver/clients/http/error.hpp>
@@ -52,12 +53,18 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
   ~RequestState();
 
   using Queue = concurrent::StringStreamQueue;
+  using DeferredPerforms = std::vector<curl::easy::deferred_perform>;
 
   /// Perform async http request
   engine::Future<std::shared_ptr<Response>> async_perform(
       utils::impl::SourceLocation location =
           utils::impl::SourceLocation::Current());
 
+  /// Perform async http request, registration of the request in its multi is
+  /// appended to `deferred` instead of being scheduled to the event loop
+  engine::Future<std::shared_ptr<Response>> async_perform(
+      utils::impl::SourceLocation location, DeferredPerforms& deferred);
+
   /// Perform streaming http request, returns headers future
   engine::Future<void> async_perform_stream(
       const std::shared_ptr<Queue>& queue,
@@ -110,6 +117,9 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
 
   void SetDestinationMetricNameAuto(std::string destination);
 
+  /// account a batch of `size` requests submitted together
+  void AccountBatch(std::size_t size);
+
   void SetDestinationMetricName(const std::string& destination);
 
   void SetTestsuiteConfig(const std::shared_ptr<const TestsuiteConfig>& config);
@@ -152,7 +162,11 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
   /// simply run perform_request if there is now errors from timer
   void on_retry_timer(std::error_code err);
   /// run curl async_request, called once per attempt
-  void perform_request(curl::easy::handler_type handler);
+  void perform_request(curl::easy::handler_type handler,
+                       DeferredPerforms* deferred = nullptr);
+
+  engine::Future<std::shared_ptr<Response>> DoAsyncPerform(
+      utils::impl::SourceLocation location, DeferredPerforms* deferred);
 
   void UpdateTimeoutFromDeadline(std::chrono::milliseconds backoff);
   [[nodiscard]] bool UpdateTimeoutFromDeadlineAndCheck(
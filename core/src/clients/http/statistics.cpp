@@ -70,6 +70,11 @@ void RequestStats::AccountCancelledByDeadline() noexcept {
   ++stats_.cancelled_by_deadline_;
 }
 
+void RequestStats::AccountBatch(std::size_t size) noexcept {
+  ++stats_.batches_;
+  stats_.batched_requests_ += utils::statistics::Rate{size};
+}
+
 Statistics::ErrorGroup Statistics::ErrorCodeToGroup(std::error_code ec) {
   using ErrorCode = curl::errc::EasyErrorCode;
 
@@ -179,6 +184,10 @@ void DumpMetric(utils::statistics::Writer& writer,
   writer["sockets"]["throttled"] = stats.multi.socket_ratelimit;
   writer["sockets"]["active"] = utils::statistics::Rate{
       stats.multi.socket_open.value - stats.multi.socket_close.value};
+
+  // Batches are submitted per multi, so they are not accounted per destination
+  writer["batches"] = stats.batches;
+  writer["batched-requests"] = stats.batched_requests;
 }
 
 void DumpMetric(utils::statistics::Writer& writer,
@@ -199,6 +208,8 @@ InstanceStatistics::InstanceStatistics(const Statistics& other)
       retries(other.retries_.Load()),
       timeout_updated_by_deadline(other.timeout_updated_by_deadline_.Load()),
       cancelled_by_deadline(other.cancelled_by_deadline_.Load()),
+      batches(other.batches_.Load()),
+      batched_requests(other.batched_requests_.Load()),
       reply_status(other.reply_status_) {
   for (size_t i = 0; i < error_count.size(); i++)
     error_count[i] = other.error_count_[i].Load();
@@ -233,6 +244,8 @@ InstanceStatistics& InstanceStatistics::operator+=(
 
   timeout_updated_by_deadline += stat.timeout_updated_by_deadline;
   cancelled_by_deadline += stat.cancelled_by_deadline;
+  batches += stat.batches;
+  batched_requests += stat.batched_requests;
   reply_status += stat.reply_status;
 
   multi += stat.multi;
@@ -35,6 +35,8 @@ class RequestStats final {
   void AccountTimeoutUpdatedByDeadline() noexcept;
   void AccountCancelledByDeadline() noexcept;
 
+  void AccountBatch(std::size_t size) noexcept;
+
  private:
   void StoreTiming() noexcept;
 
@@ -103,6 +105,8 @@ class Statistics {
   utils::statistics::RateCounter socket_open_{0};
   utils::statistics::RateCounter timeout_updated_by_deadline_;
   utils::statistics::RateCounter cancelled_by_deadline_;
+  utils::statistics::RateCounter batches_;
+  utils::statistics::RateCounter batched_requests_;
   utils::statistics::HttpCodes reply_status_;
 
   friend struct InstanceStatistics;
@@ -130,6 +134,8 @@ struct InstanceStatistics {
 
   utils::statistics::Rate timeout_updated_by_deadline;
   utils::statistics::Rate cancelled_by_deadline;
+  utils::statistics::Rate batches;
+  utils::statistics::Rate batched_requests;
   utils::statistics::HttpCodes::Snapshot reply_status;
 
   MultiStats multi;
@@ -103,6 +103,26 @@ properties:
                 type: integer
                 description: size of a single coroutine, bytes
                 defaultDescription: 256 * 1024
+            local_cache_size:
+                type: integer
+                description: |
+                    max amount of idle coroutines to keep in a per-thread
+                    cache in front of the shared pool, 0 disables the cache;
+                    the cached coroutines are reclaimed by
+                    idle_stack_reclaim_timeout as well
+                defaultDescription: 0
+            idle_stack_reclaim_timeout:
+                type: string
+                description: |
+                    return the stack memory of coroutines that were idle for
+                    longer than this to the OS; 0 disables the reclamation
+                defaultDescription: 0
+            profile_stack_usage:
+                type: boolean
+                description: |
+                    measure the stack usage of each task and report it in
+                    the statistics of task processors
+                defaultDescription: false
     event_thread_pool:
         type: object
         description: event thread pool options
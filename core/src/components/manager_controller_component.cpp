@@ -8,6 +8,7 @@
 #include <userver/dynamic_config/storage/component.hpp>
 #include <userver/dynamic_config/value.hpp>
 #include <userver/logging/component.hpp>
+#include <userver/utils/statistics/rate.hpp>
 
 #include <components/manager.hpp>
 
@@ -48,6 +49,10 @@ void DumpMetric(utils::statistics::Writer& writer,
   }
 
   writer["worker-threads"] = task_processor.GetWorkerCount();
+
+  if (const auto* stack_usage = task_processor.GetStackUsageHistogram()) {
+    writer["coro-stack-usage-kb"] = *stack_usage;
+  }
 }
 
 }  // namespace engine
@@ -111,6 +116,9 @@ void ManagerControllerComponent::WriteStatistics(
           components_manager_.GetTaskProcessorPools()->GetCoroPool().GetStats();
       coro_stats["active"] = stats.active_coroutines;
       coro_stats["total"] = stats.total_coroutines;
+      coro_stats["resident-stacks"] = stats.resident_stacks;
+      coro_stats["reclaimed-stacks"] =
+          utils::statistics::Rate{stats.reclaimed_stacks};
     }
   }
 
@@ -152,17 +152,28 @@ engine::ev::ThreadControl& easy::GetThreadControl() {
 
 void easy::async_perform(handler_type handler) {
   LOG_TRACE() << "easy::async_perform start " << this;
+  auto perform = prepare_async_perform(std::move(handler));
+  multi_->GetThreadControl().RunInEvLoopDeferred(std::move(perform));
+  LOG_TRACE() << "easy::async_perform finished " << this;
+}
+
+easy::deferred_perform easy::prepare_async_perform(handler_type handler) {
   size_t request_num = ++request_counter_;
-  if (multi_) {
-    multi_->GetThreadControl().RunInEvLoopDeferred(
-        [self = shared_from_this(), this, handler = std::move(handler),
-         request_num]() mutable {
-          return do_ev_async_perform(std::move(handler), request_num);
-        });
-  } else {
+  if (!multi_) {
     throw std::runtime_error("no multi!");
   }
-  LOG_TRACE() << "easy::async_perform finished " << this;
+  return deferred_perform{shared_from_this(), std::move(handler), request_num};
+}
+
+easy::deferred_perform::deferred_perform(std::shared_ptr<easy>&& self,
+                                         handler_type&& handler,
+                                         size_t request_num)
+    : self_(std::move(self)),
+      handler_(std::move(handler)),
+      request_num_(request_num) {}
+
+void easy::deferred_perform::operator()() {
+  self_->do_ev_async_perform(std::move(handler_), request_num_);
 }
 
 void easy::do_ev_async_perform(handler_type handler, size_t request_num) {
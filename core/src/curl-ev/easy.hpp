@@ -217,9 +217,29 @@ class easy final : public std::enable_shared_from_this<easy> {
   inline native::CURL* native_handle() { return handle_; }
   engine::ev::ThreadControl& GetThreadControl();
 
+  // Registration of the handle in its multi, must be invoked in the libev
+  // thread of the multi
+  class deferred_perform final {
+   public:
+    void operator()();
+
+   private:
+    friend class easy;
+
+    deferred_perform(std::shared_ptr<easy>&& self, handler_type&& handler,
+                     size_t request_num);
+
+    std::shared_ptr<easy> self_;
+    handler_type handler_;
+    size_t request_num_;
+  };
+
   void perform();
   void perform(std::error_code& ec);
   void async_perform(handler_type handler);
+  // Same as async_perform(), but leaves running the registration in the libev
+  // thread to the caller, e.g. to register several handles at once
+  deferred_perform prepare_async_perform(handler_type handler);
   void cancel();
   void reset();
   void set_source(std::shared_ptr<std::istream> source);
@@ -574,6 +574,10 @@ properties:
                 type: boolean
                 description: Whether to encrypt the dump
                 defaultDescription: false
+            mmap:
+                type: boolean
+                description: Whether to read the dump by mapping it into memory
+                defaultDescription: false
 )");
 }
 
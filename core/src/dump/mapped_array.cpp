@@ -0,0 +1,72 @@
+#include <userver/dump/mapped_array.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include <userver/dump/operations_file.hpp>
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace dump::impl {
+
+namespace {
+
+constexpr std::string_view kZeroPadding{
+    "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", alignof(std::max_align_t)};
+
+}  // namespace
+
+void WriteAlignmentPadding(Writer& writer, std::size_t alignment) {
+  UASSERT(alignment != 0 && alignment <= kZeroPadding.size());
+
+  // Only a plain dump file can be mapped, so only there the alignment
+  // of the data in the file matters
+  const auto* file_writer = dynamic_cast<const FileWriter*>(&writer);
+  if (file_writer == nullptr) {
+    writer.Write(std::uint8_t{0});
+    return;
+  }
+
+  // The padding size itself takes 1 byte
+  const auto position = file_writer->GetPosition() + 1;
+  const auto padding = static_cast<std::uint8_t>(
+      (alignment - position % alignment) % alignment);
+  writer.Write(padding);
+  WriteStringViewUnsafe(writer, kZeroPadding.substr(0, padding));
+}
+
+void SkipAlignmentPadding(Reader& reader) {
+  const auto padding = reader.Read<std::uint8_t>();
+  if (padding >= kZeroPadding.size()) {
+    throw Error(fmt::format("Invalid alignment padding in dump: {}", padding));
+  }
+  ReadStringViewUnsafe(reader, padding);
+}
+
+MappedBytes ReadMappedBytes(Reader& reader, std::size_t count,
+                            std::size_t element_size, std::size_t alignment) {
+  if (count > std::numeric_limits<std::size_t>::max() / element_size) {
+    throw Error(fmt::format("Invalid array size in dump: {}", count));
+  }
+  const auto bytes = ReadStringViewUnsafe(reader, count * element_size);
+
+  const auto* mmap_reader = dynamic_cast<const MmapFileReader*>(&reader);
+  if (mmap_reader != nullptr &&
+      reinterpret_cast<std::uintptr_t>(bytes.data()) % alignment == 0) {
+    return {bytes.data(), mmap_reader->GetMapping(), true};
+  }
+
+  // 'new char[]' returns memory suitably aligned for any fundamental type
+  std::shared_ptr<char[]> buffer{new char[bytes.size()]};
+  std::memcpy(buffer.get(), bytes.data(), bytes.size());
+  const void* data = buffer.get();
+  return {data, std::move(buffer), false};
+}
+
+}  // namespace dump::impl
+
+USERVER_NAMESPACE_END
@@ -1,20 +1,49 @@
 #include <userver/dump/operations_file.hpp>
 
+#include <sys/mman.h>
+
 #include <algorithm>
+#include <cerrno>
 #include <stdexcept>
+#include <system_error>
 #include <utility>
 
 #include <fmt/format.h>
 
+#include <userver/fs/blocking/file_descriptor.hpp>
 #include <userver/fs/blocking/write.hpp>
+#include <userver/utils/assert.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace dump {
 
 namespace {
+
 constexpr std::size_t kCheckTimeAfterBytes{1 << 15};
-}
+
+class FileMapping final {
+ public:
+  FileMapping(void* data, std::size_t size) : data_(data), size_(size) {}
+
+  FileMapping(FileMapping&&) = delete;
+  FileMapping& operator=(FileMapping&&) = delete;
+
+  ~FileMapping() {
+    [[maybe_unused]] const int result = ::munmap(data_, size_);
+    UASSERT(result == 0);
+  }
+
+  std::string_view GetData() const noexcept {
+    return {static_cast<const char*>(data_), size_};
+  }
+
+ private:
+  void* const data_;
+  const std::size_t size_;
+};
+
+}  // namespace
 
 FileWriter::FileWriter(std::string path, boost::filesystem::perms perms,
                        tracing::ScopeTime& scope)
@@ -44,6 +73,15 @@ void FileWriter::WriteRaw(std::string_view data) {
   cpu_relax_.Relax(data.size());
 }
 
+std::size_t FileWriter::GetPosition() const {
+  try {
+    return file_.GetPosition();
+  } catch (const std::exception& ex) {
+    throw Error(fmt::format("Failed to get position in the dump file \"{}\": {}",
+                            path_, ex.what()));
+  }
+}
+
 void FileWriter::Finish() {
   try {
     // Flush must be performed at some point before Rename, otherwise after a
@@ -116,11 +154,62 @@ void FileReader::Finish() {
   }
 }
 
-FileOperationsFactory::FileOperationsFactory(boost::filesystem::perms perms)
-    : perms_(perms) {}
+MmapFileReader::MmapFileReader(std::string path) : path_(std::move(path)) {
+  try {
+    const auto file =
+        fs::blocking::FileDescriptor::Open(path_, fs::blocking::OpenFlag::kRead);
+    file_size_ = file.GetSize();
+    if (file_size_ == 0) return;
+
+    void* const data = ::mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE,
+                              file.GetNative(), 0);
+    if (data == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    auto mapping = std::make_shared<const FileMapping>(data, file_size_);
+    unread_data_ = mapping->GetData();
+    mapping_ = std::move(mapping);
+
+    // The dump is read sequentially, and then the mapped pages are accessed
+    // by the cache in an arbitrary order
+    ::madvise(data, file_size_, MADV_WILLNEED);
+  } catch (const std::exception& ex) {
+    throw Error(fmt::format(
+        "Failed to map the dump file for reading \"{}\". Reason: {}", path_,
+        ex.what()));
+  }
+}
+
+std::string_view MmapFileReader::ReadRaw(std::size_t max_size) {
+  const auto result_size = std::min(max_size, unread_data_.size());
+  const auto result = unread_data_.substr(0, result_size);
+  unread_data_ = unread_data_.substr(result_size);
+  return result;
+}
+
+void MmapFileReader::Finish() {
+  if (!unread_data_.empty()) {
+    throw Error(
+        fmt::format("Unexpected extra data at the end of the dump file \"{}\": "
+                    "file-size={}, position={}, unread-size={}",
+                    path_, file_size_, file_size_ - unread_data_.size(),
+                    unread_data_.size()));
+  }
+}
+
+const std::shared_ptr<const void>& MmapFileReader::GetMapping() const noexcept {
+  return mapping_;
+}
+
+FileOperationsFactory::FileOperationsFactory(boost::filesystem::perms perms,
+                                             bool use_mmap)
+    : perms_(perms), use_mmap_(use_mmap) {}
 
 std::unique_ptr<Reader> FileOperationsFactory::CreateReader(
     std::string full_path) {
+  if (use_mmap_) {
+    return std::make_unique<MmapFileReader>(std::move(full_path));
+  }
   return std::make_unique<FileReader>(std::move(full_path));
 }
 
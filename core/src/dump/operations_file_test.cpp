@@ -2,6 +2,7 @@
 
 #include <boost/regex.hpp>
 
+#include <userver/dump/mapped_array.hpp>
 #include <userver/dump/unsafe.hpp>
 #include <userver/fs/blocking/read.hpp>
 #include <userver/fs/blocking/temp_directory.hpp>
@@ -113,4 +114,71 @@ TEST(DumpOperationsFile, Underread) {
   FAIL();
 }
 
+UTEST(DumpOperationsFile, MmapWriteReadRaw) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = DumpFilePath(dir);
+
+  auto scope_time = tracing::Span::CurrentSpan().CreateScopeTime("dump");
+  dump::FileWriter writer(path, boost::filesystem::perms::owner_read,
+                          scope_time);
+  writer.Write(std::string{"abc"});
+  WriteStringViewUnsafe(writer, std::string(10, 'a'));
+  writer.Finish();
+
+  dump::MmapFileReader reader(path);
+  EXPECT_EQ(reader.Read<std::string>(), "abc");
+  EXPECT_EQ(ReadStringViewUnsafe(reader, 10), std::string(10, 'a'));
+  reader.Finish();
+}
+
+UTEST(DumpOperationsFile, MmapEmptyDump) {
+  const auto file = fs::blocking::TempFile::Create();
+
+  dump::MmapFileReader reader(file.GetPath());
+  reader.Finish();
+}
+
+UTEST(DumpOperationsFile, MmapUnderread) {
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), std::string(10, 'a'));
+
+  dump::MmapFileReader reader(file.GetPath());
+  EXPECT_EQ(ReadStringViewUnsafe(reader, 9), std::string(9, 'a'));
+  UEXPECT_THROW(reader.Finish(), dump::Error);
+}
+
+UTEST(DumpOperationsFile, MappedArray) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = DumpFilePath(dir);
+
+  const dump::MappedArray<std::uint64_t> original{
+      std::vector<std::uint64_t>{1, 2, 3, 0xdeadbeef}};
+
+  auto scope_time = tracing::Span::CurrentSpan().CreateScopeTime("dump");
+  dump::FileWriter writer(path, boost::filesystem::perms::owner_read,
+                          scope_time);
+  // Misalign the array on purpose
+  writer.Write(std::string{"a"});
+  writer.Write(original);
+  writer.Finish();
+
+  dump::MappedArray<std::uint64_t> mapped;
+  {
+    dump::MmapFileReader reader(path);
+    EXPECT_EQ(reader.Read<std::string>(), "a");
+    mapped = reader.Read<dump::MappedArray<std::uint64_t>>();
+    reader.Finish();
+  }
+  // The mapping outlives the reader
+  EXPECT_TRUE(mapped.IsMapped());
+  EXPECT_EQ(mapped, original);
+
+  dump::FileReader reader(path);
+  EXPECT_EQ(reader.Read<std::string>(), "a");
+  const auto copied = reader.Read<dump::MappedArray<std::uint64_t>>();
+  reader.Finish();
+  EXPECT_FALSE(copied.IsMapped());
+  EXPECT_EQ(copied, original);
+}
+
 USERVER_NAMESPACE_END
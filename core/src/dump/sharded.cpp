@@ -0,0 +1,70 @@
+#include <userver/dump/sharded.hpp>
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace dump::impl {
+
+namespace {
+
+// Distinguishes sharded dumps from plain ones, which start with a (small)
+// container size
+constexpr std::uint64_t kShardedDumpMarker = 0x5348'4152'4444'554d;
+
+}  // namespace
+
+BufferWriter::BufferWriter() = default;
+
+void BufferWriter::WriteRaw(std::string_view data) { data_.append(data); }
+
+void BufferWriter::Finish() {
+  // nothing to do
+}
+
+std::string BufferWriter::Extract() && { return std::move(data_); }
+
+BufferReader::BufferReader(std::string data)
+    : data_(std::move(data)), unread_data_(data_) {}
+
+std::string_view BufferReader::ReadRaw(std::size_t max_size) {
+  const auto result_size = std::min(max_size, unread_data_.size());
+  const auto result = unread_data_.substr(0, result_size);
+  unread_data_ = unread_data_.substr(result_size);
+  return result;
+}
+
+void BufferReader::Finish() {
+  if (!unread_data_.empty()) {
+    throw Error(fmt::format(
+        "Unexpected extra data at the end of a dump shard: shard-size={}, "
+        "position={}, unread-size={}",
+        data_.size(), data_.size() - unread_data_.size(), unread_data_.size()));
+  }
+}
+
+void WriteShardedHeader(Writer& writer, std::size_t shard_count) {
+  writer.Write(kShardedDumpMarker);
+  writer.Write(shard_count);
+}
+
+std::size_t ReadShardedHeader(Reader& reader) {
+  const auto marker = reader.Read<std::uint64_t>();
+  if (marker != kShardedDumpMarker) {
+    throw Error(
+        "The dump was not written in the sharded format. Make sure that "
+        "'format-version' was bumped when switching to sharded dumps");
+  }
+
+  const auto shard_count = reader.Read<std::size_t>();
+  if (shard_count == 0 || shard_count > kMaxShardCount) {
+    throw Error(fmt::format("Invalid dump shard count: {}", shard_count));
+  }
+  return shard_count;
+}
+
+}  // namespace dump::impl
+
+USERVER_NAMESPACE_END
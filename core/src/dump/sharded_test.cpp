@@ -0,0 +1,82 @@
+#include <userver/dump/sharded.hpp>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <userver/dump/operations_mock.hpp>
+#include <userver/dump/test_helpers.hpp>
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+template <typename T>
+std::string ToShardedBinary(const T& value, std::size_t shard_count) {
+  dump::MockWriter writer;
+  dump::WriteSharded(writer, value, shard_count);
+  writer.Finish();
+  return std::move(writer).Extract();
+}
+
+template <typename T>
+T FromShardedBinary(std::string data) {
+  dump::MockReader reader(std::move(data));
+  auto result = dump::ReadSharded<T>(reader);
+  reader.Finish();
+  return result;
+}
+
+template <typename T>
+void TestShardedWriteReadCycle(const T& original) {
+  for (const std::size_t shard_count : {0u, 1u, 2u, 3u, 7u, 100u}) {
+    EXPECT_EQ(FromShardedBinary<T>(ToShardedBinary(original, shard_count)),
+              original)
+        << "shard_count=" << shard_count;
+  }
+}
+
+}  // namespace
+
+UTEST_MT(DumpSharded, Vector, 4) {
+  std::vector<int> data;
+  for (int i = 0; i < 1000; ++i) data.push_back(i);
+  TestShardedWriteReadCycle(data);
+  TestShardedWriteReadCycle(std::vector<bool>{true, false, true});
+  TestShardedWriteReadCycle(std::vector<std::string>{});
+}
+
+UTEST_MT(DumpSharded, UnorderedMap, 4) {
+  std::unordered_map<int, std::string> data;
+  for (int i = 0; i < 1000; ++i) data.emplace(i, std::to_string(i));
+  TestShardedWriteReadCycle(data);
+  TestShardedWriteReadCycle(std::unordered_map<std::string, int>{});
+}
+
+UTEST_MT(DumpSharded, MapAndSet, 4) {
+  TestShardedWriteReadCycle(
+      std::map<std::string, int>{{"a", 1}, {"b", 2}, {"c", 3}});
+  TestShardedWriteReadCycle(std::unordered_set<int>{1, 2, 5, 8, 13});
+}
+
+UTEST_MT(DumpSharded, ShardCountIsClamped, 4) {
+  std::vector<int> data;
+  for (int i = 0; i < 5000; ++i) data.push_back(i);
+
+  const auto binary = ToShardedBinary(data, dump::kMaxShardCount + 1000);
+  dump::MockReader reader(binary);
+  EXPECT_EQ(dump::impl::ReadShardedHeader(reader), dump::kMaxShardCount);
+
+  EXPECT_EQ(FromShardedBinary<std::vector<int>>(binary), data);
+}
+
+UTEST(DumpSharded, RejectsPlainDump) {
+  const std::vector<int> data{1, 2, 3};
+  UEXPECT_THROW_MSG(FromShardedBinary<std::vector<int>>(dump::ToBinary(data)),
+                    dump::Error, "not written in the sharded format");
+}
+
+USERVER_NAMESPACE_END
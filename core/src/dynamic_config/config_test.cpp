@@ -118,6 +118,21 @@ UTEST_F(DynamicConfigTest, VariableSnapshotPtr) {
 
 UTEST_F(DynamicConfigTest, Copy) { EXPECT_EQ(source_.GetCopy(kIntConfig), 5); }
 
+UTEST(DynamicConfig, CopySeesUpdates) {
+  dynamic_config::StorageMock storage{{kIntConfig, 5}};
+  const auto source = storage.GetSource();
+  EXPECT_EQ(source.GetCopy(kIntConfig), 5);
+  EXPECT_EQ(source.GetCopy(kIntConfig), 5);
+
+  storage.Extend({{kIntConfig, 10}});
+  EXPECT_EQ(source.GetCopy(kIntConfig), 10);
+
+  // Caches of different storages do not interfere
+  const dynamic_config::StorageMock other_storage{{kIntConfig, 20}};
+  EXPECT_EQ(other_storage.GetSource().GetCopy(kIntConfig), 20);
+  EXPECT_EQ(source.GetCopy(kIntConfig), 10);
+}
+
 struct OldConfig final {
   static const dynamic_config::Key<OldConfig> kDeprecatedKey;
 
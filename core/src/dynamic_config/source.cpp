@@ -12,6 +12,10 @@ Source::Source(impl::StorageData& storage) : storage_(&storage) {}
 
 Snapshot Source::GetSnapshot() const { return Snapshot{*storage_}; }
 
+const Snapshot* Source::GetThreadCachedSnapshot() const {
+  return storage_->GetThreadCachedSnapshot();
+}
+
 Source::SnapshotEventSource& Source::GetEventChannel() {
   return storage_->GetChannel();
 }
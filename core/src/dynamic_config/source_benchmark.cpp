@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <userver/dynamic_config/source.hpp>
+#include <userver/dynamic_config/storage_mock.hpp>
+#include <userver/engine/run_standalone.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+const dynamic_config::Key kIntConfig{dynamic_config::ConstantConfig{}, 0};
+
+const dynamic_config::Key kBoolConfig{dynamic_config::ConstantConfig{}, false};
+
+}  // namespace
+
+void dynamic_config_get_snapshot(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const dynamic_config::StorageMock storage{{kIntConfig, 42},
+                                              {kBoolConfig, true}};
+    const auto source = storage.GetSource();
+
+    for ([[maybe_unused]] auto _ : state) {
+      const auto snapshot = source.GetSnapshot();
+      benchmark::DoNotOptimize(snapshot[kIntConfig]);
+      benchmark::DoNotOptimize(snapshot[kBoolConfig]);
+    }
+  });
+}
+BENCHMARK(dynamic_config_get_snapshot);
+
+void dynamic_config_get_copy(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const dynamic_config::StorageMock storage{{kIntConfig, 42},
+                                              {kBoolConfig, true}};
+    const auto source = storage.GetSource();
+
+    for ([[maybe_unused]] auto _ : state) {
+      benchmark::DoNotOptimize(source.GetCopy(kIntConfig));
+      benchmark::DoNotOptimize(source.GetCopy(kBoolConfig));
+    }
+  });
+}
+BENCHMARK(dynamic_config_get_copy);
+
+// Every read after an update has to acquire a new snapshot
+void dynamic_config_get_copy_updated(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    dynamic_config::StorageMock storage{{kIntConfig, 42}, {kBoolConfig, true}};
+    const auto source = storage.GetSource();
+    const auto reads_per_update = state.range(0);
+
+    std::int64_t i = 0;
+    for ([[maybe_unused]] auto _ : state) {
+      if (++i % reads_per_update == 0) {
+        state.PauseTiming();
+        storage.Extend({{kIntConfig, static_cast<int>(i)}});
+        state.ResumeTiming();
+      }
+      benchmark::DoNotOptimize(source.GetCopy(kIntConfig));
+    }
+  });
+}
+BENCHMARK(dynamic_config_get_copy_updated)->Arg(1)->Arg(16)->Arg(256);
+
+USERVER_NAMESPACE_END
@@ -3,6 +3,7 @@
 #include <mutex>
 #include <optional>
 
+#include <userver/compiler/thread_local.hpp>
 #include <userver/dynamic_config/impl/snapshot.hpp>
 #include <userver/dynamic_config/snapshot.hpp>
 #include <userver/dynamic_config/source.hpp>
@@ -11,8 +12,22 @@ USERVER_NAMESPACE_BEGIN
 
 namespace dynamic_config::impl {
 
+namespace {
+
+// Threads beyond this number read the config without caching
+constexpr std::size_t kMaxCachedThreads = 256;
+
+std::atomic<std::size_t> next_thread_index{0};
+
+compiler::ThreadLocal thread_index = [] {
+  return next_thread_index.fetch_add(1, std::memory_order_relaxed);
+};
+
+}  // namespace
+
 StorageData::StorageData(SnapshotData config)
     : config_(std::move(config)),
+      thread_caches_(std::make_unique<ThreadCache[]>(kMaxCachedThreads)),
       snapshot_channel_("dynamic-config-snapshot",
                         [&](auto& func) {
                           const auto snapshot = GetSnapshot();
@@ -31,6 +46,22 @@ rcu::ReadablePtr<SnapshotData> StorageData::Read() const {
   return config_.Read();
 }
 
+const Snapshot* StorageData::GetThreadCachedSnapshot() {
+  const auto index = *thread_index.Use();
+  if (index >= kMaxCachedThreads) return nullptr;
+
+  auto& cache = thread_caches_[index];
+  const auto version = version_.load(std::memory_order_acquire);
+  if (cache.version != version) {
+    // The version is loaded before the config, so the cached config is never
+    // older than the version says
+    cache.snapshot.reset();
+    cache.snapshot.emplace(GetSnapshot());
+    cache.version = version;
+  }
+  return &*cache.snapshot;
+}
+
 void StorageData::Update(SnapshotData config,
                          AfterAssignHook after_assign_hook) {
   std::lock_guard lock(update_mutex_);
@@ -43,6 +74,7 @@ void StorageData::Update(SnapshotData config,
   }
 
   config_.Assign(std::move(config));
+  version_.fetch_add(1, std::memory_order_release);
   after_assign_hook();
 
   const Diff diff{std::move(previous_config), GetSnapshot()};
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
 #include <userver/concurrent/async_event_channel.hpp>
 #include <userver/dynamic_config/impl/snapshot.hpp>
 #include <userver/dynamic_config/snapshot.hpp>
@@ -22,6 +27,11 @@ class StorageData final {
 
   rcu::ReadablePtr<SnapshotData> Read() const;
 
+  /// Returns the snapshot of the current config kept for the calling thread,
+  /// or nullptr if the thread has no cache slot. The result must not be used
+  /// after a context switch, as the coroutine may migrate to another thread.
+  const Snapshot* GetThreadCachedSnapshot();
+
   void Update(SnapshotData config, AfterAssignHook after_assign_hook);
 
   SnapshotChannel& GetChannel();
@@ -37,7 +47,19 @@ class StorageData final {
  private:
   Snapshot GetSnapshot() { return Snapshot{*this}; }
 
+  // Only accessed by the thread with the corresponding index. Idle threads
+  // keep the old configs alive until they read the config again.
+  struct alignas(64) ThreadCache final {
+    std::uint64_t version{0};
+    std::optional<Snapshot> snapshot;
+  };
+
   rcu::Variable<SnapshotData> config_;
+  // Incremented after each update of config_, starts from 1 so that empty
+  // thread caches are never up to date
+  std::atomic<std::uint64_t> version_{1};
+  // Must be destroyed before config_
+  std::unique_ptr<ThreadCache[]> thread_caches_;
   SnapshotChannel snapshot_channel_;
   DiffChannel diff_channel_;
 
@@ -1,9 +1,15 @@
 #pragma once
 
-#include <algorithm>  // for std::max
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <moodycamel/concurrentqueue.h>
 
@@ -11,9 +17,11 @@
 
 #include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/datetime.hpp>
 
 #include "pool_config.hpp"
 #include "pool_stats.hpp"
+#include "stack.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -34,18 +42,73 @@ class Pool final {
   void PutCoroutine(CoroutinePtr&& coroutine_ptr);
   PoolStats GetStats() const;
   std::size_t GetStackSize() const;
+  bool IsStackUsageProfilingEnabled() const noexcept;
 
  private:
-  Coroutine CreateCoroutine(bool quiet = false);
+  using Clock = utils::datetime::SteadyClock;
+
+  struct IdleCoroutine final {
+    Coroutine coroutine;
+    StackInfo stack;
+    Clock::time_point idle_since;
+  };
+
+  // Idle coroutines that were recently used by a thread, the most recently
+  // used one is at the back, and the tokens of the thread for the shared
+  // queue. The cache is bound to a single pool at a time and is returned to
+  // it when the thread starts using another pool.
+  //
+  // The owning thread locks the cache in GetCoroutine and PutCoroutine.
+  // Other threads only try to lock it: the pool destructor to detach it and
+  // the stack reclamation to take the coroutines that were idle for too long,
+  // so that idle threads do not keep the stacks resident.
+  class LocalCache final {
+   public:
+    LocalCache() = default;
+    LocalCache(const LocalCache&) = delete;
+    LocalCache& operator=(const LocalCache&) = delete;
+    ~LocalCache();
+
+    void lock() noexcept;
+    bool try_lock() noexcept;
+    void unlock() noexcept;
+
+    Pool* pool{nullptr};
+    // Pools may be allocated at the address of a destroyed one
+    std::uint64_t pool_id{0};
+    std::vector<IdleCoroutine> coroutines;
+    std::optional<moodycamel::ProducerToken> producer_token;
+    std::optional<moodycamel::ConsumerToken> consumer_token;
+
+   private:
+    std::atomic<bool> is_locked_{false};
+  };
+
+  using LocalCacheLock = std::unique_lock<LocalCache>;
+
+  static std::uint64_t GenerateId() noexcept;
+
+  IdleCoroutine CreateCoroutine(bool quiet = false);
   void OnCoroutineDestruction() noexcept;
 
-  template <typename Token>
-  Token& GetUsedPoolToken();
+  bool IsStackReclaimEnabled() const noexcept;
+  bool EnqueueUsed(LocalCache& cache, IdleCoroutine&& coroutine);
+  void MaybeReclaimIdleStacks(LocalCache& cache, Clock::time_point now);
+  void ReclaimIdleStacks(LocalCache& cache, Clock::time_point now);
+  void ReclaimIdleStack(IdleCoroutine&& coroutine, std::size_t& reclaimed);
+  std::vector<IdleCoroutine> ExtractIdleFromLocalCaches(
+      Clock::time_point idle_deadline);
+
+  LocalCacheLock LockLocalCache();
+  void AttachLocalCache(LocalCache& cache);
+  // Must be called with the cache locked
+  void RemoveLocalCache(LocalCache& cache) noexcept;
+  // Must be called with caches_mutex_ held and the cache locked
+  void DetachLocalCache(LocalCache& cache) noexcept;
 
   const PoolConfig config_;
   const Executor executor_;
-
-  boost::coroutines2::protected_fixedsize_stack stack_allocator_;
+  const std::uint64_t id_;
 
   // We aim to reuse coroutines as much as possible,
   // because since coroutine stack is a mmap-ed chunk of memory and not actually
@@ -53,18 +116,29 @@ class Pool final {
   //
   // The same could've been achieved with some LIFO container, but apparently
   // we don't have a container handy enough to not just use 2 queues.
-  moodycamel::ConcurrentQueue<Coroutine> initial_coroutines_;
-  moodycamel::ConcurrentQueue<Coroutine> used_coroutines_;
+  //
+  // Coroutines with reclaimed stacks are returned into `initial_coroutines_`,
+  // as they are as cheap to keep as the never used ones.
+  moodycamel::ConcurrentQueue<IdleCoroutine> initial_coroutines_;
+  moodycamel::ConcurrentQueue<IdleCoroutine> used_coroutines_;
 
+  // Includes the coroutines in local caches
   std::atomic<std::size_t> idle_coroutines_num_;
   std::atomic<std::size_t> total_coroutines_num_;
+  std::atomic<std::size_t> locally_cached_coroutines_num_{0};
+  std::atomic<std::size_t> reclaimed_stacks_num_{0};
+  std::atomic<Clock::time_point> next_stack_reclaim_{Clock::time_point{}};
+
+  // Local caches of the threads that use the pool
+  std::mutex caches_mutex_;
+  std::vector<LocalCache*> caches_;
 };
 
 template <typename Task>
 class Pool<Task>::CoroutinePtr final {
  public:
-  CoroutinePtr(Coroutine&& coro, Pool<Task>& pool) noexcept
-      : coro_(std::move(coro)), pool_(&pool) {}
+  CoroutinePtr(IdleCoroutine&& coro, Pool<Task>& pool) noexcept
+      : coro_(std::move(coro.coroutine)), stack_(coro.stack), pool_(&pool) {}
 
   CoroutinePtr(CoroutinePtr&&) noexcept = default;
   CoroutinePtr& operator=(CoroutinePtr&&) noexcept = default;
@@ -79,6 +153,8 @@ class Pool<Task>::CoroutinePtr final {
     return coro_;
   }
 
+  const StackInfo& GetStack() const noexcept { return stack_; }
+
   void ReturnToPool() && {
     UASSERT(coro_);
     pool_->PutCoroutine(std::move(*this));
@@ -86,14 +162,46 @@ class Pool<Task>::CoroutinePtr final {
 
  private:
   Coroutine coro_;
+  StackInfo stack_;
   Pool<Task>* pool_;
 };
 
+template <typename Task>
+Pool<Task>::LocalCache::~LocalCache() {
+  const std::lock_guard lock(*this);
+  // The pool is not destroyed until the cache is detached from it
+  if (pool) pool->RemoveLocalCache(*this);
+}
+
+template <typename Task>
+void Pool<Task>::LocalCache::lock() noexcept {
+  // Other threads hold the lock only for a short time and only if the owner
+  // does not use the cache
+  while (!try_lock()) std::this_thread::yield();
+}
+
+template <typename Task>
+bool Pool<Task>::LocalCache::try_lock() noexcept {
+  return !is_locked_.exchange(true, std::memory_order_acquire);
+}
+
+template <typename Task>
+void Pool<Task>::LocalCache::unlock() noexcept {
+  is_locked_.store(false, std::memory_order_release);
+}
+
+template <typename Task>
+std::uint64_t Pool<Task>::GenerateId() noexcept {
+  // Zero is the id of a detached cache
+  static std::atomic<std::uint64_t> last_id{0};
+  return ++last_id;
+}
+
 template <typename Task>
 Pool<Task>::Pool(PoolConfig config, Executor executor)
     : config_(std::move(config)),
       executor_(executor),
-      stack_allocator_(config_.stack_size),
+      id_(GenerateId()),
       initial_coroutines_(config_.initial_size),
       used_coroutines_(config_.max_size),
       idle_coroutines_num_(config_.initial_size),
@@ -107,27 +215,58 @@ Pool<Task>::Pool(PoolConfig config, Executor executor)
 }
 
 template <typename Task>
-Pool<Task>::~Pool() = default;
+Pool<Task>::~Pool() {
+  // The threads that used the pool may be alive and may be switching to
+  // another pool right now. Such a thread holds the lock of its cache while
+  // waiting for caches_mutex_ to detach it.
+  while (true) {
+    {
+      const std::lock_guard lock(caches_mutex_);
+      caches_.erase(std::remove_if(caches_.begin(), caches_.end(),
+                                   [this](LocalCache* cache) {
+                                     if (!cache->try_lock()) return false;
+                                     DetachLocalCache(*cache);
+                                     cache->unlock();
+                                     return true;
+                                   }),
+                    caches_.end());
+      if (caches_.empty()) break;
+    }
+    std::this_thread::yield();
+  }
+}
 
 template <typename Task>
 typename Pool<Task>::CoroutinePtr Pool<Task>::GetCoroutine() {
   struct CoroutineMover {
-    std::optional<Coroutine>& result;
+    std::optional<IdleCoroutine>& result;
 
-    CoroutineMover& operator=(Coroutine&& coro) {
+    CoroutineMover& operator=(IdleCoroutine&& coro) {
       result.emplace(std::move(coro));
       return *this;
     }
   };
 
-  std::optional<Coroutine> coroutine;
+  // The most recently used coroutine of this thread is the most likely one
+  // to have its stack both resident and in CPU caches.
+  const auto cache_lock = LockLocalCache();
+  auto& cache = *cache_lock.mutex();
+  auto& local_cache = cache.coroutines;
+  if (!local_cache.empty()) {
+    CoroutinePtr result(std::move(local_cache.back()), *this);
+    local_cache.pop_back();
+    --locally_cached_coroutines_num_;
+    --idle_coroutines_num_;
+    return result;
+  }
+
+  std::optional<IdleCoroutine> coroutine;
   CoroutineMover mover{coroutine};
 
   // First try to dequeue from 'working set': if we can get a coroutine
   // from there we are happy, because we saved on minor-page-faulting (thus
   // increasing resident memory usage) a not-yet-de-virtualized coroutine stack.
-  if (used_coroutines_.try_dequeue(
-          GetUsedPoolToken<moodycamel::ConsumerToken>(), mover) ||
+  if (used_coroutines_.try_dequeue(*cache.consumer_token, mover) ||
       initial_coroutines_.try_dequeue(mover)) {
     --idle_coroutines_num_;
   } else {
@@ -139,34 +278,64 @@ typename Pool<Task>::CoroutinePtr Pool<Task>::GetCoroutine() {
 template <typename Task>
 void Pool<Task>::PutCoroutine(CoroutinePtr&& coroutine_ptr) {
   if (idle_coroutines_num_.load() >= config_.max_size) return;
-  auto& token = GetUsedPoolToken<moodycamel::ProducerToken>();
-  const bool ok =
-      // We only ever return coroutines into our 'working set'.
-      used_coroutines_.enqueue(token, std::move(coroutine_ptr.Get()));
-  if (ok) ++idle_coroutines_num_;
+
+  const bool reclaim_enabled = IsStackReclaimEnabled();
+  const auto now = reclaim_enabled ? Clock::now() : Clock::time_point{};
+
+  const auto cache_lock = LockLocalCache();
+  auto& cache = *cache_lock.mutex();
+  auto& local_cache = cache.coroutines;
+  if (reclaim_enabled && !local_cache.empty() &&
+      now - local_cache.front().idle_since >
+          config_.idle_stack_reclaim_timeout) {
+    // The least recently used coroutine of this thread is not hot anymore,
+    // let it be reclaimed with the others.
+    auto oldest = std::move(local_cache.front());
+    local_cache.erase(local_cache.begin());
+    --locally_cached_coroutines_num_;
+    --idle_coroutines_num_;
+    EnqueueUsed(cache, std::move(oldest));
+  }
+
+  IdleCoroutine idle{std::move(coroutine_ptr.Get()), coroutine_ptr.GetStack(),
+                     now};
+  if (local_cache.size() < config_.local_cache_size) {
+    local_cache.push_back(std::move(idle));
+    ++locally_cached_coroutines_num_;
+    ++idle_coroutines_num_;
+  } else {
+    // We only ever return coroutines into our 'working set'.
+    EnqueueUsed(cache, std::move(idle));
+  }
+
+  if (reclaim_enabled) MaybeReclaimIdleStacks(cache, now);
 }
 
 template <typename Task>
 PoolStats Pool<Task>::GetStats() const {
   PoolStats stats;
+  const auto total = total_coroutines_num_.load();
+  const auto cold = initial_coroutines_.size_approx();
   stats.active_coroutines =
-      total_coroutines_num_.load() -
-      (used_coroutines_.size_approx() + initial_coroutines_.size_approx());
-  stats.total_coroutines =
-      std::max(total_coroutines_num_.load(), stats.active_coroutines);
+      total - (used_coroutines_.size_approx() + cold +
+               locally_cached_coroutines_num_.load());
+  stats.total_coroutines = std::max(total, stats.active_coroutines);
+  stats.resident_stacks = stats.total_coroutines - std::min(total, cold);
+  stats.reclaimed_stacks = reclaimed_stacks_num_.load();
   return stats;
 }
 
 template <typename Task>
-typename Pool<Task>::Coroutine Pool<Task>::CreateCoroutine(bool quiet) {
+typename Pool<Task>::IdleCoroutine Pool<Task>::CreateCoroutine(bool quiet) {
   try {
-    Coroutine coroutine(stack_allocator_, executor_);
+    StackInfo stack;
+    Coroutine coroutine(StackAllocator{config_.stack_size, &stack}, executor_);
     const auto new_total = ++total_coroutines_num_;
     if (!quiet) {
       LOG_DEBUG() << "Created a coroutine #" << new_total << '/'
                   << config_.max_size;
     }
-    return coroutine;
+    return {std::move(coroutine), stack, {}};
   } catch (const std::bad_alloc&) {
     if (errno == ENOMEM) {
       // It should be ok to allocate here (which LOG_ERROR might do),
@@ -189,16 +358,194 @@ void Pool<Task>::OnCoroutineDestruction() noexcept {
   --total_coroutines_num_;
 }
 
+template <typename Task>
+bool Pool<Task>::IsStackReclaimEnabled() const noexcept {
+  return config_.idle_stack_reclaim_timeout.count() > 0;
+}
+
+template <typename Task>
+bool Pool<Task>::EnqueueUsed(LocalCache& cache, IdleCoroutine&& coroutine) {
+  const bool ok =
+      used_coroutines_.enqueue(*cache.producer_token, std::move(coroutine));
+  if (ok) {
+    ++idle_coroutines_num_;
+  } else {
+    // The coroutine is destroyed by the caller
+    OnCoroutineDestruction();
+  }
+  return ok;
+}
+
+template <typename Task>
+void Pool<Task>::MaybeReclaimIdleStacks(LocalCache& cache,
+                                        Clock::time_point now) {
+  auto next_reclaim = next_stack_reclaim_.load(std::memory_order_relaxed);
+  if (now < next_reclaim) return;
+
+  const auto reclaim_period = std::chrono::duration_cast<Clock::duration>(
+                                  config_.idle_stack_reclaim_timeout) /
+                              2;
+
+  // Only a single thread at a time does the reclamation
+  if (!next_stack_reclaim_.compare_exchange_strong(
+          next_reclaim, now + reclaim_period, std::memory_order_relaxed)) {
+    return;
+  }
+  ReclaimIdleStacks(cache, now);
+}
+
+template <typename Task>
+void Pool<Task>::ReclaimIdleStacks(LocalCache& cache, Clock::time_point now) {
+  // madvise on a large stack may take tens of microseconds, the rest of
+  // the stacks are reclaimed on the following runs
+  constexpr std::size_t kMaxReclaimedStacksPerRun = 256;
+
+  struct CoroutineMover {
+    std::optional<IdleCoroutine>& result;
+
+    CoroutineMover& operator=(IdleCoroutine&& coro) {
+      result.emplace(std::move(coro));
+      return *this;
+    }
+  };
+
+  const auto idle_deadline = now - config_.idle_stack_reclaim_timeout;
+  std::size_t reclaimed = 0;
+
+  // Each idle coroutine is checked at most once, the recently used ones are
+  // put back to the end of the queue
+  for (auto to_check = used_coroutines_.size_approx(); to_check > 0;
+       --to_check) {
+    std::optional<IdleCoroutine> coroutine;
+    CoroutineMover mover{coroutine};
+    if (!used_coroutines_.try_dequeue(*cache.consumer_token, mover)) {
+      break;
+    }
+    --idle_coroutines_num_;
+
+    if (coroutine->idle_since > idle_deadline) {
+      EnqueueUsed(cache, std::move(*coroutine));
+      continue;
+    }
+
+    ReclaimIdleStack(std::move(*coroutine), reclaimed);
+    if (reclaimed >= kMaxReclaimedStacksPerRun) break;
+  }
+
+  // Caches of the threads that do not run tasks anymore
+  if (reclaimed < kMaxReclaimedStacksPerRun) {
+    for (auto& coroutine : ExtractIdleFromLocalCaches(idle_deadline)) {
+      ReclaimIdleStack(std::move(coroutine), reclaimed);
+    }
+  }
+
+  if (reclaimed != 0) {
+    reclaimed_stacks_num_ += reclaimed;
+    LOG_DEBUG() << "Returned the stacks of " << reclaimed
+                << " idle coroutines to the OS";
+  }
+}
+
+// Returns the stack pages to the OS and puts the coroutine to the cold queue,
+// the coroutine must not be accounted in idle_coroutines_num_
+template <typename Task>
+void Pool<Task>::ReclaimIdleStack(IdleCoroutine&& coroutine,
+                                  std::size_t& reclaimed) {
+  if (ReclaimStackPages(coroutine.stack)) ++reclaimed;
+  if (initial_coroutines_.enqueue(std::move(coroutine))) {
+    ++idle_coroutines_num_;
+  } else {
+    OnCoroutineDestruction();
+  }
+}
+
+template <typename Task>
+std::vector<typename Pool<Task>::IdleCoroutine>
+Pool<Task>::ExtractIdleFromLocalCaches(Clock::time_point idle_deadline) {
+  std::vector<IdleCoroutine> result;
+  const std::lock_guard lock(caches_mutex_);
+  for (auto* cache : caches_) {
+    // The cache of the current thread is locked by it, the busy caches are
+    // not idle
+    if (!cache->try_lock()) continue;
+    const std::lock_guard cache_lock(*cache, std::adopt_lock);
+
+    auto& coroutines = cache->coroutines;
+    const auto idle_end =
+        std::find_if(coroutines.begin(), coroutines.end(),
+                     [idle_deadline](const IdleCoroutine& coroutine) {
+                       return coroutine.idle_since > idle_deadline;
+                     });
+    const auto count = static_cast<std::size_t>(idle_end - coroutines.begin());
+    if (count == 0) continue;
+
+    result.insert(result.end(), std::make_move_iterator(coroutines.begin()),
+                  std::make_move_iterator(idle_end));
+    coroutines.erase(coroutines.begin(), idle_end);
+    locally_cached_coroutines_num_ -= count;
+    idle_coroutines_num_ -= count;
+  }
+  return result;
+}
+
 template <typename Task>
 std::size_t Pool<Task>::GetStackSize() const {
   return config_.stack_size;
 }
 
 template <typename Task>
-template <typename Token>
-Token& Pool<Task>::GetUsedPoolToken() {
-  thread_local Token token(used_coroutines_);
-  return token;
+bool Pool<Task>::IsStackUsageProfilingEnabled() const noexcept {
+  return config_.profile_stack_usage;
+}
+
+template <typename Task>
+typename Pool<Task>::LocalCacheLock Pool<Task>::LockLocalCache() {
+  thread_local LocalCache cache;
+  LocalCacheLock lock(cache);
+  if (cache.pool_id != id_) {
+    // This thread used another pool, that pool is not destroyed until
+    // the cache is detached from it
+    if (cache.pool) cache.pool->RemoveLocalCache(cache);
+    AttachLocalCache(cache);
+  }
+  return lock;
+}
+
+template <typename Task>
+void Pool<Task>::AttachLocalCache(LocalCache& cache) {
+  UASSERT(!cache.pool);
+  cache.coroutines.reserve(config_.local_cache_size);
+  cache.producer_token.emplace(used_coroutines_);
+  cache.consumer_token.emplace(used_coroutines_);
+
+  const std::lock_guard lock(caches_mutex_);
+  caches_.push_back(&cache);
+  cache.pool = this;
+  cache.pool_id = id_;
+}
+
+template <typename Task>
+void Pool<Task>::RemoveLocalCache(LocalCache& cache) noexcept {
+  const std::lock_guard lock(caches_mutex_);
+  DetachLocalCache(cache);
+  caches_.erase(std::find(caches_.begin(), caches_.end(), &cache));
+}
+
+template <typename Task>
+void Pool<Task>::DetachLocalCache(LocalCache& cache) noexcept {
+  UASSERT(cache.pool == this);
+  for (auto& coroutine : cache.coroutines) {
+    if (!used_coroutines_.enqueue(std::move(coroutine))) {
+      --idle_coroutines_num_;
+      OnCoroutineDestruction();
+    }
+  }
+  locally_cached_coroutines_num_ -= cache.coroutines.size();
+  cache.coroutines.clear();
+  cache.producer_token.reset();
+  cache.consumer_token.reset();
+  cache.pool = nullptr;
+  cache.pool_id = 0;
 }
 
 }  // namespace engine::coro
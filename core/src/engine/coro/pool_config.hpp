@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 
 #include <userver/formats/yaml.hpp>
@@ -13,6 +14,11 @@ struct PoolConfig {
   std::size_t initial_size = 1000;
   std::size_t max_size = 4000;
   std::size_t stack_size = 256 * 1024ULL;
+  /// Zero disables the per-thread caches of idle coroutines
+  std::size_t local_cache_size = 0;
+  /// Zero disables the reclamation of idle coroutine stacks
+  std::chrono::milliseconds idle_stack_reclaim_timeout{0};
+  bool profile_stack_usage = false;
 };
 
 PoolConfig Parse(const yaml_config::YamlConfig& value,
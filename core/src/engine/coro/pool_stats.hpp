@@ -10,11 +10,18 @@ namespace engine::coro {
 struct PoolStats {
   size_t active_coroutines = 0;
   size_t total_coroutines = 0;
+  // Coroutines that were used or are in use, and have not had their stacks
+  // returned to the OS since then
+  size_t resident_stacks = 0;
+  // Total amount of idle stacks returned to the OS
+  size_t reclaimed_stacks = 0;
 };
 
 inline PoolStats& operator+=(PoolStats& lhs, const PoolStats& rhs) {
   lhs.active_coroutines += rhs.active_coroutines;
   lhs.total_coroutines += rhs.total_coroutines;
+  lhs.resident_stacks += rhs.resident_stacks;
+  lhs.reclaimed_stacks += rhs.reclaimed_stacks;
   return lhs;
 }
 
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <engine/coro/pool.hpp>
+#include <engine/coro/stack.hpp>
+#include <userver/utils/datetime.hpp>
+#include <userver/utils/mock_now.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+struct DummyTask {};
+
+using Pool = engine::coro::Pool<DummyTask>;
+
+void DummyExecutor(Pool::TaskPipe& task_pipe) {
+  for ([[maybe_unused]] DummyTask* task : task_pipe) {
+  }
+}
+
+engine::coro::PoolConfig MakeConfig() {
+  engine::coro::PoolConfig config;
+  config.initial_size = 0;
+  config.max_size = 10;
+  config.stack_size = 128 * 1024;
+  return config;
+}
+
+// Freezes the pool clock, so that the idle timeouts expire only on MockSleep
+class MockNowGuard final {
+ public:
+  MockNowGuard() { utils::datetime::MockNowSet(utils::datetime::Now()); }
+  ~MockNowGuard() { utils::datetime::MockNowUnset(); }
+
+  MockNowGuard(const MockNowGuard&) = delete;
+  MockNowGuard& operator=(const MockNowGuard&) = delete;
+};
+
+// Runs the function in a thread with empty per-thread caches
+template <typename Func>
+void RunInThread(Func func) {
+  std::thread(func).join();
+}
+
+}  // namespace
+
+TEST(CoroPool, LocalCacheReusesLastCoroutine) {
+  auto config = MakeConfig();
+  config.local_cache_size = 2;
+  Pool pool{config, &DummyExecutor};
+
+  RunInThread([&pool] {
+    auto first = pool.GetCoroutine();
+    auto second = pool.GetCoroutine();
+    auto* const first_stack = first.GetStack().top;
+    auto* const second_stack = second.GetStack().top;
+    EXPECT_NE(first_stack, second_stack);
+    EXPECT_EQ(pool.GetStats().active_coroutines, 2);
+
+    std::move(first).ReturnToPool();
+    std::move(second).ReturnToPool();
+    EXPECT_EQ(pool.GetStats().active_coroutines, 0);
+    EXPECT_EQ(pool.GetStats().total_coroutines, 2);
+
+    auto last_used = pool.GetCoroutine();
+    EXPECT_EQ(last_used.GetStack().top, second_stack);
+    auto previous = pool.GetCoroutine();
+    EXPECT_EQ(previous.GetStack().top, first_stack);
+    EXPECT_EQ(pool.GetStats().total_coroutines, 2);
+  });
+}
+
+TEST(CoroPool, LocalCachePerPool) {
+  auto config = MakeConfig();
+  config.local_cache_size = 2;
+  Pool first_pool{config, &DummyExecutor};
+  Pool second_pool{config, &DummyExecutor};
+
+  RunInThread([&] {
+    auto first = first_pool.GetCoroutine();
+    auto* const first_stack = first.GetStack().top;
+    std::move(first).ReturnToPool();
+
+    // The coroutine cached for the first pool is not given by the second one
+    auto second = second_pool.GetCoroutine();
+    EXPECT_NE(second.GetStack().top, first_stack);
+    EXPECT_EQ(second_pool.GetStats().total_coroutines, 1);
+    EXPECT_EQ(second_pool.GetStats().active_coroutines, 1);
+    std::move(second).ReturnToPool();
+
+    // Switching the pools returns the cached coroutines to their pool
+    auto again = first_pool.GetCoroutine();
+    EXPECT_EQ(again.GetStack().top, first_stack);
+    EXPECT_EQ(first_pool.GetStats().total_coroutines, 1);
+    EXPECT_EQ(first_pool.GetStats().active_coroutines, 1);
+    EXPECT_EQ(second_pool.GetStats().total_coroutines, 1);
+    EXPECT_EQ(second_pool.GetStats().active_coroutines, 0);
+    std::move(again).ReturnToPool();
+  });
+}
+
+TEST(CoroPool, DestroyedBeforeThreadExit) {
+  auto config = MakeConfig();
+  config.local_cache_size = 2;
+  auto pool = std::make_unique<Pool>(config, &DummyExecutor);
+
+  std::promise<void> cached;
+  std::promise<void> destroyed;
+  std::thread thread([&] {
+    pool->GetCoroutine().ReturnToPool();
+    cached.set_value();
+    destroyed.get_future().wait();
+
+    // The cache was detached from the destroyed pool
+    Pool other_pool{config, &DummyExecutor};
+    auto coroutine = other_pool.GetCoroutine();
+    EXPECT_EQ(other_pool.GetStats().total_coroutines, 1);
+    std::move(coroutine).ReturnToPool();
+  });
+
+  cached.get_future().wait();
+  EXPECT_EQ(pool->GetStats().total_coroutines, 1);
+  EXPECT_EQ(pool->GetStats().active_coroutines, 0);
+  pool.reset();
+  destroyed.set_value();
+  thread.join();
+}
+
+TEST(CoroPool, ReclaimIdleStacks) {
+  auto config = MakeConfig();
+  config.local_cache_size = 0;
+  config.idle_stack_reclaim_timeout = std::chrono::milliseconds{1};
+  const MockNowGuard mock_now;
+  Pool pool{config, &DummyExecutor};
+
+  RunInThread([&pool] {
+    DummyTask task;
+    auto idle = pool.GetCoroutine();
+    auto busy = pool.GetCoroutine();
+    idle.Get()(&task);
+    std::move(idle).ReturnToPool();
+    EXPECT_EQ(pool.GetStats().resident_stacks, 2);
+
+    utils::datetime::MockSleep(std::chrono::milliseconds{10});
+
+    // Returning any coroutine triggers the reclamation
+    std::move(busy).ReturnToPool();
+
+    const auto stats = pool.GetStats();
+    EXPECT_EQ(stats.reclaimed_stacks, 1);
+    EXPECT_EQ(stats.total_coroutines, 2);
+    EXPECT_EQ(stats.resident_stacks, 1);
+
+    // Coroutine with a reclaimed stack is still usable
+    auto first = pool.GetCoroutine();
+    auto second = pool.GetCoroutine();
+    first.Get()(&task);
+    second.Get()(&task);
+    EXPECT_EQ(pool.GetStats().total_coroutines, 2);
+  });
+}
+
+TEST(CoroPool, ReclaimIdleThreadCaches) {
+  auto config = MakeConfig();
+  config.local_cache_size = 2;
+  config.idle_stack_reclaim_timeout = std::chrono::milliseconds{1};
+  const MockNowGuard mock_now;
+  Pool pool{config, &DummyExecutor};
+
+  std::promise<void> cached;
+  std::promise<void> reclaimed;
+  std::thread idle_thread([&] {
+    DummyTask task;
+    auto coroutine = pool.GetCoroutine();
+    coroutine.Get()(&task);
+    std::move(coroutine).ReturnToPool();
+    cached.set_value();
+    // Does not use the pool anymore
+    reclaimed.get_future().wait();
+  });
+  cached.get_future().wait();
+  utils::datetime::MockSleep(std::chrono::milliseconds{10});
+
+  RunInThread([&pool] {
+    // Returning any coroutine triggers the reclamation
+    pool.GetCoroutine().ReturnToPool();
+
+    const auto stats = pool.GetStats();
+    EXPECT_EQ(stats.reclaimed_stacks, 1);
+    EXPECT_EQ(stats.total_coroutines, 2);
+    EXPECT_EQ(stats.resident_stacks, 1);
+    EXPECT_EQ(stats.active_coroutines, 0);
+  });
+
+  reclaimed.set_value();
+  idle_thread.join();
+}
+
+TEST(CoroPool, ReclaimStackPagesZeroesMemory) {
+  constexpr std::size_t kStackSize = 128 * 1024;
+  engine::coro::StackInfo stack;
+  engine::coro::StackAllocator allocator{kStackSize, &stack};
+  auto sctx = allocator.allocate();
+  ASSERT_EQ(stack.top, sctx.sp);
+
+  auto* const top = static_cast<char*>(stack.top);
+  auto* const reclaimed = top - engine::coro::kStackTopReserve - 1;
+  auto* const kept = top - 1;
+  *reclaimed = 'x';
+  *kept = 'y';
+
+  EXPECT_TRUE(engine::coro::ReclaimStackPages(stack));
+  EXPECT_EQ(*reclaimed, '\0');
+  EXPECT_EQ(*kept, 'y');
+
+  allocator.deallocate(sctx);
+}
+
+TEST(CoroPool, MeasureStackUsage) {
+  constexpr std::size_t kStackSize = 128 * 1024;
+  constexpr std::size_t kUsage = 40 * 1024;
+  engine::coro::StackInfo stack;
+  engine::coro::StackAllocator allocator{kStackSize, &stack};
+  auto sctx = allocator.allocate();
+
+  auto* const top = static_cast<char*>(stack.top);
+  const auto unused_stack_usage = engine::coro::MeasureStackUsage(stack);
+  EXPECT_GE(unused_stack_usage, engine::coro::kStackTopReserve);
+
+  *(top - kUsage) = 'x';
+  *(top - kUsage / 2) = 'y';
+  const auto usage = engine::coro::MeasureStackUsage(stack);
+  EXPECT_GE(usage, kUsage);
+  EXPECT_LT(usage, kUsage + sizeof(std::uint64_t));
+
+  // The used part is reset, so that the next measurement is independent
+  EXPECT_EQ(*(top - kUsage / 2), '\0');
+  EXPECT_EQ(engine::coro::MeasureStackUsage(stack), unused_stack_usage);
+
+  allocator.deallocate(sctx);
+}
+
+USERVER_NAMESPACE_END
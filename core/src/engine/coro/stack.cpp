@@ -0,0 +1,96 @@
+#include <engine/coro/stack.hpp>
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::coro {
+
+StackAllocator::StackAllocator(std::size_t stack_size,
+                               StackInfo* allocated) noexcept
+    : impl_(stack_size), allocated_(allocated) {}
+
+boost::context::stack_context StackAllocator::allocate() {
+  auto sctx = impl_.allocate();
+  if (allocated_) *allocated_ = StackInfo{sctx.sp, sctx.size};
+  return sctx;
+}
+
+void StackAllocator::deallocate(boost::context::stack_context& sctx) noexcept {
+  impl_.deallocate(sctx);
+}
+
+namespace {
+
+// The part of the stack below the top reserve, without the guard page
+struct StackRange {
+  char* begin{nullptr};
+  char* end{nullptr};
+};
+
+std::optional<StackRange> GetRangeBelowReserve(const StackInfo& stack,
+                                               std::size_t page_size) noexcept {
+  const std::size_t reserve =
+      (kStackTopReserve + page_size - 1) / page_size * page_size;
+  // The bottom page is the guard page, it is never backed by memory
+  if (!stack.top || stack.size < reserve + 2 * page_size) return std::nullopt;
+
+  auto* const top = static_cast<char*>(stack.top);
+  return StackRange{top - stack.size + page_size, top - reserve};
+}
+
+// Pages that were never touched or were reclaimed are not resident, and
+// there is no need to scan them
+char* FindLowestResidentPage(StackRange range, std::size_t page_size) noexcept {
+  constexpr std::size_t kPagesPerCall = 64;
+  unsigned char residency[kPagesPerCall];
+
+  for (char* chunk = range.begin; chunk < range.end;
+       chunk += kPagesPerCall * page_size) {
+    const auto length = std::min<std::size_t>(range.end - chunk,
+                                              kPagesPerCall * page_size);
+    if (::mincore(chunk, length, residency) != 0) return chunk;
+
+    for (std::size_t i = 0; i < length / page_size; ++i) {
+      if (residency[i] & 1) return chunk + i * page_size;
+    }
+  }
+  return range.end;
+}
+
+}  // namespace
+
+bool ReclaimStackPages(const StackInfo& stack) noexcept {
+  const std::size_t page_size = boost::context::stack_traits::page_size();
+  const auto range = GetRangeBelowReserve(stack, page_size);
+  if (!range) return false;
+
+  return ::madvise(range->begin, range->end - range->begin, MADV_DONTNEED) ==
+         0;
+}
+
+std::size_t MeasureStackUsage(const StackInfo& stack) noexcept {
+  const std::size_t page_size = boost::context::stack_traits::page_size();
+  const auto range = GetRangeBelowReserve(stack, page_size);
+  if (!range) return stack.size;
+
+  using Word = std::uint64_t;
+  const auto* word =
+      reinterpret_cast<const Word*>(FindLowestResidentPage(*range, page_size));
+  const auto* const end = reinterpret_cast<const Word*>(range->end);
+  while (word != end && *word == 0) ++word;
+
+  auto* const used_begin = reinterpret_cast<char*>(const_cast<Word*>(word));
+  std::memset(used_begin, 0, range->end - used_begin);
+
+  return static_cast<char*>(stack.top) - used_begin;
+}
+
+}  // namespace engine::coro
+
+USERVER_NAMESPACE_END
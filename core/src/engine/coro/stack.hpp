@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+
+#include <coroutines/coroutine.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::coro {
+
+/// Location of a coroutine stack, as allocated by protected_fixedsize_stack
+struct StackInfo {
+  /// The highest address of the stack, the stack grows down from it
+  void* top{nullptr};
+  /// Size of the mapping, including the guard page at the bottom
+  std::size_t size{0};
+};
+
+/// Amount of bytes at the top of an idle coroutine stack that are never
+/// reclaimed: they hold the control block of the coroutine and the frames
+/// of the suspended executor.
+inline constexpr std::size_t kStackTopReserve = 16 * 1024;
+
+/// @brief Same as boost::coroutines2::protected_fixedsize_stack, but also
+/// reports the location of the allocated stack.
+///
+/// The stack allocator is copied into the coroutine, so the location is
+/// written into `*allocated` only once, from within the coroutine constructor.
+class StackAllocator final {
+ public:
+  StackAllocator(std::size_t stack_size, StackInfo* allocated) noexcept;
+
+  boost::context::stack_context allocate();
+  void deallocate(boost::context::stack_context& sctx) noexcept;
+
+ private:
+  boost::coroutines2::protected_fixedsize_stack impl_;
+  StackInfo* allocated_;
+};
+
+/// Returns the pages of an idle coroutine stack to the OS, except for the
+/// top kStackTopReserve bytes. The pages are zero-filled on the next access.
+///
+/// Returns false if the stack is too small to reclaim anything or on error.
+bool ReclaimStackPages(const StackInfo& stack) noexcept;
+
+/// @brief Returns the amount of bytes of an idle coroutine stack that were
+/// used since the previous call, and prepares the stack for the next call.
+///
+/// Fresh and reclaimed stack pages are zero-filled by the OS, so zero is used
+/// as a canary: the stack is scanned from the lowest resident page for the
+/// first non-zero word, then the used part is zeroed again. The result is
+/// never less than kStackTopReserve, which is not scanned, and may be a few
+/// words less than the real usage if the deepest frame stored zeros.
+std::size_t MeasureStackUsage(const StackInfo& stack) noexcept;
+
+}  // namespace engine::coro
+
+USERVER_NAMESPACE_END
@@ -86,6 +86,14 @@ class Direction final {
                     TransferMode mode, Deadline deadline,
                     const Context&... context);
 
+  // (IoFunc*)(int, size_t, size_t), e.g. sendfile. For the transfers that
+  // do not use a user buffer, receives the count of already transferred bytes
+  // and the count of bytes left.
+  template <typename IoFunc, typename... Context>
+  size_t PerformIoUnbuffered(SingleUserGuard& guard, IoFunc&& io_func,
+                             size_t len, TransferMode mode, Deadline deadline,
+                             const Context&... context);
+
  private:
   friend class FdControl;
   explicit Direction(Kind kind);
@@ -249,6 +257,30 @@ size_t Direction::PerformIo(SingleUserGuard&, IoFunc&& io_func, void* buf,
   return pos - begin;
 }
 
+template <typename IoFunc, typename... Context>
+size_t Direction::PerformIoUnbuffered(SingleUserGuard&, IoFunc&& io_func,
+                                      size_t len, TransferMode mode,
+                                      Deadline deadline,
+                                      const Context&... context) {
+  size_t processed_bytes = 0;
+
+  while (processed_bytes < len) {
+    auto chunk_size = io_func(Fd(), processed_bytes, len - processed_bytes);
+
+    if (chunk_size > 0) {
+      processed_bytes += chunk_size;
+      if (mode == TransferMode::kOnce) {
+        break;
+      }
+    } else if (!chunk_size ||
+               TryHandleError(errno, processed_bytes, mode, deadline,
+                              context...) == ErrorMode::kFatal) {
+      break;
+    }
+  }
+  return processed_bytes;
+}
+
 }  // namespace engine::io::impl
 
 USERVER_NAMESPACE_END
@@ -4,7 +4,11 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 
+#include <algorithm>
 #include <cerrno>
 #include <string>
 #include <vector>
@@ -106,6 +110,26 @@ class SendToWrapper {
   const Sockaddr& dest_addr_;
 };
 
+#ifdef __linux__
+class SendFileWrapper {
+ public:
+  SendFileWrapper(int file_fd, std::uint64_t offset)
+      : file_fd_(file_fd), offset_(offset) {}
+
+  [[nodiscard]] ssize_t operator()(int fd, size_t sent, size_t len) const {
+    auto offset = static_cast<off_t>(offset_ + sent);
+    return ::sendfile(fd, file_fd_, &offset, len);
+  }
+
+ private:
+  const int file_fd_;
+  const std::uint64_t offset_;
+};
+#else
+// MAC_COMPAT: sendfile has a different interface, reading through a buffer
+constexpr size_t kSendFileBufferSize = 64 * 1024;
+#endif
+
 void FillIoSendData(const IoData* data, struct iovec* dst, std::size_t count) {
   UASSERT(data);
   UASSERT(count > 0);
@@ -282,6 +306,36 @@ size_t Socket::SendAll(const void* buf, size_t len, Deadline deadline) {
                        peername_);
 }
 
+size_t Socket::SendFile(int file_fd, std::uint64_t offset, size_t len,
+                        Deadline deadline) {
+  if (!IsValid()) {
+    throw IoException("Attempt to SendFile to closed socket");
+  }
+#ifdef __linux__
+  auto& dir = fd_control_->Write();
+  impl::Direction::SingleUserGuard guard(dir);
+  return dir.PerformIoUnbuffered(guard, SendFileWrapper{file_fd, offset}, len,
+                                 impl::TransferMode::kWhole, deadline,
+                                 "SendFile to ", peername_);
+#else
+  std::vector<char> buffer(std::min(len, kSendFileBufferSize));
+  size_t sent_bytes = 0;
+  while (sent_bytes < len) {
+    const auto read_bytes = utils::CheckSyscallCustomException<IoSystemError>(
+        ::pread(file_fd, buffer.data(),
+                std::min(len - sent_bytes, buffer.size()),
+                static_cast<off_t>(offset + sent_bytes)),
+        "reading the file for SendFile");
+    if (read_bytes == 0) break;
+
+    const auto chunk_size = SendAll(buffer.data(), read_bytes, deadline);
+    sent_bytes += chunk_size;
+    if (chunk_size != static_cast<size_t>(read_bytes)) break;
+  }
+  return sent_bytes;
+#endif
+}
+
 Socket::RecvFromResult Socket::RecvSomeFrom(void* buf, size_t len,
                                             Deadline deadline) {
   if (!IsValid()) {
@@ -17,6 +17,9 @@
 #include <userver/engine/mutex.hpp>
 #include <userver/engine/single_consumer_event.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
+#include <userver/fs/blocking/temp_file.hpp>
+#include <userver/fs/blocking/write.hpp>
 #include <userver/internal/net/net_listener.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -175,6 +178,53 @@ UTEST(Socket, SendAllVector) {
   EXPECT_EQ(bytes_sent, bytes_read);
 }
 
+UTEST(Socket, SendFile) {
+  const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  // Larger than the socket buffers to make sendfile wait for the reader
+  std::string contents(8 * 1024 * 1024, '\0');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), contents);
+
+  constexpr size_t kOffset = 3;
+  const auto expected = std::string_view{contents}.substr(kOffset);
+
+  TcpListener listener;
+  auto sockets = listener.MakeSocketPair(deadline);
+  auto read_task = engine::AsyncNoSpan([&sockets, &deadline, &expected] {
+    std::string buf(expected.size(), '\0');
+    const auto bytes_read =
+        sockets.first.RecvAll(buf.data(), buf.size(), deadline);
+    EXPECT_EQ(bytes_read, expected.size());
+    EXPECT_TRUE(buf == expected);
+  });
+
+  /// [send file in socket]
+  const auto fd = fs::blocking::FileDescriptor::Open(
+      file.GetPath(), fs::blocking::OpenFlag::kRead);
+  const auto bytes_sent = sockets.second.SendFile(
+      fd.GetNative(), kOffset, contents.size() - kOffset, deadline);
+  /// [send file in socket]
+  EXPECT_EQ(bytes_sent, expected.size());
+
+  read_task.Get();
+
+  // Stops at the end of the file
+  auto eof_read_task = engine::AsyncNoSpan([&sockets, &deadline, &contents] {
+    std::array<char, 2> buf{};
+    EXPECT_EQ(sockets.first.RecvAll(buf.data(), buf.size(), deadline), 2);
+    EXPECT_EQ(std::string_view(buf.data(), buf.size()),
+              std::string_view{contents}.substr(contents.size() - 2));
+  });
+  EXPECT_EQ(sockets.second.SendFile(fd.GetNative(), contents.size() - 2, 100,
+                                    deadline),
+            2);
+  eof_read_task.Get();
+}
+
 UTEST(Socket, SendAllVectorHeap) {
   const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
 
@@ -0,0 +1,435 @@
+#include <engine/io/tls_session_cache_impl.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+
+#include <fmt/format.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#else
+#include <openssl/hmac.h>
+#endif
+
+#include <crypto/helpers.hpp>
+#include <userver/engine/io/exception.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/datetime.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::io {
+namespace {
+
+constexpr std::size_t kSessionCacheWays = 16;
+constexpr std::size_t kTicketKeySize = 80;
+constexpr unsigned char kSessionIdContext[] = "userver";
+
+cache::NWayLRU<std::string, std::string> MakeSessionsCache(
+    std::size_t max_size) {
+  return {kSessionCacheWays,
+          std::max<std::size_t>(max_size / kSessionCacheWays, 1)};
+}
+
+std::string SerializeSession(SSL_SESSION* session) {
+  const int size = i2d_SSL_SESSION(session, nullptr);
+  if (size <= 0) return {};
+  std::string der(size, '\0');
+  auto* pos = reinterpret_cast<unsigned char*>(der.data());
+  i2d_SSL_SESSION(session, &pos);
+  return der;
+}
+
+SSL_SESSION* DeserializeSession(const std::string& der) {
+  const auto* pos = reinterpret_cast<const unsigned char*>(der.data());
+  return d2i_SSL_SESSION(nullptr, &pos, static_cast<long>(der.size()));
+}
+
+TlsTicketKey GenerateTicketKey() {
+  TlsTicketKey key;
+  if (1 != RAND_bytes(key.name.data(), key.name.size()) ||
+      1 != RAND_bytes(key.hmac_secret.data(), key.hmac_secret.size()) ||
+      1 != RAND_bytes(key.aes_key.data(), key.aes_key.size())) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to generate TLS session ticket key: RAND_bytes"));
+  }
+  key.created = utils::datetime::SteadyNow();
+  return key;
+}
+
+int GetServerCacheIndex() {
+  static const int kIndex =
+      SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return kIndex;
+}
+
+int GetClientCacheIndex() {
+  static const int kIndex =
+      SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  return kIndex;
+}
+
+void FreeSessionKey(void*, void* ptr, CRYPTO_EX_DATA*, int, long,
+                    void*) noexcept {
+  delete static_cast<std::string*>(ptr);
+}
+
+int GetSessionKeyIndex() {
+  static const int kIndex =
+      SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, &FreeSessionKey);
+  return kIndex;
+}
+
+TlsServerSessionCache::Impl* GetServerCache(SSL_CTX* ssl_ctx) {
+  return static_cast<TlsServerSessionCache::Impl*>(
+      SSL_CTX_get_ex_data(ssl_ctx, GetServerCacheIndex()));
+}
+
+TlsServerSessionCache::Impl* GetServerCache(SSL* ssl) {
+  return GetServerCache(SSL_get_SSL_CTX(ssl));
+}
+
+TlsClientSessionCache::Impl* GetClientCache(SSL* ssl) {
+  return static_cast<TlsClientSessionCache::Impl*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), GetClientCacheIndex()));
+}
+
+int ServerNewSession(SSL* ssl, SSL_SESSION* session) noexcept {
+  auto* cache = GetServerCache(ssl);
+  UASSERT(cache);
+  try {
+    cache->StoreSession(session);
+  } catch (const std::exception& ex) {
+    LOG_LIMITED_WARNING() << "Failed to cache TLS session: " << ex;
+  }
+  return 0;  // the session is not referenced
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x010100000L
+SSL_SESSION* ServerGetSession(SSL* ssl, const unsigned char* id, int id_length,
+                              int* copy) noexcept {
+#else
+SSL_SESSION* ServerGetSession(SSL* ssl, unsigned char* id, int id_length,
+                              int* copy) noexcept {
+#endif
+  auto* cache = GetServerCache(ssl);
+  UASSERT(cache);
+  *copy = 0;  // the reference is passed to OpenSSL
+  try {
+    return cache->FindSession(id, id_length);
+  } catch (const std::exception& ex) {
+    LOG_LIMITED_WARNING() << "Failed to find TLS session: " << ex;
+    return nullptr;
+  }
+}
+
+void ServerRemoveSession(SSL_CTX* ssl_ctx, SSL_SESSION* session) noexcept {
+  auto* cache = GetServerCache(ssl_ctx);
+  if (!cache) return;
+  try {
+    cache->RemoveSession(session);
+  } catch (const std::exception& ex) {
+    LOG_LIMITED_WARNING() << "Failed to remove TLS session: " << ex;
+  }
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L
+using MacCtx = EVP_MAC_CTX;
+
+bool InitMac(EVP_MAC_CTX* mac_ctx, const TlsTicketKey& key) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto* digest = const_cast<char*>("SHA256");
+  std::array<OSSL_PARAM, 3> params{
+      OSSL_PARAM_construct_octet_string(
+          OSSL_MAC_PARAM_KEY,
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+          const_cast<unsigned char*>(key.hmac_secret.data()),
+          key.hmac_secret.size()),
+      OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+      OSSL_PARAM_construct_end()};
+  return 1 == EVP_MAC_CTX_set_params(mac_ctx, params.data());
+}
+#else
+using MacCtx = HMAC_CTX;
+
+bool InitMac(HMAC_CTX* mac_ctx, const TlsTicketKey& key) {
+  return 1 == HMAC_Init_ex(mac_ctx, key.hmac_secret.data(),
+                           key.hmac_secret.size(), EVP_sha256(), nullptr);
+}
+#endif
+
+// Returns 1 on success, 2 if the ticket should be renewed as it is encrypted
+// with an old key, 0 if the ticket key is unknown and -1 on errors
+int TicketKeyCallback(SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                      EVP_CIPHER_CTX* cipher_ctx, MacCtx* mac_ctx,
+                      int enc) noexcept {
+  auto* cache = GetServerCache(ssl);
+  UASSERT(cache);
+  try {
+    const auto keys = cache->GetTicketKeys(enc == 1);
+    if (enc == 1) {
+      const auto& key = keys->front();
+      const auto iv_length = EVP_CIPHER_iv_length(EVP_aes_256_cbc());
+      if (1 != RAND_bytes(iv, iv_length)) return -1;
+      std::memcpy(key_name, key.name.data(), key.name.size());
+      if (1 != EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr,
+                                  key.aes_key.data(), iv)) {
+        return -1;
+      }
+      return InitMac(mac_ctx, key) ? 1 : -1;
+    }
+
+    for (std::size_t i = 0; i < keys->size(); ++i) {
+      const auto& key = (*keys)[i];
+      if (std::memcmp(key_name, key.name.data(), key.name.size()) != 0) {
+        continue;
+      }
+      if (1 != EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr,
+                                  key.aes_key.data(), iv)) {
+        return -1;
+      }
+      if (!InitMac(mac_ctx, key)) return -1;
+      return i == 0 ? 1 : 2;
+    }
+    return 0;
+  } catch (const std::exception& ex) {
+    LOG_LIMITED_WARNING() << "Failed to process TLS session ticket: " << ex;
+    return -1;
+  }
+}
+
+int ClientNewSession(SSL* ssl, SSL_SESSION* session) noexcept {
+  auto* cache = GetClientCache(ssl);
+  UASSERT(cache);
+  try {
+    cache->StoreSession(ssl, session);
+  } catch (const std::exception& ex) {
+    LOG_LIMITED_WARNING() << "Failed to store TLS session: " << ex;
+  }
+  return 0;  // the session is not referenced
+}
+
+void CountHandshake(SSL* ssl, TlsResumptionStatistics& stats) {
+  if (SSL_session_reused(ssl)) {
+    ++stats.resumed_handshakes;
+  } else {
+    ++stats.full_handshakes;
+  }
+}
+
+}  // namespace
+
+void DumpMetric(utils::statistics::Writer& writer,
+                const TlsResumptionStatistics& stats) {
+  writer["full"] = stats.full_handshakes.load();
+  writer["resumed"] = stats.resumed_handshakes.load();
+}
+
+TlsServerSessionCache::Impl::Impl(std::size_t max_size,
+                                  std::chrono::seconds session_timeout)
+    : sessions_(MakeSessionsCache(max_size)),
+      session_timeout_(session_timeout),
+      ticket_keys_(std::vector{GenerateTicketKey()}) {}
+
+void TlsServerSessionCache::Impl::SetTicketKeys(
+    std::vector<TlsTicketKey> keys) {
+  UASSERT(!keys.empty());
+  auto ticket_keys = ticket_keys_.StartWrite();
+  // keep the key that issued the current tickets to resume their sessions
+  const auto& previous_key = ticket_keys->front();
+  const bool is_previous_key_kept =
+      std::any_of(keys.begin(), keys.end(), [&previous_key](const auto& key) {
+        return key.name == previous_key.name;
+      });
+  if (!is_previous_key_kept) keys.push_back(previous_key);
+  *ticket_keys = std::move(keys);
+  are_ticket_keys_generated_ = false;
+  ticket_keys.Commit();
+}
+
+void TlsServerSessionCache::Impl::SetUp(SSL_CTX* ssl_ctx) {
+  if (1 != SSL_CTX_set_ex_data(ssl_ctx, GetServerCacheIndex(), this)) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to set up TLS session cache: SSL_CTX_set_ex_data"));
+  }
+  if (1 != SSL_CTX_set_session_id_context(ssl_ctx, kSessionIdContext,
+                                          sizeof(kSessionIdContext) - 1)) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to set up TLS session cache: SSL_CTX_set_session_id_context"));
+  }
+  SSL_CTX_set_session_cache_mode(
+      ssl_ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_set_timeout(ssl_ctx, session_timeout_.count());
+  SSL_CTX_sess_set_new_cb(ssl_ctx, &ServerNewSession);
+  SSL_CTX_sess_set_get_cb(ssl_ctx, &ServerGetSession);
+  SSL_CTX_sess_set_remove_cb(ssl_ctx, &ServerRemoveSession);
+
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L
+  const auto ret =
+      SSL_CTX_set_tlsext_ticket_key_evp_cb(ssl_ctx, &TicketKeyCallback);
+#else
+  // cast in openssl macro expansion
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  const auto ret =
+      SSL_CTX_set_tlsext_ticket_key_cb(ssl_ctx, &TicketKeyCallback);
+#endif
+  if (1 != ret) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to set up TLS session cache: ticket key callback"));
+  }
+}
+
+void TlsServerSessionCache::Impl::AccountHandshake(SSL* ssl) {
+  CountHandshake(ssl, stats);
+}
+
+rcu::ReadablePtr<std::vector<TlsTicketKey>>
+TlsServerSessionCache::Impl::GetTicketKeys(bool for_issue) {
+  auto keys = ticket_keys_.Read();
+  if (!for_issue || !are_ticket_keys_generated_) return keys;
+
+  const auto now = utils::datetime::SteadyNow();
+  if (now - keys->front().created < session_timeout_) return keys;
+
+  {
+    auto new_keys = ticket_keys_.StartWrite();
+    if (are_ticket_keys_generated_ &&
+        now - new_keys->front().created >= session_timeout_) {
+      // keep the previous key to resume the sessions issued with it
+      new_keys->insert(new_keys->begin(), GenerateTicketKey());
+      new_keys->resize(2);
+      new_keys.Commit();
+    }
+  }
+  return ticket_keys_.Read();
+}
+
+void TlsServerSessionCache::Impl::StoreSession(SSL_SESSION* session) {
+  unsigned int id_length = 0;
+  const auto* id = SSL_SESSION_get_id(session, &id_length);
+  auto der = SerializeSession(session);
+  if (der.empty()) return;
+  sessions_.Put(std::string(reinterpret_cast<const char*>(id), id_length),
+                std::move(der));
+}
+
+SSL_SESSION* TlsServerSessionCache::Impl::FindSession(const unsigned char* id,
+                                                      int id_length) {
+  const auto der =
+      sessions_.Get(std::string(reinterpret_cast<const char*>(id), id_length));
+  if (!der) return nullptr;
+  return DeserializeSession(*der);
+}
+
+void TlsServerSessionCache::Impl::RemoveSession(SSL_SESSION* session) {
+  unsigned int id_length = 0;
+  const auto* id = SSL_SESSION_get_id(session, &id_length);
+  sessions_.InvalidateByKey(
+      std::string(reinterpret_cast<const char*>(id), id_length));
+}
+
+TlsServerSessionCache::TlsServerSessionCache(
+    std::size_t max_size, std::chrono::seconds session_timeout)
+    : impl_(std::make_unique<Impl>(max_size, session_timeout)) {}
+
+TlsServerSessionCache::~TlsServerSessionCache() = default;
+
+void TlsServerSessionCache::SetTicketKeys(
+    const std::vector<std::string>& keys) {
+  if (keys.empty()) {
+    throw TlsException("At least one TLS session ticket key is required");
+  }
+
+  std::vector<TlsTicketKey> ticket_keys;
+  ticket_keys.reserve(keys.size());
+  for (const auto& key : keys) {
+    if (key.size() != kTicketKeySize) {
+      throw TlsException(
+          fmt::format("TLS session ticket key must be {} bytes long, got {}",
+                      kTicketKeySize, key.size()));
+    }
+    auto& ticket_key = ticket_keys.emplace_back();
+    const auto* pos = key.data();
+    std::memcpy(ticket_key.name.data(), pos, ticket_key.name.size());
+    pos += ticket_key.name.size();
+    std::memcpy(ticket_key.hmac_secret.data(), pos,
+                ticket_key.hmac_secret.size());
+    pos += ticket_key.hmac_secret.size();
+    std::memcpy(ticket_key.aes_key.data(), pos, ticket_key.aes_key.size());
+  }
+  impl_->SetTicketKeys(std::move(ticket_keys));
+}
+
+const TlsResumptionStatistics& TlsServerSessionCache::GetStatistics() const {
+  return impl_->stats;
+}
+
+TlsClientSessionCache::Impl::Impl(std::size_t max_size)
+    : sessions_(MakeSessionsCache(max_size)) {}
+
+void TlsClientSessionCache::Impl::SetUp(SSL_CTX* ssl_ctx) {
+  if (1 != SSL_CTX_set_ex_data(ssl_ctx, GetClientCacheIndex(), this)) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to set up TLS session cache: SSL_CTX_set_ex_data"));
+  }
+  SSL_CTX_set_session_cache_mode(
+      ssl_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(ssl_ctx, &ClientNewSession);
+}
+
+void TlsClientSessionCache::Impl::SetSession(SSL* ssl, std::string key) {
+  auto stored_key = std::make_unique<std::string>(std::move(key));
+  if (1 != SSL_set_ex_data(ssl, GetSessionKeyIndex(), stored_key.get())) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to set up TLS session cache: SSL_set_ex_data"));
+  }
+  const auto& session_key = *stored_key.release();
+
+  const auto der = sessions_.Get(session_key);
+  if (!der) return;
+
+  auto* session = DeserializeSession(*der);
+  if (!session) return;
+  if (1 != SSL_set_session(ssl, session)) {
+    LOG_LIMITED_WARNING() << crypto::FormatSslError(
+        "Failed to resume TLS session: SSL_set_session");
+  }
+  SSL_SESSION_free(session);
+}
+
+void TlsClientSessionCache::Impl::AccountHandshake(SSL* ssl) {
+  CountHandshake(ssl, stats);
+}
+
+void TlsClientSessionCache::Impl::StoreSession(SSL* ssl,
+                                               SSL_SESSION* session) {
+  const auto* key =
+      static_cast<std::string*>(SSL_get_ex_data(ssl, GetSessionKeyIndex()));
+  if (!key) return;
+#if OPENSSL_VERSION_NUMBER >= 0x010101000L
+  if (!SSL_SESSION_is_resumable(session)) return;
+#endif
+
+  auto der = SerializeSession(session);
+  if (der.empty()) return;
+  sessions_.Put(*key, std::move(der));
+}
+
+TlsClientSessionCache::TlsClientSessionCache(std::size_t max_size)
+    : impl_(std::make_unique<Impl>(max_size)) {}
+
+TlsClientSessionCache::~TlsClientSessionCache() = default;
+
+const TlsResumptionStatistics& TlsClientSessionCache::GetStatistics() const {
+  return impl_->stats;
+}
+
+}  // namespace engine::io
+
+USERVER_NAMESPACE_END
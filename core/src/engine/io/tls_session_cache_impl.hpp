@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <openssl/ssl.h>
+
+#include <userver/cache/nway_lru_cache.hpp>
+#include <userver/engine/io/tls_session_cache.hpp>
+#include <userver/rcu/rcu.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::io {
+
+struct TlsTicketKey final {
+  std::array<unsigned char, 16> name{};
+  std::array<unsigned char, 32> hmac_secret{};
+  std::array<unsigned char, 32> aes_key{};
+  std::chrono::steady_clock::time_point created;
+};
+
+class TlsServerSessionCache::Impl final {
+ public:
+  Impl(std::size_t max_size, std::chrono::seconds session_timeout);
+
+  void SetTicketKeys(std::vector<TlsTicketKey> keys);
+
+  /// Installs the session cache and ticket key callbacks into the context
+  void SetUp(SSL_CTX* ssl_ctx);
+
+  void AccountHandshake(SSL* ssl);
+
+  /// Rotates a generated key if it is too old to issue new tickets
+  rcu::ReadablePtr<std::vector<TlsTicketKey>> GetTicketKeys(bool for_issue);
+
+  void StoreSession(SSL_SESSION* session);
+  SSL_SESSION* FindSession(const unsigned char* id, int id_length);
+  void RemoveSession(SSL_SESSION* session);
+
+  TlsResumptionStatistics stats;
+
+ private:
+  cache::NWayLRU<std::string, std::string> sessions_;
+  const std::chrono::seconds session_timeout_;
+  std::atomic<bool> are_ticket_keys_generated_{true};
+  rcu::Variable<std::vector<TlsTicketKey>> ticket_keys_;
+};
+
+class TlsClientSessionCache::Impl final {
+ public:
+  explicit Impl(std::size_t max_size);
+
+  /// Installs the session store callback into the context
+  void SetUp(SSL_CTX* ssl_ctx);
+
+  /// Offers the last session of the server for resumption, new sessions of
+  /// the connection are stored by the same key
+  void SetSession(SSL* ssl, std::string key);
+
+  void AccountHandshake(SSL* ssl);
+
+  void StoreSession(SSL* ssl, SSL_SESSION* session);
+
+  TlsResumptionStatistics stats;
+
+ private:
+  cache::NWayLRU<std::string, std::string> sessions_;
+};
+
+}  // namespace engine::io
+
+USERVER_NAMESPACE_END
@@ -1,7 +1,9 @@
 #include <userver/engine/io/tls_wrapper.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <memory>
+#include <string>
 
 #include <fmt/format.h>
 #include <openssl/bio.h>
@@ -10,7 +12,9 @@
 #include <crypto/helpers.hpp>
 #include <crypto/openssl.hpp>
 #include <engine/io/fd_control.hpp>
+#include <engine/io/tls_session_cache_impl.hpp>
 #include <userver/engine/io/exception.hpp>
+#include <userver/engine/task/cancel.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
 
@@ -230,6 +234,28 @@ enum InterruptAction {
   kFail,
 };
 
+// Kernel TLS requires the OpenSSL socket BIO, custom BIOs are not supported
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L && !defined(OPENSSL_NO_KTLS)
+constexpr bool kIsKernelTlsSupported = true;
+
+void EnableKernelTls(SSL_CTX* ssl_ctx) {
+  SSL_CTX_set_options(ssl_ctx, SSL_OP_ENABLE_KTLS);
+}
+
+bool HasKernelTlsSend(SSL* ssl) {
+  return BIO_get_ktls_send(SSL_get_wbio(ssl));
+}
+#else
+constexpr bool kIsKernelTlsSupported = false;
+
+void EnableKernelTls(SSL_CTX*) {}
+
+bool HasKernelTlsSend(SSL*) { return false; }
+#endif
+
+// Max size of the plaintext in a single TLS record
+constexpr size_t kMaxRecordSize = SSL3_RT_MAX_PLAIN_LENGTH;
+
 }  // namespace
 
 class TlsWrapper::Impl {
@@ -239,20 +265,36 @@ class TlsWrapper::Impl {
   Impl(Impl&& other) noexcept
       : bio_data(std::move(other.bio_data)),
         ssl(std::move(other.ssl)),
-        is_in_shutdown(other.is_in_shutdown) {
+        is_in_shutdown(other.is_in_shutdown),
+        uses_openssl_socket_bio(other.uses_openssl_socket_bio),
+        is_kernel_tls_send(other.is_kernel_tls_send) {
     UASSERT(SSL_get_rbio(ssl.get()) == SSL_get_wbio(ssl.get()));
-    SyncBioData(SSL_get_rbio(ssl.get()), &other.bio_data);
+    if (!uses_openssl_socket_bio) {
+      SyncBioData(SSL_get_rbio(ssl.get()), &other.bio_data);
+    }
   }
 
-  void SetUp(SslCtx&& ssl_ctx) {
-    Bio socket_bio{BIO_new(GetSocketBioMethod())};
-    if (!socket_bio) {
-      throw TlsException(
-          crypto::FormatSslError("Failed to set up TLS wrapper: BIO_new"));
+  void SetUp(SslCtx&& ssl_ctx,
+             KernelTlsMode kernel_tls = KernelTlsMode::kDisabled) {
+    Bio socket_bio;
+    if (kernel_tls == KernelTlsMode::kIfAvailable && kIsKernelTlsSupported) {
+      EnableKernelTls(ssl_ctx.get());
+      socket_bio.reset(BIO_new_socket(bio_data.socket.Fd(), BIO_NOCLOSE));
+      if (!socket_bio) {
+        throw TlsException(crypto::FormatSslError(
+            "Failed to set up TLS wrapper: BIO_new_socket"));
+      }
+      uses_openssl_socket_bio = true;
+    } else {
+      socket_bio.reset(BIO_new(GetSocketBioMethod()));
+      if (!socket_bio) {
+        throw TlsException(
+            crypto::FormatSslError("Failed to set up TLS wrapper: BIO_new"));
+      }
+      BIO_set_shutdown(socket_bio.get(), 0);
+      SyncBioData(socket_bio.get(), nullptr);
+      BIO_set_init(socket_bio.get(), 1);
     }
-    BIO_set_shutdown(socket_bio.get(), 0);
-    SyncBioData(socket_bio.get(), nullptr);
-    BIO_set_init(socket_bio.get(), 1);
 
     ssl.reset(SSL_new(ssl_ctx.get()));
     if (!ssl) {
@@ -274,6 +316,7 @@ class TlsWrapper::Impl {
     if (!len) return 0;
 
     bio_data.current_deadline = deadline;
+    if (uses_openssl_socket_bio) bio_data.last_exception = {};
 
     char* const begin = static_cast<char*>(buf);
     char* const end = begin + len;
@@ -294,6 +337,11 @@ class TlsWrapper::Impl {
           // timeout, cancel, EOF, or just a spurious wakeup
           case SSL_ERROR_WANT_READ:
           case SSL_ERROR_WANT_WRITE:
+            if (uses_openssl_socket_bio &&
+                WaitSocketBio(ssl_error, pos - begin)) {
+              continue;
+            }
+            break;
           case SSL_ERROR_ZERO_RETURN:
             break;
 
@@ -327,6 +375,77 @@ class TlsWrapper::Impl {
     return pos - begin;
   }
 
+  // Packs the buffers into full-size records, copying only the data that
+  // does not fill a whole record by itself
+  size_t SendCoalesced(const IoData* list, size_t list_size,
+                       Deadline deadline) {
+    size_t total_size = 0;
+    for (size_t i = 0; i < list_size; ++i) total_size += list[i].len;
+
+    std::string record;
+    record.reserve(std::min(total_size, kMaxRecordSize));
+    size_t sent_bytes = 0;
+    const auto send_chunk = [&](const char* data, size_t len) {
+      const auto sent = PerformSslIo(
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+          &SSL_write_ex, const_cast<char*>(data), len,
+          impl::TransferMode::kWhole, InterruptAction::kFail, deadline,
+          "SendAll");
+      sent_bytes += sent;
+      return sent == len;
+    };
+
+    for (size_t i = 0; i < list_size; ++i) {
+      const auto* data = static_cast<const char*>(list[i].data);
+      size_t len = list[i].len;
+      while (len) {
+        if (record.empty() && len >= kMaxRecordSize) {
+          const auto whole_records_size = len - len % kMaxRecordSize;
+          if (!send_chunk(data, whole_records_size)) return sent_bytes;
+          data += whole_records_size;
+          len -= whole_records_size;
+          continue;
+        }
+
+        const auto chunk_size = std::min(len, kMaxRecordSize - record.size());
+        record.append(data, chunk_size);
+        data += chunk_size;
+        len -= chunk_size;
+        if (record.size() == kMaxRecordSize) {
+          if (!send_chunk(record.data(), record.size())) return sent_bytes;
+          record.clear();
+        }
+      }
+    }
+    if (!record.empty()) send_chunk(record.data(), record.size());
+    return sent_bytes;
+  }
+
+  // OpenSSL socket BIO does not wait for the socket, so we do it the way
+  // Socket does. Stores the exception and returns false on timeout or
+  // cancellation.
+  bool WaitSocketBio(int ssl_error, size_t bytes_transferred) {
+    UASSERT(uses_openssl_socket_bio);
+    bio_data.last_exception = {};
+
+    auto& socket = bio_data.socket;
+    const auto deadline = bio_data.current_deadline;
+    const bool is_ready = ssl_error == SSL_ERROR_WANT_READ
+                              ? socket.WaitReadable(deadline)
+                              : socket.WaitWriteable(deadline);
+    if (is_ready) return true;
+
+    try {
+      if (current_task::ShouldCancel()) {
+        throw IoCancelled(bytes_transferred);
+      }
+      throw IoTimeout(bytes_transferred);
+    } catch (const IoInterrupted&) {
+      bio_data.last_exception = std::current_exception();
+    }
+    return false;
+  }
+
   void CheckAlive() const {
     if (!ssl) {
       throw TlsException("SSL connection is broken");
@@ -336,6 +455,8 @@ class TlsWrapper::Impl {
   SocketBioData bio_data;
   Ssl ssl;
   bool is_in_shutdown{false};
+  bool uses_openssl_socket_bio{false};
+  bool is_kernel_tls_send{false};
 
  private:
   void SyncBioData(BIO* bio,
@@ -349,8 +470,15 @@ TlsWrapper::TlsWrapper(Socket&& socket) : impl_(std::move(socket)) {}
 
 TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
                                       const std::string& server_name,
-                                      Deadline deadline) {
+                                      Deadline deadline,
+                                      TlsClientSessionCache* session_cache) {
   auto ssl_ctx = MakeSslCtx();
+  std::string session_key;
+  if (session_cache) {
+    session_cache->impl_->SetUp(ssl_ctx.get());
+    session_key = server_name.empty() ? fmt::to_string(socket.Getpeername())
+                                      : server_name;
+  }
 
   if (!server_name.empty()) {
     X509_VERIFY_PARAM* verify_param = SSL_CTX_get0_param(ssl_ctx.get());
@@ -377,6 +505,10 @@ TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
           "Failed to set up client TLS wrapper: SSL_set_tlsext_host_name"));
     }
   }
+  if (session_cache) {
+    session_cache->impl_->SetSession(wrapper.impl_->ssl.get(),
+                                     std::move(session_key));
+  }
 
   wrapper.impl_->bio_data.current_deadline = deadline;
 
@@ -390,14 +522,19 @@ TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
         fmt::format("Failed to set up client TLS wrapper ({})",
                     SSL_get_error(wrapper.impl_->ssl.get(), ret))));
   }
+  if (session_cache) {
+    session_cache->impl_->AccountHandshake(wrapper.impl_->ssl.get());
+  }
   return wrapper;
 }
 
 TlsWrapper TlsWrapper::StartTlsServer(
     Socket&& socket, const crypto::Certificate& cert,
     const crypto::PrivateKey& key, Deadline deadline,
-    const std::vector<crypto::Certificate>& cert_authorities) {
+    const std::vector<crypto::Certificate>& cert_authorities,
+    KernelTlsMode kernel_tls, TlsServerSessionCache* session_cache) {
   auto ssl_ctx = MakeSslCtx();
+  if (session_cache) session_cache->impl_->SetUp(ssl_ctx.get());
 
   if (!cert_authorities.empty()) {
     auto* store = SSL_CTX_get_cert_store(ssl_ctx.get());
@@ -420,18 +557,34 @@ TlsWrapper TlsWrapper::StartTlsServer(
   }
 
   TlsWrapper wrapper{std::move(socket)};
-  wrapper.impl_->SetUp(std::move(ssl_ctx));
-  wrapper.impl_->bio_data.current_deadline = deadline;
+  auto& impl = *wrapper.impl_;
+  impl.SetUp(std::move(ssl_ctx), kernel_tls);
+  impl.bio_data.current_deadline = deadline;
+
+  auto ret = SSL_accept(impl.ssl.get());
+  while (1 != ret) {
+    const int ssl_error = SSL_get_error(impl.ssl.get(), ret);
+    if (impl.uses_openssl_socket_bio &&
+        (ssl_error == SSL_ERROR_WANT_READ ||
+         ssl_error == SSL_ERROR_WANT_WRITE) &&
+        impl.WaitSocketBio(ssl_error, 0)) {
+      ret = SSL_accept(impl.ssl.get());
+      continue;
+    }
 
-  auto ret = SSL_accept(wrapper.impl_->ssl.get());
-  if (1 != ret) {
-    if (wrapper.impl_->bio_data.last_exception) {
-      std::rethrow_exception(wrapper.impl_->bio_data.last_exception);
+    if (impl.bio_data.last_exception) {
+      std::rethrow_exception(impl.bio_data.last_exception);
     }
 
-    throw TlsException(crypto::FormatSslError(
-        fmt::format("Failed to set up server TLS wrapper ({})",
-                    SSL_get_error(wrapper.impl_->ssl.get(), ret))));
+    throw TlsException(crypto::FormatSslError(fmt::format(
+        "Failed to set up server TLS wrapper ({})", ssl_error)));
+  }
+
+  if (session_cache) session_cache->impl_->AccountHandshake(impl.ssl.get());
+  if (impl.uses_openssl_socket_bio) {
+    impl.is_kernel_tls_send = HasKernelTlsSend(impl.ssl.get());
+    LOG_TRACE() << "Kernel TLS send offload is "
+                << (impl.is_kernel_tls_send ? "enabled" : "unavailable");
   }
 
   return wrapper;
@@ -476,12 +629,24 @@ size_t TlsWrapper::RecvAll(void* buf, size_t len, Deadline deadline) {
 
 size_t TlsWrapper::SendAll(const void* buf, size_t len, Deadline deadline) {
   impl_->CheckAlive();
+  if (impl_->is_kernel_tls_send) {
+    return impl_->bio_data.socket.SendAll(buf, len, deadline);
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   return impl_->PerformSslIo(&SSL_write_ex, const_cast<void*>(buf), len,
                              impl::TransferMode::kWhole, InterruptAction::kFail,
                              deadline, "SendAll");
 }
 
+size_t TlsWrapper::SendAll(const IoData* list, std::size_t list_size,
+                           Deadline deadline) {
+  impl_->CheckAlive();
+  if (impl_->is_kernel_tls_send) {
+    return impl_->bio_data.socket.SendAll(list, list_size, deadline);
+  }
+  return impl_->SendCoalesced(list, list_size, deadline);
+}
+
 Socket TlsWrapper::StopTls(Deadline deadline) {
   if (impl_->ssl) {
     impl_->is_in_shutdown = true;
@@ -495,6 +660,9 @@ Socket TlsWrapper::StopTls(Deadline deadline) {
           // this is fine
           case SSL_ERROR_WANT_READ:
           case SSL_ERROR_WANT_WRITE:
+            if (impl_->uses_openssl_socket_bio) {
+              impl_->WaitSocketBio(ssl_error, 0);
+            }
             break;
 
           // connection breaking errors
@@ -519,6 +687,10 @@ Socket TlsWrapper::StopTls(Deadline deadline) {
   return std::move(impl_->bio_data.socket);
 }
 
+bool TlsWrapper::IsKernelTlsSendEnabled() const {
+  return impl_->is_kernel_tls_send;
+}
+
 int TlsWrapper::GetRawFd() { return impl_->bio_data.socket.Fd(); }
 
 }  // namespace engine::io
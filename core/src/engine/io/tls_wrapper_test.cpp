@@ -4,6 +4,7 @@
 #include <sys/socket.h>
 
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -572,4 +573,187 @@ UTEST(TlsWrapper, PeerDisconnect) {
   server_task.Get();
 }
 
+UTEST_MT(TlsWrapper, VectoredSend, 2) {
+  const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  TcpListener tcp_listener;
+  auto [server, client] = tcp_listener.MakeSocketPair(test_deadline);
+
+  // Buffers that fill a record only together, that span several records
+  // and that are sent as whole records without copying
+  const std::string header(100, 'h');
+  const std::string body(40000, 'b');
+  const std::string tail(16384, 't');
+  const std::string expected = header + body + tail + header;
+
+  auto server_task = engine::AsyncNoSpan(
+      [&, test_deadline](auto&& server) {
+        auto tls_server = io::TlsWrapper::StartTlsServer(
+            std::forward<decltype(server)>(server),
+            crypto::Certificate::LoadFromString(cert),
+            crypto::PrivateKey::LoadFromString(key), test_deadline);
+        EXPECT_EQ(expected.size(),
+                  tls_server.WriteAll({{header.data(), header.size()},
+                                       {body.data(), body.size()},
+                                       {tail.data(), tail.size()},
+                                       {header.data(), header.size()}},
+                                      test_deadline));
+      },
+      std::move(server));
+
+  auto tls_client =
+      io::TlsWrapper::StartTlsClient(std::move(client), {}, test_deadline);
+  std::string received(expected.size(), '\0');
+  EXPECT_EQ(expected.size(),
+            tls_client.RecvAll(received.data(), received.size(),
+                               test_deadline));
+  EXPECT_EQ(expected, received);
+
+  server_task.Get();
+}
+
+UTEST_MT(TlsWrapper, KernelTls, 2) {
+  const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  TcpListener tcp_listener;
+  auto [server, client] = tcp_listener.MakeSocketPair(test_deadline);
+
+  const std::string body(20000, 'b');
+
+  auto server_task = engine::AsyncNoSpan(
+      [&, test_deadline](auto&& server) {
+        // Falls back to userspace TLS if kTLS is not available
+        auto tls_server = io::TlsWrapper::StartTlsServer(
+            std::forward<decltype(server)>(server),
+            crypto::Certificate::LoadFromString(cert),
+            crypto::PrivateKey::LoadFromString(key), test_deadline, {},
+            io::KernelTlsMode::kIfAvailable);
+        LOG_INFO() << "Kernel TLS send: "
+                   << tls_server.IsKernelTlsSendEnabled();
+
+        char c = 0;
+        EXPECT_EQ(1, tls_server.RecvSome(&c, 1, test_deadline));
+        EXPECT_EQ('1', c);
+        EXPECT_EQ(1, tls_server.SendAll("2", 1, test_deadline));
+        EXPECT_EQ(body.size() + 1,
+                  tls_server.WriteAll(
+                      {{body.data(), body.size()}, {"3", 1}}, test_deadline));
+      },
+      std::move(server));
+
+  auto tls_client =
+      io::TlsWrapper::StartTlsClient(std::move(client), {}, test_deadline);
+  EXPECT_FALSE(tls_client.IsKernelTlsSendEnabled());
+  EXPECT_EQ(1, tls_client.SendAll("1", 1, test_deadline));
+  char c = 0;
+  EXPECT_EQ(1, tls_client.RecvSome(&c, 1, test_deadline));
+  EXPECT_EQ('2', c);
+  std::string received(body.size() + 1, '\0');
+  EXPECT_EQ(received.size(),
+            tls_client.RecvAll(received.data(), received.size(),
+                               test_deadline));
+  EXPECT_EQ(body + "3", received);
+
+  server_task.Get();
+}
+
+UTEST_MT(TlsWrapper, SessionResumption, 2) {
+  const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  TcpListener tcp_listener;
+  io::TlsServerSessionCache server_cache(100, std::chrono::seconds{60});
+  io::TlsClientSessionCache client_cache(100);
+
+  for (int i = 0; i < 3; ++i) {
+    auto [server, client] = tcp_listener.MakeSocketPair(test_deadline);
+
+    auto server_task = engine::AsyncNoSpan(
+        [&server_cache, test_deadline](auto&& server) {
+          auto tls_server = io::TlsWrapper::StartTlsServer(
+              std::forward<decltype(server)>(server),
+              crypto::Certificate::LoadFromString(cert),
+              crypto::PrivateKey::LoadFromString(key), test_deadline, {},
+              io::KernelTlsMode::kDisabled, &server_cache);
+          EXPECT_EQ(1, tls_server.SendAll("1", 1, test_deadline));
+          char c = 0;
+          EXPECT_EQ(1, tls_server.RecvSome(&c, 1, test_deadline));
+        },
+        std::move(server));
+
+    auto tls_client = io::TlsWrapper::StartTlsClient(
+        std::move(client), {}, test_deadline, &client_cache);
+    char c = 0;
+    // TLS 1.3 session tickets are received along with the data
+    EXPECT_EQ(1, tls_client.RecvSome(&c, 1, test_deadline));
+    EXPECT_EQ(1, tls_client.SendAll("2", 1, test_deadline));
+    server_task.Get();
+  }
+
+  EXPECT_EQ(1, server_cache.GetStatistics().full_handshakes);
+  EXPECT_EQ(2, server_cache.GetStatistics().resumed_handshakes);
+  EXPECT_EQ(1, client_cache.GetStatistics().full_handshakes);
+  EXPECT_EQ(2, client_cache.GetStatistics().resumed_handshakes);
+}
+
+UTEST_MT(TlsWrapper, SessionTicketKeysRotation, 2) {
+  const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  TcpListener tcp_listener;
+  io::TlsServerSessionCache server_cache(100, std::chrono::seconds{60});
+  io::TlsClientSessionCache client_cache(100);
+
+  const auto handshake = [&] {
+    auto [server, client] = tcp_listener.MakeSocketPair(test_deadline);
+
+    auto server_task = engine::AsyncNoSpan(
+        [&server_cache, test_deadline](auto&& server) {
+          auto tls_server = io::TlsWrapper::StartTlsServer(
+              std::forward<decltype(server)>(server),
+              crypto::Certificate::LoadFromString(cert),
+              crypto::PrivateKey::LoadFromString(key), test_deadline, {},
+              io::KernelTlsMode::kDisabled, &server_cache);
+          EXPECT_EQ(1, tls_server.SendAll("1", 1, test_deadline));
+          char c = 0;
+          EXPECT_EQ(1, tls_server.RecvSome(&c, 1, test_deadline));
+        },
+        std::move(server));
+
+    auto tls_client = io::TlsWrapper::StartTlsClient(
+        std::move(client), {}, test_deadline, &client_cache);
+    char c = 0;
+    EXPECT_EQ(1, tls_client.RecvSome(&c, 1, test_deadline));
+    EXPECT_EQ(1, tls_client.SendAll("2", 1, test_deadline));
+    server_task.Get();
+  };
+
+  server_cache.SetTicketKeys({std::string(80, 'a')});
+  handshake();
+  EXPECT_EQ(1, server_cache.GetStatistics().full_handshakes);
+
+  // The ticket issued with the previous key is still accepted
+  server_cache.SetTicketKeys({std::string(80, 'b')});
+  handshake();
+  EXPECT_EQ(1, server_cache.GetStatistics().resumed_handshakes);
+
+  server_cache.SetTicketKeys({std::string(80, 'c')});
+  handshake();
+  EXPECT_EQ(2, server_cache.GetStatistics().resumed_handshakes);
+
+  // After one more rotation the key that issued the last ticket is dropped
+  server_cache.SetTicketKeys({std::string(80, 'd')});
+  server_cache.SetTicketKeys({std::string(80, 'e')});
+  handshake();
+  EXPECT_EQ(2, server_cache.GetStatistics().full_handshakes);
+  EXPECT_EQ(2, server_cache.GetStatistics().resumed_handshakes);
+}
+
+UTEST(TlsWrapper, InvalidSessionTicketKeys) {
+  io::TlsServerSessionCache server_cache(100, std::chrono::seconds{60});
+  UEXPECT_THROW(server_cache.SetTicketKeys({}), io::TlsException);
+  UEXPECT_THROW(server_cache.SetTicketKeys({std::string(48, 'k')}),
+                io::TlsException);
+  UEXPECT_NO_THROW(server_cache.SetTicketKeys(
+      {std::string(80, 'k'), std::string(80, 'o')}));
+}
+
 USERVER_NAMESPACE_END
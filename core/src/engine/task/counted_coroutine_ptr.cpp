@@ -10,7 +10,9 @@ namespace engine::impl {
 
 CountedCoroutinePtr::CountedCoroutinePtr(CoroPool::CoroutinePtr coro,
                                          TaskProcessor& task_processor)
-    : coro_(std::move(coro)), token_(task_processor.GetTaskCounter()) {}
+    : coro_(std::move(coro)),
+      token_(task_processor.GetTaskCounter()),
+      task_processor_(&task_processor) {}
 
 CountedCoroutinePtr::CoroPool::Coroutine& CountedCoroutinePtr::operator*() {
   UASSERT(coro_);
@@ -18,7 +20,15 @@ CountedCoroutinePtr::CoroPool::Coroutine& CountedCoroutinePtr::operator*() {
 }
 
 void CountedCoroutinePtr::ReturnToPool() && {
-  if (coro_) std::move(*coro_).ReturnToPool();
+  if (coro_) {
+    UASSERT(task_processor_);
+    if (auto* stack_usage = task_processor_->GetStackUsageHistogram()) {
+      constexpr double kBytesInKb = 1024;
+      stack_usage->Account(coro::MeasureStackUsage(coro_->GetStack()) /
+                           kBytesInKb);
+    }
+    std::move(*coro_).ReturnToPool();
+  }
   token_ = std::nullopt;
 }
 
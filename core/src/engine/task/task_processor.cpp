@@ -45,6 +45,10 @@ std::vector<std::function<void()>>& ThreadStartedHooks() {
   return thread_started_hooks;
 }
 
+// Stacks are page-granular and the default stack size is 256KiB
+constexpr double kStackUsageBoundsKb[] = {16,  24,  32,  48,  64,  96,  128,
+                                          192, 256, 384, 512, 768, 1024};
+
 void EmitMagicNanosleep() {
   // If we're ptrace'd (e.g. by strace), the magic syscall tells a tracer
   // that all startup stuff of the current thread is done.
@@ -72,6 +76,9 @@ TaskProcessor::TaskProcessor(TaskProcessorConfig config,
       config_(std::move(config)),
       pools_(std::move(pools)) {
   utils::impl::FinishStaticRegistration();
+  if (pools_->GetCoroPool().IsStackUsageProfilingEnabled()) {
+    stack_usage_kb_.emplace(kStackUsageBoundsKb);
+  }
   try {
     LOG_INFO() << "creating task_processor " << Name() << " "
                << "worker_threads=" << config_.worker_threads
@@ -222,6 +229,16 @@ std::vector<std::uint8_t> TaskProcessor::CollectCurrentLoadPct() const {
   return cpu_stats_storage_->CollectCurrentLoadPct();
 }
 
+utils::statistics::Histogram*
+TaskProcessor::GetStackUsageHistogram() noexcept {
+  return stack_usage_kb_ ? &*stack_usage_kb_ : nullptr;
+}
+
+const utils::statistics::Histogram* TaskProcessor::GetStackUsageHistogram()
+    const noexcept {
+  return stack_usage_kb_ ? &*stack_usage_kb_ : nullptr;
+}
+
 void RegisterThreadStartedHook(std::function<void()> func) {
   utils::impl::AssertStaticRegistrationAllowed(
       "Calling engine::RegisterThreadStartedHook()");
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -17,6 +18,7 @@
 
 #include <userver/engine/impl/detached_tasks_sync_block.hpp>
 #include <userver/logging/logger.hpp>
+#include <userver/utils/statistics/histogram.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -77,6 +79,11 @@ class TaskProcessor final {
 
   std::vector<std::uint8_t> CollectCurrentLoadPct() const;
 
+  /// Stack usage of finished tasks in KiB, nullptr if the profiling is
+  /// disabled in coro_pool config
+  utils::statistics::Histogram* GetStackUsageHistogram() noexcept;
+  const utils::statistics::Histogram* GetStackUsageHistogram() const noexcept;
+
  private:
   void Cleanup() noexcept;
 
@@ -115,6 +122,8 @@ class TaskProcessor final {
 
   std::unique_ptr<utils::statistics::ThreadPoolCpuStatsStorage>
       cpu_stats_storage_{nullptr};
+
+  std::optional<utils::statistics::Histogram> stack_usage_kb_;
 };
 
 /// Register a function that runs on all threads on task processor creation.
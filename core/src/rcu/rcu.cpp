@@ -11,6 +11,11 @@ uint64_t GetNextEpoch() noexcept {
   return counter++;
 }
 
+std::size_t GetNextEpochReaderSlot() noexcept {
+  static std::atomic<std::size_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
 }  // namespace rcu::impl
 
 USERVER_NAMESPACE_END
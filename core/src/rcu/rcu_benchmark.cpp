@@ -13,10 +13,17 @@
 
 USERVER_NAMESPACE_BEGIN
 
-template <int VariableCount>
+namespace {
+
+using HazardPointerTraits = rcu::DefaultRcuTraits<std::uint64_t>;
+using EpochTraits = rcu::EpochRcuTraits<std::uint64_t>;
+
+}  // namespace
+
+template <int VariableCount, typename RcuTraits>
 void rcu_read(benchmark::State& state) {
   engine::RunStandalone([&] {
-    rcu::Variable<std::uint64_t> vars[VariableCount];
+    rcu::Variable<std::uint64_t, RcuTraits> vars[VariableCount];
     {
       std::uint64_t i = 0;
       for (auto& var : vars) {
@@ -33,14 +40,17 @@ void rcu_read(benchmark::State& state) {
     }
   });
 }
-BENCHMARK_TEMPLATE(rcu_read, 1);
-BENCHMARK_TEMPLATE(rcu_read, 2);
-BENCHMARK_TEMPLATE(rcu_read, 4);
-
-template <int VariableCount>
+BENCHMARK_TEMPLATE(rcu_read, 1, HazardPointerTraits);
+BENCHMARK_TEMPLATE(rcu_read, 2, HazardPointerTraits);
+BENCHMARK_TEMPLATE(rcu_read, 4, HazardPointerTraits);
+BENCHMARK_TEMPLATE(rcu_read, 1, EpochTraits);
+BENCHMARK_TEMPLATE(rcu_read, 2, EpochTraits);
+BENCHMARK_TEMPLATE(rcu_read, 4, EpochTraits);
+
+template <int VariableCount, typename RcuTraits>
 void rcu_write(benchmark::State& state) {
   engine::RunStandalone([&] {
-    rcu::Variable<std::uint64_t> vars[VariableCount];
+    rcu::Variable<std::uint64_t, RcuTraits> vars[VariableCount];
 
     std::uint64_t i = 0;
     for ([[maybe_unused]] auto _ : state) {
@@ -49,10 +59,14 @@ void rcu_write(benchmark::State& state) {
     }
   });
 }
-BENCHMARK_TEMPLATE(rcu_write, 1);
-BENCHMARK_TEMPLATE(rcu_write, 2);
-BENCHMARK_TEMPLATE(rcu_write, 4);
-
+BENCHMARK_TEMPLATE(rcu_write, 1, HazardPointerTraits);
+BENCHMARK_TEMPLATE(rcu_write, 2, HazardPointerTraits);
+BENCHMARK_TEMPLATE(rcu_write, 4, HazardPointerTraits);
+BENCHMARK_TEMPLATE(rcu_write, 1, EpochTraits);
+BENCHMARK_TEMPLATE(rcu_write, 2, EpochTraits);
+BENCHMARK_TEMPLATE(rcu_write, 4, EpochTraits);
+
+template <typename RcuTraits>
 void rcu_contention(benchmark::State& state) {
   const std::size_t readers_count = state.range(0);
   const std::size_t writers_count = state.range(1);
@@ -63,14 +77,14 @@ void rcu_contention(benchmark::State& state) {
 
   engine::RunStandalone(thread_count, [&] {
     std::atomic<bool> run{true};
-    rcu::Variable<std::uint64_t> var{0};
+    rcu::Variable<std::uint64_t, RcuTraits> var{0};
 
     std::vector<engine::TaskWithResult<void>> tasks;
     tasks.reserve(readers_count - 1 + writers_count);
 
     for (std::size_t j = 0; j < readers_count - 1; j++) {
       tasks.push_back(utils::Async("reader", [&] {
-        std::vector<rcu::ReadablePtr<std::uint64_t>> pointers;
+        std::vector<rcu::ReadablePtr<std::uint64_t, RcuTraits>> pointers;
         pointers.reserve(kept_readable_pointers_count);
 
         while (run) {
@@ -94,7 +108,7 @@ void rcu_contention(benchmark::State& state) {
     }
 
     {
-      std::queue<rcu::ReadablePtr<std::uint64_t>> pointers;
+      std::queue<rcu::ReadablePtr<std::uint64_t, RcuTraits>> pointers;
       for (std::size_t i = 0; i < kept_readable_pointers_count; i++) {
         pointers.push(var.Read());
       }
@@ -112,10 +126,76 @@ void rcu_contention(benchmark::State& state) {
     }
   });
 }
-BENCHMARK(rcu_contention)
+BENCHMARK_TEMPLATE(rcu_contention, HazardPointerTraits)
     ->RangeMultiplier(2)
     ->Ranges({{1, 16}, {0, 1}, {1, 4}})
     ->Ranges({{2048, 2048}, {0, 1}, {1, 4}});
+BENCHMARK_TEMPLATE(rcu_contention, EpochTraits)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 16}, {0, 1}, {1, 4}})
+    ->Ranges({{2048, 2048}, {0, 1}, {1, 4}});
+
+// Every worker thread reads, and some of them also write the variable
+// several times per read batch. Reports the throughput of both.
+template <typename RcuTraits>
+void rcu_many_threads(benchmark::State& state) {
+  const std::size_t thread_count = state.range(0);
+  const std::size_t writers_count = state.range(1);
+
+  engine::RunStandalone(thread_count, [&] {
+    std::atomic<bool> run{true};
+    std::atomic<std::uint64_t> writes{0};
+    rcu::Variable<std::uint64_t, RcuTraits> var{0};
+
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(thread_count - 1 + writers_count);
+
+    for (std::size_t i = 0; i < thread_count - 1; i++) {
+      tasks.push_back(utils::Async("reader", [&] {
+        while (run) {
+          for (int j = 0; j < 100; ++j) {
+            auto reader = var.Read();
+            benchmark::DoNotOptimize(reader);
+          }
+          engine::Yield();
+        }
+      }));
+    }
+
+    for (std::size_t i = 0; i < writers_count; i++) {
+      tasks.push_back(utils::Async("writer", [&] {
+        std::uint64_t value = 0;
+        while (run) {
+          var.Assign(++value);
+          writes.fetch_add(1, std::memory_order_relaxed);
+          engine::Yield();
+        }
+      }));
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+      auto reader = var.Read();
+      benchmark::DoNotOptimize(reader);
+    }
+
+    run = false;
+    for (auto& task : tasks) {
+      task.Get();
+    }
+    state.counters["writes"] =
+        benchmark::Counter(writes.load(), benchmark::Counter::kIsRate);
+  });
+}
+BENCHMARK_TEMPLATE(rcu_many_threads, HazardPointerTraits)
+    ->Args({64, 1})
+    ->Args({64, 4})
+    ->Args({128, 4})
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(rcu_many_threads, EpochTraits)
+    ->Args({64, 1})
+    ->Args({64, 4})
+    ->Args({128, 4})
+    ->UseRealTime();
 
 void rcu_of_shared_ptr(benchmark::State& state) {
   const std::size_t readers_count = state.range(0);
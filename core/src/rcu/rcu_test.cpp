@@ -164,6 +164,36 @@ UTEST(Rcu, Lifetime) {
   EXPECT_EQ(1, Counted::counter);
 }
 
+UTEST(Rcu, EpochLifetime) {
+  using Counted = Counted<struct EpochLifetimeTag>;
+  {
+    rcu::Variable<Counted, rcu::EpochRcuTraits<Counted>> ptr;
+    EXPECT_EQ(1, Counted::counter);
+
+    {
+      auto reader = ptr.Read();
+      auto writer = ptr.StartWrite();
+      writer->value = 10;
+      writer.Commit();
+      engine::Yield();
+      EXPECT_EQ(2, Counted::counter);
+      EXPECT_EQ(1, reader->value);
+
+      auto reader_copy = reader;
+      EXPECT_EQ(10, reader_copy->value);
+    }
+    ptr.Cleanup();
+    engine::Yield();
+    EXPECT_EQ(1, Counted::counter);
+
+    // Without readers the old value is freed right away
+    ptr.Emplace();
+    engine::Yield();
+    EXPECT_EQ(1, Counted::counter);
+  }
+  EXPECT_EQ(0, Counted::counter);
+}
+
 UTEST(Rcu, ReadablePtrMoveAssign) {
   using Counted = Counted<struct MoveAssignTag>;
 
@@ -413,14 +443,13 @@ constexpr std::size_t kSleeperTask = 1;
 constexpr std::size_t kTotalTasks =
     kReadablePtrPingPongTasks + kReadingTasks + kWritingTasks + kSleeperTask;
 
-}  // namespace
-
-UTEST_MT(Rcu, TortureTest, kTotalTasks) {
-  rcu::Variable<CleaningUpInt> data{1};
+template <typename RcuTraits>
+void RunTortureTest() {
+  rcu::Variable<CleaningUpInt, RcuTraits> data{1};
   std::atomic<bool> keep_running{true};
 
   engine::Mutex ping_pong_mutex;
-  rcu::ReadablePtr<CleaningUpInt> ptr = data.Read();
+  rcu::ReadablePtr<CleaningUpInt, RcuTraits> ptr = data.Read();
 
   std::vector<engine::TaskWithResult<void>> tasks;
 
@@ -457,6 +486,16 @@ UTEST_MT(Rcu, TortureTest, kTotalTasks) {
   keep_running = false;
 }
 
+}  // namespace
+
+UTEST_MT(Rcu, TortureTest, kTotalTasks) {
+  RunTortureTest<rcu::DefaultRcuTraits<CleaningUpInt>>();
+}
+
+UTEST_MT(Rcu, EpochTortureTest, kTotalTasks) {
+  RunTortureTest<rcu::EpochRcuTraits<CleaningUpInt>>();
+}
+
 UTEST(Rcu, WritablePtrUnlocksInCommit) {
   rcu::Variable<int> var{1};
 
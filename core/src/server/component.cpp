@@ -36,9 +36,17 @@ Server::Server(const components::ComponentConfig& component_config,
       "http.handler.total", [this](utils::statistics::Writer& writer) {
         return server_->WriteTotalHandlerStatistics(writer);
       });
+
+  auto* secdist =
+      component_context.FindComponentOptional<components::Secdist>();
+  if (secdist) {
+    secdist_subscriber_ = secdist->GetStorage().UpdateAndListen(
+        this, kName, &Server::OnSecdistUpdate);
+  }
 }
 
 Server::~Server() {
+  secdist_subscriber_.Unsubscribe();
   server_statistics_holder_.Unregister();
   handler_statistics_holder_.Unregister();
 }
@@ -63,6 +71,11 @@ void Server::AddHandler(const server::handlers::HttpHandlerBase& handler,
   server_->AddHandler(handler, task_processor);
 }
 
+void Server::OnSecdistUpdate(
+    const storages::secdist::SecdistConfig& secdist) {
+  server_->UpdateTlsTicketKeys(secdist);
+}
+
 void Server::WriteStatistics(utils::statistics::Writer& writer) {
   server_->WriteMonitorData(writer);
 }
@@ -124,6 +137,21 @@ properties:
                     private-key-passphrase-name:
                         type: string
                         description: passphrase name located in secdist
+                    kernel-tls:
+                        type: boolean
+                        description: offload encryption of responses to the kernel (kTLS) if available
+                        defaultDescription: false
+                    session-cache-size:
+                        type: integer
+                        description: max count of TLS sessions cached by id, enables session resumption by id and by tickets if not zero
+                        defaultDescription: 0
+                    session-timeout:
+                        type: integer
+                        description: lifetime in seconds of resumable TLS sessions and tickets
+                        defaultDescription: 3600
+                    session-ticket-keys-name:
+                        type: string
+                        description: name of the TLS session ticket keys located in secdist, the keys are updated along with the secdist
             handler-defaults:
                 type: object
                 description: handler defaults options
@@ -174,6 +202,13 @@ properties:
                         type: integer
                         description: timeout in seconds to drop connection if there's not data received from it
                         defaultDescription: 600
+                    request_parser:
+                        type: string
+                        description: "HTTP request parser: 'http_parser' or 'simd' that scans the input in 16 byte blocks and copies headers less"
+                        defaultDescription: http_parser
+                        enum:
+                          - http_parser
+                          - simd
             shards:
                 type: integer
                 description: how many concurrent tasks harvest data from a single socket; do not set if not sure what it is doing
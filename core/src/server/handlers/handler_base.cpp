@@ -107,6 +107,12 @@ properties:
         type: boolean
         description: TODO
         defaultDescription: false
+    request-body-stream:
+        type: boolean
+        description: |
+            receive the request body while the handler is running, the body is
+            available via server::http::HttpRequest::GetRequestBodyStream()
+        defaultDescription: false
     monitor-handler:
         type: boolean
         description: overrides the in-code `is_monitor` flag that makes the handler run either on 'server.listener' or on 'server.listener-monitor'
@@ -774,6 +774,29 @@ void HttpHandlerBase::ReportMalformedRequest(
   }
 }
 
+void HttpHandlerBase::ReportThrottledRequest(
+    request::RequestBase& request) const {
+  try {
+    UASSERT(dynamic_cast<http::HttpRequestImpl*>(&request));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    auto& http_request_impl = static_cast<http::HttpRequestImpl&>(request);
+    const http::HttpRequest http_request(http_request_impl);
+    auto& response = http_request.GetHttpResponse();
+    response.SetStatus(http::HttpStatus::kTooManyRequests);
+
+    const HttpHandlerStatisticsScope stats_scope(
+        *handler_statistics_, http_request.GetMethod(), response);
+    handler_statistics_->ForMethod(http_request.GetMethod())
+        .IncrementRateLimitReached();
+
+    SetFormattedErrorResponse(
+        response, GetFormattedExternalErrorBody(CustomHandlerException{
+                      HandlerErrorCode::kTooManyRequests}));
+  } catch (const std::exception& ex) {
+    LOG_ERROR() << "unable to handle throttled request: " << ex;
+  }
+}
+
 const std::string& HttpHandlerBase::HandlerName() const {
   return handler_name_;
 }
@@ -875,6 +898,8 @@ void HttpHandlerBase::CheckRatelimit(
 void HttpHandlerBase::DecompressRequestBody(
     http::HttpRequest& http_request) const {
   if (!http_request.IsBodyCompressed()) return;
+  // Streamed bodies are passed to the handler as-is
+  if (http_request.IsRequestBodyStreamed()) return;
 
   const auto& content_encoding = http_request.GetHeader(
       USERVER_NAMESPACE::http::headers::kContentEncoding);
@@ -52,9 +52,9 @@ std::string HttpHandlerStatic::HandleRequestThrow(
   const auto file = storage_.TryGetFile(request.GetRequestPath());
   if (file) {
     const auto config = config_.GetSnapshot();
-    request.GetHttpResponse().SetContentType(
-        config[kContentTypeMap][file->extension]);
-    return file->data;
+    auto& response = request.GetHttpResponse();
+    response.SetContentType(config[kContentTypeMap][file->extension]);
+    return response.ApplyRanges(file->data);
   }
   request.GetResponse().SetStatusNotFound();
   return "File not found";
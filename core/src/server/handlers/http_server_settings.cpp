@@ -33,6 +33,26 @@ const dynamic_config::Key<CcCustomStatus> kCcCustomStatus{
 const dynamic_config::Key<bool> kStreamApiEnabled{
     "USERVER_HANDLER_STREAM_API_ENABLED", false};
 
+LoadSheddingConfig Parse(const formats::json::Value& value,
+                         formats::parse::To<LoadSheddingConfig>) {
+  LoadSheddingConfig result;
+  result.enabled = value["enabled"].As<bool>(result.enabled);
+  result.deadline_aware =
+      value["deadline-aware"].As<bool>(result.deadline_aware);
+  result.target_delay = std::chrono::milliseconds{
+      value["target-delay-ms"].As<std::chrono::milliseconds::rep>(
+          result.target_delay.count())};
+  result.interval = std::chrono::milliseconds{
+      value["interval-ms"].As<std::chrono::milliseconds::rep>(
+          result.interval.count())};
+  return result;
+}
+
+const dynamic_config::Key<LoadSheddingConfig> kLoadShedding{
+    "USERVER_LOAD_SHEDDING",
+    dynamic_config::DefaultAsJsonString{"{}"},
+};
+
 }  // namespace server::handlers
 
 USERVER_NAMESPACE_END
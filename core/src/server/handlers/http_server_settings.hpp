@@ -27,6 +27,18 @@ extern const dynamic_config::Key<CcCustomStatus> kCcCustomStatus;
 
 extern const dynamic_config::Key<bool> kStreamApiEnabled;
 
+struct LoadSheddingConfig final {
+  bool enabled{false};
+  bool deadline_aware{true};
+  std::chrono::milliseconds target_delay{5};
+  std::chrono::milliseconds interval{100};
+};
+
+LoadSheddingConfig Parse(const formats::json::Value& value,
+                         formats::parse::To<LoadSheddingConfig>);
+
+extern const dynamic_config::Key<LoadSheddingConfig> kLoadShedding;
+
 }  // namespace server::handlers
 
 USERVER_NAMESPACE_END
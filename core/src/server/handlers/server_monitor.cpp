@@ -64,7 +64,24 @@ ServerMonitor::ServerMonitor(
       statistics_storage_(
           component_context.FindComponent<components::StatisticsStorage>()
               .GetStorage()),
-      common_labels_{config["common-labels"].As<CommonLabels>({})} {}
+      common_labels_{config["common-labels"].As<CommonLabels>({})} {
+  const auto cache_interval =
+      config["prometheus-cache-interval"].As<std::chrono::milliseconds>(0);
+  if (cache_interval.count() > 0) {
+    prometheus_cache_ =
+        std::make_unique<utils::statistics::PrometheusFormatCache>(
+            cache_interval);
+    prometheus_cache_statistics_holder_ = statistics_storage_.RegisterWriter(
+        "server-monitor.prometheus-cache",
+        [this](utils::statistics::Writer& writer) {
+          writer = *prometheus_cache_;
+        });
+  }
+}
+
+ServerMonitor::~ServerMonitor() {
+  prometheus_cache_statistics_holder_.Unregister();
+}
 
 std::string ServerMonitor::HandleRequestThrow(const http::HttpRequest& request,
                                               request::RequestContext&) const {
@@ -102,10 +119,18 @@ std::string ServerMonitor::HandleRequestThrow(const http::HttpRequest& request,
                                                  statistics_request);
 
     case StatsFormat::kPrometheus:
+      if (prometheus_cache_) {
+        return prometheus_cache_->ToPrometheusFormat(statistics_storage_,
+                                                     statistics_request);
+      }
       return utils::statistics::ToPrometheusFormat(statistics_storage_,
                                                    statistics_request);
 
     case StatsFormat::kPrometheusUntyped:
+      if (prometheus_cache_) {
+        return prometheus_cache_->ToPrometheusFormatUntyped(
+            statistics_storage_, statistics_request);
+      }
       return utils::statistics::ToPrometheusFormatUntyped(statistics_storage_,
                                                           statistics_request);
 
@@ -153,6 +178,12 @@ properties:
             added to each metric.
         additionalProperties: true
         properties: {}
+    prometheus-cache-interval:
+        type: string
+        description: |
+            reuse the Prometheus output of each metrics writer for this
+            time, 0 disables the caching
+        defaultDescription: 0
   )");
 }
 
@@ -9,13 +9,14 @@
 #include <userver/server/http/http_request.hpp>
 
 #include <server/http/http_request_parser.hpp>
+#include <server/http/http_request_simd_parser.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace server {
 
-inline server::http::HttpRequestParser CreateTestParser(
-    server::http::HttpRequestParser::OnNewRequestCb&& cb) {
+template <typename Parser = server::http::HttpRequestParser>
+Parser CreateTestParser(typename Parser::OnNewRequestCb&& cb) {
   static const server::http::HandlerInfoIndex kTestHandlerInfoIndex;
   static constexpr server::request::HttpRequestConfig kTestRequestConfig{
       /*.max_url_size = */ 8192,
@@ -27,9 +28,8 @@ inline server::http::HttpRequestParser CreateTestParser(
   };
   static server::net::ParserStats test_stats;
   static server::request::ResponseDataAccounter test_accounter;
-  return server::http::HttpRequestParser(kTestHandlerInfoIndex,
-                                         kTestRequestConfig, std::move(cb),
-                                         test_stats, test_accounter);
+  return Parser(kTestHandlerInfoIndex, kTestRequestConfig, std::move(cb),
+                test_stats, test_accounter);
 }
 
 }  // namespace server
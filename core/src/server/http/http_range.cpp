@@ -0,0 +1,112 @@
+#include <userver/server/http/http_range.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+#include <userver/utils/str_icase.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+namespace {
+
+constexpr std::string_view kBytesUnit = "bytes";
+
+std::string_view TrimOws(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+std::optional<std::uint64_t> ParsePosition(std::string_view value) {
+  std::uint64_t result{0};
+  const auto* const end = value.data() + value.size();
+  const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+  if (value.empty() || ec != std::errc{} || ptr != end) return std::nullopt;
+  return result;
+}
+
+void MergeRanges(std::vector<ByteRange>& ranges) {
+  std::sort(ranges.begin(), ranges.end(),
+            [](const ByteRange& lhs, const ByteRange& rhs) {
+              return lhs.first < rhs.first;
+            });
+
+  std::size_t merged = 0;
+  for (std::size_t i = 1; i < ranges.size(); ++i) {
+    auto& current = ranges[merged];
+    // `last + 1` can not overflow, `last` is less than the size
+    if (ranges[i].first <= current.last + 1) {
+      current.last = std::max(current.last, ranges[i].last);
+    } else {
+      ranges[++merged] = ranges[i];
+    }
+  }
+  if (!ranges.empty()) ranges.resize(merged + 1);
+}
+
+}  // namespace
+
+std::optional<std::vector<ByteRange>> ParseByteRanges(std::string_view range,
+                                                      std::uint64_t size) {
+  const auto unit_end = range.find('=');
+  if (unit_end == std::string_view::npos ||
+      !utils::StrIcaseEqual{}(TrimOws(range.substr(0, unit_end)),
+                              kBytesUnit)) {
+    return std::nullopt;
+  }
+  range.remove_prefix(unit_end + 1);
+
+  std::vector<ByteRange> result;
+  std::size_t specs_count = 0;
+  while (!range.empty()) {
+    const auto spec_end = std::min(range.find(','), range.size());
+    const auto spec = TrimOws(range.substr(0, spec_end));
+    range.remove_prefix(std::min(spec_end + 1, range.size()));
+    // Empty list elements are allowed by RFC 9110, section 5.6.1
+    if (spec.empty()) continue;
+
+    if (++specs_count > kMaxByteRanges) return std::nullopt;
+
+    const auto dash = spec.find('-');
+    if (dash == std::string_view::npos) return std::nullopt;
+
+    if (dash == 0) {
+      // suffix-range: the last N bytes
+      const auto suffix_length = ParsePosition(spec.substr(1));
+      if (!suffix_length) return std::nullopt;
+      if (*suffix_length == 0 || size == 0) continue;
+
+      result.push_back({size - std::min(*suffix_length, size), size - 1});
+      continue;
+    }
+
+    const auto first = ParsePosition(spec.substr(0, dash));
+    if (!first) return std::nullopt;
+
+    auto last = std::numeric_limits<std::uint64_t>::max();
+    if (dash + 1 != spec.size()) {
+      const auto parsed_last = ParsePosition(spec.substr(dash + 1));
+      if (!parsed_last || *parsed_last < *first) return std::nullopt;
+      last = *parsed_last;
+    }
+
+    if (*first >= size) continue;
+    result.push_back({*first, std::min(last, size - 1)});
+  }
+
+  if (specs_count == 0) return std::nullopt;
+
+  MergeRanges(result);
+  return result;
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,80 @@
+#include <userver/server/http/http_range.hpp>
+
+#include <string>
+
+#include <fmt/format.h>
+
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using server::http::ByteRange;
+using server::http::ParseByteRanges;
+using Ranges = std::vector<ByteRange>;
+
+}  // namespace
+
+TEST(HttpRange, Sample) {
+  /// [Sample]
+  const auto ranges = ParseByteRanges("bytes=0-99, 200-, -50", 1000);
+  ASSERT_TRUE(ranges);
+  EXPECT_EQ(*ranges,
+            (Ranges{{0, 99}, {200, 999}}));  // `-50` is within `200-`
+  /// [Sample]
+}
+
+TEST(HttpRange, Single) {
+  EXPECT_EQ(ParseByteRanges("bytes=0-0", 10), (Ranges{{0, 0}}));
+  EXPECT_EQ(ParseByteRanges("bytes=2-5", 10), (Ranges{{2, 5}}));
+  EXPECT_EQ(ParseByteRanges("bytes=2-", 10), (Ranges{{2, 9}}));
+  EXPECT_EQ(ParseByteRanges("bytes=2-100", 10), (Ranges{{2, 9}}));
+  EXPECT_EQ(ParseByteRanges("bytes=-3", 10), (Ranges{{7, 9}}));
+  EXPECT_EQ(ParseByteRanges("bytes=-100", 10), (Ranges{{0, 9}}));
+  EXPECT_EQ(ParseByteRanges("BYTES = 1-1", 10), (Ranges{{1, 1}}));
+  EXPECT_EQ(ParseByteRanges("bytes=0-18446744073709551615", 10),
+            (Ranges{{0, 9}}));
+}
+
+TEST(HttpRange, Multiple) {
+  EXPECT_EQ(ParseByteRanges("bytes=5-6,0-1", 10), (Ranges{{0, 1}, {5, 6}}));
+  EXPECT_EQ(ParseByteRanges("bytes=0-1,2-3", 10), (Ranges{{0, 3}}));
+  EXPECT_EQ(ParseByteRanges("bytes=0-5,2-3", 10), (Ranges{{0, 5}}));
+  EXPECT_EQ(ParseByteRanges("bytes=0-1, ,\t-2,", 10),
+            (Ranges{{0, 1}, {8, 9}}));
+}
+
+TEST(HttpRange, Unsatisfiable) {
+  EXPECT_EQ(ParseByteRanges("bytes=10-", 10), Ranges{});
+  EXPECT_EQ(ParseByteRanges("bytes=10-20,30-40", 10), Ranges{});
+  EXPECT_EQ(ParseByteRanges("bytes=-0", 10), Ranges{});
+  EXPECT_EQ(ParseByteRanges("bytes=0-", 0), Ranges{});
+  EXPECT_EQ(ParseByteRanges("bytes=-5", 0), Ranges{});
+
+  EXPECT_EQ(ParseByteRanges("bytes=10-,0-0", 10), (Ranges{{0, 0}}));
+}
+
+TEST(HttpRange, Ignored) {
+  for (const std::string_view range :
+       {"", "bytes", "bytes=", "bytes=,", "items=0-1", "bytes=1",
+        "bytes=a-b", "bytes=1-a", "bytes=5-1", "bytes=-", "bytes=--1",
+        "bytes=+1-2", "bytes=0-1;2-3", "bytes=0-18446744073709551616"}) {
+    EXPECT_EQ(ParseByteRanges(range, 10), std::nullopt) << range;
+  }
+}
+
+TEST(HttpRange, TooManyRanges) {
+  std::string range = "bytes=0-0";
+  for (std::size_t i = 1; i < server::http::kMaxByteRanges; ++i) {
+    range += fmt::format(",{}-{}", i * 2, i * 2);
+  }
+  const auto ranges = ParseByteRanges(range, 1000);
+  ASSERT_TRUE(ranges);
+  EXPECT_EQ(ranges->size(), server::http::kMaxByteRanges);
+
+  range += ",999-999";
+  EXPECT_EQ(ParseByteRanges(range, 1000), std::nullopt);
+}
+
+USERVER_NAMESPACE_END
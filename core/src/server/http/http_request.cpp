@@ -1,5 +1,7 @@
 #include <userver/server/http/http_request.hpp>
 
+#include <stdexcept>
+
 #include <server/http/http_request_impl.hpp>
 #include <userver/engine/io/socket.hpp>
 
@@ -172,6 +174,20 @@ const HttpRequest::CookiesMap& HttpRequest::RequestCookies() const {
   return impl_.GetCookies();
 }
 
+bool HttpRequest::IsRequestBodyStreamed() const {
+  return impl_.GetRequestBodyStream() != nullptr;
+}
+
+RequestBodyStream& HttpRequest::GetRequestBodyStream() const {
+  auto* stream = impl_.GetRequestBodyStream();
+  if (!stream) {
+    throw std::logic_error(
+        "Request body is not streamed, set 'request-body-stream: true' in the "
+        "static config of the handler");
+  }
+  return *stream;
+}
+
 void HttpRequest::SetRequestBody(std::string body) {
   impl_.SetRequestBody(std::move(body));
 }  // namespace server::http
@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include <server/http/http_request_constructor.hpp>
+#include <server/http/http_request_parser.hpp>
+#include <server/http/http_request_simd_parser.hpp>
+#include <userver/engine/run_standalone.hpp>
+
+// This file is built into a separate benchmark binary, see core/CMakeLists.txt.
+// It replaces the global operator new to count the heap allocations.
+
+namespace {
+
+// Counts only between AllocationsCounter construction and Get(), so that
+// the benchmark library and the engine startup are not accounted
+std::atomic<bool> is_counting{false};
+std::atomic<std::uint64_t> allocations_count{0};
+
+void CountAllocation() noexcept {
+  if (is_counting.load(std::memory_order_relaxed)) {
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+// Both the plain and the nothrow forms are replaced to keep the pairs of
+// new/delete consistent
+void* operator new(std::size_t size) {
+  CountAllocation();
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  CountAllocation();
+  return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+class AllocationsCounter final {
+ public:
+  AllocationsCounter() noexcept {
+    allocations_count = 0;
+    is_counting = true;
+  }
+
+  ~AllocationsCounter() { is_counting = false; }
+
+  std::uint64_t Get() const noexcept { return allocations_count.load(); }
+};
+
+void SetAllocationsPerRequest(benchmark::State& state,
+                              std::uint64_t allocations,
+                              std::uint64_t requests) {
+  state.counters["allocs_per_request"] =
+      static_cast<double>(allocations) / static_cast<double>(requests);
+}
+
+// A typical proxied request: a bunch of tracing and forwarding headers,
+// repeated to fill a receive buffer with pipelined requests
+std::string MakeRequests(std::size_t headers_count, std::size_t count) {
+  std::string request =
+      "POST /v1/some/handler?id=12345&lang=en HTTP/1.1\r\n"
+      "Host: service.example.net\r\n"
+      "Content-Type: application/json\r\n"
+      "Content-Length: 26\r\n";
+  for (std::size_t i = 0; i < headers_count; ++i) {
+    request += fmt::format(
+        "X-Proxy-Header-{}: 2b6d9d7a7a4b4f0e8c2b1d0a9f8e7d6c-{}\r\n", i, i);
+  }
+  request += "\r\n{\"key\":\"value\",\"id\":12345}";
+
+  std::string result;
+  for (std::size_t i = 0; i < count; ++i) result += request;
+  return result;
+}
+
+template <typename Parser>
+void http_request_parse_allocations(benchmark::State& state) {
+  constexpr std::size_t kRequestsCount = 16;
+  const auto data = MakeRequests(state.range(0), kRequestsCount);
+
+  engine::RunStandalone([&] {
+    const server::http::HandlerInfoIndex handler_info_index;
+    const server::request::HttpRequestConfig config{};
+    server::net::ParserStats stats;
+    server::request::ResponseDataAccounter accounter;
+    std::size_t parsed = 0;
+    Parser parser(
+        handler_info_index, config,
+        [&parsed](std::shared_ptr<server::request::RequestBase>&& request) {
+          benchmark::DoNotOptimize(request);
+          ++parsed;
+        },
+        stats, accounter,
+        server::http::HttpRequestConstructor::CreateRequestPool());
+
+    const AllocationsCounter counter;
+    for ([[maybe_unused]] auto _ : state) {
+      parser.Parse(data.data(), data.size());
+    }
+    const auto allocations = counter.Get();
+
+    if (parsed != state.iterations() * kRequestsCount) {
+      state.SkipWithError("Not all the requests were parsed");
+      return;
+    }
+    state.SetItemsProcessed(parsed);
+    SetAllocationsPerRequest(state, allocations, parsed);
+  });
+}
+
+// Builds the requests right through the constructor, with the request pool
+// turned off (0) and on (1). Every allocation of the request and of its
+// members is counted, the pool saves only the one of the request object.
+void http_request_construct_allocations(benchmark::State& state) {
+  const bool use_pool = state.range(0);
+  constexpr std::string_view kUrl = "/v1/some/handler?id=12345&lang=en";
+  constexpr std::string_view kBody = R"({"key":"value","id":12345})";
+
+  engine::RunStandalone([&] {
+    const server::http::HandlerInfoIndex handler_info_index;
+    const server::request::HttpRequestConfig config{};
+    server::request::ResponseDataAccounter accounter;
+    const auto request_pool =
+        use_pool ? server::http::HttpRequestConstructor::CreateRequestPool()
+                 : nullptr;
+
+    const AllocationsCounter counter;
+    for ([[maybe_unused]] auto _ : state) {
+      server::http::HttpRequestConstructor constructor{
+          config, handler_info_index, accounter, request_pool};
+      constructor.SetMethod(server::http::HttpMethod::kPost);
+      constructor.SetHttpMajor(1);
+      constructor.SetHttpMinor(1);
+      constructor.AppendUrl(kUrl.data(), kUrl.size());
+      constructor.ParseUrl();
+      constructor.AppendHeader("Host", "service.example.net");
+      constructor.AppendHeader("Content-Type", "application/json");
+      constructor.AppendBody(kBody.data(), kBody.size());
+      benchmark::DoNotOptimize(constructor.Finalize());
+    }
+    const auto allocations = counter.Get();
+
+    state.SetItemsProcessed(state.iterations());
+    SetAllocationsPerRequest(state, allocations, state.iterations());
+  });
+}
+
+}  // namespace
+
+BENCHMARK(http_request_construct_allocations)
+    ->ArgName("pool")
+    ->Arg(0)
+    ->Arg(1);
+
+BENCHMARK_TEMPLATE(http_request_parse_allocations,
+                   server::http::HttpRequestParser)
+    ->RangeMultiplier(4)
+    ->Range(1, 64);
+BENCHMARK_TEMPLATE(http_request_parse_allocations,
+                   server::http::HttpRequestSimdParser)
+    ->RangeMultiplier(4)
+    ->Range(1, 64);
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,53 @@
+#include <userver/server/http/http_request_body_stream.hpp>
+
+#include <userver/engine/task/cancel.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+RequestBodyStream::RequestBodyStream(Queue::Consumer&& consumer)
+    : consumer_(std::move(consumer)) {}
+
+bool RequestBodyStream::ReadChunk(std::string& chunk,
+                                  engine::Deadline deadline) {
+  chunk.clear();
+  if (is_complete_) return false;
+
+  if (!consumer_.Pop(chunk, deadline)) {
+    if (engine::current_task::ShouldCancel()) {
+      throw RequestBodyStreamError(
+          "Task was cancelled while reading the request body");
+    }
+    if (deadline.IsReached()) {
+      throw RequestBodyStreamError(
+          "Deadline expired while reading the request body");
+    }
+    throw RequestBodyStreamError(
+        "Connection was closed before the request body was fully received");
+  }
+
+  // An empty chunk marks the end of the body
+  if (chunk.empty()) {
+    is_complete_ = true;
+    return false;
+  }
+  return true;
+}
+
+std::string RequestBodyStream::ReadAll(engine::Deadline deadline) {
+  std::string result;
+  std::string chunk;
+  while (ReadChunk(chunk, deadline)) {
+    if (result.empty()) {
+      result = std::move(chunk);
+    } else {
+      result += chunk;
+    }
+  }
+  return result;
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
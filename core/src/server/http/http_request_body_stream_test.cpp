@@ -0,0 +1,85 @@
+#include <userver/server/http/http_request_body_stream.hpp>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using Queue = server::http::RequestBodyStream::Queue;
+
+}  // namespace
+
+UTEST(RequestBodyStream, ReadChunks) {
+  auto queue = Queue::Create();
+  server::http::RequestBodyStream stream{queue->GetConsumer()};
+
+  {
+    auto producer = queue->GetProducer();
+    ASSERT_TRUE(producer.Push("first"));
+    ASSERT_TRUE(producer.Push("second"));
+    ASSERT_TRUE(producer.Push(std::string{}));
+  }
+
+  std::string chunk;
+  EXPECT_TRUE(stream.ReadChunk(chunk));
+  EXPECT_EQ(chunk, "first");
+  EXPECT_TRUE(stream.ReadChunk(chunk));
+  EXPECT_EQ(chunk, "second");
+  EXPECT_FALSE(stream.IsComplete());
+
+  EXPECT_FALSE(stream.ReadChunk(chunk));
+  EXPECT_TRUE(chunk.empty());
+  EXPECT_TRUE(stream.IsComplete());
+  EXPECT_FALSE(stream.ReadChunk(chunk));
+}
+
+UTEST(RequestBodyStream, ReadAllWithBackpressure) {
+  auto queue = Queue::Create(8);
+  server::http::RequestBodyStream stream{queue->GetConsumer()};
+
+  auto producer_task = engine::AsyncNoSpan([producer = queue->GetProducer()] {
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_TRUE(producer.Push("abcd"));
+    }
+    ASSERT_TRUE(producer.Push(std::string{}));
+  });
+
+  engine::Yield();
+  EXPECT_FALSE(producer_task.IsFinished());
+
+  std::string expected;
+  for (int i = 0; i < 10; ++i) expected += "abcd";
+  EXPECT_EQ(stream.ReadAll(), expected);
+  producer_task.Get();
+}
+
+UTEST(RequestBodyStream, Incomplete) {
+  auto queue = Queue::Create();
+  server::http::RequestBodyStream stream{queue->GetConsumer()};
+
+  {
+    auto producer = queue->GetProducer();
+    ASSERT_TRUE(producer.Push("partial"));
+  }
+
+  std::string chunk;
+  EXPECT_TRUE(stream.ReadChunk(chunk));
+  UEXPECT_THROW(stream.ReadChunk(chunk), server::http::RequestBodyStreamError);
+  EXPECT_FALSE(stream.IsComplete());
+}
+
+UTEST(RequestBodyStream, Deadline) {
+  auto queue = Queue::Create();
+  server::http::RequestBodyStream stream{queue->GetConsumer()};
+  auto producer = queue->GetProducer();
+
+  std::string chunk;
+  UEXPECT_THROW(stream.ReadChunk(chunk, engine::Deadline::FromDuration(
+                                            std::chrono::milliseconds{10})),
+                server::http::RequestBodyStreamError);
+}
+
+USERVER_NAMESPACE_END
@@ -17,6 +17,19 @@ namespace server::http {
 
 namespace {
 
+// Must be greater than the size of any chunk pushed to the queue
+constexpr std::size_t kBodyStreamQueueSize = 1024 * 1024;
+constexpr std::size_t kMaxBodyStreamChunkSize = kBodyStreamQueueSize / 4;
+
+// Content-Length is sent by the client and is not trusted to allocate the
+// whole body in advance, larger bodies grow as they arrive
+constexpr std::size_t kMaxBodyReserveSize = 64 * 1024;
+
+// The shared_ptr control block allocated along with the request holds
+// a vtable pointer, the reference counters and the allocator, which is
+// a shared_ptr to the pool. Requests that do not fit go to the heap.
+constexpr std::size_t kRequestControlBlockOverhead = 4 * sizeof(void*);
+
 inline void Strip(const char*& begin, const char*& end) {
   while (begin < end && isspace(*begin)) ++begin;
   while (begin < end && isspace(end[-1])) --end;
@@ -39,14 +52,31 @@ void StripDuplicateStartingSlashes(std::string& s) {
   s = s.substr(non_slash_pos - 1);
 }
 
+std::shared_ptr<HttpRequestImpl> MakeRequest(
+    request::ResponseDataAccounter& data_accounter,
+    std::shared_ptr<HttpRequestPool>&& request_pool) {
+  if (!request_pool) return std::make_shared<HttpRequestImpl>(data_accounter);
+
+  // The request and the shared_ptr control block share a pooled slot
+  return std::allocate_shared<HttpRequestImpl>(
+      HttpRequestPoolAllocator<HttpRequestImpl>{std::move(request_pool)},
+      data_accounter);
+}
+
 }  // namespace
 
 HttpRequestConstructor::HttpRequestConstructor(
     Config config, const HandlerInfoIndex& handler_info_index,
-    request::ResponseDataAccounter& data_accounter)
+    request::ResponseDataAccounter& data_accounter,
+    std::shared_ptr<HttpRequestPool> request_pool)
     : config_(config),
       handler_info_index_(handler_info_index),
-      request_(std::make_shared<HttpRequestImpl>(data_accounter)) {}
+      request_(MakeRequest(data_accounter, std::move(request_pool))) {}
+
+std::shared_ptr<HttpRequestPool> HttpRequestConstructor::CreateRequestPool() {
+  return std::make_shared<HttpRequestPool>(sizeof(HttpRequestImpl) +
+                                           kRequestControlBlockOverhead);
+}
 
 void HttpRequestConstructor::SetMethod(HttpMethod method) {
   request_->method_ = method;
@@ -112,6 +142,7 @@ void HttpRequestConstructor::ParseUrl() {
     config_.parse_args_from_body =
         handler_config.request_config.parse_args_from_body;
     if (handler_config.decompress_request) config_.decompress_request = true;
+    is_body_stream_requested_ = handler_config.request_body_stream;
 
     request_->SetTaskProcessor(handler_info->task_processor);
     request_->SetHttpHandler(handler_info->handler);
@@ -156,16 +187,74 @@ void HttpRequestConstructor::AppendHeaderValue(const char* data, size_t size) {
   header_value_.append(data, size);
 }
 
+void HttpRequestConstructor::AppendHeader(std::string_view field,
+                                          std::string_view value) {
+  UASSERT(!header_field_flag_);
+
+  AccountHeadersSize(field.size() + value.size());
+  AccountRequestSize(field.size() + value.size());
+
+  InsertHeader(std::string{field}, std::string{value});
+}
+
 void HttpRequestConstructor::AppendBody(const char* data, size_t size) {
   AccountRequestSize(size);
-  request_->request_body_.append(data, size);
+
+  if (!is_body_streamed_) {
+    request_->request_body_.append(data, size);
+    return;
+  }
+
+  while (size > 0) {
+    const auto chunk_size = std::min(size, kMaxBodyStreamChunkSize);
+    PushBodyChunk(std::string(data, chunk_size));
+    data += chunk_size;
+    size -= chunk_size;
+  }
+}
+
+void HttpRequestConstructor::ReserveBody(size_t size) {
+  if (is_body_streamed_) return;
+  if (size > config_.max_request_size - request_size_) return;
+  request_->request_body_.reserve(std::min(size, kMaxBodyReserveSize));
 }
 
 void HttpRequestConstructor::SetIsFinal(bool is_final) {
   request_->is_final_ = is_final;
 }
 
+std::shared_ptr<request::RequestBase>
+HttpRequestConstructor::StartBodyStream() {
+  UASSERT(!is_body_streamed_);
+  if (!is_body_stream_requested_ || status_ != Status::kOk) return nullptr;
+
+  LOG_TRACE() << "streaming body, method=" << request_->GetMethodStr();
+
+  is_body_streamed_ = true;
+  FinalizeImpl();
+  CheckStatus();
+
+  if (status_ == Status::kOk) {
+    auto queue = RequestBodyStream::Queue::Create(kBodyStreamQueueSize);
+    request_->request_body_stream_.emplace(queue->GetConsumer());
+    body_stream_producer_.emplace(queue->GetProducer());
+  }
+
+  return std::move(request_);  // request_ is left empty
+}
+
+void HttpRequestConstructor::FinishBodyStream(bool is_complete) {
+  UASSERT(is_body_streamed_);
+  if (body_stream_producer_ && is_complete) {
+    // An empty chunk marks the end of the body
+    [[maybe_unused]] const auto pushed =
+        body_stream_producer_->Push(std::string{});
+  }
+  body_stream_producer_.reset();
+}
+
 std::shared_ptr<request::RequestBase> HttpRequestConstructor::Finalize() {
+  UASSERT(!is_body_streamed_);
   LOG_TRACE() << "method=" << request_->GetMethodStr();
 
   FinalizeImpl();
@@ -188,7 +277,7 @@ void HttpRequestConstructor::FinalizeImpl() {
 
   try {
     ParseArgs(parsed_url_);
-    if (config_.parse_args_from_body) {
+    if (config_.parse_args_from_body && !is_body_streamed_) {
       if (!config_.decompress_request || !request_->IsBodyCompressed())
         ParseArgs(request_->request_body_.data(),
                   request_->request_body_.size());
@@ -218,7 +307,7 @@ void HttpRequestConstructor::FinalizeImpl() {
 
   const auto& content_type =
       request_->GetHeader(USERVER_NAMESPACE::http::headers::kContentType);
-  if (IsMultipartFormDataContentType(content_type)) {
+  if (IsMultipartFormDataContentType(content_type) && !is_body_streamed_) {
     if (!ParseMultipartFormData(content_type, request_->RequestBody(),
                                 request_->form_data_args_)) {
       SetStatus(Status::kParseMultipartFormDataError);
@@ -246,9 +335,19 @@ void HttpRequestConstructor::ParseArgs(const char* data, size_t size) {
 void HttpRequestConstructor::AddHeader() {
   UASSERT(header_field_flag_);
 
+  InsertHeader(std::move(header_field_), std::move(header_value_));
+  header_field_.clear();
+  header_value_.clear();
+}
+
+void HttpRequestConstructor::InsertHeader(std::string&& field,
+                                          std::string&& value) {
+  // Trailers of a streamed body arrive after the request was passed to the
+  // handler, they are dropped
+  if (is_body_streamed_) return;
+
   try {
-    request_->headers_.InsertOrAppend(std::move(header_field_),
-                                      std::move(header_value_));
+    request_->headers_.InsertOrAppend(std::move(field), std::move(value));
   } catch (const USERVER_NAMESPACE::http::headers::HeaderMap::
                TooManyHeadersException&) {
     SetStatus(Status::kHeadersTooLarge);
@@ -256,8 +355,6 @@ void HttpRequestConstructor::AddHeader() {
         "HeaderMap reached its maximum capacity, already contains {} headers",
         request_->headers_.size()));
   }
-  header_field_.clear();
-  header_value_.clear();
 }
 
 void HttpRequestConstructor::ParseCookies() {
@@ -304,10 +401,30 @@ void HttpRequestConstructor::ParseCookies() {
   }
 }
 
+void HttpRequestConstructor::PushBodyChunk(std::string&& chunk) {
+  // The handler may finish without reading the whole body, the rest of it is
+  // discarded
+  if (!body_stream_producer_) return;
+
+  if (!body_stream_producer_->Push(std::move(chunk))) {
+    body_stream_producer_.reset();
+  }
+}
+
 void HttpRequestConstructor::SetStatus(HttpRequestConstructor::Status status) {
   status_ = status;
 }
 
+void HttpRequestConstructor::SetError(Status status) {
+  UASSERT(status != Status::kOk);
+  // A malformed request is rejected whatever its route is, while the limits
+  // exceeded before the error are still reported
+  if (status_ == Status::kOk || status_ == Status::kHandlerNotFound ||
+      status_ == Status::kMethodNotAllowed) {
+    SetStatus(status);
+  }
+}
+
 void HttpRequestConstructor::AccountRequestSize(size_t size) {
   request_size_ += size;
   if (request_size_ > config_.max_request_size) {
@@ -316,7 +433,8 @@ void HttpRequestConstructor::AccountRequestSize(size_t size) {
         "request is too large, " + std::to_string(request_size_) + ">" +
         std::to_string(config_.max_request_size) +
         " (enforced by 'max_request_size' handler limit in config.yaml)" +
-        ", url: " + (url_parsed_ ? request_->GetUrl() : "not parsed yet") +
+        ", url: " +
+        (url_parsed_ && request_ ? request_->GetUrl() : "not parsed yet") +
         ", added size " + std::to_string(size));
   }
 }
@@ -341,7 +459,8 @@ void HttpRequestConstructor::AccountHeadersSize(size_t size) {
                             std::to_string(config_.max_headers_size) +
                             " (enforced by 'max_headers_size' handler limit in "
                             "config.yaml)" +
-                            ", url: " + request_->GetUrl() + ", added size " +
+                            ", url: " + (request_ ? request_->GetUrl() : "") +
+                            ", added size " +
                             std::to_string(size));
   }
 }
@@ -398,6 +517,10 @@ void HttpRequestConstructor::CheckStatus() const {
           "invalid body of multipart/form-data request");
       request_->GetHttpResponse().SetReady();
       break;
+    case Status::kNotImplemented:
+      request_->SetResponseStatus(HttpStatus::kNotImplemented);
+      request_->GetHttpResponse().SetReady();
+      break;
   }
 }
 
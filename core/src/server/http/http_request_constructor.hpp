@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string_view>
 
 #include <http_parser.h>
 
@@ -12,6 +14,7 @@
 
 #include "handler_info_index.hpp"
 #include "http_request_impl.hpp"
+#include "http_request_pool.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -31,17 +34,23 @@ class HttpRequestConstructor final : public request::RequestConstructor {
     kParseArgsError,
     kParseCookiesError,
     kParseMultipartFormDataError,
+    kNotImplemented,
   };
 
   using Config = server::request::HttpRequestConfig;
 
-  HttpRequestConstructor(Config config,
-                         const HandlerInfoIndex& handler_info_index,
-                         request::ResponseDataAccounter& data_accounter);
+  // The request is allocated in a slot of `request_pool` if it is not null
+  HttpRequestConstructor(
+      Config config, const HandlerInfoIndex& handler_info_index,
+      request::ResponseDataAccounter& data_accounter,
+      std::shared_ptr<HttpRequestPool> request_pool = {});
 
   HttpRequestConstructor(HttpRequestConstructor&&) = delete;
   HttpRequestConstructor& operator=(HttpRequestConstructor&&) = delete;
 
+  // Creates a pool with slots that fit exactly one request
+  static std::shared_ptr<HttpRequestPool> CreateRequestPool();
+
   void SetMethod(HttpMethod method);
   void SetHttpMajor(unsigned short http_major);
   void SetHttpMinor(unsigned short http_minor);
@@ -50,10 +59,30 @@ class HttpRequestConstructor final : public request::RequestConstructor {
   void ParseUrl();
   void AppendHeaderField(const char* data, size_t size);
   void AppendHeaderValue(const char* data, size_t size);
+  // Adds a complete header, must not be mixed with AppendHeaderField and
+  // AppendHeaderValue within a single request
+  void AppendHeader(std::string_view field, std::string_view value);
   void AppendBody(const char* data, size_t size);
+  // Preallocates memory for a body of a known size, if it fits the limits.
+  // At most the first 64 KiB are preallocated.
+  void ReserveBody(size_t size);
 
   void SetIsFinal(bool is_final);
 
+  // Makes Finalize() answer the request with `status` instead of passing it
+  // to the handler. Used by the parsers for malformed requests.
+  void SetError(Status status);
+
+  // Must be called after all the headers are received. If the handler
+  // consumes the request body as a stream, returns the request to be
+  // processed right away. AppendBody then passes the body to the handler,
+  // blocking while the handler has too much unread data.
+  std::shared_ptr<request::RequestBase> StartBodyStream();
+  bool IsBodyStreamed() const { return is_body_streamed_; }
+  // Reports the end of the streamed body or that the body will not be
+  // received completely
+  void FinishBodyStream(bool is_complete);
+
   std::shared_ptr<request::RequestBase> Finalize() override;
 
  private:
@@ -62,7 +91,9 @@ class HttpRequestConstructor final : public request::RequestConstructor {
   void ParseArgs(const http_parser_url& url);
   void ParseArgs(const char* data, size_t size);
   void AddHeader();
+  void InsertHeader(std::string&& field, std::string&& value);
   void ParseCookies();
+  void PushBodyChunk(std::string&& chunk);
 
   void SetStatus(Status status);
   void AccountRequestSize(size_t size);
@@ -84,8 +115,12 @@ class HttpRequestConstructor final : public request::RequestConstructor {
   size_t url_size_ = 0;
   size_t headers_size_ = 0;
   bool url_parsed_ = false;
+  bool is_body_stream_requested_ = false;
+  bool is_body_streamed_ = false;
   Status status_ = Status::kOk;
 
+  std::optional<RequestBodyStream::Queue::Producer> body_stream_producer_;
+
   std::shared_ptr<HttpRequestImpl> request_;
 };
 
@@ -1,6 +1,13 @@
 #include <benchmark/benchmark.h>
 
+#include <string>
+
+#include <fmt/format.h>
+
 #include <server/http/http_request_constructor.hpp>
+#include <server/http/http_request_parser.hpp>
+#include <server/http/http_request_simd_parser.hpp>
+#include <userver/engine/run_standalone.hpp>
 #include <utils/gbench_auxilary.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -16,9 +23,67 @@ void http_request_constructor_url_decode(benchmark::State& state) {
   for ([[maybe_unused]] auto _ : state)
     benchmark::DoNotOptimize(USERVER_NAMESPACE::http::parser::UrlDecode(input));
 }
+
+// A typical proxied request: a bunch of tracing and forwarding headers,
+// repeated to fill a receive buffer with pipelined requests
+std::string MakeRequests(std::size_t headers_count, std::size_t count) {
+  std::string request =
+      "POST /v1/some/handler?id=12345&lang=en HTTP/1.1\r\n"
+      "Host: service.example.net\r\n"
+      "Content-Type: application/json\r\n"
+      "Content-Length: 26\r\n";
+  for (std::size_t i = 0; i < headers_count; ++i) {
+    request += fmt::format(
+        "X-Proxy-Header-{}: 2b6d9d7a7a4b4f0e8c2b1d0a9f8e7d6c-{}\r\n", i, i);
+  }
+  request += "\r\n{\"key\":\"value\",\"id\":12345}";
+
+  std::string result;
+  for (std::size_t i = 0; i < count; ++i) result += request;
+  return result;
+}
+
+template <typename Parser>
+void http_request_parse(benchmark::State& state) {
+  constexpr std::size_t kRequestsCount = 16;
+  const auto data = MakeRequests(state.range(0), kRequestsCount);
+
+  engine::RunStandalone([&] {
+    const server::http::HandlerInfoIndex handler_info_index;
+    const server::request::HttpRequestConfig config{};
+    server::net::ParserStats stats;
+    server::request::ResponseDataAccounter accounter;
+    std::size_t parsed = 0;
+    Parser parser(
+        handler_info_index, config,
+        [&parsed](std::shared_ptr<server::request::RequestBase>&& request) {
+          benchmark::DoNotOptimize(request);
+          ++parsed;
+        },
+        stats, accounter);
+
+    for ([[maybe_unused]] auto _ : state) {
+      parser.Parse(data.data(), data.size());
+    }
+
+    if (parsed != state.iterations() * kRequestsCount) {
+      state.SkipWithError("Not all the requests were parsed");
+    }
+    state.SetItemsProcessed(parsed);
+    state.SetBytesProcessed(state.iterations() * data.size());
+  });
+}
+
 }  // namespace
 BENCHMARK(http_request_constructor_url_decode)
     ->RangeMultiplier(2)
     ->Range(1, 1024);
 
+BENCHMARK_TEMPLATE(http_request_parse, server::http::HttpRequestParser)
+    ->RangeMultiplier(4)
+    ->Range(1, 64);
+BENCHMARK_TEMPLATE(http_request_parse, server::http::HttpRequestSimdParser)
+    ->RangeMultiplier(4)
+    ->Range(1, 64);
+
 USERVER_NAMESPACE_END
@@ -15,4 +15,24 @@ TEST(HttpRequestConstructor, DecodeUrlPlus) {
   EXPECT_EQ("Some String", http::parser::UrlDecode(str));
 }
 
+UTEST(HttpRequestConstructor, RequestPoolSlotFitsRequest) {
+  const server::http::HandlerInfoIndex handler_info_index;
+  server::request::ResponseDataAccounter accounter;
+  const auto pool = server::http::HttpRequestConstructor::CreateRequestPool();
+
+  const void* first_address = nullptr;
+  {
+    server::http::HttpRequestConstructor constructor{
+        {}, handler_info_index, accounter, pool};
+    const auto request = constructor.Finalize();
+    first_address = request.get();
+  }
+  // The request went into a slot rather than to the heap
+  EXPECT_TRUE(pool->HasFreeSlots());
+
+  server::http::HttpRequestConstructor constructor{
+      {}, handler_info_index, accounter, pool};
+  EXPECT_EQ(constructor.Finalize().get(), first_address);
+}
+
 USERVER_NAMESPACE_END
@@ -1,5 +1,6 @@
 #include "http_request_handler.hpp"
 
+#include <charconv>
 #include <chrono>
 #include <stdexcept>
 
@@ -13,10 +14,12 @@
 #include <userver/http/common_headers.hpp>
 #include <userver/logging/component.hpp>
 #include <userver/logging/logger.hpp>
+#include <userver/server/handlers/impl/deadline_propagation_config.hpp>
 #include <userver/server/http/http_request.hpp>
 #include <userver/server/http/http_response.hpp>
 #include <userver/server/request/task_inherited_request.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
 #include "http_request_impl.hpp"
 
 USERVER_NAMESPACE_BEGIN
@@ -24,6 +27,12 @@ USERVER_NAMESPACE_BEGIN
 namespace server::http {
 namespace {
 
+// Rejected requests are not accounted in handler statistics
+handlers::HttpRequestStatistics& GetDummyStatistics() {
+  static handlers::HttpRequestStatistics dummy_statistics;
+  return dummy_statistics;
+}
+
 engine::TaskWithResult<void> StartFailsafeTask(
     std::shared_ptr<request::RequestBase> request) {
   UASSERT(dynamic_cast<http::HttpRequestImpl*>(&*request));
@@ -31,9 +40,7 @@ engine::TaskWithResult<void> StartFailsafeTask(
   auto& http_request = static_cast<http::HttpRequestImpl&>(*request);
 
   const auto* handler = http_request.GetHttpHandler();
-  static handlers::HttpRequestStatistics dummy_statistics;
-
-  http_request.SetHttpHandlerStatistics(dummy_statistics);
+  http_request.SetHttpHandlerStatistics(GetDummyStatistics());
 
   return engine::AsyncNoSpan([request = std::move(request), handler]() {
     request->SetTaskStartTime();
@@ -81,6 +88,58 @@ namespace {
 utils::statistics::MetricTag<std::atomic<size_t>> kCcStatusCodeIsCustom{
     "congestion-control.rps.is-custom-status-activated"};
 
+utils::statistics::MetricTag<utils::statistics::RateCounter>
+    kShedByQueueDelay{"congestion-control.load-shedding.queue-delay"};
+
+utils::statistics::MetricTag<utils::statistics::RateCounter>
+    kShedByUnreachableDeadline{
+        "congestion-control.load-shedding.unreachable-deadline"};
+
+// Whether the propagated deadline of the request expires before the request
+// is expected to leave the task processor queue
+bool IsDeadlineUnreachable(const HttpRequestImpl& http_request,
+                           std::chrono::steady_clock::duration expected_delay) {
+  const auto& timeout_ms_str = http_request.GetHeader(
+      USERVER_NAMESPACE::http::headers::kXYaTaxiClientTimeoutMs);
+  if (timeout_ms_str.empty()) return false;
+
+  std::uint64_t timeout_ms = 0;
+  const auto* const end = timeout_ms_str.data() + timeout_ms_str.size();
+  const auto [ptr, ec] =
+      std::from_chars(timeout_ms_str.data(), end, timeout_ms);
+  // Malformed and very large timeouts are left to the handler
+  if (ec != std::errc{} || ptr != end ||
+      std::chrono::milliseconds{timeout_ms} >=
+          std::chrono::hours{24 * 365 * 10}) {
+    return false;
+  }
+
+  return http_request.StartTime() + std::chrono::milliseconds{timeout_ms} <
+         std::chrono::steady_clock::now() + expected_delay;
+}
+
+void RejectByQueueDelay(request::RequestBase& request,
+                        const handlers::HttpHandlerBase& handler) {
+  UASSERT(dynamic_cast<http::HttpRequestImpl*>(&request));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+  auto& http_request = static_cast<http::HttpRequestImpl&>(request);
+  http_request.SetHttpHandlerStatistics(GetDummyStatistics());
+
+  auto& http_response = http_request.GetHttpResponse();
+  SetThrottleReason(
+      http_response, "queue delay",
+      std::string{
+          USERVER_NAMESPACE::http::headers::ratelimit_reason::kQueueDelay});
+  handler.ReportThrottledRequest(request);
+
+  LOG_LIMITED_WARNING() << "Request throttled (queue delay, "
+                           "limit via USERVER_LOAD_SHEDDING), url="
+                        << http_request.GetUrl();
+
+  request.SetResponseNotifyTime();
+  http_response.SetReady();
+}
+
 }  // namespace
 
 engine::TaskWithResult<void> HttpRequestHandler::StartRequestTask(
@@ -156,17 +215,69 @@ engine::TaskWithResult<void> HttpRequestHandler::StartRequestTask(
     return StartFailsafeTask(std::move(request));
   }
 
+  QueueDelayController* queue_delay_controller = nullptr;
+  QueueDelayController::Settings queue_delay_settings{};
+  const auto& load_shedding = config[handlers::kLoadShedding];
+  if (!is_monitor_ && throttling_enabled && load_shedding.enabled) {
+    const auto it = queue_delay_controllers_.find(task_processor);
+    UASSERT(it != queue_delay_controllers_.end());
+    queue_delay_controller = it->second.get();
+    queue_delay_settings = {load_shedding.target_delay, load_shedding.interval};
+
+    // Shed requests that would wait in the queue for longer than the client
+    // is going to wait for the response
+    const auto standing_delay = queue_delay_controller->GetStandingDelay(
+        std::chrono::steady_clock::now(), queue_delay_settings);
+    if (load_shedding.deadline_aware &&
+        standing_delay != std::chrono::steady_clock::duration::zero() &&
+        handler->GetConfig().deadline_propagation_enabled &&
+        config[handlers::impl::kDeadlinePropagationEnabled] &&
+        IsDeadlineUnreachable(http_request, standing_delay)) {
+      SetThrottleReason(
+          http_response, "unreachable deadline",
+          std::string{USERVER_NAMESPACE::http::headers::ratelimit_reason::
+                          kUnreachableDeadline});
+      http_response.SetStatus(HttpStatus::kTooManyRequests);
+      http_response.SetReady();
+      ++metrics_->GetMetric(kShedByUnreachableDeadline);
+
+      LOG_LIMITED_WARNING()
+          << "Request throttled (deadline is unreachable with the current "
+             "queue delay of "
+          << std::chrono::duration_cast<std::chrono::milliseconds>(
+                 standing_delay)
+                 .count()
+          << "ms, limit via USERVER_LOAD_SHEDDING), url="
+          << http_request.GetUrl();
+
+      return StartFailsafeTask(std::move(request));
+    }
+  }
+
   if (handler->GetConfig().response_body_stream &&
       config[handlers::kStreamApiEnabled]) {
     http_response.SetStreamBody();
   }
 
-  auto payload = [request = std::move(request), handler] {
+  auto payload = [request = std::move(request), handler,
+                  queue_delay_controller, queue_delay_settings,
+                  create_time = std::chrono::steady_clock::now(),
+                  metrics = metrics_.get()] {
     server::request::kTaskInheritedRequest.Set(
         std::static_pointer_cast<HttpRequestImpl>(request));
 
     request->SetTaskStartTime();
 
+    if (queue_delay_controller) {
+      const auto now = std::chrono::steady_clock::now();
+      if (queue_delay_controller->ShouldShed(now - create_time, now,
+                                             queue_delay_settings)) {
+        ++metrics->GetMetric(kShedByQueueDelay);
+        RejectByQueueDelay(*request, *handler);
+        return;
+      }
+    }
+
     request::RequestContext context;
     handler->HandleRequest(*request, context);
 
@@ -198,6 +309,11 @@ void HttpRequestHandler::AddHandler(const handlers::HttpHandlerBase& handler,
   }
   std::lock_guard<engine::Mutex> lock(handler_infos_mutex_);
   handler_info_index_.AddHandler(handler, task_processor);
+
+  auto& queue_delay_controller = queue_delay_controllers_[&task_processor];
+  if (!queue_delay_controller) {
+    queue_delay_controller = std::make_unique<QueueDelayController>();
+  }
 }
 
 bool HttpRequestHandler::IsAddHandlerDisabled() const noexcept {
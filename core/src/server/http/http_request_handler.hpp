@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <optional>
+#include <unordered_map>
 
 #include <server/http/request_handler_base.hpp>
 #include <userver/components/component_context.hpp>
@@ -13,6 +15,7 @@
 #include <userver/utils/token_bucket.hpp>
 
 #include "handler_info_index.hpp"
+#include "queue_delay_controller.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -59,6 +62,10 @@ class HttpRequestHandler final : public RequestHandlerBase {
   // synchronization is not needed.
   engine::Mutex handler_infos_mutex_;
   HandlerInfoIndex handler_info_index_;
+  // Filled along with handler_info_index_, one per task processor queue
+  std::unordered_map<const engine::TaskProcessor*,
+                     std::unique_ptr<QueueDelayController>>
+      queue_delay_controllers_;
 
   std::atomic<bool> add_handler_disabled_;
   const bool is_monitor_;
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,6 +11,7 @@
 
 #include <userver/server/http/http_method.hpp>
 #include <userver/server/http/http_request.hpp>
+#include <userver/server/http/http_request_body_stream.hpp>
 #include <userver/server/http/http_response.hpp>
 #include <userver/server/request/request_base.hpp>
 #include <userver/utils/datetime/wall_coarse_clock.hpp>
@@ -83,6 +85,9 @@ class HttpRequestImpl final : public request::RequestBase {
   const HttpRequest::CookiesMap& GetCookies() const;
 
   const std::string& RequestBody() const { return request_body_; }
+  RequestBodyStream* GetRequestBodyStream() const {
+    return request_body_stream_ ? &*request_body_stream_ : nullptr;
+  }
   void SetRequestBody(std::string body);
   void ParseArgsFromBody();
   void SetResponseStatus(HttpStatus status) const {
@@ -145,6 +150,7 @@ class HttpRequestImpl final : public request::RequestBase {
   std::string url_;
   std::string request_path_;
   std::string request_body_;
+  mutable std::optional<RequestBodyStream> request_body_stream_;
   std::string path_suffix_;
   utils::impl::TransparentMap<std::string, std::vector<std::string>,
                               utils::StrCaseHash>
@@ -52,12 +52,14 @@ HttpRequestParser::HttpRequestParser(
     const HandlerInfoIndex& handler_info_index,
     const request::HttpRequestConfig& request_config,
     OnNewRequestCb&& on_new_request_cb, net::ParserStats& stats,
-    request::ResponseDataAccounter& data_accounter)
+    request::ResponseDataAccounter& data_accounter,
+    std::shared_ptr<HttpRequestPool> request_pool)
     : handler_info_index_(handler_info_index),
       request_constructor_config_{request_config},
       on_new_request_cb_(std::move(on_new_request_cb)),
       stats_(stats),
-      data_accounter_(data_accounter) {
+      data_accounter_(data_accounter),
+      request_pool_(std::move(request_pool)) {
   http_parser_init(&parser_, HTTP_REQUEST);
   parser_.data = this;
 }
@@ -181,6 +183,13 @@ int HttpRequestParser::OnHeadersCompleteImpl(http_parser* p) {
     return -1;
   }
   LOG_TRACE() << "headers complete";
+
+  if (!p->upgrade) {
+    request_constructor_->SetIsFinal(!http_should_keep_alive(p));
+    if (auto request = request_constructor_->StartBodyStream()) {
+      on_new_request_cb_(std::move(request));
+    }
+  }
   return 0;
 }
 
@@ -203,6 +212,12 @@ int HttpRequestParser::OnMessageCompleteImpl(http_parser* p) {
   if (p->upgrade) {
     return -1;  // error
   }
+  if (request_constructor_->IsBodyStreamed()) {
+    request_constructor_->FinishBodyStream(/*is_complete=*/true);
+    LOG_TRACE() << "message complete";
+    FinalizeRequest();
+    return 0;
+  }
   request_constructor_->SetIsFinal(!http_should_keep_alive(p));
   if (!CheckUrlComplete(p)) return -1;
   LOG_TRACE() << "message complete";
@@ -213,7 +228,7 @@ int HttpRequestParser::OnMessageCompleteImpl(http_parser* p) {
 void HttpRequestParser::CreateRequestConstructor() {
   ++stats_.parsing_request_count;
   request_constructor_.emplace(request_constructor_config_, handler_info_index_,
-                               data_accounter_);
+                               data_accounter_, request_pool_);
   url_complete_ = false;
 }
 
@@ -243,6 +258,12 @@ bool HttpRequestParser::FinalizeRequest() {
 bool HttpRequestParser::FinalizeRequestImpl() {
   if (!request_constructor_) CreateRequestConstructor();
 
+  if (request_constructor_->IsBodyStreamed()) {
+    // The request was passed to the handler when the headers were received
+    request_constructor_->FinishBodyStream(/*is_complete=*/false);
+    return true;
+  }
+
   if (auto request = request_constructor_->Finalize()) {
     on_new_request_cb_(std::move(request));
   } else {
@@ -0,0 +1,56 @@
+#include "http_request_pool.hpp"
+
+#include <new>
+
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+HttpRequestPool::HttpRequestPool(std::size_t slot_size)
+    : slot_size_(slot_size) {
+  UASSERT(slot_size_ > 0);
+}
+
+HttpRequestPool::~HttpRequestPool() { ReleaseFreeSlots(); }
+
+void* HttpRequestPool::Acquire() {
+  for (auto& slot : free_slots_) {
+    if (slot.load(std::memory_order_relaxed) == nullptr) continue;
+    auto* result = slot.exchange(nullptr, std::memory_order_acquire);
+    if (result) return result;
+  }
+  return ::operator new(slot_size_);
+}
+
+void HttpRequestPool::Release(void* slot) noexcept {
+  for (auto& free_slot : free_slots_) {
+    void* expected = nullptr;
+    if (free_slot.compare_exchange_strong(expected, slot,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  ::operator delete(slot, slot_size_);
+}
+
+bool HttpRequestPool::HasFreeSlots() const noexcept {
+  for (const auto& slot : free_slots_) {
+    if (slot.load(std::memory_order_relaxed) != nullptr) return true;
+  }
+  return false;
+}
+
+void HttpRequestPool::ReleaseFreeSlots() noexcept {
+  for (auto& slot : free_slots_) {
+    // Deleting a null pointer is a no-op
+    ::operator delete(slot.exchange(nullptr, std::memory_order_acquire),
+                      slot_size_);
+  }
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+// Pool of fixed-size memory slots for the requests of a single connection.
+//
+// Each slot holds exactly one object, e.g. HttpRequestImpl together with its
+// shared_ptr control block. The members of the object still use the heap.
+// Slots are acquired by the connection's parser and released by whichever
+// task drops the last reference to a request, so the pool is thread-safe.
+class HttpRequestPool final {
+ public:
+  explicit HttpRequestPool(std::size_t slot_size);
+  HttpRequestPool(const HttpRequestPool&) = delete;
+  HttpRequestPool& operator=(const HttpRequestPool&) = delete;
+  ~HttpRequestPool();
+
+  std::size_t GetSlotSize() const noexcept { return slot_size_; }
+
+  // Returns a slot of GetSlotSize() bytes, reusing a free one if possible
+  void* Acquire();
+  // Keeps the slot for reuse or frees it if there are enough free slots
+  void Release(void* slot) noexcept;
+
+  bool HasFreeSlots() const noexcept;
+  // Frees the slots kept for reuse, e.g. when the connection becomes idle
+  void ReleaseFreeSlots() noexcept;
+
+ private:
+  // A connection rarely has more than a few requests in flight. Exchanging
+  // the slots is cheaper than a lock-free list and is free of ABA issues.
+  static constexpr std::size_t kMaxFreeSlots = 4;
+
+  const std::size_t slot_size_;
+  std::array<std::atomic<void*>, kMaxFreeSlots> free_slots_{};
+};
+
+// Standard allocator over HttpRequestPool, e.g. for std::allocate_shared.
+// Allocations that do not fit into a slot are served by the heap.
+template <typename T>
+class HttpRequestPoolAllocator {
+ public:
+  using value_type = T;
+
+  explicit HttpRequestPoolAllocator(
+      std::shared_ptr<HttpRequestPool> pool) noexcept
+      : pool_(std::move(pool)) {}
+
+  template <typename U>
+  HttpRequestPoolAllocator(const HttpRequestPoolAllocator<U>& other) noexcept
+      : pool_(other.pool_) {}
+
+  T* allocate(std::size_t n) {
+    if (IsPooled(n)) return static_cast<T*>(pool_->Acquire());
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* ptr, std::size_t n) noexcept {
+    if (IsPooled(n)) {
+      pool_->Release(ptr);
+    } else {
+      std::allocator<T>{}.deallocate(ptr, n);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const HttpRequestPoolAllocator<U>& other) const noexcept {
+    return pool_ == other.pool_;
+  }
+
+  template <typename U>
+  bool operator!=(const HttpRequestPoolAllocator<U>& other) const noexcept {
+    return pool_ != other.pool_;
+  }
+
+ private:
+  template <typename U>
+  friend class HttpRequestPoolAllocator;
+
+  bool IsPooled(std::size_t n) const noexcept {
+    return n == 1 && sizeof(T) <= pool_->GetSlotSize() &&
+           alignof(T) <= alignof(std::max_align_t);
+  }
+
+  std::shared_ptr<HttpRequestPool> pool_;
+};
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
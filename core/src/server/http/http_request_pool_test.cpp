@@ -0,0 +1,105 @@
+#include <server/http/http_request_pool.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <userver/utest/utest.hpp>
+#include <userver/utils/async.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using server::http::HttpRequestPool;
+using server::http::HttpRequestPoolAllocator;
+
+constexpr std::size_t kSlotSize = 256;
+
+std::shared_ptr<HttpRequestPool> MakePool() {
+  return std::make_shared<HttpRequestPool>(kSlotSize);
+}
+
+template <typename T>
+std::shared_ptr<T> MakeShared(std::shared_ptr<HttpRequestPool> pool) {
+  return std::allocate_shared<T>(HttpRequestPoolAllocator<T>{std::move(pool)});
+}
+
+}  // namespace
+
+TEST(HttpRequestPool, SlotIsReused) {
+  const auto pool = MakePool();
+
+  const void* first_address = nullptr;
+  {
+    const auto first = MakeShared<std::uint64_t>(pool);
+    *first = 42;
+    first_address = first.get();
+  }
+  EXPECT_TRUE(pool->HasFreeSlots());
+
+  const auto second = MakeShared<std::uint64_t>(pool);
+  EXPECT_EQ(second.get(), first_address);
+  EXPECT_FALSE(pool->HasFreeSlots());
+}
+
+TEST(HttpRequestPool, ConcurrentRequests) {
+  const auto pool = MakePool();
+
+  const auto first = MakeShared<int>(pool);
+  const auto second = MakeShared<int>(pool);
+  EXPECT_NE(first.get(), second.get());
+
+  *first = 1;
+  *second = 2;
+  EXPECT_EQ(*first, 1);
+  EXPECT_EQ(*second, 2);
+}
+
+TEST(HttpRequestPool, LargeObjectsUseHeap) {
+  const auto pool = MakePool();
+
+  using Large = std::array<char, kSlotSize>;
+  MakeShared<Large>(pool)->fill('a');
+  EXPECT_FALSE(pool->HasFreeSlots());
+}
+
+TEST(HttpRequestPool, ReleaseFreeSlots) {
+  const auto pool = MakePool();
+  EXPECT_FALSE(pool->HasFreeSlots());
+
+  MakeShared<int>(pool).reset();
+  EXPECT_TRUE(pool->HasFreeSlots());
+
+  pool->ReleaseFreeSlots();
+  EXPECT_FALSE(pool->HasFreeSlots());
+}
+
+TEST(HttpRequestPool, RequestOutlivesOwner) {
+  auto pool = MakePool();
+  auto request = MakeShared<int>(pool);
+
+  // The allocator keeps the pool alive until the last request is freed
+  pool.reset();
+  *request = 1;
+  request.reset();
+}
+
+UTEST_MT(HttpRequestPool, ReleaseFromOtherThreads, 4) {
+  const auto pool = MakePool();
+
+  for (int i = 0; i < 100; ++i) {
+    std::vector<engine::TaskWithResult<void>> tasks;
+    for (int j = 0; j < 8; ++j) {
+      tasks.push_back(utils::Async(
+          "release", [request = MakeShared<int>(pool)]() mutable {
+            *request = 1;
+            request.reset();
+          }));
+    }
+    for (auto& task : tasks) task.Get();
+  }
+}
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,546 @@
+#include "http_request_simd_parser.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+
+#include <userver/http/common_headers.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_method.hpp>
+#include <userver/server/request/request_base.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/str_icase.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+namespace {
+
+namespace headers = USERVER_NAMESPACE::http::headers;
+
+constexpr bool IsControl(char c) noexcept {
+  const auto byte = static_cast<unsigned char>(c);
+  return byte < 0x20 || byte == 0x7f;
+}
+
+// RFC 7230, section 3.2.6
+constexpr auto kTokenChars = []() {
+  std::array<bool, 256> result{};
+  for (char c = '0'; c <= '9'; ++c) result[c] = true;
+  for (char c = 'a'; c <= 'z'; ++c) result[c] = true;
+  for (char c = 'A'; c <= 'Z'; ++c) result[c] = true;
+  for (const char c : std::string_view{"!#$%&'*+-.^_`|~"}) result[c] = true;
+  return result;
+}();
+
+bool IsToken(std::string_view str) noexcept {
+  if (str.empty()) return false;
+  return std::all_of(str.begin(), str.end(), [](char c) {
+    return kTokenChars[static_cast<unsigned char>(c)];
+  });
+}
+
+bool IsDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+bool IsOws(char c) noexcept { return c == ' ' || c == '\t'; }
+
+std::string_view TrimOws(std::string_view str) noexcept {
+  while (!str.empty() && IsOws(str.front())) str.remove_prefix(1);
+  while (!str.empty() && IsOws(str.back())) str.remove_suffix(1);
+  return str;
+}
+
+// Returns the position of the first control character, or `size` if there is
+// none. Most of the request head consists of printable characters, so
+// checking 16 bytes at a time is a lot faster than a byte-by-byte loop.
+std::size_t FindControl(const char* data, std::size_t size) noexcept {
+  std::size_t pos = 0;
+#ifdef __SSE2__
+  const auto max_control = _mm_set1_epi8(0x1f);
+  const auto del = _mm_set1_epi8(0x7f);
+  for (; pos + 16 <= size; pos += 16) {
+    const auto chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const auto is_control = _mm_or_si128(
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk),
+        _mm_cmpeq_epi8(chunk, del));
+    const auto mask = _mm_movemask_epi8(is_control);
+    if (mask != 0) return pos + __builtin_ctz(mask);
+  }
+#endif
+  for (; pos < size; ++pos) {
+    if (IsControl(data[pos])) return pos;
+  }
+  return size;
+}
+
+HttpMethod ParseMethod(std::string_view method) {
+  for (const auto known :
+       {HttpMethod::kGet, HttpMethod::kPost, HttpMethod::kPut,
+        HttpMethod::kDelete, HttpMethod::kPatch, HttpMethod::kHead,
+        HttpMethod::kOptions, HttpMethod::kConnect}) {
+    if (method == ToString(known)) return known;
+  }
+  return HttpMethod::kUnknown;
+}
+
+bool ParseHttpVersion(std::string_view version, unsigned short& major,
+                      unsigned short& minor) noexcept {
+  constexpr std::string_view kPrefix = "HTTP/";
+  if (version.size() != kPrefix.size() + 3 ||
+      version.substr(0, kPrefix.size()) != kPrefix) {
+    return false;
+  }
+  version.remove_prefix(kPrefix.size());
+  if (!IsDigit(version[0]) || version[1] != '.' ||
+      !IsDigit(version[2])) {
+    return false;
+  }
+  major = version[0] - '0';
+  minor = version[2] - '0';
+  return true;
+}
+
+bool SplitHeader(std::string_view line, std::string_view& field,
+                 std::string_view& value) noexcept {
+  const auto colon = line.find(':');
+  if (colon == std::string_view::npos) return false;
+  field = line.substr(0, colon);
+  value = TrimOws(line.substr(colon + 1));
+  return IsToken(field);
+}
+
+bool ParseDecimal(std::string_view str, std::uint64_t& result) noexcept {
+  // 19 decimal digits always fit into std::uint64_t
+  if (str.empty() || str.size() > 19) return false;
+  result = 0;
+  for (const char c : str) {
+    if (!IsDigit(c)) return false;
+    result = result * 10 + (c - '0');
+  }
+  return true;
+}
+
+bool ParseHex(std::string_view str, std::uint64_t& result) noexcept {
+  // 15 hex digits do not overflow std::uint64_t in the size computations
+  if (str.empty() || str.size() > 15) return false;
+  result = 0;
+  for (const char c : str) {
+    result <<= 4;
+    if (c >= '0' && c <= '9') {
+      result |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      result |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      result |= c - 'A' + 10;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Func>
+void ForEachListToken(std::string_view list, Func func) {
+  while (!list.empty()) {
+    const auto comma = list.find(',');
+    func(TrimOws(list.substr(0, comma)));
+    if (comma == std::string_view::npos) break;
+    list.remove_prefix(comma + 1);
+  }
+}
+
+}  // namespace
+
+HttpRequestSimdParser::HttpRequestSimdParser(
+    const HandlerInfoIndex& handler_info_index,
+    const request::HttpRequestConfig& request_config,
+    OnNewRequestCb&& on_new_request_cb, net::ParserStats& stats,
+    request::ResponseDataAccounter& data_accounter,
+    std::shared_ptr<HttpRequestPool> request_pool)
+    : handler_info_index_(handler_info_index),
+      request_constructor_config_{request_config},
+      on_new_request_cb_(std::move(on_new_request_cb)),
+      stats_(stats),
+      data_accounter_(data_accounter),
+      request_pool_(std::move(request_pool)) {}
+
+bool HttpRequestSimdParser::Parse(const char* data, size_t size) {
+  std::string_view input{data, size};
+  while (!input.empty()) {
+    if (state_ == State::kClosed || state_ == State::kUpgraded) {
+      LOG_WARNING() << "unexpected data after the final request, size="
+                    << input.size();
+      return false;
+    }
+
+    if (state_ == State::kBody || state_ == State::kChunkData) {
+      try {
+        ProcessBody(input);
+      } catch (const std::exception& ex) {
+        LOG_WARNING() << "can't append body: " << ex;
+        FinalizeRequest();
+        return false;
+      }
+      if (body_bytes_left_ != 0) continue;
+      if (state_ == State::kChunkData) {
+        state_ = State::kChunkDataEnd;
+      } else if (!CompleteMessage()) {
+        return false;
+      }
+      continue;
+    }
+
+    std::string_view line;
+    const auto status = NextLine(input, line);
+    if (status == LineStatus::kIncomplete) break;
+    if (status == LineStatus::kInvalid || !ProcessLine(line)) {
+      LOG_WARNING() << "malformed request line or header, size="
+                    << line.size();
+      if (request_constructor_) {
+        request_constructor_->SetError(
+            HttpRequestConstructor::Status::kBadRequest);
+      }
+      FinalizeRequest();
+      return false;
+    }
+    pending_line_.clear();
+
+    if (state_ == State::kUpgraded) return false;
+  }
+  return true;
+}
+
+HttpRequestSimdParser::LineStatus HttpRequestSimdParser::ScanLine(
+    std::string_view input, std::size_t& line_size,
+    std::size_t& consumed) noexcept {
+  std::size_t pos = 0;
+  while (true) {
+    pos += FindControl(input.data() + pos, input.size() - pos);
+    if (pos == input.size()) return LineStatus::kIncomplete;
+
+    switch (input[pos]) {
+      case '\t':
+        ++pos;
+        continue;
+      case '\n':
+        line_size = pos;
+        consumed = pos + 1;
+        return LineStatus::kComplete;
+      case '\r':
+        if (pos + 1 == input.size()) return LineStatus::kIncomplete;
+        if (input[pos + 1] != '\n') return LineStatus::kInvalid;
+        line_size = pos;
+        consumed = pos + 2;
+        return LineStatus::kComplete;
+      default:
+        return LineStatus::kInvalid;
+    }
+  }
+}
+
+HttpRequestSimdParser::LineStatus HttpRequestSimdParser::NextLine(
+    std::string_view& input, std::string_view& line) {
+  // A single line may not exceed the whole request limit, the more precise
+  // limits are checked by HttpRequestConstructor
+  const auto max_line_size = request_constructor_config_.max_request_size;
+  std::size_t line_size = 0;
+  std::size_t consumed = 0;
+
+  if (pending_line_.empty()) {
+    const auto status = ScanLine(input, line_size, consumed);
+    if (status == LineStatus::kComplete) {
+      line = input.substr(0, line_size);
+      input.remove_prefix(consumed);
+    } else if (status == LineStatus::kIncomplete) {
+      if (input.size() > max_line_size) return LineStatus::kInvalid;
+      pending_line_.assign(input);
+      input = {};
+    }
+    return status;
+  }
+
+  const auto newline = input.find('\n');
+  const auto size =
+      newline == std::string_view::npos ? input.size() : newline + 1;
+  if (pending_line_.size() + size > max_line_size) return LineStatus::kInvalid;
+  pending_line_.append(input.data(), size);
+  input.remove_prefix(size);
+  if (newline == std::string_view::npos) return LineStatus::kIncomplete;
+
+  if (ScanLine(pending_line_, line_size, consumed) != LineStatus::kComplete) {
+    return LineStatus::kInvalid;
+  }
+  UASSERT(consumed == pending_line_.size());
+  line = std::string_view{pending_line_}.substr(0, line_size);
+  return LineStatus::kComplete;
+}
+
+bool HttpRequestSimdParser::ProcessLine(std::string_view line) {
+  switch (state_) {
+    case State::kRequestLine:
+      return ProcessRequestLine(line);
+    case State::kHeaders:
+      return ProcessHeaderLine(line);
+    case State::kChunkSize:
+      return ProcessChunkSize(line);
+    case State::kChunkDataEnd:
+      if (!line.empty()) return false;
+      state_ = State::kChunkSize;
+      return true;
+    case State::kTrailers: {
+      if (line.empty()) return CompleteMessage();
+      std::string_view field;
+      std::string_view value;
+      if (!SplitHeader(line, field, value)) return false;
+      try {
+        request_constructor_->AppendHeader(field, value);
+      } catch (const std::exception& ex) {
+        LOG_WARNING() << "can't append trailer: " << ex;
+        return false;
+      }
+      return true;
+    }
+    case State::kBody:
+    case State::kChunkData:
+    case State::kClosed:
+    case State::kUpgraded:
+      break;
+  }
+  UINVARIANT(false, "Unexpected state of the HTTP parser");
+  return false;
+}
+
+bool HttpRequestSimdParser::ProcessRequestLine(std::string_view line) {
+  // RFC 7230, section 3.5: ignore empty lines before the request line
+  if (line.empty()) return true;
+
+  CreateRequestConstructor();
+  LOG_TRACE() << "request line: '" << line << '\'';
+
+  // ScanLine lets tabs through for the header values
+  if (line.find('\t') != std::string_view::npos) return false;
+
+  const auto method_end = line.find(' ');
+  const auto url_end = line.rfind(' ');
+  if (method_end == std::string_view::npos || url_end == method_end) {
+    return false;
+  }
+  const auto method = line.substr(0, method_end);
+  const auto url = line.substr(method_end + 1, url_end - method_end - 1);
+  if (!IsToken(method) || url.empty() ||
+      url.find(' ') != std::string_view::npos ||
+      !ParseHttpVersion(line.substr(url_end + 1), http_major_, http_minor_)) {
+    return false;
+  }
+
+  const auto parsed_method = ParseMethod(method);
+  is_connect_ = (parsed_method == HttpMethod::kConnect);
+  request_constructor_->SetMethod(parsed_method);
+  request_constructor_->SetHttpMajor(http_major_);
+  request_constructor_->SetHttpMinor(http_minor_);
+  try {
+    request_constructor_->AppendUrl(url.data(), url.size());
+    request_constructor_->ParseUrl();
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't parse url: " << ex;
+    return false;
+  }
+
+  state_ = State::kHeaders;
+  return true;
+}
+
+bool HttpRequestSimdParser::ProcessHeaderLine(std::string_view line) {
+  if (line.empty()) return ProcessHeadersComplete();
+
+  if (IsOws(line.front())) {
+    LOG_WARNING() << "obsolete line folding is not supported";
+    return false;
+  }
+
+  std::string_view field;
+  std::string_view value;
+  if (!SplitHeader(line, field, value)) return false;
+  LOG_TRACE() << "header: '" << field << "': '" << value << '\'';
+
+  const utils::StrIcaseEqual equal;
+  if (equal(field, headers::kContentLength)) {
+    // Even equal duplicates are rejected, a proxy in front of the server
+    // could have picked another one of them
+    std::uint64_t content_length = 0;
+    if (content_length_ || !ParseDecimal(value, content_length)) {
+      LOG_WARNING() << "invalid or duplicate Content-Length: '" << value
+                    << '\'';
+      return false;
+    }
+    content_length_ = content_length;
+  } else if (equal(field, headers::kTransferEncoding)) {
+    // The body is decoded only if `chunked` is the one and only coding,
+    // anything else would be passed to the handler undecoded
+    bool is_supported = true;
+    ForEachListToken(value, [this, &equal, &is_supported](
+                                std::string_view token) {
+      if (token.empty()) return;
+      if (is_chunked_ || !equal(token, "chunked")) is_supported = false;
+      is_chunked_ = true;
+    });
+    if (!is_supported || !is_chunked_) {
+      LOG_WARNING() << "unsupported Transfer-Encoding: '" << value << '\'';
+      request_constructor_->SetError(
+          HttpRequestConstructor::Status::kNotImplemented);
+      return false;
+    }
+  } else if (equal(field, headers::kConnection)) {
+    ForEachListToken(value, [this, &equal](std::string_view token) {
+      if (equal(token, "close")) {
+        connection_close_ = true;
+      } else if (equal(token, "keep-alive")) {
+        connection_keep_alive_ = true;
+      } else if (equal(token, "upgrade")) {
+        connection_upgrade_ = true;
+      }
+    });
+  } else if (equal(field, headers::kUpgrade)) {
+    has_upgrade_ = true;
+  }
+
+  try {
+    request_constructor_->AppendHeader(field, value);
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't append header: " << ex;
+    return false;
+  }
+  return true;
+}
+
+bool HttpRequestSimdParser::ProcessHeadersComplete() {
+  LOG_TRACE() << "headers complete";
+
+  if (is_connect_ || (has_upgrade_ && connection_upgrade_)) {
+    // The connection is handed over to the handler, just like with
+    // HttpRequestParser
+    request_constructor_->SetIsFinal(true);
+    state_ = State::kUpgraded;
+    FinalizeRequest();
+    return true;
+  }
+
+  if (is_chunked_ && content_length_) {
+    LOG_WARNING() << "both Transfer-Encoding and Content-Length are set";
+    return false;
+  }
+
+  request_constructor_->SetIsFinal(!IsKeepAlive());
+  if (auto request = request_constructor_->StartBodyStream()) {
+    on_new_request_cb_(std::move(request));
+  }
+
+  if (is_chunked_) {
+    state_ = State::kChunkSize;
+    return true;
+  }
+
+  if (content_length_.value_or(0) != 0) {
+    request_constructor_->ReserveBody(*content_length_);
+    body_bytes_left_ = *content_length_;
+    state_ = State::kBody;
+    return true;
+  }
+
+  return CompleteMessage();
+}
+
+bool HttpRequestSimdParser::ProcessChunkSize(std::string_view line) {
+  const auto extension = line.find(';');
+  std::uint64_t chunk_size = 0;
+  if (!ParseHex(TrimOws(line.substr(0, extension)), chunk_size)) {
+    LOG_WARNING() << "invalid chunk size: '" << line << '\'';
+    return false;
+  }
+
+  if (chunk_size == 0) {
+    state_ = State::kTrailers;
+  } else {
+    body_bytes_left_ = chunk_size;
+    state_ = State::kChunkData;
+  }
+  return true;
+}
+
+void HttpRequestSimdParser::ProcessBody(std::string_view& input) {
+  const auto size = static_cast<std::size_t>(
+      std::min<std::uint64_t>(body_bytes_left_, input.size()));
+  request_constructor_->AppendBody(input.data(), size);
+  body_bytes_left_ -= size;
+  input.remove_prefix(size);
+}
+
+bool HttpRequestSimdParser::IsKeepAlive() const noexcept {
+  // Same as http_should_keep_alive() of http_parser
+  return (http_major_ > 0 && http_minor_ > 0) ? !connection_close_
+                                              : connection_keep_alive_;
+}
+
+bool HttpRequestSimdParser::CompleteMessage() {
+  const bool keep_alive = IsKeepAlive();
+  if (request_constructor_->IsBodyStreamed()) {
+    request_constructor_->FinishBodyStream(/*is_complete=*/true);
+  } else {
+    request_constructor_->SetIsFinal(!keep_alive);
+  }
+  LOG_TRACE() << "message complete";
+
+  state_ = keep_alive ? State::kRequestLine : State::kClosed;
+  return FinalizeRequest();
+}
+
+void HttpRequestSimdParser::CreateRequestConstructor() {
+  ++stats_.parsing_request_count;
+  request_constructor_.emplace(request_constructor_config_, handler_info_index_,
+                               data_accounter_, request_pool_);
+
+  http_major_ = 0;
+  http_minor_ = 0;
+  content_length_.reset();
+  body_bytes_left_ = 0;
+  is_chunked_ = false;
+  connection_close_ = false;
+  connection_keep_alive_ = false;
+  connection_upgrade_ = false;
+  has_upgrade_ = false;
+  is_connect_ = false;
+}
+
+bool HttpRequestSimdParser::FinalizeRequest() {
+  bool res = FinalizeRequestImpl();
+  --stats_.parsing_request_count;
+  request_constructor_.reset();
+  return res;
+}
+
+bool HttpRequestSimdParser::FinalizeRequestImpl() {
+  if (!request_constructor_) CreateRequestConstructor();
+
+  if (request_constructor_->IsBodyStreamed()) {
+    // The request was passed to the handler when the headers were received
+    request_constructor_->FinishBodyStream(/*is_complete=*/false);
+    return true;
+  }
+
+  if (auto request = request_constructor_->Finalize()) {
+    on_new_request_cb_(std::move(request));
+  } else {
+    LOG_ERROR() << "request is null after Finalize()";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
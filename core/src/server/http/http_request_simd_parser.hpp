@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <server/net/stats.hpp>
+#include <server/request/request_parser.hpp>
+
+#include <userver/server/request/request_config.hpp>
+
+#include "http_request_constructor.hpp"
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+/// @brief HTTP/1.x request parser that scans the input for line delimiters
+/// with SIMD and passes the request line and whole headers to
+/// HttpRequestConstructor as views into the receive buffer.
+///
+/// Unlike HttpRequestParser it does not split the input into byte-sized
+/// callbacks and does not accumulate headers in intermediate strings. Data is
+/// copied only when a line is split between two reads, and into the resulting
+/// HttpRequestImpl, which outlives the receive buffer.
+class HttpRequestSimdParser final : public request::RequestParser {
+ public:
+  using OnNewRequestCb =
+      std::function<void(std::shared_ptr<request::RequestBase>&&)>;
+
+  HttpRequestSimdParser(const HandlerInfoIndex& handler_info_index,
+                        const request::HttpRequestConfig& request_config,
+                        OnNewRequestCb&& on_new_request_cb,
+                        net::ParserStats& stats,
+                        request::ResponseDataAccounter& data_accounter,
+                        std::shared_ptr<HttpRequestPool> request_pool = {});
+
+  HttpRequestSimdParser(HttpRequestSimdParser&&) = delete;
+  HttpRequestSimdParser& operator=(HttpRequestSimdParser&&) = delete;
+
+  bool Parse(const char* data, size_t size) override;
+
+ private:
+  enum class State {
+    kRequestLine,
+    kHeaders,
+    kBody,
+    kChunkSize,
+    kChunkData,
+    kChunkDataEnd,
+    kTrailers,
+    kClosed,
+    kUpgraded,
+  };
+
+  enum class LineStatus { kComplete, kIncomplete, kInvalid };
+
+  static LineStatus ScanLine(std::string_view input, std::size_t& line_size,
+                             std::size_t& consumed) noexcept;
+  LineStatus NextLine(std::string_view& input, std::string_view& line);
+
+  bool ProcessLine(std::string_view line);
+  bool ProcessRequestLine(std::string_view line);
+  bool ProcessHeaderLine(std::string_view line);
+  bool ProcessHeadersComplete();
+  bool ProcessChunkSize(std::string_view line);
+  void ProcessBody(std::string_view& input);
+
+  bool IsKeepAlive() const noexcept;
+  bool CompleteMessage();
+
+  void CreateRequestConstructor();
+
+  bool FinalizeRequest();
+  bool FinalizeRequestImpl();
+
+  const HandlerInfoIndex& handler_info_index_;
+  const HttpRequestConstructor::Config request_constructor_config_;
+
+  OnNewRequestCb on_new_request_cb_;
+
+  State state_{State::kRequestLine};
+  // Holds a line that was split between two reads
+  std::string pending_line_;
+
+  unsigned short http_major_{0};
+  unsigned short http_minor_{0};
+  std::optional<std::uint64_t> content_length_;
+  std::uint64_t body_bytes_left_{0};
+  bool is_chunked_{false};
+  bool connection_close_{false};
+  bool connection_keep_alive_{false};
+  bool connection_upgrade_{false};
+  bool has_upgrade_{false};
+  bool is_connect_{false};
+
+  std::optional<HttpRequestConstructor> request_constructor_;
+
+  net::ParserStats& stats_;
+  request::ResponseDataAccounter& data_accounter_;
+  // Recycles the memory of the requests of this connection, may be null
+  const std::shared_ptr<HttpRequestPool> request_pool_;
+};
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,266 @@
+#include <userver/utest/utest.hpp>
+
+#include <string>
+#include <vector>
+
+#include <userver/server/http/http_request.hpp>
+
+#include <server/http/http_request_impl.hpp>
+#include <server/http/http_request_simd_parser.hpp>
+
+#include "create_parser_test.hpp"
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using RequestImplPtr = std::shared_ptr<server::http::HttpRequestImpl>;
+
+class ParsedRequests final {
+ public:
+  server::http::HttpRequestSimdParser::OnNewRequestCb MakeCallback() {
+    return [this](std::shared_ptr<server::request::RequestBase>&& request) {
+      requests_.push_back(
+          std::dynamic_pointer_cast<server::http::HttpRequestImpl>(request));
+      ASSERT_TRUE(requests_.back());
+    };
+  }
+
+  const std::vector<RequestImplPtr>& Get() const { return requests_; }
+
+ private:
+  std::vector<RequestImplPtr> requests_;
+};
+
+constexpr std::string_view kRequestWithHeaders =
+    "POST /path/to?arg=value HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "X-Test:  spaces around \t\r\n"
+    "x-test: second\r\n"
+    "Content-Length: 4\r\n"
+    "\r\n"
+    "body";
+
+// The request is answered with `status` rather than passed to a handler
+void ExpectRejected(std::string_view data, server::http::HttpStatus status) {
+  ParsedRequests parsed;
+  auto parser = server::CreateTestParser<server::http::HttpRequestSimdParser>(
+      parsed.MakeCallback());
+
+  EXPECT_FALSE(parser.Parse(data.data(), data.size())) << data;
+  ASSERT_EQ(parsed.Get().size(), 1) << data;
+  EXPECT_EQ(parsed.Get()[0]->GetHttpResponse().GetStatus(), status) << data;
+}
+
+void CheckRequestWithHeaders(server::http::HttpRequestImpl& impl) {
+  const server::http::HttpRequest request{impl};
+  EXPECT_EQ(request.GetMethod(), server::http::HttpMethod::kPost);
+  EXPECT_EQ(request.GetUrl(), "/path/to?arg=value");
+  EXPECT_EQ(request.GetRequestPath(), "/path/to");
+  EXPECT_EQ(request.GetArg("arg"), "value");
+  EXPECT_EQ(request.GetHeader("host"), "localhost");
+  EXPECT_EQ(request.GetHeader("X-Test"), "spaces around,second");
+  EXPECT_EQ(request.RequestBody(), "body");
+  EXPECT_EQ(request.GetHttpMajor(), 1);
+  EXPECT_EQ(request.GetHttpMinor(), 1);
+  EXPECT_FALSE(impl.IsFinal());
+}
+
+}  // namespace
+
+UTEST(HttpRequestSimdParser, Simple) {
+  ParsedRequests parsed;
+  auto parser = server::CreateTestParser<server::http::HttpRequestSimdParser>(
+      parsed.MakeCallback());
+
+  EXPECT_TRUE(
+      parser.Parse(kRequestWithHeaders.data(), kRequestWithHeaders.size()));
+  ASSERT_EQ(parsed.Get().size(), 1);
+  CheckRequestWithHeaders(*parsed.Get()[0]);
+}
+
+UTEST(HttpRequestSimdParser, SplitAtEveryPosition) {
+  for (std::size_t split = 1; split < kRequestWithHeaders.size(); ++split) {
+    ParsedRequests parsed;
+    auto parser =
+        server::CreateTestParser<server::http::HttpRequestSimdParser>(
+            parsed.MakeCallback());
+
+    EXPECT_TRUE(parser.Parse(kRequestWithHeaders.data(), split));
+    EXPECT_TRUE(parser.Parse(kRequestWithHeaders.data() + split,
+                             kRequestWithHeaders.size() - split));
+    ASSERT_EQ(parsed.Get().size(), 1) << "split=" << split;
+    CheckRequestWithHeaders(*parsed.Get()[0]);
+  }
+}
+
+UTEST(HttpRequestSimdParser, ByteByByte) {
+  ParsedRequests parsed;
+  auto parser = server::CreateTestParser<server::http::HttpRequestSimdParser>(
+      parsed.MakeCallback());
+
+  for (const char c : kRequestWithHeaders) {
+    EXPECT_TRUE(parser.Parse(&c, 1));
+  }
+  ASSERT_EQ(parsed.Get().size(), 1);
+  CheckRequestWithHeaders(*parsed.Get()[0]);
+}
+
+UTEST(HttpRequestSimdParser, Pipelined) {
+  ParsedRequests parsed;
+  auto parser = server::CreateTestParser<server::http::HttpRequestSimdParser>(
+      parsed.MakeCallback());
+
+  const std::string data = std::string{kRequestWithHeaders} + "\r\n" +
+                           std::string{kRequestWithHeaders} +
+                           "GET /last HTTP/1.1\r\nConnection: close\r\n\r\n";
+  EXPECT_TRUE(parser.Parse(data.data(), data.size()));
+  ASSERT_EQ(parsed.Get().size(), 3);
+  CheckRequestWithHeaders(*parsed.Get()[0]);
+  CheckRequestWithHeaders(*parsed.Get()[1]);
+  EXPECT_EQ(parsed.Get()[2]->GetUrl(), "/last");
+  EXPECT_TRUE(parsed.Get()[2]->IsFinal());
+
+  const std::string_view more = "GET / HTTP/1.1\r\n\r\n";
+  EXPECT_FALSE(parser.Parse(more.data(), more.size()));
+  EXPECT_EQ(parsed.Get().size(), 3);
+}
+
+UTEST(HttpRequestSimdParser, Chunked) {
+  ParsedRequests parsed;
+  auto parser = server::CreateTestParser<server::http::HttpRequestSimdParser>(
+      parsed.MakeCallback());
+
+  const std::string_view data =
+      "PUT / HTTP/1.1\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "4\r\nWiki\r\n"
+      "6;ext=1\r\npedia \r\n"
+      "E\r\nin \r\n\r\nchunks.\r\n"
+      "0\r\n"
+      "X-Trailer: yes\r\n"
+      "\r\n";
+  for (std::size_t split = 1; split < data.size(); ++split) {
+    EXPECT_TRUE(parser.Parse(data.data(), split));
+    EXPECT_TRUE(parser.Parse(data.data() + split, data.size() - split));
+  }
+
+  ASSERT_EQ(parsed.Get().size(), data.size() - 1);
+  for (const auto& request : parsed.Get()) {
+    EXPECT_EQ(request->RequestBody(), "Wikipedia in \r\n\r\nchunks.");
+    EXPECT_EQ(request->GetHeader("X-Trailer"), "yes");
+  }
+}
+
+UTEST(HttpRequestSimdParser, KeepAlive) {
+  ParsedRequests parsed;
+  auto parser = server::CreateTestParser<server::http::HttpRequestSimdParser>(
+      parsed.MakeCallback());
+
+  const std::string_view data =
+      "GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"
+      "GET / HTTP/1.0\r\n\r\n";
+  EXPECT_TRUE(parser.Parse(data.data(), data.size()));
+  ASSERT_EQ(parsed.Get().size(), 2);
+  EXPECT_FALSE(parsed.Get()[0]->IsFinal());
+  EXPECT_TRUE(parsed.Get()[1]->IsFinal());
+}
+
+UTEST(HttpRequestSimdParser, Malformed) {
+  for (const std::string_view data : {
+           "GET / HTTP/1.1\r\nBad Header: value\r\n\r\n",
+           "GET / HTTP/1.1\r\nNoColon\r\n\r\n",
+           "GET / HTTP/1.1\r\nX-Folded: a\r\n b\r\n\r\n",
+           "GET / HTTP/1.1\r\nX-Control: a\x01 b\r\n\r\n",
+           "GET / HTTP/1.1\r\nX-Cr: a\rb\r\n\r\n",
+           "GET / HTTX/1.1\r\n\r\n",
+           "GET /\r\n\r\n",
+           "POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n",
+           "POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\n",
+       }) {
+    ParsedRequests parsed;
+    auto parser =
+        server::CreateTestParser<server::http::HttpRequestSimdParser>(
+            parsed.MakeCallback());
+
+    EXPECT_FALSE(parser.Parse(data.data(), data.size())) << data;
+    EXPECT_EQ(parsed.Get().size(), 1) << data;
+  }
+}
+
+UTEST(HttpRequestSimdParser, DuplicateContentLength) {
+  // Equal values are rejected as well, a proxy could have picked any of them
+  ExpectRejected(
+      "POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\na",
+      server::http::HttpStatus::kBadRequest);
+  ExpectRejected(
+      "POST / HTTP/1.1\r\ncontent-length: 0\r\nContent-Length: 0\r\n\r\n",
+      server::http::HttpStatus::kBadRequest);
+}
+
+UTEST(HttpRequestSimdParser, UnsupportedTransferEncoding) {
+  for (const std::string_view data : {
+           "POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: chunked, chunked\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n"
+           "Transfer-Encoding: chunked\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: identity\r\n\r\n",
+           "POST / HTTP/1.1\r\nTransfer-Encoding: \r\n\r\n",
+       }) {
+    ExpectRejected(data, server::http::HttpStatus::kNotImplemented);
+  }
+
+  ExpectRejected(
+      "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+      "Content-Length: 4\r\n\r\n",
+      server::http::HttpStatus::kBadRequest);
+}
+
+UTEST(HttpRequestSimdParser, ControlCharactersInRequestLine) {
+  for (const std::string_view data : {
+           "GET\t/ HTTP/1.1\r\n\r\n",
+           "GET /a\tb HTTP/1.1\r\n\r\n",
+           "GET /\tHTTP/1.1\r\n\r\n",
+           "GET / HTTP/1.1\t\r\n\r\n",
+           "GET /a\x01 HTTP/1.1\r\n\r\n",
+           "GET /a\x7f HTTP/1.1\r\n\r\n",
+           "GET /a b HTTP/1.1\r\n\r\n",
+       }) {
+    ExpectRejected(data, server::http::HttpStatus::kBadRequest);
+  }
+}
+
+UTEST(HttpRequestSimdParser, SameAsHttpParser) {
+  const std::string_view data =
+      "GET /a//b?x=1&y=%20 HTTP/1.1\r\n"
+      "Cookie: a=b; c=d\r\n"
+      "X-Long-Header-Name-To-Cross-Simd-Blocks: "
+      "value-value-value-value-value-value\r\n"
+      "\r\n";
+
+  ParsedRequests simd;
+  auto simd_parser =
+      server::CreateTestParser<server::http::HttpRequestSimdParser>(
+          simd.MakeCallback());
+  EXPECT_TRUE(simd_parser.Parse(data.data(), data.size()));
+
+  ParsedRequests reference;
+  auto reference_parser = server::CreateTestParser(reference.MakeCallback());
+  EXPECT_TRUE(reference_parser.Parse(data.data(), data.size()));
+
+  ASSERT_EQ(simd.Get().size(), 1);
+  ASSERT_EQ(reference.Get().size(), 1);
+  const server::http::HttpRequest lhs{*simd.Get()[0]};
+  const server::http::HttpRequest rhs{*reference.Get()[0]};
+  EXPECT_EQ(lhs.GetUrl(), rhs.GetUrl());
+  EXPECT_EQ(lhs.GetRequestPath(), rhs.GetRequestPath());
+  EXPECT_EQ(lhs.GetArg("y"), rhs.GetArg("y"));
+  EXPECT_EQ(lhs.GetCookie("c"), rhs.GetCookie("c"));
+  EXPECT_EQ(lhs.GetHeaders(), rhs.GetHeaders());
+}
+
+USERVER_NAMESPACE_END
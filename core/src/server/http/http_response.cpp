@@ -1,10 +1,15 @@
 #include <userver/server/http/http_response.hpp>
 
+#include <algorithm>
 #include <array>
+#include <memory>
+
+#include <unistd.h>
 
 #include <cctz/time_zone.h>
 #include <fmt/compile.h>
 
+#include <userver/engine/async.hpp>
 #include <userver/engine/deadline.hpp>
 #include <userver/engine/io/socket.hpp>
 #include <userver/hostinfo/blocking/get_hostname.hpp>
@@ -16,6 +21,9 @@
 #include <userver/utils/assert.hpp>
 #include <userver/utils/datetime/wall_coarse_clock.hpp>
 #include <userver/utils/small_string.hpp>
+#include <userver/utils/uuid4.hpp>
+
+#include <utils/check_syscall.hpp>
 
 #include <server/http/http_cached_date.hpp>
 
@@ -36,6 +44,9 @@ constexpr std::string_view kKeyValueHeaderSeparator = ": ";
 // charset https://www.iana.org/assignments/media-types/application/octet-stream
 constexpr std::string_view kDefaultContentType = "application/octet-stream";
 
+// Chunk size to read a file body on the fs task processor and send it over TLS
+constexpr std::size_t kFileBodyChunkSize = 64 * 1024;
+
 constexpr std::string_view kClose = "close";
 constexpr std::string_view kKeepAlive = "keep-alive";
 
@@ -72,6 +83,39 @@ void CheckHeaderValue(std::string_view value) {
   }
 }
 
+// RFC 9110, section 13.1.5: a strong entity tag or the exact Last-Modified
+// date of the response
+bool IsIfRangeMatched(std::string_view if_range, std::string_view etag,
+                      std::string_view last_modified) {
+  if (if_range.empty()) return true;
+  if (if_range.front() == '"' || if_range.substr(0, 2) == "W/") {
+    return if_range.front() == '"' && if_range == etag;
+  }
+  return if_range == last_modified;
+}
+
+std::string MakeContentRange(const server::http::ByteRange& range,
+                             std::uint64_t size) {
+  return fmt::format(FMT_COMPILE("bytes {}-{}/{}"), range.first, range.last,
+                     size);
+}
+
+std::string MakeMultipartPartHeaders(std::string_view boundary,
+                                     std::string_view content_type,
+                                     const server::http::ByteRange& range,
+                                     std::uint64_t size) {
+  return fmt::format(FMT_COMPILE("\r\n--{}\r\n{}: {}\r\n{}: {}\r\n\r\n"),
+                     boundary,
+                     std::string_view{http::headers::kContentType},
+                     content_type,
+                     std::string_view{http::headers::kContentRange},
+                     MakeContentRange(range, size));
+}
+
+std::string MakeMultipartEnd(std::string_view boundary) {
+  return fmt::format(FMT_COMPILE("\r\n--{}--\r\n"), boundary);
+}
+
 bool IsBodyForbiddenForStatus(server::http::HttpStatus status) {
   return status == server::http::HttpStatus::kNoContent ||
          status == server::http::HttpStatus::kNotModified ||
@@ -314,33 +358,108 @@ std::size_t HttpResponse::SetBodyNotStreamed(
   const bool is_body_forbidden = IsBodyForbiddenForStatus(status_);
   const bool is_head_request = request_.GetMethod() == HttpMethod::kHead;
   const auto& data = GetData();
+  const bool is_file_body = file_body_ && data.empty();
+  const std::uint64_t body_size = is_file_body ? file_body_->size
+                                               : data.size();
 
   if (!is_body_forbidden) {
     impl::OutputHeader(header, USERVER_NAMESPACE::http::headers::kContentLength,
-                       fmt::format(FMT_COMPILE("{}"), data.size()));
+                       fmt::format(FMT_COMPILE("{}"), body_size));
   }
   header.append(kCrlf);
 
-  if (is_body_forbidden && !data.empty()) {
+  if (is_body_forbidden && body_size != 0) {
     LOG_LIMITED_WARNING()
         << "Non-empty body provided for response with HTTP code "
         << static_cast<int>(status_)
         << " which does not allow one, it will be dropped";
   }
 
-  ssize_t sent_bytes = 0;
-  if (!is_head_request && !is_body_forbidden) {
+  std::size_t sent_bytes = 0;
+  if (is_head_request || is_body_forbidden) {
+    sent_bytes =
+        socket.WriteAll(header.data(), header.size(), engine::Deadline{});
+  } else if (is_file_body) {
+    sent_bytes =
+        socket.WriteAll(header.data(), header.size(), engine::Deadline{});
+    header.clear();
+    header.shrink_to_fit();  // free memory before time-consuming operation
+    sent_bytes += SendFileBody(socket);
+  } else {
     sent_bytes = socket.WriteAll(
         {{header.data(), header.size()}, {data.data(), data.size()}},
         engine::Deadline{});
-  } else {
-    sent_bytes =
-        socket.WriteAll(header.data(), header.size(), engine::Deadline{});
   }
+  file_body_.reset();
 
   return sent_bytes;
 }
 
+std::size_t HttpResponse::SendFileBody(engine::io::RwBase& socket) {
+  UASSERT(file_body_);
+  const int fd = file_body_->file.GetNative();
+  auto& fs_task_processor = *file_body_->fs_task_processor;
+  auto* plain_socket = dynamic_cast<engine::io::Socket*>(&socket);
+
+  std::unique_ptr<char[]> buffer;
+  const auto send_file_part = [&](std::uint64_t offset, std::uint64_t length) {
+    if (plain_socket) {
+      return plain_socket->SendFile(fd, offset, length, engine::Deadline{});
+    }
+
+    if (!buffer) buffer = std::make_unique<char[]>(kFileBodyChunkSize);
+    std::size_t sent_bytes = 0;
+    while (sent_bytes < length) {
+      // Disk reads may take long, do not block the thread that sends
+      const auto read_bytes =
+          engine::AsyncNoSpan(
+              fs_task_processor,
+              [fd, data = buffer.get(),
+               size = std::min<std::uint64_t>(length - sent_bytes,
+                                              kFileBodyChunkSize),
+               file_offset = static_cast<off_t>(offset + sent_bytes)] {
+                return static_cast<std::size_t>(utils::CheckSyscall(
+                    ::pread(fd, data, size, file_offset),
+                    "reading the response body file"));
+              })
+              .Get();
+      if (read_bytes == 0) break;
+
+      const auto chunk_size =
+          socket.WriteAll(buffer.get(), read_bytes, engine::Deadline{});
+      sent_bytes += chunk_size;
+      if (chunk_size != read_bytes) break;
+    }
+    return sent_bytes;
+  };
+
+  std::uint64_t sent_bytes = 0;
+  for (const auto& part : file_body_->parts) {
+    if (!part.prefix.empty()) {
+      sent_bytes += socket.WriteAll(part.prefix.data(), part.prefix.size(),
+                                    engine::Deadline{});
+    }
+    const auto part_sent_bytes = send_file_part(part.offset, part.length);
+    sent_bytes += part_sent_bytes;
+    if (part_sent_bytes != part.length) break;
+  }
+  if (sent_bytes == file_body_->size - file_body_->suffix.size() &&
+      !file_body_->suffix.empty()) {
+    sent_bytes += socket.WriteAll(file_body_->suffix.data(),
+                                  file_body_->suffix.size(),
+                                  engine::Deadline{});
+  }
+
+  if (sent_bytes != file_body_->size) {
+    // Content-Length is already sent, the connection must not be reused
+    throw std::runtime_error(fmt::format(
+        "Response body file is shorter than expected or the connection was "
+        "closed, sent {} of {} bytes",
+        sent_bytes, file_body_->size));
+  }
+  return sent_bytes;
+}
+
 std::size_t HttpResponse::SetBodyStreamed(
     engine::io::RwBase& socket,
     USERVER_NAMESPACE::http::headers::HeadersString& header) {
@@ -400,6 +519,125 @@ void HttpResponse::SetStreamBody() {
 
 bool HttpResponse::IsBodyStreamed() const { return body_stream_.has_value(); }
 
+void HttpResponse::SetFileBody(engine::TaskProcessor& fs_task_processor,
+                               fs::blocking::FileDescriptor file,
+                               std::uint64_t offset, std::uint64_t length) {
+  UINVARIANT(!IsBodyStreamed(), "File body can not be set for a stream");
+  std::vector<FileBodyPart> parts;
+  parts.push_back({{}, offset, length});
+  file_body_.emplace(FileBody{&fs_task_processor, std::move(file),
+                              std::move(parts), {}, length});
+}
+
+std::optional<std::vector<ByteRange>> HttpResponse::GetRequestedRanges(
+    std::uint64_t size) {
+  SetHeader(USERVER_NAMESPACE::http::headers::kAcceptRanges, "bytes");
+  if (request_.GetMethod() != HttpMethod::kGet || status_ != HttpStatus::kOk) {
+    return std::nullopt;
+  }
+
+  const auto& range =
+      request_.GetHeader(USERVER_NAMESPACE::http::headers::kRange);
+  if (range.empty()) return std::nullopt;
+  if (!IsIfRangeMatched(
+          request_.GetHeader(USERVER_NAMESPACE::http::headers::kIfRange),
+          GetHeader(USERVER_NAMESPACE::http::headers::kETag),
+          GetHeader(USERVER_NAMESPACE::http::headers::kLastModified))) {
+    return std::nullopt;
+  }
+
+  auto ranges = ParseByteRanges(range, size);
+  if (!ranges) return std::nullopt;
+
+  if (ranges->empty()) {
+    SetStatus(HttpStatus::kRangeNotSatisfiable);
+    SetHeader(USERVER_NAMESPACE::http::headers::kContentRange,
+              fmt::format(FMT_COMPILE("bytes */{}"), size));
+  } else {
+    SetStatus(HttpStatus::kPartialContent);
+    if (ranges->size() == 1) {
+      SetHeader(USERVER_NAMESPACE::http::headers::kContentRange,
+                MakeContentRange(ranges->front(), size));
+    }
+  }
+  return ranges;
+}
+
+std::string HttpResponse::ApplyRanges(std::string body) {
+  const auto ranges = GetRequestedRanges(body.size());
+  if (!ranges) return body;
+  if (ranges->empty()) return {};
+
+  if (ranges->size() == 1) {
+    const auto& range = ranges->front();
+    body.erase(range.last + 1);
+    body.erase(0, range.first);
+    return body;
+  }
+
+  const auto boundary = utils::generators::GenerateUuid();
+  const std::string content_type =
+      HasHeader(USERVER_NAMESPACE::http::headers::kContentType)
+          ? GetHeader(USERVER_NAMESPACE::http::headers::kContentType)
+          : std::string{kDefaultContentType};
+
+  std::string result;
+  for (const auto& range : *ranges) {
+    result += MakeMultipartPartHeaders(boundary, content_type, range,
+                                       body.size());
+    result.append(body, range.first, range.Size());
+  }
+  result += MakeMultipartEnd(boundary);
+
+  SetHeader(USERVER_NAMESPACE::http::headers::kContentType,
+            "multipart/byteranges; boundary=" + boundary);
+  return result;
+}
+
+void HttpResponse::SetFileBodyWithRanges(
+    engine::TaskProcessor& fs_task_processor,
+    fs::blocking::FileDescriptor file) {
+  UINVARIANT(!IsBodyStreamed(), "File body can not be set for a stream");
+  const auto size = file.GetSize();
+  const auto ranges = GetRequestedRanges(size);
+  if (!ranges) {
+    SetFileBody(fs_task_processor, std::move(file), 0, size);
+    return;
+  }
+  if (ranges->empty()) return;
+
+  if (ranges->size() == 1) {
+    SetFileBody(fs_task_processor, std::move(file), ranges->front().first,
+                ranges->front().Size());
+    return;
+  }
+
+  const auto boundary = utils::generators::GenerateUuid();
+  const std::string content_type =
+      HasHeader(USERVER_NAMESPACE::http::headers::kContentType)
+          ? GetHeader(USERVER_NAMESPACE::http::headers::kContentType)
+          : std::string{kDefaultContentType};
+
+  FileBody file_body{
+      &fs_task_processor, std::move(file), {}, MakeMultipartEnd(boundary), 0};
+  for (const auto& range : *ranges) {
+    auto prefix = MakeMultipartPartHeaders(boundary, content_type, range, size);
+    file_body.size += prefix.size() + range.Size();
+    file_body.parts.push_back({std::move(prefix), range.first, range.Size()});
+  }
+  file_body.size += file_body.suffix.size();
+  file_body_.emplace(std::move(file_body));
+
+  SetHeader(USERVER_NAMESPACE::http::headers::kContentType,
+            "multipart/byteranges; boundary=" + boundary);
+}
+
+void HttpResponse::SetFileBody(engine::TaskProcessor& fs_task_processor,
+                               fs::blocking::FileDescriptor file) {
+  const auto size = file.GetSize();
+  SetFileBody(fs_task_processor, std::move(file), 0, size);
+}
+
 HttpResponse::Queue::Producer HttpResponse::GetBodyProducer() {
   UASSERT(IsBodyStreamed());
   UASSERT_MSG(body_stream_producer_, "GetBodyProducer() is called twice");
@@ -4,8 +4,12 @@
 #include <fmt/format.h>
 #include <gmock/gmock.h>
 
+#include <server/http/http_request_constructor.hpp>
 #include <server/http/http_request_impl.hpp>
 #include <userver/engine/async.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
+#include <userver/fs/blocking/temp_file.hpp>
+#include <userver/fs/blocking/write.hpp>
 #include <userver/http/common_headers.hpp>
 #include <userver/internal/net/net_listener.hpp>
 #include <userver/server/http/http_response.hpp>
@@ -117,6 +121,291 @@ UTEST_P(HttpResponseBody, ForbiddenBody) {
 INSTANTIATE_UTEST_SUITE_P(HttpResponseForbiddenBody, HttpResponseBody,
                           testing::Values(100, 101, 150, 199, 304, 204));
 
+namespace {
+
+// Hides the socket type to make the response read and send the file in chunks,
+// just like for a TLS connection
+class OpaqueStream final : public engine::io::RwBase {
+ public:
+  explicit OpaqueStream(engine::io::Socket&& socket)
+      : socket_(std::move(socket)) {}
+
+  bool IsValid() const override { return socket_.IsValid(); }
+  bool WaitReadable(engine::Deadline deadline) override {
+    return socket_.WaitReadable(deadline);
+  }
+  size_t ReadSome(void* buf, size_t len, engine::Deadline deadline) override {
+    return socket_.ReadSome(buf, len, deadline);
+  }
+  size_t ReadAll(void* buf, size_t len, engine::Deadline deadline) override {
+    return socket_.ReadAll(buf, len, deadline);
+  }
+  bool WaitWriteable(engine::Deadline deadline) override {
+    return socket_.WaitWriteable(deadline);
+  }
+  size_t WriteAll(const void* buf, size_t len,
+                  engine::Deadline deadline) override {
+    return socket_.WriteAll(buf, len, deadline);
+  }
+
+ private:
+  engine::io::Socket socket_;
+};
+
+using Headers = std::vector<std::pair<std::string_view, std::string_view>>;
+
+std::shared_ptr<server::http::HttpRequestImpl> MakeRequest(
+    server::request::ResponseDataAccounter& accounter,
+    server::http::HttpMethod method, const Headers& headers) {
+  const server::http::HandlerInfoIndex handler_info_index;
+  server::http::HttpRequestConstructor constructor{{}, handler_info_index,
+                                                   accounter};
+  constructor.SetMethod(method);
+  constructor.SetHttpMajor(1);
+  constructor.SetHttpMinor(1);
+  constexpr std::string_view kUrl = "/file";
+  constructor.AppendUrl(kUrl.data(), kUrl.size());
+  constructor.ParseUrl();
+  for (const auto& [name, value] : headers) {
+    constructor.AppendHeader(name, value);
+  }
+
+  auto request = std::static_pointer_cast<server::http::HttpRequestImpl>(
+      constructor.Finalize());
+  // There are no handlers in the index
+  request->GetHttpResponse().SetStatus(server::http::HttpStatus::kOk);
+  return request;
+}
+
+std::string ReceiveResponse(server::http::HttpResponse& response,
+                            bool is_plain_socket, std::size_t max_size) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+  auto [server, client] =
+      internal::net::TcpListener{}.MakeSocketPair(test_deadline);
+  auto send_task = engine::AsyncNoSpan(
+      [is_plain_socket](auto&& response, auto&& socket) {
+        if (is_plain_socket) {
+          response.SendResponse(socket);
+        } else {
+          OpaqueStream stream{std::move(socket)};
+          response.SendResponse(stream);
+        }
+      },
+      std::ref(response), std::move(server));
+
+  std::string buffer(max_size, '\0');
+  const auto reply_size =
+      client.RecvAll(buffer.data(), buffer.size(), test_deadline);
+  buffer.resize(reply_size);
+  send_task.Get();
+  return buffer;
+}
+
+}  // namespace
+
+class HttpResponseFileBody : public testing::TestWithParam<bool> {};
+
+UTEST_P(HttpResponseFileBody, Send) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+  const bool is_plain_socket = GetParam();
+
+  std::string contents(300 * 1024, '\0');
+  for (std::size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), contents);
+
+  constexpr std::size_t kOffset = 7;
+  constexpr std::size_t kLength = 200 * 1024;
+
+  server::request::ResponseDataAccounter accounter;
+  server::http::HttpRequestImpl request{accounter};
+  server::http::HttpResponse response{request, accounter};
+
+  response.SetData({});
+  response.SetFileBody(engine::current_task::GetTaskProcessor(),
+                       fs::blocking::FileDescriptor::Open(
+                           file.GetPath(), fs::blocking::OpenFlag::kRead),
+                       kOffset, kLength);
+  EXPECT_TRUE(response.HasFileBody());
+
+  auto [server, client] =
+      internal::net::TcpListener{}.MakeSocketPair(test_deadline);
+  auto send_task = engine::AsyncNoSpan(
+      [is_plain_socket](auto&& response, auto&& socket) {
+        if (is_plain_socket) {
+          response.SendResponse(socket);
+        } else {
+          OpaqueStream stream{std::move(socket)};
+          response.SendResponse(stream);
+        }
+      },
+      std::ref(response), std::move(server));
+
+  std::string buffer(kLength + 4096, '\0');
+  const auto reply_size =
+      client.RecvAll(buffer.data(), buffer.size(), test_deadline);
+  buffer.resize(reply_size);
+  send_task.Get();
+
+  EXPECT_THAT(buffer, testing::HasSubstr(fmt::format(
+                          "\r\n{}: {}\r\n", http::headers::kContentLength,
+                          kLength)));
+  const auto body_pos = buffer.find("\r\n\r\n");
+  ASSERT_NE(body_pos, std::string::npos);
+  EXPECT_TRUE(std::string_view{buffer}.substr(body_pos + 4) ==
+              std::string_view{contents}.substr(kOffset, kLength));
+  EXPECT_FALSE(response.HasFileBody());
+  EXPECT_EQ(response.BytesSent(), reply_size);
+}
+
+UTEST_P(HttpResponseFileBody, SendRanges) {
+  const std::string contents = "0123456789abcdefghij";
+  const auto file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(file.GetPath(), contents);
+
+  server::request::ResponseDataAccounter accounter;
+  const auto request = MakeRequest(accounter, server::http::HttpMethod::kGet,
+                                   {{"Range", "bytes=1-2,-3"}});
+  auto& response = request->GetHttpResponse();
+  response.SetContentType(http::content_type::kTextPlain);
+  response.SetData({});
+  response.SetFileBodyWithRanges(
+      engine::current_task::GetTaskProcessor(),
+      fs::blocking::FileDescriptor::Open(file.GetPath(),
+                                         fs::blocking::OpenFlag::kRead));
+  EXPECT_EQ(response.GetStatus(), server::http::HttpStatus::kPartialContent);
+
+  const auto& content_type = response.GetHeader(http::headers::kContentType);
+  const std::string_view boundary_prefix = "multipart/byteranges; boundary=";
+  ASSERT_EQ(content_type.substr(0, boundary_prefix.size()), boundary_prefix);
+  const auto boundary = content_type.substr(boundary_prefix.size());
+
+  const auto reply = ReceiveResponse(response, GetParam(), 4096);
+  const auto body_pos = reply.find("\r\n\r\n");
+  ASSERT_NE(body_pos, std::string::npos);
+  const auto body = reply.substr(body_pos + 4);
+
+  EXPECT_EQ(body, fmt::format("\r\n--{0}\r\n"
+                              "Content-Type: text/plain; charset=utf-8\r\n"
+                              "Content-Range: bytes 1-2/20\r\n\r\n"
+                              "12"
+                              "\r\n--{0}\r\n"
+                              "Content-Type: text/plain; charset=utf-8\r\n"
+                              "Content-Range: bytes 17-19/20\r\n\r\n"
+                              "hij"
+                              "\r\n--{0}--\r\n",
+                              boundary));
+  EXPECT_THAT(reply, testing::HasSubstr(fmt::format(
+                         "\r\n{}: {}\r\n", http::headers::kContentLength,
+                         body.size())));
+}
+
+INSTANTIATE_UTEST_SUITE_P(HttpResponseFileBodySocket, HttpResponseFileBody,
+                          testing::Values(true, false));
+
+UTEST(HttpResponse, Ranges) {
+  server::request::ResponseDataAccounter accounter;
+  const auto request = MakeRequest(accounter, server::http::HttpMethod::kGet,
+                                   {{"Range", "bytes=2-4"}});
+
+  /// [Ranges]
+  auto& response = request->GetHttpResponse();
+  response.SetContentType(http::content_type::kTextPlain);
+  auto body = response.ApplyRanges("0123456789");
+  /// [Ranges]
+
+  EXPECT_EQ(body, "234");
+  EXPECT_EQ(response.GetStatus(), server::http::HttpStatus::kPartialContent);
+  EXPECT_EQ(response.GetHeader(http::headers::kContentRange), "bytes 2-4/10");
+  EXPECT_EQ(response.GetHeader(http::headers::kAcceptRanges), "bytes");
+}
+
+UTEST(HttpResponse, RangesMultipart) {
+  server::request::ResponseDataAccounter accounter;
+  const auto request = MakeRequest(accounter, server::http::HttpMethod::kGet,
+                                   {{"Range", "bytes=0-0,-1"}});
+  auto& response = request->GetHttpResponse();
+
+  const auto body = response.ApplyRanges("0123456789");
+  EXPECT_EQ(response.GetStatus(), server::http::HttpStatus::kPartialContent);
+  EXPECT_FALSE(response.HasHeader(http::headers::kContentRange));
+
+  const auto& content_type = response.GetHeader(http::headers::kContentType);
+  const std::string_view boundary_prefix = "multipart/byteranges; boundary=";
+  ASSERT_EQ(content_type.substr(0, boundary_prefix.size()), boundary_prefix);
+  const auto boundary = content_type.substr(boundary_prefix.size());
+
+  EXPECT_EQ(body, fmt::format("\r\n--{0}\r\n"
+                              "Content-Type: application/octet-stream\r\n"
+                              "Content-Range: bytes 0-0/10\r\n\r\n"
+                              "0"
+                              "\r\n--{0}\r\n"
+                              "Content-Type: application/octet-stream\r\n"
+                              "Content-Range: bytes 9-9/10\r\n\r\n"
+                              "9"
+                              "\r\n--{0}--\r\n",
+                              boundary));
+}
+
+UTEST(HttpResponse, RangesNotSatisfiable) {
+  server::request::ResponseDataAccounter accounter;
+  const auto request = MakeRequest(accounter, server::http::HttpMethod::kGet,
+                                   {{"Range", "bytes=10-"}});
+  auto& response = request->GetHttpResponse();
+
+  EXPECT_EQ(response.ApplyRanges("0123456789"), "");
+  EXPECT_EQ(response.GetStatus(),
+            server::http::HttpStatus::kRangeNotSatisfiable);
+  EXPECT_EQ(response.GetHeader(http::headers::kContentRange), "bytes */10");
+}
+
+UTEST(HttpResponse, RangesIgnored) {
+  const std::vector<std::pair<server::http::HttpMethod, Headers>> cases{
+      {server::http::HttpMethod::kGet, {}},
+      {server::http::HttpMethod::kGet, {{"Range", "bytes=2-1"}}},
+      {server::http::HttpMethod::kHead, {{"Range", "bytes=0-1"}}},
+      {server::http::HttpMethod::kPost, {{"Range", "bytes=0-1"}}},
+      {server::http::HttpMethod::kGet,
+       {{"Range", "bytes=0-1"}, {"If-Range", R"("other")"}}},
+      {server::http::HttpMethod::kGet,
+       {{"Range", "bytes=0-1"}, {"If-Range", R"(W/"tag")"}}},
+      {server::http::HttpMethod::kGet,
+       {{"Range", "bytes=0-1"},
+        {"If-Range", "Tue, 15 Nov 1994 08:12:31 GMT"}}},
+  };
+
+  for (const auto& [method, headers] : cases) {
+    server::request::ResponseDataAccounter accounter;
+    const auto request = MakeRequest(accounter, method, headers);
+    auto& response = request->GetHttpResponse();
+    response.SetHeader(http::headers::kETag, R"("tag")");
+
+    EXPECT_EQ(response.ApplyRanges("0123456789"), "0123456789");
+    EXPECT_EQ(response.GetStatus(), server::http::HttpStatus::kOk);
+  }
+}
+
+UTEST(HttpResponse, RangesIfRange) {
+  for (const std::string_view if_range :
+       {R"("tag")", "Tue, 15 Nov 1994 08:12:31 GMT"}) {
+    server::request::ResponseDataAccounter accounter;
+    const auto request =
+        MakeRequest(accounter, server::http::HttpMethod::kGet,
+                    {{"Range", "bytes=0-1"}, {"If-Range", if_range}});
+    auto& response = request->GetHttpResponse();
+    response.SetHeader(http::headers::kETag, R"("tag")");
+    response.SetHeader(http::headers::kLastModified,
+                       "Tue, 15 Nov 1994 08:12:31 GMT");
+
+    EXPECT_EQ(response.ApplyRanges("0123456789"), "01");
+    EXPECT_EQ(response.GetStatus(), server::http::HttpStatus::kPartialContent);
+  }
+}
+
 TEST(HttpResponse, GetHeaderDoesntThrow) {
   server::request::ResponseDataAccounter accounter{};
   const server::http::HttpRequestImpl request_impl{accounter};
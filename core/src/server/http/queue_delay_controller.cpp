@@ -0,0 +1,64 @@
+#include <server/http/queue_delay_controller.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+bool QueueDelayController::ShouldShed(Clock::duration delay,
+                                      Clock::time_point now,
+                                      const Settings& settings) noexcept {
+  const auto now_rep = now.time_since_epoch().count();
+  auto interval_end = interval_end_.load(std::memory_order_relaxed);
+  if (now_rep >= interval_end &&
+      interval_end_.compare_exchange_strong(interval_end,
+                                            now_rep + settings.interval.count(),
+                                            std::memory_order_relaxed)) {
+    // Only the winner of the race closes the interval. If more than one
+    // interval has passed, the last one had no requests at all.
+    const auto min_delay =
+        min_delay_.exchange(kNoDelay, std::memory_order_relaxed);
+    standing_delay_.store(
+        ComputeStandingDelay(min_delay, interval_end, now_rep, settings),
+        std::memory_order_relaxed);
+  }
+
+  const auto delay_rep = delay.count();
+  auto min_delay = min_delay_.load(std::memory_order_relaxed);
+  while (delay_rep < min_delay &&
+         !min_delay_.compare_exchange_weak(min_delay, delay_rep,
+                                           std::memory_order_relaxed)) {
+  }
+
+  const bool is_standing =
+      standing_delay_.load(std::memory_order_relaxed) != 0;
+  return delay > (is_standing ? settings.target : settings.interval);
+}
+
+QueueDelayController::Clock::duration QueueDelayController::GetStandingDelay(
+    Clock::time_point now, const Settings& settings) const noexcept {
+  const auto now_rep = now.time_since_epoch().count();
+  const auto interval_end = interval_end_.load(std::memory_order_relaxed);
+  if (now_rep < interval_end) {
+    return Clock::duration{standing_delay_.load(std::memory_order_relaxed)};
+  }
+
+  // The interval is over but was not closed by ShouldShed yet, e.g. because
+  // all the requests were shed before they got into the queue. Answer as if
+  // it was closed now, so that a stale standing delay does not outlive it.
+  return Clock::duration{
+      ComputeStandingDelay(min_delay_.load(std::memory_order_relaxed),
+                           interval_end, now_rep, settings)};
+}
+
+QueueDelayController::Clock::rep QueueDelayController::ComputeStandingDelay(
+    Clock::rep min_delay, Clock::rep interval_end, Clock::rep now,
+    const Settings& settings) noexcept {
+  const bool is_standing = min_delay != kNoDelay &&
+                           min_delay > settings.target.count() &&
+                           now < interval_end + settings.interval.count();
+  return is_standing ? min_delay : 0;
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
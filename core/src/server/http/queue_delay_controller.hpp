@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+/// @brief CoDel-style controller of the time incoming requests spend in the
+/// task processor queue.
+///
+/// The minimal queue delay over an interval tells a standing queue from
+/// a burst: if even the fastest request of the last interval waited for more
+/// than the target, the queue is standing and the server is overloaded. In
+/// that state the requests that waited for more than the target are shed,
+/// otherwise only the ones that waited for more than the whole interval.
+/// See "Controlling Queue Delay" by K. Nichols and V. Jacobson.
+class QueueDelayController final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Settings final {
+    Clock::duration target;
+    Clock::duration interval;
+  };
+
+  /// Accounts the queue delay of a request that is about to start, returns
+  /// true if the request should be rejected
+  bool ShouldShed(Clock::duration delay, Clock::time_point now,
+                  const Settings& settings) noexcept;
+
+  /// Minimal queue delay over the last interval if the queue is standing,
+  /// zero otherwise
+  Clock::duration GetStandingDelay(Clock::time_point now,
+                                   const Settings& settings) const noexcept;
+
+ private:
+  static constexpr auto kNoDelay = Clock::duration::max().count();
+
+  static Clock::rep ComputeStandingDelay(Clock::rep min_delay,
+                                         Clock::rep interval_end,
+                                         Clock::rep now,
+                                         const Settings& settings) noexcept;
+
+  // Time points and durations are stored as Clock::rep to be lock-free
+  std::atomic<Clock::rep> interval_end_{0};
+  std::atomic<Clock::rep> min_delay_{kNoDelay};
+  std::atomic<Clock::rep> standing_delay_{0};
+};
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <server/http/queue_delay_controller.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using server::http::QueueDelayController;
+using namespace std::chrono_literals;
+
+const QueueDelayController::Settings kSettings{5ms, 100ms};
+
+}  // namespace
+
+TEST(QueueDelayController, BurstIsNotShed) {
+  QueueDelayController controller;
+  auto now = QueueDelayController::Clock::now();
+
+  for (int interval = 0; interval < 3; ++interval) {
+    // A single fast request per interval means there is no standing queue
+    EXPECT_FALSE(controller.ShouldShed(1ms, now, kSettings));
+    EXPECT_FALSE(controller.ShouldShed(50ms, now + 10ms, kSettings));
+    now += 101ms;
+  }
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 0ms);
+
+  // Requests that waited for more than the whole interval are always shed
+  EXPECT_TRUE(controller.ShouldShed(150ms, now, kSettings));
+}
+
+TEST(QueueDelayController, StandingQueueIsShed) {
+  QueueDelayController controller;
+  auto now = QueueDelayController::Clock::now();
+
+  EXPECT_FALSE(controller.ShouldShed(20ms, now, kSettings));
+  EXPECT_FALSE(controller.ShouldShed(30ms, now + 50ms, kSettings));
+  now += 101ms;
+
+  // The fastest request of the previous interval waited for more than
+  // the target, so everything above the target is shed now
+  EXPECT_TRUE(controller.ShouldShed(20ms, now, kSettings));
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 20ms);
+  EXPECT_FALSE(controller.ShouldShed(3ms, now + 10ms, kSettings));
+  now += 101ms;
+
+  // The queue has drained
+  EXPECT_FALSE(controller.ShouldShed(20ms, now, kSettings));
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 0ms);
+}
+
+TEST(QueueDelayController, IdleIntervalResetsState) {
+  QueueDelayController controller;
+  auto now = QueueDelayController::Clock::now();
+
+  EXPECT_FALSE(controller.ShouldShed(20ms, now, kSettings));
+  now += 101ms;
+  EXPECT_TRUE(controller.ShouldShed(20ms, now, kSettings));
+
+  // No requests at all for an interval
+  now += 201ms;
+  EXPECT_FALSE(controller.ShouldShed(20ms, now, kSettings));
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 0ms);
+}
+
+TEST(QueueDelayController, StandingDelayExpiresWithoutRequests) {
+  QueueDelayController controller;
+  auto now = QueueDelayController::Clock::now();
+
+  EXPECT_FALSE(controller.ShouldShed(20ms, now, kSettings));
+  now += 101ms;
+  EXPECT_TRUE(controller.ShouldShed(20ms, now, kSettings));
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 20ms);
+
+  // All the following requests are shed before they get into the queue,
+  // so ShouldShed is not called for them. The standing delay measured by
+  // the last request is used for the whole next interval.
+  EXPECT_EQ(controller.GetStandingDelay(now + 50ms, kSettings), 20ms);
+  EXPECT_EQ(controller.GetStandingDelay(now + 150ms, kSettings), 20ms);
+
+  // No request got through the queue for the whole interval, so it is not
+  // known to be standing anymore and the requests are let in again
+  EXPECT_EQ(controller.GetStandingDelay(now + 201ms, kSettings), 0ms);
+  EXPECT_EQ(controller.GetStandingDelay(now + 500ms, kSettings), 0ms);
+
+  // The queue is still standing, the first request after the pause tells so
+  now += 301ms;
+  EXPECT_FALSE(controller.ShouldShed(30ms, now, kSettings));
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 0ms);
+  EXPECT_EQ(controller.GetStandingDelay(now + 101ms, kSettings), 30ms);
+  now += 101ms;
+  EXPECT_TRUE(controller.ShouldShed(30ms, now, kSettings));
+  EXPECT_EQ(controller.GetStandingDelay(now, kSettings), 30ms);
+}
+
+USERVER_NAMESPACE_END
@@ -1,5 +1,7 @@
 #include "connection.hpp"
 
+#include <sys/socket.h>
+
 #include <algorithm>
 #include <array>
 #include <stdexcept>
@@ -7,6 +9,7 @@
 #include <vector>
 
 #include <server/http/http_request_parser.hpp>
+#include <server/http/http_request_simd_parser.hpp>
 #include <server/http/request_handler_base.hpp>
 
 #include <userver/engine/async.hpp>
@@ -23,6 +26,27 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::net {
 
+namespace {
+
+// The cached request slots are freed if the connection receives nothing for
+// this long, so that idle keep-alive connections hold no memory
+constexpr std::chrono::seconds kRequestPoolIdleTimeout{1};
+
+bool WaitReadable(engine::io::RwBase& socket, http::HttpRequestPool& pool,
+                  engine::Deadline deadline) {
+  if (pool.HasFreeSlots()) {
+    const auto idle_deadline =
+        engine::Deadline::FromDuration(kRequestPoolIdleTimeout);
+    if (idle_deadline < deadline) {
+      if (socket.WaitReadable(idle_deadline)) return true;
+      pool.ReleaseFreeSlots();
+    }
+  }
+  return socket.WaitReadable(deadline);
+}
+
+}  // namespace
+
 Connection::Connection(
     const ConnectionConfig& config,
     const request::HttpRequestConfig& handler_defaults_config,
@@ -102,14 +126,24 @@ void Connection::ListenForRequests(
   try {
     request_tasks_->SetSoftMaxSize(config_.requests_queue_size_threshold);
 
-    http::HttpRequestParser request_parser(
-        request_handler_.GetHandlerInfoIndex(), handler_defaults_config_,
-        [this, &producer](RequestBasePtr&& request_ptr) {
-          if (!NewRequest(std::move(request_ptr), producer)) {
-            is_accepting_requests_ = false;
-          }
-        },
-        stats_->parser_stats, data_accounter_);
+    auto on_new_request = [this, &producer](RequestBasePtr&& request_ptr) {
+      if (!NewRequest(std::move(request_ptr), producer)) {
+        is_accepting_requests_ = false;
+      }
+    };
+    const auto request_pool = http::HttpRequestConstructor::CreateRequestPool();
+    std::unique_ptr<request::RequestParser> request_parser;
+    if (config_.request_parser == RequestParserType::kSimd) {
+      request_parser = std::make_unique<http::HttpRequestSimdParser>(
+          request_handler_.GetHandlerInfoIndex(), handler_defaults_config_,
+          std::move(on_new_request), stats_->parser_stats, data_accounter_,
+          request_pool);
+    } else {
+      request_parser = std::make_unique<http::HttpRequestParser>(
+          request_handler_.GetHandlerInfoIndex(), handler_defaults_config_,
+          std::move(on_new_request), stats_->parser_stats, data_accounter_,
+          request_pool);
+    }
 
     std::vector<char> buf(config_.in_buffer_size);
     std::size_t last_bytes_read = 0;
@@ -128,7 +162,7 @@ void Connection::ListenForRequests(
       //
       // So instead we just do 2. and 3., shaving off a whole recv syscall
       if (last_bytes_read != buf.size()) {
-        is_readable = peer_socket_->WaitReadable(deadline);
+        is_readable = WaitReadable(*peer_socket_, *request_pool, deadline);
       }
 
       last_bytes_read =
@@ -150,7 +184,7 @@ void Connection::ListenForRequests(
       LOG_TRACE() << "Received " << last_bytes_read << " byte(s) from "
                   << Getpeername() << " on fd " << Fd();
 
-      if (!request_parser.Parse(buf.data(), last_bytes_read)) {
+      if (!request_parser->Parse(buf.data(), last_bytes_read)) {
         LOG_DEBUG() << "Malformed request from " << Getpeername() << " on fd "
                     << Fd();
 
@@ -278,9 +312,15 @@ void Connection::SendResponse(request::RequestBase& request) {
               ? logging::Level::kWarning
               : logging::Level::kError;
       LOG(log_level) << "I/O error while sending data: " << ex;
+      // The error may come from the file of the body, while the socket is
+      // still alive and has the response sent partially
+      AbortResponseChain();
       response.SetSendFailed(std::chrono::steady_clock::now());
     } catch (const std::exception& ex) {
       LOG_ERROR() << "Error while sending data: " << ex;
+      // The response may be sent partially, following responses would be
+      // garbled
+      AbortResponseChain();
       response.SetSendFailed(std::chrono::steady_clock::now());
     }
   } else {
@@ -294,6 +334,15 @@ void Connection::SendResponse(request::RequestBase& request) {
                           request_handler_.LoggerAccessTskv(), peer_name_);
 }
 
+void Connection::AbortResponseChain() noexcept {
+  is_response_chain_valid_ = false;
+
+  // The client waits for the rest of the response that is never sent. Close
+  // the connection to let it know, the listener stops on the closed socket.
+  const auto fd = Fd();
+  if (fd >= 0) ::shutdown(fd, SHUT_RDWR);
+}
+
 std::string Connection::Getpeername() const { return peer_name_; }
 
 }  // namespace server::net
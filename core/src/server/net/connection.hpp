@@ -51,6 +51,9 @@ class Connection final {
   void ProcessResponses(Queue::Consumer&) noexcept;
   void HandleQueueItem(QueueItem& item) noexcept;
   void SendResponse(request::RequestBase& request);
+  // Stops sending responses after a partially sent one and closes
+  // the connection
+  void AbortResponseChain() noexcept;
 
   std::string Getpeername() const;
 
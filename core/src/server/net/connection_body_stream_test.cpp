@@ -0,0 +1,324 @@
+#include <userver/utest/utest.hpp>
+
+#include <netinet/in.h>
+
+#include <charconv>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include <components/component_list_test.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/components/minimal_server_component_list.hpp>
+#include <userver/components/run.hpp>
+#include <userver/engine/io/exception.hpp>
+#include <userver/engine/io/socket.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/internal/net/net_listener.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_request_body_stream.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// More than the body stream queue, the parser buffer and the socket buffers
+// on both sides can hold together
+constexpr std::size_t kLargeBodySize = 32 * 1024 * 1024;
+
+char BodyByte(std::size_t offset) {
+  return static_cast<char>('a' + offset % 26);
+}
+
+std::string MakeBody(std::size_t size) {
+  std::string body(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) body[i] = BodyByte(i);
+  return body;
+}
+
+std::string MakeRequestHead(std::string_view type, std::size_t body_size) {
+  return fmt::format(
+      "POST /stream?type={} HTTP/1.1\r\nHost: localhost\r\n"
+      "Content-Length: {}\r\n\r\n",
+      type, body_size);
+}
+
+std::string MakeRequest(std::string_view type, std::string_view body) {
+  return MakeRequestHead(type, body.size()).append(body);
+}
+
+engine::Deadline MakeDeadline() {
+  return engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+}
+
+class StreamHandler final : public server::handlers::HttpHandlerBase {
+ public:
+  static constexpr std::string_view kName = "handler-body-stream";
+
+  StreamHandler(const components::ComponentConfig& config,
+                const components::ComponentContext& context)
+      : HttpHandlerBase(config, context) {}
+
+  std::string HandleRequestThrow(
+      const server::http::HttpRequest& request,
+      server::request::RequestContext&) const override {
+    EXPECT_TRUE(request.IsRequestBodyStreamed());
+    auto& body = request.GetRequestBodyStream();
+    const auto& type = request.GetArg("type");
+
+    if (type == "first-chunk") {
+      // The rest of the body is left unread
+      std::string chunk;
+      EXPECT_TRUE(body.ReadChunk(chunk));
+      return chunk;
+    }
+
+    if (type == "slow") {
+      EXPECT_TRUE(resume_reading_.WaitForEventFor(utest::kMaxTestWaitTime));
+
+      std::size_t size = 0;
+      std::string chunk;
+      while (body.ReadChunk(chunk)) {
+        for (const char c : chunk) {
+          if (c != BodyByte(size++)) return "corrupted";
+        }
+        engine::SleepFor(std::chrono::milliseconds{1});
+      }
+      return std::to_string(size);
+    }
+
+    return body.ReadAll();
+  }
+
+  void ResumeReading() { resume_reading_.Send(); }
+
+ private:
+  mutable engine::SingleConsumerEvent resume_reading_;
+};
+
+// HTTP/1.1 client over a raw socket, so that the requests could be pipelined
+// and their bodies could be sent in parts
+class RawClient final {
+ public:
+  explicit RawClient(std::uint16_t port)
+      : socket_(engine::io::AddrDomain::kInet6,
+                engine::io::SocketType::kStream) {
+    engine::io::Sockaddr addr;
+    auto* sa = addr.As<sockaddr_in6>();
+    sa->sin6_family = AF_INET6;
+    sa->sin6_addr = in6addr_loopback;
+    addr.SetPort(port);
+    socket_.Connect(addr, MakeDeadline());
+  }
+
+  void Send(std::string_view data) {
+    EXPECT_EQ(socket_.SendAll(data.data(), data.size(), MakeDeadline()),
+              data.size());
+  }
+
+  // Returns the count of bytes sent before the deadline
+  std::size_t SendUntil(std::string_view data, engine::Deadline deadline) {
+    try {
+      return socket_.SendAll(data.data(), data.size(), deadline);
+    } catch (const engine::io::IoTimeout& ex) {
+      return ex.BytesTransferred();
+    }
+  }
+
+  // Returns the body of the next response
+  std::string ReadResponse() {
+    auto headers_end = buffer_.find("\r\n\r\n");
+    while (headers_end == std::string::npos) {
+      Recv();
+      headers_end = buffer_.find("\r\n\r\n");
+    }
+    const std::string_view headers{buffer_.data(), headers_end};
+    EXPECT_EQ(headers.substr(0, 12), "HTTP/1.1 200") << headers;
+
+    constexpr std::string_view kContentLength = "\r\nContent-Length: ";
+    const auto length_pos = headers.find(kContentLength);
+    if (length_pos == std::string_view::npos) {
+      ADD_FAILURE() << "No Content-Length in " << headers;
+      return {};
+    }
+    const auto* length_begin =
+        headers.data() + length_pos + kContentLength.size();
+    std::size_t length = 0;
+    const auto [ptr, ec] =
+        std::from_chars(length_begin, headers.data() + headers.size(), length);
+    EXPECT_EQ(ec, std::errc{}) << headers;
+
+    const auto body_begin = headers_end + 4;
+    while (buffer_.size() < body_begin + length) Recv();
+    auto body = buffer_.substr(body_begin, length);
+    buffer_.erase(0, body_begin + length);
+    return body;
+  }
+
+ private:
+  void Recv() {
+    char data[4096];
+    const auto size = socket_.RecvSome(data, sizeof(data), MakeDeadline());
+    if (size == 0) {
+      throw std::runtime_error("Connection was closed by the server");
+    }
+    buffer_.append(data, size);
+  }
+
+  engine::io::Socket socket_;
+  std::string buffer_;
+};
+
+// Runs the scenario from the static config once the server is started
+class StreamClient final : public components::LoggableComponentBase {
+ public:
+  static constexpr std::string_view kName = "body-stream-client";
+
+  StreamClient(const components::ComponentConfig& config,
+               const components::ComponentContext& context)
+      : components::LoggableComponentBase(config, context),
+        handler_(context.FindComponent<StreamHandler>()),
+        scenario_(config["scenario"].As<std::string>()),
+        port_(config["port"].As<std::uint16_t>()) {}
+
+  void OnAllComponentsLoaded() override {
+    if (scenario_ == "handoff") {
+      Handoff();
+    } else if (scenario_ == "ordering") {
+      Ordering();
+    } else if (scenario_ == "backpressure") {
+      Backpressure();
+    } else {
+      ADD_FAILURE() << "Unknown scenario " << scenario_;
+    }
+  }
+
+ private:
+  void Handoff() {
+    RawClient client{port_};
+    const auto body = MakeBody(kLargeBodySize);
+    const std::string_view head_part{body.data(), 4};
+
+    client.Send(MakeRequestHead("first-chunk", body.size()).append(head_part));
+    // The handler is started and responds before the body is received
+    const auto response = client.ReadResponse();
+    EXPECT_FALSE(response.empty());
+    EXPECT_EQ(response, head_part.substr(0, response.size()));
+
+    // The unread part of the body is discarded, even if it does not fit into
+    // the stream queue, and the connection is kept alive
+    client.Send(std::string_view{body}.substr(head_part.size()));
+    client.Send(MakeRequest("echo", "next"));
+    EXPECT_EQ(client.ReadResponse(), "next");
+  }
+
+  void Ordering() {
+    RawClient client{port_};
+    const auto chunked_request =
+        "POST /stream?type=echo HTTP/1.1\r\nHost: localhost\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n"
+        "3\r\nsec\r\n3\r\nond\r\n0\r\n\r\n";
+    client.Send(MakeRequest("echo", "first") + chunked_request +
+                MakeRequest("echo", "") + MakeRequest("echo", "third"));
+
+    // Every body is finished and the responses come in the requests order
+    EXPECT_EQ(client.ReadResponse(), "first");
+    EXPECT_EQ(client.ReadResponse(), "second");
+    EXPECT_EQ(client.ReadResponse(), "");
+    EXPECT_EQ(client.ReadResponse(), "third");
+  }
+
+  void Backpressure() {
+    RawClient client{port_};
+    const auto request =
+        MakeRequestHead("slow", kLargeBodySize) + MakeBody(kLargeBodySize);
+
+    // The handler does not read yet, so the server stops reading the socket
+    const auto sent = client.SendUntil(
+        request,
+        engine::Deadline::FromDuration(std::chrono::milliseconds{500}));
+    EXPECT_LT(sent, request.size());
+
+    handler_.ResumeReading();
+    client.Send(std::string_view{request}.substr(sent));
+    EXPECT_EQ(client.ReadResponse(), std::to_string(kLargeBodySize));
+  }
+
+  StreamHandler& handler_;
+  const std::string scenario_;
+  const std::uint16_t port_;
+};
+
+constexpr std::string_view kStaticConfig = R"(
+components_manager:
+  coro_pool:
+    initial_size: 50
+    max_size: 500
+  default_task_processor: main-task-processor
+  event_thread_pool:
+    threads: 2
+  task_processors:
+    fs-task-processor:
+      worker_threads: 2
+    main-task-processor:
+      worker_threads: 4
+  components:
+    logging:
+      fs-task-processor: fs-task-processor
+      loggers:
+        default:
+          file_path: '@null'
+          level: warning
+    dynamic-config:
+      defaults: {{}}
+    server:
+      listener:
+          port: {0}
+          task_processor: main-task-processor
+    handler-body-stream:
+      path: /stream
+      method: POST
+      task_processor: main-task-processor
+      request-body-stream: true
+      max_request_size: 67108864
+    body-stream-client:
+      port: {0}
+      scenario: {1}
+)";
+
+std::uint16_t FindFreePort() {
+  std::uint16_t result{};
+  engine::RunStandalone([&result] {
+    const internal::net::TcpListener listener{};
+    result = listener.Port();
+  });
+  return result;
+}
+
+void RunScenario(std::string_view scenario) {
+  components::RunOnce(
+      components::InMemoryConfig{
+          fmt::format(kStaticConfig, FindFreePort(), scenario)},
+      components::MinimalServerComponentList()
+          .Append<StreamHandler>()
+          .Append<StreamClient>());
+}
+
+}  // namespace
+
+class ServerNetConnectionBodyStream : public ComponentList {};
+
+TEST_F(ServerNetConnectionBodyStream, HandoffAndDiscard) {
+  RunScenario("handoff");
+}
+
+TEST_F(ServerNetConnectionBodyStream, Ordering) { RunScenario("ordering"); }
+
+TEST_F(ServerNetConnectionBodyStream, Backpressure) {
+  RunScenario("backpressure");
+}
+
+USERVER_NAMESPACE_END
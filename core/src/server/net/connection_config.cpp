@@ -1,11 +1,26 @@
 #include <server/net/connection_config.hpp>
 
+#include <stdexcept>
+
+#include <fmt/format.h>
+
 #include <userver/yaml_config/yaml_config.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace server::net {
 
+RequestParserType Parse(const yaml_config::YamlConfig& value,
+                        formats::parse::To<RequestParserType>) {
+  const auto str = value.As<std::string>();
+  if (str == "http_parser") return RequestParserType::kHttpParser;
+  if (str == "simd") return RequestParserType::kSimd;
+
+  throw std::runtime_error(fmt::format(
+      "Invalid request parser '{}' at '{}', expected 'http_parser' or 'simd'",
+      str, value.GetPath()));
+}
+
 ConnectionConfig Parse(const yaml_config::YamlConfig& value,
                        formats::parse::To<ConnectionConfig>) {
   ConnectionConfig config;
@@ -18,6 +33,8 @@ ConnectionConfig Parse(const yaml_config::YamlConfig& value,
   config.keepalive_timeout =
       value["keepalive_timeout"].As<std::chrono::seconds>(
           config.keepalive_timeout);
+  config.request_parser =
+      value["request_parser"].As<RequestParserType>(config.request_parser);
 
   return config;
 }
@@ -9,10 +9,19 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::net {
 
+enum class RequestParserType {
+  kHttpParser,
+  kSimd,
+};
+
+RequestParserType Parse(const yaml_config::YamlConfig& value,
+                        formats::parse::To<RequestParserType>);
+
 struct ConnectionConfig {
   size_t in_buffer_size = 32 * 1024;
   size_t requests_queue_size_threshold = 100;
   std::chrono::seconds keepalive_timeout{10 * 60};
+  RequestParserType request_parser{RequestParserType::kHttpParser};
 };
 
 ConnectionConfig Parse(const yaml_config::YamlConfig& value,
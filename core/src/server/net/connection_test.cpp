@@ -1,6 +1,7 @@
 #include <server/net/connection.hpp>
 
 #include <fmt/format.h>
+#include <gmock/gmock.h>
 
 #include <server/handlers/http_handler_base_statistics.hpp>
 #include <server/http/http_request_impl.hpp>
@@ -9,6 +10,10 @@
 #include <userver/clients/http/client.hpp>
 #include <userver/engine/io/sockaddr.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/fs/blocking/file_descriptor.hpp>
+#include <userver/fs/blocking/temp_directory.hpp>
+#include <userver/fs/blocking/temp_file.hpp>
+#include <userver/fs/blocking/write.hpp>
 
 #include <userver/utest/http_client.hpp>
 #include <userver/utest/utest.hpp>
@@ -23,10 +28,11 @@ constexpr auto kAcceptTimeout = utest::kMaxTestWaitTime;
 
 class TestHttprequestHandler : public server::http::RequestHandlerBase {
  public:
-  enum class Behaviors { kNoop, kHang };
+  enum class Behaviors { kNoop, kHang, kFileBody };
 
-  explicit TestHttprequestHandler(Behaviors behavior = Behaviors::kNoop)
-      : behavior_(behavior) {}
+  explicit TestHttprequestHandler(Behaviors behavior = Behaviors::kNoop,
+                                  std::string file_body_path = {})
+      : behavior_(behavior), file_body_path_(std::move(file_body_path)) {}
 
   engine::TaskWithResult<void> StartRequestTask(
       std::shared_ptr<server::request::RequestBase> request) const override {
@@ -45,6 +51,17 @@ class TestHttprequestHandler : public server::http::RequestHandlerBase {
           ASSERT_TRUE(engine::current_task::IsCancelRequested());
           ++asyncs_finished;
         });
+      case Behaviors::kFileBody:
+        return engine::AsyncNoSpan([this, &http_request]() {
+          auto& response = http_request.GetHttpResponse();
+          response.SetStatus(server::http::HttpStatus::kOk);
+          response.SetFileBody(
+              engine::current_task::GetTaskProcessor(),
+              fs::blocking::FileDescriptor::Open(file_body_path_,
+                                                 fs::blocking::OpenFlag::kRead),
+              0, kFileBodySize);
+          ++asyncs_finished;
+        });
     }
 
     UINVARIANT(false, "Unexpected behavior");
@@ -64,8 +81,11 @@ class TestHttprequestHandler : public server::http::RequestHandlerBase {
   // NOLINTNEXTLINE(misc-non-private-member-variables-in-classes)
   mutable std::atomic<std::size_t> asyncs_finished{0};
 
+  static constexpr std::size_t kFileBodySize = 1024;
+
  private:
   const Behaviors behavior_;
+  const std::string file_body_path_;
   logging::LoggerPtr no_logger_;
   server::http::HandlerInfoIndex handler_info_index_;
 };
@@ -323,4 +343,64 @@ UTEST(ServerNetConnection, CancelMultipleInFlight) {
   FAIL() << "Failed to simulate cancellation of multiple requests";
 }
 
+UTEST(ServerNetConnection, FileBodyFailureClosesKeepAlive) {
+  const auto short_file = fs::blocking::TempFile::Create();
+  fs::blocking::RewriteFileContents(short_file.GetPath(), "short body");
+  // sendfile fails with EINVAL for a directory after the headers are sent
+  const auto directory = fs::blocking::TempDirectory::Create();
+
+  for (const auto& path : {short_file.GetPath(), directory.GetPath()}) {
+    net::ListenerConfig config = CreateConfig();
+    auto request_socket = net::CreateSocket(config);
+
+    const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+    const auto addr = request_socket.Getsockname();
+    engine::io::Socket client{addr.Domain(), engine::io::SocketType::kStream};
+    client.Connect(addr, deadline);
+
+    auto peer = request_socket.Accept(Deadline::FromDuration(kAcceptTimeout));
+    ASSERT_TRUE(peer.IsValid());
+    auto stats = std::make_shared<net::Stats>();
+    server::request::ResponseDataAccounter data_accounter;
+    TestHttprequestHandler handler{
+        TestHttprequestHandler::Behaviors::kFileBody, path};
+
+    auto task = engine::AsyncNoSpan([&] {
+      net::Connection connection(
+          config.connection_config, config.handler_defaults,
+          std::make_unique<engine::io::Socket>(std::move(peer)), {}, handler,
+          stats, data_accounter);
+
+      connection.Process();
+    });
+
+    // Two pipelined requests on a keep-alive connection
+    constexpr std::string_view kRequests =
+        "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+        "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ASSERT_EQ(client.SendAll(kRequests.data(), kRequests.size(), deadline),
+              kRequests.size());
+
+    // The server closes the connection instead of sending the next response
+    // right after the incomplete body
+    std::string reply(64 * 1024, '\0');
+    reply.resize(client.RecvAll(reply.data(), reply.size(), deadline));
+    EXPECT_FALSE(deadline.IsReached()) << path;
+
+    const auto headers_end = reply.find("\r\n\r\n");
+    ASSERT_NE(headers_end, std::string::npos) << path;
+    EXPECT_THAT(reply.substr(0, headers_end),
+                testing::HasSubstr(fmt::format(
+                    "Content-Length: {}",
+                    TestHttprequestHandler::kFileBodySize)));
+    EXPECT_LT(reply.size() - headers_end - 4,
+              TestHttprequestHandler::kFileBodySize)
+        << path;
+    EXPECT_EQ(reply.find("HTTP/1.1", headers_end), std::string::npos) << path;
+
+    task.WaitFor(utest::kMaxTestWaitTime);
+    EXPECT_TRUE(task.IsFinished()) << path;
+  }
+}
+
 USERVER_NAMESPACE_END
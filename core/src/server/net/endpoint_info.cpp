@@ -6,7 +6,16 @@ namespace server::net {
 
 EndpointInfo::EndpointInfo(const ListenerConfig& listener_config,
                            http::HttpRequestHandler& request_handler)
-    : listener_config(listener_config), request_handler(request_handler) {}
+    : listener_config(listener_config), request_handler(request_handler) {
+  if (listener_config.tls && listener_config.tls_session_cache_size) {
+    tls_session_cache = std::make_unique<engine::io::TlsServerSessionCache>(
+        listener_config.tls_session_cache_size,
+        listener_config.tls_session_timeout);
+    if (!listener_config.tls_session_ticket_keys.empty()) {
+      tls_session_cache->SetTicketKeys(listener_config.tls_session_ticket_keys);
+    }
+  }
+}
 
 std::string EndpointInfo::GetDescription() const {
   if (listener_config.unix_socket_path.empty())
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
+
+#include <userver/engine/io/tls_session_cache.hpp>
 
 #include <server/http/http_request_handler.hpp>
 #include <server/net/connection.hpp>
@@ -18,6 +21,7 @@ struct EndpointInfo {
   const ListenerConfig& listener_config;
   http::HttpRequestHandler& request_handler;
   Connection::Type connection_type{Connection::Type::kRequest};
+  std::unique_ptr<engine::io::TlsServerSessionCache> tls_session_cache;
 
   std::atomic<size_t> connection_count{0};
 };
@@ -56,6 +56,15 @@ ListenerConfig Parse(const yaml_config::YamlConfig& value,
   if (!pkey_pass_name.empty()) {
     config.tls_private_key_passphrase_name = pkey_pass_name;
   }
+  config.tls_kernel_offload = value["tls"]["kernel-tls"].As<bool>(false);
+  config.tls_session_cache_size =
+      value["tls"]["session-cache-size"].As<std::size_t>(
+          config.tls_session_cache_size);
+  config.tls_session_timeout =
+      value["tls"]["session-timeout"].As<std::chrono::seconds>(
+          config.tls_session_timeout);
+  config.tls_session_ticket_keys_name =
+      value["tls"]["session-ticket-keys-name"].As<std::string>({});
 
   return config;
 }
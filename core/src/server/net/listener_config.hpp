@@ -1,7 +1,10 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <userver/crypto/certificate.hpp>
 #include <userver/crypto/private_key.hpp>
@@ -29,6 +32,11 @@ struct ListenerConfig {
   std::string tls_private_key_path;
   std::string tls_private_key_passphrase_name;
   crypto::PrivateKey tls_private_key;
+  bool tls_kernel_offload{false};
+  std::size_t tls_session_cache_size{0};
+  std::chrono::seconds tls_session_timeout{3600};
+  std::string tls_session_ticket_keys_name;
+  std::vector<std::string> tls_session_ticket_keys;
 };
 
 ListenerConfig Parse(const yaml_config::YamlConfig& value,
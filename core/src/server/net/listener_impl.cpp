@@ -102,7 +102,11 @@ void ListenerImpl::ProcessConnection(engine::io::Socket peer_socket) {
     socket = std::make_unique<engine::io::TlsWrapper>(
         engine::io::TlsWrapper::StartTlsServer(
             std::move(peer_socket), endpoint_info_->listener_config.tls_cert,
-            endpoint_info_->listener_config.tls_private_key, {}));
+            endpoint_info_->listener_config.tls_private_key, {}, {},
+            endpoint_info_->listener_config.tls_kernel_offload
+                ? engine::io::KernelTlsMode::kIfAvailable
+                : engine::io::KernelTlsMode::kDisabled,
+            endpoint_info_->tls_session_cache.get()));
   } else {
     socket = std::make_unique<engine::io::Socket>(std::move(peer_socket));
   }
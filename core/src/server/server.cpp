@@ -18,6 +18,7 @@
 #include <server/pph_config.hpp>
 #include <server/requests_view.hpp>
 #include <server/server_config.hpp>
+#include <server/tls_ticket_keys_config.hpp>
 #include <userver/fs/blocking/read.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -116,6 +117,9 @@ class ServerImpl final {
   std::chrono::milliseconds GetAvgRequestTimeMs() const;
   const http::HttpRequestHandler& GetHttpRequestHandler(bool is_monitor) const;
   net::Stats GetServerStats() const;
+  const engine::io::TlsResumptionStatistics* GetTlsResumptionStatistics()
+      const;
+  void UpdateTlsTicketKeys(const storages::secdist::SecdistConfig& secdist);
   const ServerConfig& GetServerConfig() const { return config_; }
 
   RequestsView& GetRequestsView();
@@ -152,6 +156,12 @@ ServerImpl::ServerImpl(ServerConfig config,
         config_.listener.tls_private_key_passphrase_name);
     config_.listener.tls_private_key =
         crypto::PrivateKey::LoadFromString(contents, pph.GetUnderlying());
+
+    if (!config_.listener.tls_session_ticket_keys_name.empty()) {
+      config_.listener.tls_session_ticket_keys =
+          secdist.Get<TlsTicketKeysConfig>().GetTicketKeys(
+              config_.listener.tls_session_ticket_keys_name);
+    }
   }
 
   main_port_info_.Init(config_, config_.listener, component_context, false);
@@ -264,6 +274,31 @@ net::Stats ServerImpl::GetServerStats() const {
   return summary;
 }
 
+const engine::io::TlsResumptionStatistics*
+ServerImpl::GetTlsResumptionStatistics() const {
+  const auto& endpoint_info = main_port_info_.endpoint_info_;
+  if (!endpoint_info || !endpoint_info->tls_session_cache) return nullptr;
+  return &endpoint_info->tls_session_cache->GetStatistics();
+}
+
+void ServerImpl::UpdateTlsTicketKeys(
+    const storages::secdist::SecdistConfig& secdist) {
+  const auto& keys_name = config_.listener.tls_session_ticket_keys_name;
+  const auto& endpoint_info = main_port_info_.endpoint_info_;
+  if (keys_name.empty() || !endpoint_info ||
+      !endpoint_info->tls_session_cache) {
+    return;
+  }
+
+  try {
+    endpoint_info->tls_session_cache->SetTicketKeys(
+        secdist.Get<TlsTicketKeysConfig>().GetTicketKeys(keys_name));
+  } catch (const std::exception& ex) {
+    LOG_ERROR() << "Failed to update TLS session ticket keys '" << keys_name
+                << "', the previous keys are kept: " << ex;
+  }
+}
+
 RequestsView& ServerImpl::GetRequestsView() {
   UASSERT(!main_port_info_.IsRunning() || has_requests_view_watchers_.load());
 
@@ -337,6 +372,10 @@ void Server::WriteMonitorData(utils::statistics::Writer& writer) const {
     request_stats["processed"] = server_stats.requests_processed_count;
     request_stats["parsing"] = server_stats.parser_stats.parsing_request_count;
   }
+
+  if (const auto* tls_stats = pimpl->GetTlsResumptionStatistics()) {
+    writer["tls"]["handshakes"] = *tls_stats;
+  }
 }
 
 void Server::WriteTotalHandlerStatistics(
@@ -374,6 +413,11 @@ void Server::SetRpsRatelimit(std::optional<size_t> rps) {
   pimpl->SetRpsRatelimit(rps);
 }
 
+void Server::UpdateTlsTicketKeys(
+    const storages::secdist::SecdistConfig& secdist) {
+  pimpl->UpdateTlsTicketKeys(secdist);
+}
+
 void Server::SetRpsRatelimitStatusCode(http::HttpStatus status_code) {
   pimpl->SetRpsRatelimitStatusCode(status_code);
 }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <userver/crypto/base64.hpp>
+#include <userver/formats/json/value.hpp>
+#include <userver/formats/parse/common_containers.hpp>
+#include <userver/logging/log.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server {
+
+/// Keys to encrypt TLS session tickets with, stored in secdist as base64
+class TlsTicketKeysConfig final {
+ public:
+  explicit TlsTicketKeysConfig(const formats::json::Value& doc)
+      : keys_(doc["tls_session_ticket_keys"]
+                  .As<std::unordered_map<std::string,
+                                         std::vector<std::string>>>({})) {}
+
+  std::vector<std::string> GetTicketKeys(const std::string& name) const {
+    const auto it = keys_.find(name);
+    if (it == keys_.end()) {
+      LOG_ERROR() << "No TLS session ticket keys for name '" << name << "'";
+      throw std::out_of_range("No TLS session ticket keys for name " + name);
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(it->second.size());
+    for (const auto& key : it->second) {
+      keys.push_back(crypto::base64::Base64Decode(key));
+    }
+    return keys;
+  }
+
+ private:
+  std::unordered_map<std::string, std::vector<std::string>> keys_;
+};
+
+}  // namespace server
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,269 @@
+#include <userver/server/websocket/broadcast_group.hpp>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+
+#include <userver/concurrent/variable.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/exception.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+
+#include <server/websocket/permessage_deflate.hpp>
+#include <server/websocket/protocol.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::websocket {
+
+namespace impl {
+
+class BroadcastMember final {
+ public:
+  explicit BroadcastMember(WebSocketConnection& connection)
+      : connection_(connection),
+        task_processor_(engine::current_task::GetTaskProcessor()) {}
+
+  // Returns false if the member should be removed from the group
+  bool Push(std::shared_ptr<const PreparedMessage> message,
+            std::size_t max_queued_messages) {
+    const std::lock_guard lock(mutex_);
+    if (state_ != State::kActive) return false;
+
+    if (queue_.size() >= max_queued_messages) {
+      queue_.clear();
+      state_ = State::kEvicted;
+      evicted_ = true;
+      // The writer closes the connection after the write in progress
+      StartWriter();
+      return false;
+    }
+
+    queue_.push_back(std::move(message));
+    StartWriter();
+    return true;
+  }
+
+  void Leave() noexcept {
+    {
+      const std::lock_guard lock(mutex_);
+      queue_.clear();
+      state_ = State::kClosed;
+    }
+    // No new writers are started in kClosed state
+    if (!writer_.IsValid()) return;
+
+    // The writer stops after the frame in progress. It is cancelled only if
+    // the leaving task is cancelled itself, the connection is not written
+    // anymore after such a cut frame.
+    try {
+      writer_.Wait();
+    } catch (const engine::WaitInterruptedException&) {
+    }
+    writer_.SyncCancel();
+  }
+
+  bool IsEvicted() const noexcept { return evicted_; }
+
+ private:
+  enum class State {
+    kActive,
+    kEvicted,  // the connection is to be closed
+    kClosed,   // nothing is written anymore
+  };
+
+  // Must be called under mutex_
+  void StartWriter() {
+    if (writer_active_) return;
+    writer_active_ = true;
+    // A finished writer may still be running after releasing the mutex,
+    // so the assignment may briefly wait for it
+    writer_ = engine::CriticalAsyncNoSpan(task_processor_,
+                                          [this] { WriteQueued(); });
+  }
+
+  void WriteQueued() {
+    while (true) {
+      std::shared_ptr<const PreparedMessage> message;
+      bool close = false;
+      {
+        const std::lock_guard lock(mutex_);
+        if (state_ == State::kEvicted) {
+          state_ = State::kClosed;
+          close = true;
+        } else if (state_ == State::kClosed || queue_.empty()) {
+          writer_active_ = false;
+          return;
+        } else {
+          message = std::move(queue_.front());
+          queue_.pop_front();
+        }
+      }
+
+      try {
+        if (close) {
+          LOG_INFO() << "Closing slow websocket connection from "
+                     << connection_.RemoteAddr().PrimaryAddressString();
+          connection_.Close(CloseStatus::kPolicyViolation);
+        } else {
+          connection_.SendPrepared(*message);
+        }
+      } catch (const std::exception& e) {
+        LOG_WARNING() << "Failed to write a broadcast message: " << e;
+        const std::lock_guard lock(mutex_);
+        queue_.clear();
+        state_ = State::kClosed;
+        evicted_ = true;
+      }
+    }
+  }
+
+  WebSocketConnection& connection_;
+  engine::TaskProcessor& task_processor_;
+  std::atomic<bool> evicted_{false};
+
+  engine::Mutex mutex_;
+  std::deque<std::shared_ptr<const PreparedMessage>> queue_;
+  State state_{State::kActive};
+  bool writer_active_{false};
+  engine::TaskWithResult<void> writer_;
+};
+
+class BroadcastGroupImpl final {
+ public:
+  explicit BroadcastGroupImpl(const BroadcastGroupConfig& config)
+      : config_(config) {
+    if (config_.compress) {
+      DeflateParams params;
+      params.server_no_context_takeover = true;
+      params.server_max_window_bits = config_.compression_window_bits;
+      deflater_.emplace(params, config_.compression_mem_level);
+    }
+  }
+
+  void Add(std::shared_ptr<BroadcastMember> member) {
+    auto members = members_.Lock();
+    members->insert(std::move(member));
+  }
+
+  void Remove(const std::shared_ptr<BroadcastMember>& member) {
+    auto members = members_.Lock();
+    members->erase(member);
+  }
+
+  void Send(utils::span<const std::byte> data, bool is_text) {
+    const auto message = Prepare(data, is_text);
+
+    auto members = members_.Lock();
+    for (auto it = members->begin(); it != members->end();) {
+      if ((*it)->Push(message, config_.max_queued_messages)) {
+        ++it;
+      } else {
+        if ((*it)->IsEvicted()) ++evicted_;
+        it = members->erase(it);
+      }
+    }
+  }
+
+  std::size_t GetSize() const {
+    const auto members = members_.Lock();
+    return members->size();
+  }
+
+  std::uint64_t GetEvictedCount() const noexcept { return evicted_; }
+
+ private:
+  std::shared_ptr<const PreparedMessage> Prepare(
+      utils::span<const std::byte> data, bool is_text) {
+    auto result = std::make_shared<PreparedMessage>();
+    result->frame = MakeDataFrame(data, is_text, frames::Compressed::kNo,
+                                  &result->header_size);
+    result->is_text = is_text;
+
+    if (deflater_ && data.size() >= config_.compression_min_message_size) {
+      const std::lock_guard lock(deflater_mutex_);
+      result->compressed_frame = MakeDataFrame(
+          deflater_->Compress(data), is_text, frames::Compressed::kYes);
+      result->compression_window_bits = config_.compression_window_bits;
+    }
+    return result;
+  }
+
+  const BroadcastGroupConfig config_;
+  concurrent::Variable<std::unordered_set<std::shared_ptr<BroadcastMember>>>
+      members_;
+  std::atomic<std::uint64_t> evicted_{0};
+
+  engine::Mutex deflater_mutex_;
+  std::optional<Deflater> deflater_;
+};
+
+}  // namespace impl
+
+BroadcastGroup::BroadcastGroup(const BroadcastGroupConfig& config)
+    : impl_(std::make_shared<impl::BroadcastGroupImpl>(config)) {}
+
+BroadcastGroup::~BroadcastGroup() = default;
+
+BroadcastGroup::Membership BroadcastGroup::Join(
+    WebSocketConnection& connection) {
+  auto member = std::make_shared<impl::BroadcastMember>(connection);
+  impl_->Add(member);
+  return Membership{impl_, std::move(member)};
+}
+
+void BroadcastGroup::SendText(std::string_view message) {
+  DoSend(utils::as_bytes(utils::span<const char>(message)), true);
+}
+
+void BroadcastGroup::DoSend(utils::span<const std::byte> message,
+                            bool is_text) {
+  impl_->Send(message, is_text);
+}
+
+std::size_t BroadcastGroup::GetSize() const { return impl_->GetSize(); }
+
+std::uint64_t BroadcastGroup::GetEvictedCount() const noexcept {
+  return impl_->GetEvictedCount();
+}
+
+BroadcastGroup::Membership::Membership(
+    std::shared_ptr<impl::BroadcastGroupImpl> group,
+    std::shared_ptr<impl::BroadcastMember> member)
+    : group_(std::move(group)), member_(std::move(member)) {}
+
+BroadcastGroup::Membership::Membership(Membership&&) noexcept = default;
+
+BroadcastGroup::Membership& BroadcastGroup::Membership::operator=(
+    Membership&& other) noexcept {
+  if (this != &other) {
+    Leave();
+    group_ = std::move(other.group_);
+    member_ = std::move(other.member_);
+  }
+  return *this;
+}
+
+BroadcastGroup::Membership::~Membership() { Leave(); }
+
+bool BroadcastGroup::Membership::IsEvicted() const {
+  UASSERT(member_);
+  return member_->IsEvicted();
+}
+
+void BroadcastGroup::Membership::Leave() noexcept {
+  if (!member_) return;
+  group_->Remove(member_);
+  member_->Leave();
+  member_.reset();
+  group_.reset();
+}
+
+}  // namespace server::websocket
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,258 @@
+#include <userver/utest/utest.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/io/exception.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/internal/net/net_listener.hpp>
+#include <userver/server/websocket/broadcast_group.hpp>
+
+#include <server/websocket/protocol.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+namespace ws = server::websocket;
+
+class FakeConnection final : public ws::WebSocketConnection {
+ public:
+  explicit FakeConnection(bool blocked = false) : blocked_(blocked) {}
+
+  void Recv(ws::Message&) override {}
+
+  void Send(const ws::Message& message) override {
+    if (blocked_) {
+      ASSERT_TRUE(unblock_.WaitForEvent());
+      blocked_ = false;
+    }
+    sent.push_back(message);
+  }
+
+  void SendText(std::string_view message) override {
+    Send({std::string{message}, {}, true});
+  }
+
+  void Close(ws::CloseStatus status_code) override {
+    Send({{}, status_code, false});
+  }
+
+  const engine::io::Sockaddr& RemoteAddr() const override { return addr_; }
+
+  void AddFinalTags(tracing::Span&) const override {}
+  void AddStatistics(ws::Statistics&) const override {}
+
+  void Unblock() { unblock_.Send(); }
+
+  std::vector<ws::Message> sent;
+
+ protected:
+  void DoSendBinary(utils::span<const std::byte> message) override {
+    Send({std::string{reinterpret_cast<const char*>(message.data()),
+                      message.size()},
+          {},
+          false});
+  }
+
+ private:
+  bool blocked_;
+  engine::SingleConsumerEvent unblock_;
+  engine::io::Sockaddr addr_;
+};
+
+template <typename Predicate>
+void WaitUntil(Predicate predicate) {
+  const auto deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+  while (!predicate() && !deadline.IsReached()) engine::Yield();
+}
+
+struct Frame {
+  std::uint8_t first_byte{0};
+  std::string payload;
+
+  bool operator==(const Frame&) const = default;
+};
+
+// Reads a single unmasked frame sent by the server
+Frame ReadFrame(engine::io::Socket& socket, engine::Deadline deadline) {
+  const auto read = [&](std::size_t size) {
+    std::string result(size, '\0');
+    result.resize(socket.RecvAll(result.data(), size, deadline));
+    return result;
+  };
+
+  const auto header = read(2);
+  if (header.size() != 2) return {};
+
+  std::size_t size = static_cast<std::uint8_t>(header[1]) & 0x7F;
+  if (size >= 126) {
+    const auto extended = read(size == 126 ? 2 : 8);
+    size = 0;
+    for (const char c : extended) size = size * 256 + std::uint8_t(c);
+  }
+  return {static_cast<std::uint8_t>(header[0]), read(size)};
+}
+
+struct RealConnection {
+  RealConnection() {
+    auto [server, client_socket] =
+        internal::net::TcpListener{}.MakeSocketPair(deadline);
+    auto peer_name = server.Getpeername();
+    connection = ws::MakeWebSocket(
+        std::make_unique<engine::io::Socket>(std::move(server)),
+        std::move(peer_name), ws::Config{});
+    client = std::move(client_socket);
+  }
+
+  const engine::Deadline deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+  std::shared_ptr<ws::WebSocketConnection> connection;
+  engine::io::Socket client;
+};
+
+constexpr std::uint8_t kFinalText = 0x81;
+constexpr std::uint8_t kFinalBinary = 0x82;
+
+// More than the socket buffers can hold, the write blocks until the client
+// reads the message
+constexpr std::size_t kLargeMessageSize = 16 * 1024 * 1024;
+
+ws::BroadcastGroupConfig UncompressedConfig() {
+  ws::BroadcastGroupConfig config;
+  config.compress = false;
+  return config;
+}
+
+}  // namespace
+
+UTEST(WebsocketBroadcastGroup, SendsToAllMembers) {
+  ws::BroadcastGroup group;
+  FakeConnection first;
+  FakeConnection second;
+
+  auto first_membership = group.Join(first);
+  {
+    const auto second_membership = group.Join(second);
+    EXPECT_EQ(group.GetSize(), 2);
+
+    group.SendText("text");
+    group.SendBinary(std::string(100, 'b'));
+    WaitUntil(
+        [&] { return first.sent.size() == 2 && second.sent.size() == 2; });
+
+    for (const auto* connection : {&first, &second}) {
+      ASSERT_EQ(connection->sent.size(), 2);
+      EXPECT_EQ(connection->sent[0].data, "text");
+      EXPECT_TRUE(connection->sent[0].is_text);
+      EXPECT_EQ(connection->sent[1].data, std::string(100, 'b'));
+      EXPECT_FALSE(connection->sent[1].is_text);
+    }
+  }
+  EXPECT_EQ(group.GetSize(), 1);
+
+  group.SendText("last");
+  WaitUntil([&] { return first.sent.size() == 3; });
+  ASSERT_EQ(first.sent.size(), 3);
+  EXPECT_EQ(first.sent[2].data, "last");
+  EXPECT_EQ(second.sent.size(), 2);
+  EXPECT_FALSE(first_membership.IsEvicted());
+}
+
+UTEST(WebsocketBroadcastGroup, EvictsSlowMember) {
+  ws::BroadcastGroupConfig config;
+  config.max_queued_messages = 2;
+  ws::BroadcastGroup group{config};
+  FakeConnection fast;
+  FakeConnection slow{/*blocked=*/true};
+
+  const auto fast_membership = group.Join(fast);
+  const auto slow_membership = group.Join(slow);
+
+  // The first message is being written into the slow connection, the next
+  // two are queued and the last one overflows the queue
+  for (int i = 0; i < 4; ++i) {
+    group.SendText(std::to_string(i));
+    WaitUntil([&] { return fast.sent.size() == std::size_t(i) + 1; });
+  }
+
+  EXPECT_TRUE(slow_membership.IsEvicted());
+  EXPECT_FALSE(fast_membership.IsEvicted());
+  EXPECT_EQ(group.GetSize(), 1);
+  EXPECT_EQ(group.GetEvictedCount(), 1);
+  ASSERT_EQ(fast.sent.size(), 4);
+
+  // The pending messages are dropped and the connection is closed
+  slow.Unblock();
+  WaitUntil([&] { return slow.sent.size() == 2; });
+  ASSERT_EQ(slow.sent.size(), 2);
+  EXPECT_EQ(slow.sent[0].data, "0");
+  EXPECT_EQ(slow.sent[1].close_status, ws::CloseStatus::kPolicyViolation);
+}
+
+
+UTEST(WebsocketBroadcastGroup, WritesIntoRealConnection) {
+  RealConnection connection;
+  ws::BroadcastGroup group;
+  const auto membership = group.Join(*connection.connection);
+
+  group.SendText("text");
+  // Broadcast messages are not fragmented
+  const std::string large(100 * 1024, 'b');
+  group.SendBinary(large);
+
+  EXPECT_EQ(ReadFrame(connection.client, connection.deadline),
+            (Frame{kFinalText, "text"}));
+  EXPECT_EQ(ReadFrame(connection.client, connection.deadline),
+            (Frame{kFinalBinary, large}));
+}
+
+UTEST(WebsocketBroadcastGroup, LeaveFinishesFrameInProgress) {
+  RealConnection connection;
+  ws::BroadcastGroup group{UncompressedConfig()};
+  std::optional membership{group.Join(*connection.connection)};
+
+  const std::string large(kLargeMessageSize, 'b');
+  group.SendBinary(large);
+  ASSERT_TRUE(connection.client.WaitReadable(connection.deadline));
+
+  auto leave = engine::AsyncNoSpan([&membership] { membership.reset(); });
+  engine::SleepFor(std::chrono::milliseconds{50});
+  EXPECT_FALSE(leave.IsFinished());
+
+  EXPECT_EQ(ReadFrame(connection.client, connection.deadline),
+            (Frame{kFinalBinary, large}));
+  UEXPECT_NO_THROW(leave.Get());
+
+  // The connection is left in a consistent state
+  connection.connection->SendText("after");
+  EXPECT_EQ(ReadFrame(connection.client, connection.deadline),
+            (Frame{kFinalText, "after"}));
+}
+
+UTEST(WebsocketBroadcastGroup, CancelledLeaveStopsWrites) {
+  RealConnection connection;
+  ws::BroadcastGroup group{UncompressedConfig()};
+  std::optional membership{group.Join(*connection.connection)};
+
+  const std::string large(kLargeMessageSize, 'b');
+  group.SendBinary(large);
+  ASSERT_TRUE(connection.client.WaitReadable(connection.deadline));
+
+  auto leave = engine::AsyncNoSpan([&membership] { membership.reset(); });
+  engine::Yield();
+  EXPECT_FALSE(leave.IsFinished());
+  leave.SyncCancel();
+  EXPECT_FALSE(membership.has_value());
+
+  // The frame in progress was cut, nothing could be written after it
+  UEXPECT_THROW(connection.connection->SendText("after"),
+                engine::io::IoException);
+}
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,255 @@
+#include <server/websocket/permessage_deflate.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::websocket::impl {
+
+namespace {
+
+constexpr std::string_view kExtensionName = "permessage-deflate";
+
+// Z_SYNC_FLUSH ends the output with an empty stored block, which is not sent
+// over the wire, https://datatracker.ietf.org/doc/html/rfc7692#section-7.2.1
+constexpr std::string_view kSyncFlushTail{"\x00\x00\xff\xff", 4};
+
+constexpr std::size_t kMinInflateBufferSize = 1024;
+
+std::string_view Trim(std::string_view value) noexcept {
+  const auto begin = value.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) return {};
+  const auto end = value.find_last_not_of(" \t");
+  return value.substr(begin, end - begin + 1);
+}
+
+// Returns the next item of a `separator`-delimited list and removes it
+// from `list`
+std::string_view PopItem(std::string_view& list, char separator) noexcept {
+  const auto pos = list.find(separator);
+  const auto item = list.substr(0, pos);
+  list.remove_prefix(pos == std::string_view::npos ? list.size() : pos + 1);
+  return Trim(item);
+}
+
+std::optional<int> ParseWindowBits(std::string_view value) noexcept {
+  if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+    value = value.substr(1, value.size() - 2);
+  }
+  if (value.empty() || value.size() > 2) return std::nullopt;
+
+  int bits = 0;
+  for (const char c : value) {
+    if (c < '0' || c > '9') return std::nullopt;
+    bits = bits * 10 + (c - '0');
+  }
+  if (bits < 8 || bits > 15) return std::nullopt;
+  return bits;
+}
+
+std::optional<DeflateParams> ParseOffer(std::string_view offer,
+                                        const DeflateConfig& config) {
+  if (PopItem(offer, ';') != kExtensionName) return std::nullopt;
+
+  DeflateParams result;
+  result.server_no_context_takeover = config.server_no_context_takeover;
+  result.client_no_context_takeover = config.client_no_context_takeover;
+  result.server_max_window_bits = config.server_max_window_bits;
+
+  bool seen_server_no_context_takeover = false;
+  bool seen_client_no_context_takeover = false;
+  bool seen_server_max_window_bits = false;
+  bool seen_client_max_window_bits = false;
+
+  while (!offer.empty()) {
+    auto value = PopItem(offer, ';');
+    const auto name = PopItem(value, '=');
+    const bool has_value = !value.empty();
+
+    // Every parameter may appear only once
+    if (name == "server_no_context_takeover") {
+      if (has_value || std::exchange(seen_server_no_context_takeover, true)) {
+        return std::nullopt;
+      }
+      result.server_no_context_takeover = true;
+    } else if (name == "client_no_context_takeover") {
+      if (has_value || std::exchange(seen_client_no_context_takeover, true)) {
+        return std::nullopt;
+      }
+      result.client_no_context_takeover = true;
+    } else if (name == "server_max_window_bits") {
+      const auto bits = ParseWindowBits(value);
+      // zlib does not support raw deflate with 256-byte window
+      if (!bits || *bits < 9 ||
+          std::exchange(seen_server_max_window_bits, true)) {
+        return std::nullopt;
+      }
+      result.server_max_window_bits =
+          std::min(*bits, result.server_max_window_bits);
+    } else if (name == "client_max_window_bits") {
+      const auto bits = has_value ? ParseWindowBits(value) : 15;
+      if (!bits || std::exchange(seen_client_max_window_bits, true)) {
+        return std::nullopt;
+      }
+      // The client window may only be limited if the client allows it
+      result.client_max_window_bits =
+          std::min(*bits, config.client_max_window_bits);
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+
+std::optional<DeflateParams> NegotiateDeflate(std::string_view extensions,
+                                              const DeflateConfig& config) {
+  if (!config.enabled) return std::nullopt;
+
+  while (!extensions.empty()) {
+    auto result = ParseOffer(PopItem(extensions, ','), config);
+    if (result) return result;
+  }
+  return std::nullopt;
+}
+
+std::string FormatDeflateResponse(const DeflateParams& params) {
+  std::string result{kExtensionName};
+  if (params.server_no_context_takeover) {
+    result += "; server_no_context_takeover";
+  }
+  if (params.client_no_context_takeover) {
+    result += "; client_no_context_takeover";
+  }
+  if (params.server_max_window_bits < 15) {
+    result += fmt::format("; server_max_window_bits={}",
+                          params.server_max_window_bits);
+  }
+  if (params.client_max_window_bits < 15) {
+    result += fmt::format("; client_max_window_bits={}",
+                          params.client_max_window_bits);
+  }
+  return result;
+}
+
+Deflater::Deflater(const DeflateParams& params, int mem_level)
+    : no_context_takeover_(params.server_no_context_takeover) {
+  // Negative window bits produce raw deflate without zlib header and trailer
+  const int ret = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                               -params.server_max_window_bits, mem_level,
+                               Z_DEFAULT_STRATEGY);
+  if (ret != Z_OK) {
+    throw std::runtime_error(fmt::format("deflateInit2 failed: {}", ret));
+  }
+}
+
+Deflater::~Deflater() { deflateEnd(&stream_); }
+
+utils::span<const std::byte> Deflater::Compress(
+    utils::span<const std::byte> message) {
+  const auto bound =
+      deflateBound(&stream_, message.size()) + kSyncFlushTail.size();
+  if (buffer_.size() < bound) buffer_.resize(bound);
+
+  // zlib API is not const-correct
+  stream_.next_in =
+      reinterpret_cast<Bytef*>(const_cast<std::byte*>(message.data()));
+  stream_.avail_in = message.size();
+
+  std::size_t produced = 0;
+  while (true) {
+    if (produced == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+    stream_.next_out = reinterpret_cast<Bytef*>(buffer_.data() + produced);
+    stream_.avail_out = buffer_.size() - produced;
+
+    const int ret = deflate(&stream_, Z_SYNC_FLUSH);
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      throw std::runtime_error(fmt::format("deflate failed: {}", ret));
+    }
+    produced = buffer_.size() - stream_.avail_out;
+    // Free space in the output means that the flush is complete
+    if (stream_.avail_out != 0) break;
+  }
+
+  UASSERT(std::string_view(buffer_.data(), produced).substr(
+              produced - kSyncFlushTail.size()) == kSyncFlushTail);
+  produced -= kSyncFlushTail.size();
+
+  if (no_context_takeover_) deflateReset(&stream_);
+  return utils::as_bytes(utils::span<const char>(buffer_.data(), produced));
+}
+
+Inflater::Inflater(const DeflateParams& params)
+    : no_context_takeover_(params.client_no_context_takeover) {
+  const int ret = inflateInit2(&stream_, -params.client_max_window_bits);
+  if (ret != Z_OK) {
+    throw std::runtime_error(fmt::format("inflateInit2 failed: {}", ret));
+  }
+}
+
+Inflater::~Inflater() { inflateEnd(&stream_); }
+
+CloseStatus Inflater::Decompress(std::string& message, std::size_t max_size) {
+  message.append(kSyncFlushTail);
+
+  stream_.next_in = reinterpret_cast<Bytef*>(message.data());
+  stream_.avail_in = message.size();
+
+  // Compressed data is usually several times smaller than the original one
+  buffer_.resize(std::min(
+      max_size + 1, std::max(message.size() * 4, kMinInflateBufferSize)));
+
+  const auto fail = [this](CloseStatus status) {
+    inflateReset(&stream_);
+    return status;
+  };
+
+  std::size_t produced = 0;
+  while (true) {
+    if (produced == buffer_.size()) {
+      if (produced > max_size) return fail(CloseStatus::kTooBigData);
+      buffer_.resize(std::min(max_size + 1, produced * 2));
+    }
+    stream_.next_out = reinterpret_cast<Bytef*>(buffer_.data() + produced);
+    stream_.avail_out = buffer_.size() - produced;
+
+    const int ret = inflate(&stream_, Z_SYNC_FLUSH);
+    produced = buffer_.size() - stream_.avail_out;
+
+    if (ret == Z_STREAM_END) {
+      // The peer has finished the deflate stream, the rest of the input
+      // (if any) starts a new one
+      inflateReset(&stream_);
+      if (stream_.avail_in == 0) break;
+      continue;
+    }
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      return fail(CloseStatus::kBadMessageData);
+    }
+    if (stream_.avail_out != 0) {
+      // No more output is possible, so the whole input must be consumed
+      if (stream_.avail_in != 0) return fail(CloseStatus::kBadMessageData);
+      break;
+    }
+  }
+  if (produced > max_size) return fail(CloseStatus::kTooBigData);
+
+  if (no_context_takeover_) inflateReset(&stream_);
+
+  buffer_.resize(produced);
+  message.swap(buffer_);
+  return CloseStatus::kNone;
+}
+
+}  // namespace server::websocket::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <userver/server/websocket/server.hpp>
+#include <userver/utils/span.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::websocket::impl {
+
+/// Parameters of permessage-deflate extension agreed upon in the handshake,
+/// https://datatracker.ietf.org/doc/html/rfc7692
+struct DeflateParams final {
+  bool server_no_context_takeover = false;
+  bool client_no_context_takeover = false;
+  int server_max_window_bits = 15;
+  int client_max_window_bits = 15;
+};
+
+/// Picks the first acceptable permessage-deflate offer from the value of
+/// Sec-WebSocket-Extensions request header. Returns std::nullopt if there is
+/// no such offer or if the extension is disabled.
+std::optional<DeflateParams> NegotiateDeflate(std::string_view extensions,
+                                              const DeflateConfig& config);
+
+/// Formats the value of Sec-WebSocket-Extensions response header
+std::string FormatDeflateResponse(const DeflateParams& params);
+
+/// Compresses outgoing messages of a single connection
+class Deflater final {
+ public:
+  Deflater(const DeflateParams& params, int mem_level);
+  ~Deflater();
+
+  Deflater(Deflater&&) = delete;
+  Deflater& operator=(Deflater&&) = delete;
+
+  /// Compresses a whole message. The result is valid until the next call.
+  utils::span<const std::byte> Compress(utils::span<const std::byte> message);
+
+ private:
+  z_stream stream_{};
+  const bool no_context_takeover_;
+  std::string buffer_;
+};
+
+/// Decompresses incoming messages of a single connection
+class Inflater final {
+ public:
+  explicit Inflater(const DeflateParams& params);
+  ~Inflater();
+
+  Inflater(Inflater&&) = delete;
+  Inflater& operator=(Inflater&&) = delete;
+
+  /// Decompresses a whole message in-place
+  CloseStatus Decompress(std::string& message, std::size_t max_size);
+
+ private:
+  z_stream stream_{};
+  const bool no_context_takeover_;
+  std::string buffer_;
+};
+
+}  // namespace server::websocket::impl
+
+USERVER_NAMESPACE_END
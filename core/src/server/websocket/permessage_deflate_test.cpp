@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include <server/websocket/permessage_deflate.hpp>
+#include <server/websocket/protocol.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+namespace ws = server::websocket;
+
+ws::DeflateConfig MakeEnabledConfig() {
+  ws::DeflateConfig config;
+  config.enabled = true;
+  return config;
+}
+
+std::string Compress(ws::impl::Deflater& deflater, std::string_view data) {
+  const auto compressed = deflater.Compress(
+      utils::as_bytes(utils::span<const char>(data.data(), data.size())));
+  return {reinterpret_cast<const char*>(compressed.data()), compressed.size()};
+}
+
+}  // namespace
+
+TEST(WebsocketDeflate, NegotiateDisabled) {
+  EXPECT_FALSE(ws::impl::NegotiateDeflate("permessage-deflate",
+                                          ws::DeflateConfig{}));
+}
+
+TEST(WebsocketDeflate, NegotiateDefaults) {
+  const auto params = ws::impl::NegotiateDeflate(
+      "permessage-deflate; client_max_window_bits", MakeEnabledConfig());
+  ASSERT_TRUE(params);
+  EXPECT_FALSE(params->server_no_context_takeover);
+  EXPECT_FALSE(params->client_no_context_takeover);
+  EXPECT_EQ(params->server_max_window_bits, 15);
+  EXPECT_EQ(params->client_max_window_bits, 15);
+  EXPECT_EQ(ws::impl::FormatDeflateResponse(*params), "permessage-deflate");
+}
+
+TEST(WebsocketDeflate, NegotiateParams) {
+  auto config = MakeEnabledConfig();
+  config.server_max_window_bits = 12;
+  config.client_max_window_bits = 10;
+  config.client_no_context_takeover = true;
+
+  const auto params = ws::impl::NegotiateDeflate(
+      "permessage-deflate; server_no_context_takeover; "
+      "server_max_window_bits=\"14\"; client_max_window_bits",
+      config);
+  ASSERT_TRUE(params);
+  EXPECT_TRUE(params->server_no_context_takeover);
+  EXPECT_TRUE(params->client_no_context_takeover);
+  EXPECT_EQ(params->server_max_window_bits, 12);
+  EXPECT_EQ(params->client_max_window_bits, 10);
+  EXPECT_EQ(ws::impl::FormatDeflateResponse(*params),
+            "permessage-deflate; server_no_context_takeover; "
+            "client_no_context_takeover; server_max_window_bits=12; "
+            "client_max_window_bits=10");
+}
+
+TEST(WebsocketDeflate, NegotiateClientWindowNotOffered) {
+  auto config = MakeEnabledConfig();
+  config.client_max_window_bits = 10;
+
+  const auto params =
+      ws::impl::NegotiateDeflate("permessage-deflate", config);
+  ASSERT_TRUE(params);
+  // The client did not allow limiting its window
+  EXPECT_EQ(params->client_max_window_bits, 15);
+}
+
+TEST(WebsocketDeflate, NegotiateSkipsBadOffers) {
+  const auto config = MakeEnabledConfig();
+  for (const std::string_view header : {
+           "x-webkit-deflate-frame",
+           "permessage-deflate; unknown_param",
+           "permessage-deflate; server_max_window_bits",
+           "permessage-deflate; server_max_window_bits=8",
+           "permessage-deflate; server_max_window_bits=16",
+           "permessage-deflate; client_max_window_bits=abc",
+           "permessage-deflate; server_no_context_takeover=1",
+           "permessage-deflate; server_no_context_takeover; "
+           "server_no_context_takeover",
+       }) {
+    EXPECT_FALSE(ws::impl::NegotiateDeflate(header, config)) << header;
+  }
+
+  const auto params = ws::impl::NegotiateDeflate(
+      "permessage-deflate; unknown_param, "
+      "permessage-deflate; server_max_window_bits=10",
+      config);
+  ASSERT_TRUE(params);
+  EXPECT_EQ(params->server_max_window_bits, 10);
+}
+
+TEST(WebsocketDeflate, RoundTrip) {
+  for (const bool no_context_takeover : {false, true}) {
+    ws::impl::DeflateParams params;
+    params.server_no_context_takeover = no_context_takeover;
+    params.client_no_context_takeover = no_context_takeover;
+
+    ws::impl::Deflater deflater{params, 8};
+    ws::impl::Inflater inflater{params};
+
+    std::string message;
+    for (int i = 0; i < 100; ++i) {
+      message += R"({"user":"someone","text":"hello","id":)" +
+                 std::to_string(i) + "}";
+    }
+
+    for (int i = 0; i < 3; ++i) {
+      auto data = Compress(deflater, message);
+      EXPECT_LT(data.size() * 5, message.size());
+      ASSERT_EQ(inflater.Decompress(data, message.size()),
+                ws::CloseStatus::kNone);
+      EXPECT_EQ(data, message);
+    }
+  }
+}
+
+TEST(WebsocketDeflate, RfcExample) {
+  // https://datatracker.ietf.org/doc/html/rfc7692#section-7.2.3.1
+  ws::impl::Inflater inflater{ws::impl::DeflateParams{}};
+  std::string data{"\xf2\x48\xcd\xc9\xc9\x07\x00", 7};
+  ASSERT_EQ(inflater.Decompress(data, 100), ws::CloseStatus::kNone);
+  EXPECT_EQ(data, "Hello");
+
+  // The second message refers to the first one
+  data.assign("\xf2\x00\x11\x00\x00", 5);
+  ASSERT_EQ(inflater.Decompress(data, 100), ws::CloseStatus::kNone);
+  EXPECT_EQ(data, "Hello");
+}
+
+TEST(WebsocketDeflate, DecompressErrors) {
+  ws::impl::Deflater deflater{ws::impl::DeflateParams{}, 8};
+  const std::string message(1000, 'a');
+
+  {
+    ws::impl::Inflater inflater{ws::impl::DeflateParams{}};
+    auto data = Compress(deflater, message);
+    EXPECT_EQ(inflater.Decompress(data, message.size() - 1),
+              ws::CloseStatus::kTooBigData);
+  }
+  {
+    ws::impl::Inflater inflater{ws::impl::DeflateParams{}};
+    std::string data = "\xff\xff\xff\xff garbage";
+    EXPECT_EQ(inflater.Decompress(data, 1000),
+              ws::CloseStatus::kBadMessageData);
+  }
+}
+
+TEST(WebsocketMask, SameAsScalar) {
+  const std::uint8_t mask_bytes[4] = {0x37, 0xfa, 0x21, 0x3d};
+  std::uint32_t mask = 0;
+  std::memcpy(&mask, mask_bytes, sizeof(mask));
+
+  for (std::size_t size = 0; size < 100; ++size) {
+    for (std::size_t offset = 0; offset < 4; ++offset) {
+      std::string data(offset + size, '\0');
+      for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 7);
+      }
+      std::string expected = data;
+      for (std::size_t i = 0; i < size; ++i) {
+        expected[offset + i] ^= static_cast<char>(mask_bytes[i % 4]);
+      }
+
+      // Payload is not aligned in general
+      ws::impl::XorMaskInplace(
+          reinterpret_cast<std::uint8_t*>(data.data() + offset), size, mask);
+      EXPECT_EQ(data, expected) << "size=" << size << " offset=" << offset;
+    }
+  }
+}
+
+USERVER_NAMESPACE_END
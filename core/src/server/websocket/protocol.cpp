@@ -3,6 +3,10 @@
 #include <cstdlib>
 #include <cstring>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <cryptopp/sha.h>
 #include <boost/endian/conversion.hpp>
 
@@ -39,16 +43,6 @@ union Mask32 {
   uint8_t mask8[4];
 };
 
-void XorMaskInplace(uint8_t* dest, size_t len, Mask32 mask) {
-  auto* dest32 = reinterpret_cast<uint32_t*>(dest);
-  while (len >= sizeof(uint32_t)) {
-    *(dest32++) ^= mask.mask32;
-    len -= sizeof(uint32_t);
-  }
-  auto* dest8 = reinterpret_cast<uint8_t*>(dest32);
-  for (unsigned i = 0; i < len; ++i) *(dest8++) ^= mask.mask8[i];
-}
-
 template <class T, class V>
 void PushRaw(const T& value, V& data) {
   const auto* valBytes = reinterpret_cast<const char*>(&value);
@@ -61,7 +55,7 @@ namespace frames {
 
 boost::container::small_vector<char, impl::kMaxFrameHeaderSize> DataFrameHeader(
     utils::span<const std::byte> data, bool is_text,
-    Continuation is_continuation, Final is_final) {
+    Continuation is_continuation, Final is_final, Compressed is_compressed) {
   boost::container::small_vector<char, impl::kMaxFrameHeaderSize> frame;
 
   frame.resize(sizeof(WSHeader));
@@ -74,6 +68,9 @@ boost::container::small_vector<char, impl::kMaxFrameHeaderSize> DataFrameHeader(
   hdr->bits.fin = is_final == Final::kYes ? 1 : 0;
   hdr->bits.opcode = is_text ? kText : kBinary;
   if (is_continuation == Continuation::kYes) hdr->bits.opcode = kContinuation;
+  if (is_compressed == Compressed::kYes) {
+    hdr->bits.reserved = kReservedCompressed;
+  }
 
   if (data.size() <= 125) {
     hdr->bits.payloadLen = data.size();
@@ -127,6 +124,35 @@ const std::array<char, sizeof(WSHeader)>& CloseFrame() {
 
 }  // namespace frames
 
+void XorMaskInplace(std::uint8_t* dest, std::size_t len,
+                    std::uint32_t mask) noexcept {
+  // The mask is applied from the start of the frame payload, so every
+  // block of a multiple of 4 bytes starts with the first byte of the mask.
+#ifdef __SSE2__
+  const __m128i mask128 = _mm_set1_epi32(static_cast<int>(mask));
+  for (; len >= sizeof(__m128i); len -= sizeof(__m128i)) {
+    auto* block = reinterpret_cast<__m128i*>(dest);
+    _mm_storeu_si128(block, _mm_xor_si128(_mm_loadu_si128(block), mask128));
+    dest += sizeof(__m128i);
+  }
+#endif
+
+  const std::uint64_t mask64 = (static_cast<std::uint64_t>(mask) << 32) |
+                               static_cast<std::uint64_t>(mask);
+  // The payload is not aligned, memcpy compiles into plain loads and stores
+  for (; len >= sizeof(mask64); len -= sizeof(mask64)) {
+    std::uint64_t block = 0;
+    std::memcpy(&block, dest, sizeof(block));
+    block ^= mask64;
+    std::memcpy(dest, &block, sizeof(block));
+    dest += sizeof(block);
+  }
+
+  Mask32 tail_mask;
+  tail_mask.mask32 = mask;
+  for (std::size_t i = 0; i < len; ++i) dest[i] ^= tail_mask.mask8[i % 4];
+}
+
 std::string WebsocketSecAnswer(std::string_view sec_key) {
   // guid is taken from RFC
   // https://datatracker.ietf.org/doc/html/rfc6455#section-1.3
@@ -151,6 +177,26 @@ std::string WebsocketSecAnswer(std::string_view sec_key) {
                        sizeof(webSocketRespKeySHA1)));
 }
 
+utils::span<const std::byte> PreparedMessage::GetPayload() const {
+  return utils::as_bytes(utils::span<const char>(frame))
+      .last(frame.size() - header_size);
+}
+
+std::string MakeDataFrame(utils::span<const std::byte> data, bool is_text,
+                          frames::Compressed is_compressed,
+                          std::size_t* header_size) {
+  const auto header = frames::DataFrameHeader(
+      data, is_text, frames::Continuation::kNo, frames::Final::kYes,
+      is_compressed);
+  if (header_size) *header_size = header.size();
+
+  std::string frame;
+  frame.reserve(header.size() + data.size());
+  frame.append(header.data(), header.size());
+  frame.append(reinterpret_cast<const char*>(data.data()), data.size());
+  return frame;
+}
+
 CloseStatus ReadWSFrame(FrameParserState& frame, engine::io::ReadableBase& io,
                         unsigned max_payload_size, std::size_t& payload_len) {
   WSHeader hdr;
@@ -159,6 +205,18 @@ CloseStatus ReadWSFrame(FrameParserState& frame, engine::io::ReadableBase& io,
 
   const bool isDataFrame =
       (hdr.bits.opcode & (kText | kBinary)) || hdr.bits.opcode == kContinuation;
+
+  if (hdr.bits.reserved != 0) {
+    // Only the first frame of a data message may have RSV1 set, and only if
+    // permessage-deflate was negotiated
+    const bool is_message_start =
+        hdr.bits.opcode == kText || hdr.bits.opcode == kBinary;
+    if (hdr.bits.reserved != kReservedCompressed ||
+        !frame.deflate_negotiated || !is_message_start) {
+      return CloseStatus::kProtocolError;
+    }
+    frame.is_compressed = true;
+  }
   if (hdr.bits.payloadLen <= 125) {
     payload_len = hdr.bits.payloadLen;
   } else if (hdr.bits.payloadLen == 126) {
@@ -200,9 +258,11 @@ CloseStatus ReadWSFrame(FrameParserState& frame, engine::io::ReadableBase& io,
                 {});
     if (engine::current_task::ShouldCancel()) return CloseStatus::kGoingAway;
 
+    // Only the payload of the current frame is masked with its key
     if (mask.mask32)
-      XorMaskInplace(reinterpret_cast<uint8_t*>(frame.payload->data()),
-                     frame.payload->size(), mask);
+      XorMaskInplace(
+          reinterpret_cast<uint8_t*>(frame.payload->data() + newPayloadOffset),
+          payload_len, mask.mask32);
   }
   char opcode = hdr.bits.opcode;
   char fin = hdr.bits.fin;
@@ -2,6 +2,9 @@
 
 #include <userver/server/websocket/server.hpp>
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 
 #include <boost/container/small_vector.hpp>
@@ -10,6 +13,8 @@
 #include <userver/tracing/span.hpp>
 #include <userver/utils/span.hpp>
 
+#include <server/websocket/permessage_deflate.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace server::websocket::impl {
@@ -63,6 +68,9 @@ static_assert(sizeof(WSHeader) == 2);
 constexpr inline unsigned int kMaxFrameHeaderSize =
     sizeof(WSHeader) + sizeof(uint64_t);
 
+// RSV1 bit of WSHeader::bits::reserved, marks compressed messages
+constexpr inline unsigned char kReservedCompressed = 0x4;
+
 namespace frames {
 
 enum class Continuation {
@@ -75,9 +83,15 @@ enum class Final {
   kNo,
 };
 
+enum class Compressed {
+  kYes,
+  kNo,
+};
+
 boost::container::small_vector<char, impl::kMaxFrameHeaderSize> DataFrameHeader(
     utils::span<const std::byte> data, bool is_text,
-    Continuation is_continuation, Final is_final);
+    Continuation is_continuation, Final is_final,
+    Compressed is_compressed = Compressed::kNo);
 std::array<char, sizeof(WSHeader)> MakeControlFrame(
     WSOpcodes opcode, utils::span<const std::byte> data = {});
 std::string CloseFrame(CloseStatusInt status_code);
@@ -88,12 +102,40 @@ const std::array<char, sizeof(WSHeader)>& CloseFrame();
 
 std::string WebsocketSecAnswer(std::string_view sec_key);
 
+/// A data message framed once to be written as is into many connections
+struct PreparedMessage final {
+  /// A single final frame with the uncompressed payload
+  std::string frame;
+  std::size_t header_size{0};
+  bool is_text{false};
+
+  /// The same message compressed without context takeover, if any
+  std::optional<std::string> compressed_frame;
+  /// Window size the compressed_frame was produced with
+  int compression_window_bits{15};
+
+  utils::span<const std::byte> GetPayload() const;
+};
+
+/// Makes a single final data frame with the payload
+std::string MakeDataFrame(utils::span<const std::byte> data, bool is_text,
+                          frames::Compressed is_compressed,
+                          std::size_t* header_size = nullptr);
+
+/// Applies the masking key to the payload of a single frame, see
+/// https://datatracker.ietf.org/doc/html/rfc6455#section-5.3
+void XorMaskInplace(std::uint8_t* dest, std::size_t len,
+                    std::uint32_t mask) noexcept;
+
 struct FrameParserState {
   bool closed = false;
   bool ping_received = false;
   bool pong_received = false;
   bool waiting_continuation = false;
   bool is_text = false;
+  // permessage-deflate was negotiated, so RSV1 bit is allowed
+  bool deflate_negotiated = false;
+  bool is_compressed = false;
   CloseStatusInt remote_close_status = 0;
 
   std::string* payload = nullptr;
@@ -102,6 +144,11 @@ struct FrameParserState {
 CloseStatus ReadWSFrame(FrameParserState& frame, engine::io::ReadableBase& io,
                         unsigned max_payload_size, std::size_t& payload_len);
 
+std::shared_ptr<WebSocketConnection> MakeWebSocket(
+    std::unique_ptr<engine::io::RwBase>&& socket,
+    engine::io::Sockaddr&& peer_name, const Config& config,
+    const std::optional<DeflateParams>& deflate_params);
+
 }  // namespace server::websocket::impl
 
 USERVER_NAMESPACE_END
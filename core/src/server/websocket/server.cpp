@@ -31,11 +31,32 @@ utils::span<const std::byte> MakeBinarySpan(utils::span<const char> span) {
 
 }  // namespace
 
+DeflateConfig Parse(const yaml_config::YamlConfig& config,
+                    formats::parse::To<DeflateConfig>) {
+  DeflateConfig result;
+  result.enabled = config["enabled"].As<bool>(result.enabled);
+  result.server_no_context_takeover =
+      config["server-no-context-takeover"].As<bool>(
+          result.server_no_context_takeover);
+  result.client_no_context_takeover =
+      config["client-no-context-takeover"].As<bool>(
+          result.client_no_context_takeover);
+  result.server_max_window_bits =
+      config["server-max-window-bits"].As<int>(result.server_max_window_bits);
+  result.client_max_window_bits =
+      config["client-max-window-bits"].As<int>(result.client_max_window_bits);
+  result.mem_level = config["mem-level"].As<int>(result.mem_level);
+  result.min_message_size =
+      config["min-message-size"].As<unsigned>(result.min_message_size);
+  return result;
+}
+
 Config Parse(const yaml_config::YamlConfig& config,
              formats::parse::To<Config>) {
   return {
       config["max-remote-payload"].As<unsigned>(65536),
       config["fragment-size"].As<unsigned>(65536),
+      config["permessage-deflate"].As<DeflateConfig>(DeflateConfig{}),
   };
 }
 
@@ -64,16 +85,55 @@ class WebSocketConnectionImpl final : public WebSocketConnection {
 
   Config config;
 
+  // Used under write_mutex_
+  std::optional<impl::Deflater> deflater_;
+  // Used under write_mutex_. Set if a write failed or was cancelled in
+  // the middle of a frame, nothing is written after that.
+  bool is_write_broken_{false};
+  // Used only by the single task calling Recv()
+  std::optional<impl::Inflater> inflater_;
+  // Max window of shared compressed messages the peer accepts, 0 - none
+  int shared_compression_window_bits_{0};
+
  public:
-  WebSocketConnectionImpl(std::unique_ptr<engine::io::RwBase> io_,
-                          const engine::io::Sockaddr& remote_addr,
-                          const Config& server_config)
-      : io(std::move(io_)), remote_addr_(remote_addr), config(server_config) {}
+  WebSocketConnectionImpl(
+      std::unique_ptr<engine::io::RwBase> io_,
+      const engine::io::Sockaddr& remote_addr, const Config& server_config,
+      const std::optional<impl::DeflateParams>& deflate_params)
+      : io(std::move(io_)), remote_addr_(remote_addr), config(server_config) {
+    if (deflate_params) {
+      deflater_.emplace(*deflate_params, config.deflate.mem_level);
+      inflater_.emplace(*deflate_params);
+      frame_.deflate_negotiated = true;
+      // Messages compressed for a whole BroadcastGroup do not depend on
+      // the previous ones, so the peer may only accept them if it does not
+      // expect a shared compression context
+      if (deflate_params->server_no_context_takeover) {
+        shared_compression_window_bits_ =
+            deflate_params->server_max_window_bits;
+      }
+    }
+  }
 
   ~WebSocketConnectionImpl() override {
     LOG_TRACE() << "Websocket connection closed";
   }
 
+  // Must be called under write_mutex_
+  void WriteFrame(utils::span<const char> header,
+                  utils::span<const std::byte> payload) {
+    if (is_write_broken_) {
+      throw(engine::io::IoException()
+            << "Websocket connection is broken by an interrupted write");
+    }
+    // The peer can not parse anything after a partially written frame, so
+    // the connection is closed for writes if the frame is not sent entirely
+    utils::FastScopeGuard broken_guard{
+        [this]() noexcept { is_write_broken_ = true; }};
+    SendExactly(*io, header, payload);
+    broken_guard.Release();
+  }
+
   void SendExtended(MessageExtended& message) {
     stats_.msg_sent++;
     stats_.bytes_sent += message.data.size();
@@ -82,34 +142,41 @@ class WebSocketConnectionImpl final : public WebSocketConnection {
 
     LOG_TRACE() << "Write message " << message.data.size() << " bytes";
     if (message.opcode == impl::WSOpcodes::kPing) {
-      SendExactly(*io, impl::frames::PingFrame(), {});
+      WriteFrame(impl::frames::PingFrame(), {});
     } else if (message.opcode == impl::WSOpcodes::kPong) {
       const auto control_frame =
           impl::frames::MakeControlFrame(impl::WSOpcodes::kPong, message.data);
-      SendExactly(*io, control_frame, message.data);
+      WriteFrame(control_frame, message.data);
     } else if (message.close_status.has_value()) {
       const auto close_frame = impl::frames::CloseFrame(
           static_cast<int>(message.close_status.value()));
-      SendExactly(*io, close_frame, {});
+      WriteFrame(close_frame, {});
     } else if (!message.data.empty()) {
       utils::span<const std::byte> data_to_send{message.data};
+      // Only the first frame of a compressed message is marked
+      auto compressed = impl::frames::Compressed::kNo;
+      if (deflater_ && data_to_send.size() >= config.deflate.min_message_size) {
+        data_to_send = deflater_->Compress(data_to_send);
+        compressed = impl::frames::Compressed::kYes;
+      }
+
       auto continuation = impl::frames::Continuation::kNo;
       while (data_to_send.size() > config.fragment_size &&
              config.fragment_size > 0) {
         const auto data_frame_header = impl::frames::DataFrameHeader(
             data_to_send.first(config.fragment_size),
             message.opcode == impl::WSOpcodes::kText, continuation,
-            impl::frames::Final::kNo);
-        SendExactly(*io, data_frame_header,
-                    data_to_send.first(config.fragment_size));
+            impl::frames::Final::kNo, compressed);
+        WriteFrame(data_frame_header, data_to_send.first(config.fragment_size));
         continuation = impl::frames::Continuation::kYes;
+        compressed = impl::frames::Compressed::kNo;
         data_to_send =
             data_to_send.last(data_to_send.size() - config.fragment_size);
       }
       const auto data_frame_header = impl::frames::DataFrameHeader(
           data_to_send, message.opcode == impl::WSOpcodes::kText, continuation,
-          impl::frames::Final::kYes);
-      SendExactly(*io, data_frame_header, data_to_send);
+          impl::frames::Final::kYes, compressed);
+      WriteFrame(data_frame_header, data_to_send);
     }
   }
 
@@ -131,6 +198,21 @@ class WebSocketConnectionImpl final : public WebSocketConnection {
     SendExtended(mext);
   }
 
+  void SendPrepared(const impl::PreparedMessage& message) override {
+    const bool use_compressed =
+        message.compressed_frame &&
+        message.compression_window_bits <= shared_compression_window_bits_;
+    const std::string& frame =
+        use_compressed ? *message.compressed_frame : message.frame;
+
+    stats_.msg_sent++;
+    stats_.bytes_sent += message.frame.size() - message.header_size;
+
+    const std::unique_lock lock(write_mutex_);
+    LOG_TRACE() << "Write prepared message " << frame.size() << " bytes";
+    WriteFrame(frame, {});
+  }
+
   void Recv(Message& msg) override {
     msg.data.resize(0);  // do not call .clear() to keep the allocated memory
     frame_.payload = &msg.data;
@@ -176,6 +258,20 @@ class WebSocketConnectionImpl final : public WebSocketConnection {
         }
         if (frame_.waiting_continuation) continue;
 
+        if (frame_.is_compressed) {
+          frame_.is_compressed = false;
+          UASSERT(inflater_);
+          const auto inflate_status =
+              inflater_->Decompress(msg.data, config.max_remote_payload);
+          if (inflate_status != CloseStatus::kNone) {
+            MessageExtended close_msg{
+                {}, impl::WSOpcodes::kClose, inflate_status};
+            SendExtended(close_msg);
+            msg = CloseMessage(inflate_status);
+            return;
+          }
+        }
+
         msg.is_text = frame_.is_text;
         stats_.msg_recv++;
         stats_.bytes_recv += msg.data.size();
@@ -215,13 +311,35 @@ WebSocketConnection::WebSocketConnection() = default;
 
 WebSocketConnection::~WebSocketConnection() = default;
 
+void WebSocketConnection::SendPrepared(const impl::PreparedMessage& message) {
+  const auto payload = message.GetPayload();
+  Send(Message{
+      std::string{reinterpret_cast<const char*>(payload.data()),
+                  payload.size()},
+      {},
+      message.is_text,
+  });
+}
+
 std::shared_ptr<WebSocketConnection> MakeWebSocket(
     std::unique_ptr<engine::io::RwBase>&& socket,
     engine::io::Sockaddr&& peer_name, const Config& config) {
+  return impl::MakeWebSocket(std::move(socket), std::move(peer_name), config,
+                             std::nullopt);
+}
+
+namespace impl {
+
+std::shared_ptr<WebSocketConnection> MakeWebSocket(
+    std::unique_ptr<engine::io::RwBase>&& socket,
+    engine::io::Sockaddr&& peer_name, const Config& config,
+    const std::optional<DeflateParams>& deflate_params) {
   return std::make_shared<WebSocketConnectionImpl>(
-      std::move(socket), std::move(peer_name), config);
+      std::move(socket), std::move(peer_name), config, deflate_params);
 }
 
+}  // namespace impl
+
 }  // namespace server::websocket
 
 USERVER_NAMESPACE_END
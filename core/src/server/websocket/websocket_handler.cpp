@@ -63,6 +63,15 @@ std::string WebsocketHandlerBase::HandleRequestThrow(
 
   if (!HandleHandshake(request, response, context)) return "";
 
+  auto deflate_params = websocket::impl::NegotiateDeflate(
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kWebsocketExtensions),
+      config_.deflate);
+  if (deflate_params) {
+    response.SetHeader(
+        USERVER_NAMESPACE::http::headers::kWebsocketExtensions,
+        websocket::impl::FormatDeflateResponse(*deflate_params));
+  }
+
   response.SetStatus(server::http::HttpStatus::kSwitchingProtocols);
   response.SetHeader(USERVER_NAMESPACE::http::headers::kConnection, "Upgrade");
   response.SetHeader(USERVER_NAMESPACE::http::headers::kUpgrade, "websocket");
@@ -72,11 +81,12 @@ std::string WebsocketHandlerBase::HandleRequestThrow(
   request.SetUpgradeWebsocket(
       [context = std::make_shared<server::request::RequestContext>(
            std::move(context)),
+       deflate_params,
        this](std::unique_ptr<engine::io::RwBase> socket,
              engine::io::Sockaddr&& peer_name) {
         tracing::Span span("ws/" + HandlerName());
-        auto ws = websocket::MakeWebSocket(std::move(socket),
-                                           std::move(peer_name), config_);
+        auto ws = websocket::impl::MakeWebSocket(
+            std::move(socket), std::move(peer_name), config_, deflate_params);
         try {
           Handle(*ws, *context);
         } catch (const std::exception& e) {
@@ -112,6 +122,47 @@ properties:
         type: integer
         description: max output fragment size
         defaultDescription: 65536
+    permessage-deflate:
+        type: object
+        description: permessage-deflate compression extension (RFC 7692)
+        additionalProperties: false
+        properties:
+            enabled:
+                type: boolean
+                description: accept the extension if the client offers it
+                defaultDescription: false
+            server-no-context-takeover:
+                type: boolean
+                description: |
+                    reset the compression context after each outgoing
+                    message; repetitive messages are compressed worse
+                defaultDescription: false
+            client-no-context-takeover:
+                type: boolean
+                description: ask the client to not keep the compression context between messages
+                defaultDescription: false
+            server-max-window-bits:
+                type: integer
+                description: log2 of the compression window for outgoing messages
+                defaultDescription: 15
+                minimum: 9
+                maximum: 15
+            client-max-window-bits:
+                type: integer
+                description: log2 of the compression window to ask from the client, if it allows that
+                defaultDescription: 15
+                minimum: 8
+                maximum: 15
+            mem-level:
+                type: integer
+                description: zlib memLevel for compression, lower values use less memory per connection
+                defaultDescription: 8
+                minimum: 1
+                maximum: 9
+            min-message-size:
+                type: integer
+                description: messages smaller than this are sent uncompressed
+                defaultDescription: 64
 )");
 }
 
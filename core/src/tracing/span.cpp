@@ -1,5 +1,6 @@
 #include <tracing/span_impl.hpp>
 
+#include <random>
 #include <type_traits>
 
 #include <fmt/compile.h>
@@ -7,13 +8,13 @@
 
 #include <engine/task/task_context.hpp>
 #include <logging/log_helper_impl.hpp>
+#include <userver/compiler/thread_local.hpp>
 #include <userver/engine/task/local_variable.hpp>
 #include <userver/logging/impl/logger_base.hpp>
 #include <userver/logging/impl/tag_writer.hpp>
 #include <userver/tracing/span.hpp>
 #include <userver/tracing/tracer.hpp>
 #include <userver/utils/assert.hpp>
-#include <userver/utils/encoding/hex.hpp>
 #include <userver/utils/rand.hpp>
 #include <userver/utils/uuid4.hpp>
 #include <utils/internal_tag.hpp>
@@ -62,16 +63,23 @@ TsBuffer StartTsToString(std::chrono::system_clock::time_point start) {
 // Maintain coro-local span stack to identify "current span" in O(1).
 engine::TaskLocalVariable<SpanStack> task_local_spans;
 
-std::string GenerateSpanId() {
-  std::uniform_int_distribution<std::uint64_t> dist;
-  const auto random_value = utils::WithDefaultRandom(dist);
-
-  static_assert(sizeof(random_value) == 8);
-  return utils::encoding::ToHex(&random_value, 8);
-}
+// Span ids are not security-sensitive, so a fast non-cryptographic generator
+// is enough
+compiler::ThreadLocal local_id_generator = [] {
+  auto seed_seq = utils::impl::MakeSeedSeq();
+  return std::mt19937_64(seed_seq);
+};
 
 }  // namespace
 
+void impl::GenerateRandomBytes(std::uint64_t* data,
+                               std::size_t count) noexcept {
+  auto generator = local_id_generator.Use();
+  for (std::size_t i = 0; i < count; ++i) {
+    data[i] = (*generator)();
+  }
+}
+
 Span::Impl::Impl(std::string name, ReferenceType reference_type,
                  logging::Level log_level,
                  utils::impl::SourceLocation source_location)
@@ -87,9 +95,8 @@ Span::Impl::Impl(TracerPtr tracer, std::string name, const Span::Impl* parent,
       tracer_(std::move(tracer)),
       start_system_time_(std::chrono::system_clock::now()),
       start_steady_time_(std::chrono::steady_clock::now()),
-      trace_id_(parent ? parent->GetTraceId()
-                       : utils::generators::GenerateUuid()),
-      span_id_(GenerateSpanId()),
+      trace_id_(parent ? parent->trace_id_ : impl::TraceId::Generate()),
+      span_id_(impl::SpanId::Generate()),
       parent_id_(GetParentIdForLogging(parent)),
       reference_type_(reference_type),
       source_location_(source_location) {
@@ -153,11 +160,11 @@ void Span::Impl::AttachToCoroStack() {
   task_local_spans->push_back(*this);
 }
 
-std::string Span::Impl::GetParentIdForLogging(const Span::Impl* parent) {
+impl::SpanId Span::Impl::GetParentIdForLogging(const Span::Impl* parent) {
   if (!parent) return {};
 
   if (!parent->is_linked()) {
-    return parent->GetSpanId();
+    return parent->span_id_;
   }
 
   const auto* spans_ptr = task_local_spans.GetOptional();
@@ -170,9 +177,9 @@ std::string Span::Impl::GetParentIdForLogging(const Span::Impl* parent) {
   // orphaned. It's still possible for chaining to break in case parent span
   // becomes non-loggable after child span is created, but that we can't control
   for (auto current = spans_ptr->iterator_to(*parent);; --current) {
-    if (current->GetParentId().empty() /* won't find better candidate */ ||
+    if (current->parent_id_.IsEmpty() /* won't find better candidate */ ||
         current->ShouldLog()) {
-      return current->GetSpanId();
+      return current->span_id_;
     }
     if (current == spans_ptr->begin()) break;
   };
@@ -222,7 +229,7 @@ Span::Span(std::string name, ReferenceType reference_type,
                           source_location),
              Span::OptionalDeleter{OptionalDeleter::ShouldDelete()}) {
   AttachToCoroStack();
-  if (pimpl_->GetParentId().empty()) {
+  if (pimpl_->GetParentIdBinary().IsEmpty()) {
     SetLink(utils::generators::GenerateUuid());
   }
   pimpl_->span_ = this;
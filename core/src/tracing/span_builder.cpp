@@ -16,7 +16,7 @@ SpanBuilder::SpanBuilder(std::string name,
                           logging::Level::kInfo, location),
              Span::OptionalDeleter{Span::OptionalDeleter::ShouldDelete()}) {
   pimpl_->AttachToCoroStack();
-  if (pimpl_->GetParentId().empty()) {
+  if (pimpl_->GetParentIdBinary().IsEmpty()) {
     AddTagFrozen(kLinkTag, utils::generators::GenerateUuid());
   }
 }
@@ -33,7 +33,7 @@ void SpanBuilder::SetTraceId(std::string trace_id) {
   pimpl_->SetTraceId(std::move(trace_id));
 }
 
-const std::string& SpanBuilder::GetTraceId() const noexcept {
+const std::string& SpanBuilder::GetTraceId() const {
   return pimpl_->GetTraceId();
 }
 
@@ -19,6 +19,7 @@
 #include <userver/utils/impl/source_location.hpp>
 
 #include <tracing/time_storage.hpp>
+#include <tracing/tracing_id.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -54,17 +55,29 @@ class Span::Impl
   // Add the context of this Span a non-Span-specific log record
   void LogTo(logging::impl::TagWriter writer);
 
-  const std::string& GetTraceId() const& noexcept { return trace_id_; }
-  const std::string& GetSpanId() const& noexcept { return span_id_; }
-  const std::string& GetParentId() const& noexcept { return parent_id_; }
-
-  std::string GetTraceId() && noexcept { return std::move(trace_id_); }
-  std::string GetSpanId() && noexcept { return std::move(span_id_); }
-  std::string GetParentId() && noexcept { return std::move(parent_id_); }
-
-  void SetTraceId(std::string&& id) noexcept { trace_id_ = std::move(id); }
-  void SetSpanId(std::string&& id) noexcept { span_id_ = std::move(id); }
-  void SetParentId(std::string&& id) noexcept { parent_id_ = std::move(id); }
+  // The string getters format the binary ids on the first call, prefer
+  // the *Binary getters in hot paths
+  const std::string& GetTraceId() const& { return trace_id_.GetString(); }
+  const std::string& GetSpanId() const& { return span_id_.GetString(); }
+  const std::string& GetParentId() const& { return parent_id_.GetString(); }
+
+  std::string GetTraceId() && { return std::move(trace_id_).Extract(); }
+  std::string GetSpanId() && { return std::move(span_id_).Extract(); }
+  std::string GetParentId() && { return std::move(parent_id_).Extract(); }
+
+  const impl::TraceId& GetTraceIdBinary() const noexcept { return trace_id_; }
+  const impl::SpanId& GetSpanIdBinary() const noexcept { return span_id_; }
+  const impl::SpanId& GetParentIdBinary() const noexcept { return parent_id_; }
+
+  void SetTraceId(std::string&& id) noexcept {
+    trace_id_ = impl::TraceId{std::move(id)};
+  }
+  void SetSpanId(std::string&& id) noexcept {
+    span_id_ = impl::SpanId{std::move(id)};
+  }
+  void SetParentId(std::string&& id) noexcept {
+    parent_id_ = impl::SpanId{std::move(id)};
+  }
 
   ReferenceType GetReferenceType() const noexcept { return reference_type_; }
 
@@ -77,7 +90,7 @@ class Span::Impl
   static void AddOpentracingTags(formats::json::StringBuilder& output,
                                  const logging::LogExtra& input);
 
-  static std::string GetParentIdForLogging(const Span::Impl* parent);
+  static impl::SpanId GetParentIdForLogging(const Span::Impl* parent);
   bool ShouldLog() const;
 
   const std::string name_;
@@ -96,9 +109,9 @@ class Span::Impl
   const std::chrono::system_clock::time_point start_system_time_;
   const std::chrono::steady_clock::time_point start_steady_time_;
 
-  std::string trace_id_;
-  std::string span_id_;
-  std::string parent_id_;
+  impl::TraceId trace_id_;
+  impl::SpanId span_id_;
+  impl::SpanId parent_id_;
   const ReferenceType reference_type_;
   utils::impl::SourceLocation source_location_;
 
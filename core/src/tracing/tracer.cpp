@@ -30,9 +30,15 @@ class NoopTracer final : public Tracer {
 
 void NoopTracer::LogSpanContextTo(const Span::Impl& span,
                                   logging::impl::TagWriter writer) const {
-  writer.PutTag(kTraceIdName, span.GetTraceId());
-  writer.PutTag(kSpanIdName, span.GetSpanId());
-  writer.PutTag(kParentIdName, span.GetParentId());
+  impl::TraceId::HexBuffer trace_id_buffer;
+  impl::SpanId::HexBuffer span_id_buffer;
+  impl::SpanId::HexBuffer parent_id_buffer;
+  writer.PutTag(kTraceIdName,
+                span.GetTraceIdBinary().ToStringView(trace_id_buffer));
+  writer.PutTag(kSpanIdName,
+                span.GetSpanIdBinary().ToStringView(span_id_buffer));
+  writer.PutTag(kParentIdName,
+                span.GetParentIdBinary().ToStringView(parent_id_buffer));
 }
 
 auto& GlobalNoLogSpans() {
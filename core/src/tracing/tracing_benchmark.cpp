@@ -2,6 +2,7 @@
 
 #include <userver/engine/run_standalone.hpp>
 #include <userver/logging/null_logger.hpp>
+#include <userver/tracing/span.hpp>
 #include <userver/tracing/tracer.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -33,6 +34,34 @@ void tracing_happy_log(benchmark::State& state) {
 }
 BENCHMARK(tracing_happy_log);
 
+void tracing_child_span_ctr(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    auto tracer = tracing::MakeTracer("test_service", {});
+    auto root_span = tracer->CreateSpanWithoutParent("root");
+
+    for ([[maybe_unused]] auto _ : state) {
+      tracing::Span child_span{"child"};
+      benchmark::DoNotOptimize(child_span);
+    }
+  });
+}
+BENCHMARK(tracing_child_span_ctr);
+
+void tracing_span_ids_formatting(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    auto tracer = tracing::MakeTracer("test_service", {});
+    auto root_span = tracer->CreateSpanWithoutParent("root");
+
+    for ([[maybe_unused]] auto _ : state) {
+      tracing::Span child_span{"child"};
+      benchmark::DoNotOptimize(child_span.GetTraceId());
+      benchmark::DoNotOptimize(child_span.GetSpanId());
+      benchmark::DoNotOptimize(child_span.GetParentId());
+    }
+  });
+}
+BENCHMARK(tracing_span_ids_formatting);
+
 tracing::Span GetSpanWithOpentracingHttpTags(tracing::TracerPtr tracer) {
   auto span = tracer->CreateSpanWithoutParent("name");
   span.AddTag("meta_code", 200);
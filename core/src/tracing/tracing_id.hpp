@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace tracing::impl {
+
+/// Fills the buffer with random bytes using a fast thread-local generator
+void GenerateRandomBytes(std::uint64_t* data, std::size_t count) noexcept;
+
+/// @brief Identifier of a trace or of a span.
+///
+/// Identifiers generated by us are kept in the binary form, so creating and
+/// copying them does not allocate. They are formatted into hex only on demand.
+/// Identifiers that came from the outside (e.g. from headers) may have any
+/// format and are stored as-is; those that look like ours (lowercase hex of
+/// kHexSize) are also parsed into the binary form.
+///
+/// @warning `GetString` lazily caches the hex representation, so it must not
+/// be called concurrently for the same object, just like other `Span` methods.
+template <std::size_t Words>
+class TracingId final {
+ public:
+  /// Size of the hex representation of a generated identifier
+  static constexpr std::size_t kHexSize = Words * sizeof(std::uint64_t) * 2;
+
+  using HexBuffer = std::array<char, kHexSize>;
+
+  /// Creates an empty identifier
+  TracingId() = default;
+
+  explicit TracingId(std::string&& external) noexcept
+      : is_binary_(ParseFrom(external)), string_(std::move(external)) {}
+
+  // The cached hex representation of a generated identifier is not copied,
+  // so that copying to child spans does not allocate
+  TracingId(const TracingId& other)
+      : binary_(other.binary_),
+        is_binary_(other.is_binary_),
+        string_(other.is_binary_ ? std::string{} : other.string_) {}
+
+  TracingId(TracingId&&) noexcept = default;
+
+  TracingId& operator=(const TracingId& other) {
+    if (this != &other) *this = TracingId{other};
+    return *this;
+  }
+
+  TracingId& operator=(TracingId&&) noexcept = default;
+
+  static TracingId Generate() noexcept {
+    TracingId result;
+    GenerateRandomBytes(result.binary_.data(), Words);
+    result.is_binary_ = true;
+    return result;
+  }
+
+  bool IsEmpty() const noexcept { return !is_binary_ && string_.empty(); }
+
+  /// Returns the hex representation, which is valid while both `*this` and
+  /// `buffer` are alive and unchanged. Does not allocate.
+  std::string_view ToStringView(HexBuffer& buffer) const noexcept {
+    if (!is_binary_ || !string_.empty()) return string_;
+    FormatTo(buffer.data());
+    return {buffer.data(), buffer.size()};
+  }
+
+  /// Returns the hex representation, formatting it on the first call
+  const std::string& GetString() const {
+    if (is_binary_ && string_.empty()) {
+      string_.resize(kHexSize);
+      FormatTo(string_.data());
+    }
+    return string_;
+  }
+
+  std::string Extract() && {
+    GetString();
+    return std::move(string_);
+  }
+
+ private:
+  bool ParseFrom(std::string_view hex) noexcept {
+    if (hex.size() != kHexSize) return false;
+    std::array<std::uint64_t, Words> binary{};
+    for (std::size_t i = 0; i < kHexSize; ++i) {
+      const char c = hex[i];
+      std::uint64_t nibble = 0;
+      if (c >= '0' && c <= '9') {
+        nibble = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        nibble = c - 'a' + 10;
+      } else {
+        return false;
+      }
+      auto& word = binary[i / (sizeof(std::uint64_t) * 2)];
+      word = (word << 4) | nibble;
+    }
+    binary_ = binary;
+    return true;
+  }
+
+  void FormatTo(char* out) const noexcept {
+    static constexpr std::string_view kDigits = "0123456789abcdef";
+    for (const auto word : binary_) {
+      // Most significant nibble goes first, so that the hex does not depend on
+      // the byte order of the platform
+      for (int shift = 60; shift >= 0; shift -= 4) {
+        *out++ = kDigits[(word >> shift) & 0xf];
+      }
+    }
+  }
+
+  std::array<std::uint64_t, Words> binary_{};
+  bool is_binary_{false};
+  mutable std::string string_;
+};
+
+/// 128-bit trace identifier
+using TraceId = TracingId<2>;
+
+/// 64-bit span identifier
+using SpanId = TracingId<1>;
+
+}  // namespace tracing::impl
+
+USERVER_NAMESPACE_END
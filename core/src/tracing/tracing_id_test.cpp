@@ -0,0 +1,101 @@
+#include <tracing/tracing_id.hpp>
+
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using tracing::impl::SpanId;
+using tracing::impl::TraceId;
+
+bool IsLowercaseHex(std::string_view value) {
+  return value.find_first_not_of("0123456789abcdef") == std::string_view::npos;
+}
+
+}  // namespace
+
+TEST(TracingId, Empty) {
+  const TraceId id;
+  EXPECT_TRUE(id.IsEmpty());
+  EXPECT_EQ(id.GetString(), "");
+
+  TraceId::HexBuffer buffer{};
+  EXPECT_EQ(id.ToStringView(buffer), "");
+}
+
+TEST(TracingId, Generate) {
+  const auto trace_id = TraceId::Generate();
+  EXPECT_FALSE(trace_id.IsEmpty());
+  EXPECT_EQ(trace_id.GetString().size(), 32);
+  EXPECT_TRUE(IsLowercaseHex(trace_id.GetString()));
+
+  const auto span_id = SpanId::Generate();
+  EXPECT_EQ(span_id.GetString().size(), 16);
+  EXPECT_TRUE(IsLowercaseHex(span_id.GetString()));
+
+  EXPECT_NE(TraceId::Generate().GetString(), trace_id.GetString());
+}
+
+TEST(TracingId, ToStringView) {
+  const auto id = TraceId::Generate();
+
+  TraceId::HexBuffer buffer{};
+  const auto formatted = id.ToStringView(buffer);
+  EXPECT_EQ(formatted.data(), buffer.data());
+  EXPECT_EQ(formatted, id.GetString());
+
+  // Uses the cached string once it is formatted
+  EXPECT_EQ(id.ToStringView(buffer).data(), id.GetString().data());
+}
+
+TEST(TracingId, Parse) {
+  const std::string hex = "0123456789abcdeffedcba9876543210";
+  TraceId id{std::string{hex}};
+  EXPECT_EQ(id.GetString(), hex);
+
+  // Parsed identifiers are copied in the binary form and formatted back
+  const TraceId copy{id};
+  TraceId::HexBuffer buffer{};
+  const auto formatted = copy.ToStringView(buffer);
+  EXPECT_EQ(formatted.data(), buffer.data());
+  EXPECT_EQ(formatted, hex);
+  EXPECT_EQ(copy.GetString(), hex);
+
+  EXPECT_EQ(std::move(id).Extract(), hex);
+
+  EXPECT_EQ(SpanId{std::string{"00000000000000ff"}}.GetString(),
+            "00000000000000ff");
+}
+
+TEST(TracingId, External) {
+  for (const std::string_view external :
+       {"abc", "0123456789ABCDEF0123456789ABCDEF",
+        "0123456789abcdef0123456789abcdeg", "0123456789abcdef0123456789abcdef0",
+        "{some-uuid-like-value}"}) {
+    const TraceId id{std::string{external}};
+    EXPECT_FALSE(id.IsEmpty());
+    EXPECT_EQ(id.GetString(), external);
+
+    // Unparsed identifiers are stored and copied as-is
+    const TraceId copy{id};
+    TraceId::HexBuffer buffer{};
+    EXPECT_EQ(copy.ToStringView(buffer), external);
+  }
+}
+
+TEST(TracingId, CopyDoesNotCopyCache) {
+  const auto id = SpanId::Generate();
+  const auto& formatted = id.GetString();
+
+  SpanId copy{id};
+  EXPECT_EQ(copy.GetString(), formatted);
+  EXPECT_NE(copy.GetString().data(), formatted.data());
+
+  copy = SpanId::Generate();
+  EXPECT_NE(copy.GetString(), formatted);
+  copy = id;
+  EXPECT_EQ(copy.GetString(), formatted);
+}
+
+USERVER_NAMESPACE_END
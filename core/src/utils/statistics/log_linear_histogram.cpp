@@ -0,0 +1,277 @@
+#include <userver/utils/statistics/log_linear_histogram.hpp>
+
+#include <new>
+
+#include <userver/utils/assert.hpp>
+#include <userver/utils/statistics/percentile.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+namespace {
+
+using Counter = std::atomic<std::uint64_t>;
+
+// Chunk N holds the buckets of values with the highest bit
+// 'precision_bits + N - 1', chunks 0 and 1 hold the exact values.
+constexpr std::size_t kMaxChunks = 64;
+
+constexpr std::size_t GetBucketsPerChunk(std::uint8_t precision_bits) noexcept {
+  return std::size_t{1} << precision_bits;
+}
+
+std::size_t GetBucketIndex(std::uint64_t value,
+                           std::uint8_t precision_bits) noexcept {
+  const auto buckets_per_chunk = GetBucketsPerChunk(precision_bits);
+  if (value < buckets_per_chunk) return value;
+
+  const int highest_bit = 63 - __builtin_clzll(value);
+  const int shift = highest_bit - precision_bits;
+  return static_cast<std::size_t>(shift) * buckets_per_chunk +
+         static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t GetBucketHighestValue(std::size_t index,
+                                    std::uint8_t precision_bits) noexcept {
+  const auto buckets_per_chunk = GetBucketsPerChunk(precision_bits);
+  if (index < 2 * buckets_per_chunk) return index;
+
+  const auto shift = index / buckets_per_chunk - 1;
+  const std::uint64_t lowest_bits =
+      index % buckets_per_chunk + buckets_per_chunk;
+  // Written this way to avoid overflow in the last bucket
+  return (lowest_bits << shift) + ((std::uint64_t{1} << shift) - 1);
+}
+
+Counter* GetOrCreateChunk(std::atomic<Counter*>& chunk,
+                          std::size_t size) noexcept {
+  auto* current = chunk.load(std::memory_order_acquire);
+  if (current) return current;
+
+  auto* created = new (std::nothrow) Counter[size]();
+  if (!created) return nullptr;
+
+  if (chunk.compare_exchange_strong(current, created,
+                                    std::memory_order_acq_rel)) {
+    return created;
+  }
+  // Lost the race to another thread of the same shard
+  delete[] created;
+  return current;
+}
+
+}  // namespace
+
+struct LogLinearHistogram::Shard final {
+  Shard() = default;
+  Shard(const Shard&) = delete;
+  Shard& operator=(const Shard&) = delete;
+
+  ~Shard() {
+    for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<Counter*>, kMaxChunks> chunks{};
+};
+
+namespace {
+
+template <typename Shard>
+Shard* GetOrCreateShard(std::atomic<Shard*>& shard) noexcept {
+  auto* current = shard.load(std::memory_order_acquire);
+  if (current) return current;
+
+  auto* created = new (std::nothrow) Shard{};
+  if (!created) return nullptr;
+
+  if (shard.compare_exchange_strong(current, created,
+                                    std::memory_order_acq_rel)) {
+    return created;
+  }
+  delete created;
+  return current;
+}
+
+}  // namespace
+
+LogLinearHistogram::LogLinearHistogram(std::uint8_t precision_bits)
+    : precision_bits_(precision_bits) {
+  UINVARIANT(precision_bits >= 1 && precision_bits <= kMaxPrecisionBits,
+             "Invalid LogLinearHistogram precision");
+}
+
+LogLinearHistogram::LogLinearHistogram(LogLinearHistogram&& other) noexcept
+    : precision_bits_(other.precision_bits_) {
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    shards_[i].store(other.shards_[i].exchange(nullptr));
+  }
+}
+
+LogLinearHistogram::LogLinearHistogram(const LogLinearHistogram& other)
+    : LogLinearHistogram(other.precision_bits_) {
+  Add(other);
+}
+
+LogLinearHistogram& LogLinearHistogram::operator=(
+    LogLinearHistogram&& other) noexcept {
+  if (this == &other) return *this;
+
+  precision_bits_ = other.precision_bits_;
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    delete shards_[i].exchange(other.shards_[i].exchange(nullptr));
+  }
+  return *this;
+}
+
+LogLinearHistogram& LogLinearHistogram::operator=(
+    const LogLinearHistogram& other) {
+  *this = LogLinearHistogram{other};
+  return *this;
+}
+
+LogLinearHistogram::~LogLinearHistogram() {
+  for (auto& shard : shards_) delete shard.load(std::memory_order_relaxed);
+}
+
+void LogLinearHistogram::Account(std::uint64_t value,
+                                 std::uint64_t count) noexcept {
+  const auto index = GetBucketIndex(value, precision_bits_);
+  const auto buckets_per_chunk = GetBucketsPerChunk(precision_bits_);
+
+  // On allocation failure the value is not accounted
+  auto* shard = GetOrCreateShard(shards_[impl::GetCounterShardIndex()]);
+  if (!shard) return;
+  auto* chunk = GetOrCreateChunk(shard->chunks[index >> precision_bits_],
+                                 buckets_per_chunk);
+  if (!chunk) return;
+
+  chunk[index & (buckets_per_chunk - 1)].fetch_add(count,
+                                                   std::memory_order_relaxed);
+}
+
+// Calls `func(bucket_index, count)` for non-empty buckets in ascending order
+// until `func` returns false.
+template <typename Func>
+void LogLinearHistogram::ForEachBucket(Func func) const {
+  const auto buckets_per_chunk = GetBucketsPerChunk(precision_bits_);
+
+  std::array<Shard*, impl::kCounterShardCount> shards{};
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    shards[i] = shards_[i].load(std::memory_order_acquire);
+  }
+
+  for (std::size_t chunk_index = 0; chunk_index < kMaxChunks; ++chunk_index) {
+    std::array<const Counter*, impl::kCounterShardCount> chunks{};
+    bool has_chunks = false;
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+      if (!shards[i]) continue;
+      chunks[i] =
+          shards[i]->chunks[chunk_index].load(std::memory_order_acquire);
+      has_chunks |= (chunks[i] != nullptr);
+    }
+    if (!has_chunks) continue;
+
+    for (std::size_t j = 0; j < buckets_per_chunk; ++j) {
+      std::uint64_t count = 0;
+      for (const auto* chunk : chunks) {
+        if (chunk) count += chunk[j].load(std::memory_order_relaxed);
+      }
+      if (count == 0) continue;
+
+      if (!func(chunk_index * buckets_per_chunk + j, count)) return;
+    }
+  }
+}
+
+std::uint64_t LogLinearHistogram::GetCount() const noexcept {
+  std::uint64_t result = 0;
+  ForEachBucket([&result](std::size_t, std::uint64_t count) {
+    result += count;
+    return true;
+  });
+  return result;
+}
+
+std::uint64_t LogLinearHistogram::GetPercentile(
+    double percent) const noexcept {
+  const auto total_count = GetCount();
+  if (total_count == 0) return 0;
+
+  const auto want_sum = static_cast<std::uint64_t>(total_count * percent);
+  std::uint64_t sum = 0;
+  std::size_t result_index = 0;
+  ForEachBucket([&](std::size_t index, std::uint64_t count) {
+    sum += count;
+    result_index = index;
+    return sum * 100 <= want_sum;
+  });
+  return GetBucketHighestValue(result_index, precision_bits_);
+}
+
+double LogLinearHistogram::GetRelativeError() const noexcept {
+  return 1.0 / static_cast<double>(GetBucketsPerChunk(precision_bits_));
+}
+
+void LogLinearHistogram::Add(const LogLinearHistogram& other) {
+  UINVARIANT(precision_bits_ == other.precision_bits_,
+             "Adding LogLinearHistograms of different precision");
+
+  auto* shard = GetOrCreateShard(shards_[impl::GetCounterShardIndex()]);
+  if (!shard) throw std::bad_alloc{};
+
+  const auto buckets_per_chunk = GetBucketsPerChunk(precision_bits_);
+  other.ForEachBucket([&](std::size_t index, std::uint64_t count) {
+    auto* chunk = GetOrCreateChunk(shard->chunks[index >> precision_bits_],
+                                   buckets_per_chunk);
+    if (!chunk) throw std::bad_alloc{};
+
+    chunk[index & (buckets_per_chunk - 1)].fetch_add(
+        count, std::memory_order_relaxed);
+    return true;
+  });
+}
+
+void LogLinearHistogram::Reset() noexcept {
+  const auto buckets_per_chunk = GetBucketsPerChunk(precision_bits_);
+  for (auto& shard_ptr : shards_) {
+    auto* shard = shard_ptr.load(std::memory_order_acquire);
+    if (!shard) continue;
+
+    for (auto& chunk_ptr : shard->chunks) {
+      auto* chunk = chunk_ptr.load(std::memory_order_acquire);
+      if (!chunk) continue;
+
+      for (std::size_t i = 0; i < buckets_per_chunk; ++i) {
+        chunk[i].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+Histogram LogLinearHistogram::ToHistogram(
+    utils::span<const double> upper_bounds) const {
+  Histogram result{upper_bounds};
+  ForEachBucket([&](std::size_t index, std::uint64_t count) {
+    result.Account(
+        static_cast<double>(GetBucketHighestValue(index, precision_bits_)),
+        count);
+    return true;
+  });
+  return result;
+}
+
+void ResetMetric(LogLinearHistogram& histogram) noexcept { histogram.Reset(); }
+
+void DumpMetric(Writer& writer, const LogLinearHistogram& histogram,
+                std::initializer_list<double> percents) {
+  for (const double percent : percents) {
+    writer.ValueWithLabels(histogram.GetPercentile(percent),
+                           {"percentile", GetPercentileFieldName(percent)});
+  }
+}
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
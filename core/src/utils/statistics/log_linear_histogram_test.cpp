@@ -0,0 +1,158 @@
+#include <userver/utils/statistics/log_linear_histogram.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/get_all.hpp>
+#include <userver/utest/utest.hpp>
+#include <userver/utils/statistics/fmt.hpp>
+#include <userver/utils/statistics/recentperiod.hpp>
+#include <userver/utils/statistics/storage.hpp>
+#include <userver/utils/statistics/testing.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+TEST(LogLinearHistogram, Empty) {
+  const LogLinearHistogram histogram;
+  EXPECT_EQ(histogram.GetCount(), 0);
+  EXPECT_EQ(histogram.GetPercentile(0), 0);
+  EXPECT_EQ(histogram.GetPercentile(50), 0);
+  EXPECT_EQ(histogram.GetPercentile(100), 0);
+}
+
+TEST(LogLinearHistogram, ExactSmallValues) {
+  LogLinearHistogram histogram;
+  for (std::uint64_t i = 1; i <= 100; ++i) histogram.Account(i);
+
+  EXPECT_EQ(histogram.GetCount(), 100);
+  EXPECT_EQ(histogram.GetPercentile(0), 1);
+  EXPECT_EQ(histogram.GetPercentile(50), 51);
+  EXPECT_EQ(histogram.GetPercentile(99), 100);
+  EXPECT_EQ(histogram.GetPercentile(100), 100);
+}
+
+TEST(LogLinearHistogram, RelativeError) {
+  for (const std::uint8_t precision_bits : {1, 4, 6, 10}) {
+    const std::vector<std::uint64_t> values{
+        0,          1,       127,     128,
+        1000,       1023,    1024,    123'456'789,
+        1ULL << 40, 1ULL << 63, std::numeric_limits<std::uint64_t>::max()};
+
+    for (const auto value : values) {
+      LogLinearHistogram histogram{precision_bits};
+      histogram.Account(value);
+
+      const auto result = histogram.GetPercentile(100);
+      EXPECT_GE(result, value);
+      EXPECT_LE(static_cast<double>(result - value),
+                static_cast<double>(value) * histogram.GetRelativeError())
+          << "value=" << value << ", precision_bits=" << +precision_bits;
+    }
+  }
+}
+
+TEST(LogLinearHistogram, AccountMany) {
+  LogLinearHistogram histogram;
+  histogram.Account(10, 99);
+  histogram.Account(1'000'000);
+
+  EXPECT_EQ(histogram.GetCount(), 100);
+  EXPECT_EQ(histogram.GetPercentile(98), 10);
+  EXPECT_GE(histogram.GetPercentile(99.9), 1'000'000);
+  EXPECT_LE(histogram.GetPercentile(99.9), 1'016'000);
+}
+
+TEST(LogLinearHistogram, CopyAddReset) {
+  LogLinearHistogram histogram;
+  histogram.Account(5);
+  histogram.Account(500);
+
+  LogLinearHistogram copy{histogram};
+  EXPECT_EQ(copy.GetCount(), 2);
+
+  copy.Add(histogram);
+  EXPECT_EQ(copy.GetCount(), 4);
+  EXPECT_EQ(copy.GetPercentile(0), 5);
+  EXPECT_EQ(histogram.GetCount(), 2);
+
+  LogLinearHistogram moved{std::move(copy)};
+  EXPECT_EQ(moved.GetCount(), 4);
+
+  ResetMetric(moved);
+  EXPECT_EQ(moved.GetCount(), 0);
+  EXPECT_EQ(moved.GetPercentile(100), 0);
+}
+
+TEST(LogLinearHistogram, RecentPeriod) {
+  RecentPeriod<LogLinearHistogram, LogLinearHistogram> timings;
+  timings.GetCurrentCounter().Account(42);
+
+  const auto result = timings.GetStatsForPeriod(
+      std::chrono::seconds{60}, /*with_current_epoch=*/true);
+  EXPECT_EQ(result.GetCount(), 1);
+  EXPECT_EQ(result.GetPercentile(50), 42);
+}
+
+UTEST_MT(LogLinearHistogram, Concurrent, 4) {
+  constexpr std::size_t kTasks = 8;
+  constexpr std::uint64_t kIterations = 10000;
+
+  LogLinearHistogram histogram;
+  std::vector<engine::TaskWithResult<void>> tasks;
+  for (std::size_t i = 0; i < kTasks; ++i) {
+    tasks.push_back(engine::AsyncNoSpan([&histogram] {
+      for (std::uint64_t j = 0; j < kIterations; ++j) histogram.Account(j);
+    }));
+  }
+  engine::GetAll(tasks);
+
+  EXPECT_EQ(histogram.GetCount(), kTasks * kIterations);
+  EXPECT_GE(histogram.GetPercentile(100), kIterations - 1);
+}
+
+UTEST(LogLinearHistogram, Sample) {
+  /// [sample]
+  Storage storage;
+
+  LogLinearHistogram timings_us;
+  auto statistics_holder = storage.RegisterWriter(
+      "test", [&](Writer& writer) { writer = timings_us; });
+
+  for (std::uint64_t i = 1; i <= 1000; ++i) timings_us.Account(i * 1000);
+
+  const Snapshot snapshot{storage};
+  const auto p50 =
+      snapshot.SingleMetric("test", {{"percentile", "p50"}}).AsInt();
+  EXPECT_GE(p50, 501'000);
+  EXPECT_LE(p50, 501'000 * (1 + timings_us.GetRelativeError()));
+  /// [sample]
+}
+
+UTEST(LogLinearHistogram, NativeHistogram) {
+  LogLinearHistogram histogram;
+  histogram.Account(100);
+  histogram.Account(200);
+  histogram.Account(300);
+  histogram.Account(1000);
+
+  /// [native histogram]
+  Storage storage;
+  auto statistics_holder =
+      storage.RegisterWriter("test", [&](Writer& writer) {
+        static constexpr double kBounds[] = {127, 255, 511};
+        writer = histogram.ToHistogram(kBounds);
+      });
+  /// [native histogram]
+
+  const Snapshot snapshot{storage};
+  EXPECT_EQ(fmt::to_string(snapshot.SingleMetric("test")),
+            "[127]=1,[255]=1,[511]=1,[inf]=1");
+}
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
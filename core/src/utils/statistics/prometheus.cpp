@@ -2,14 +2,20 @@
 
 #include <algorithm>
 #include <iterator>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <fmt/compile.h>
 #include <fmt/format.h>
 
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/datetime.hpp>
 #include <userver/utils/impl/transparent_hash.hpp>
 #include <userver/utils/overloaded.hpp>
 #include <userver/utils/statistics/fmt.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
 #include <userver/utils/statistics/storage.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -22,6 +28,54 @@ namespace {
 
 enum class Typed { kYes, kNo };
 
+// Returns an empty string if the type of the metric should not be written
+template <Typed IsTyped>
+std::string_view GetMetricType(const MetricValue& value) {
+  if constexpr (IsTyped == Typed::kNo) {
+    const bool should_skip = value.Visit(utils::Overloaded{
+        [](std::int64_t) { return true; },
+        [](double) { return true; },
+        [](Rate) { return false; },
+        [](HistogramView) { return false; },
+    });
+    if (should_skip) return {};
+  }
+
+  return value.Visit(utils::Overloaded{
+      [](std::int64_t) -> std::string_view { return "gauge"; },
+      [](double) -> std::string_view { return "gauge"; },
+      [](Rate) -> std::string_view { return "counter"; },
+      [](HistogramView) -> std::string_view {
+        UINVARIANT(false,
+                   "Histogram metrics are not supported for Prometheus yet");
+      },
+  });
+}
+
+template <typename Buffer>
+void DumpLabels(Buffer& buf, utils::statistics::LabelsSpan labels) {
+  buf.push_back('{');
+  bool sep = false;
+  for (const auto& label : labels) {
+    if (sep) {
+      buf.push_back(',');
+    }
+    fmt::format_to(std::back_inserter(buf), FMT_COMPILE("{}=\""),
+                   impl::ToPrometheusLabel(label.Name()));
+    const auto& value = label.Value();
+    std::replace_copy(value.cbegin(), value.cend(), std::back_inserter(buf),
+                      '"', '\'');
+    buf.push_back('"');
+    sep = true;
+  }
+  buf.push_back('}');
+}
+
+template <typename Buffer>
+void DumpValue(Buffer& buf, const MetricValue& value) {
+  fmt::format_to(std::back_inserter(buf), FMT_COMPILE(" {}\n"), value);
+}
+
 template <Typed IsTyped>
 class FormatBuilder final : public utils::statistics::BaseFormatBuilder {
  public:
@@ -37,8 +91,8 @@ class FormatBuilder final : public utils::statistics::BaseFormatBuilder {
       return;
     }
     DumpMetricNameAndType(path, value);
-    DumpLabels(labels);
-    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE(" {}\n"), value);
+    DumpLabels(buf_, labels);
+    DumpValue(buf_, value);
   }
 
   std::string Release() { return fmt::to_string(buf_); }
@@ -52,58 +106,187 @@ class FormatBuilder final : public utils::statistics::BaseFormatBuilder {
     }
 
     auto prometheus_name = impl::ToPrometheusName(name);
-    DumpMetricType(prometheus_name, value);
+    const auto type = GetMetricType<IsTyped>(value);
+    if (!type.empty()) {
+      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("# TYPE {} {}\n"),
+                     prometheus_name, type);
+    }
     buf_.append(prometheus_name);
     metrics_.emplace(name, std::move(prometheus_name));
   }
 
-  void DumpMetricType([[maybe_unused]] std::string_view prometheus_name,
-                      [[maybe_unused]] const MetricValue& value) {
-    if constexpr (IsTyped == Typed::kNo) {
-      const bool should_skip = value.Visit(utils::Overloaded{
-          [](std::int64_t) { return true; },
-          [](double) { return true; },
-          [](Rate) { return false; },
-          [](HistogramView) { return false; },
-      });
-      if (should_skip) return;
+  fmt::memory_buffer buf_;
+  utils::impl::TransparentMap<std::string, std::string> metrics_;
+};
+
+// Metrics of a single Storage entry. '# TYPE' lines are written only for the
+// first occurrence of a metric in the whole output, so they are stored
+// separately and inserted while concatenating the fragments.
+struct Fragment final {
+  struct TypeLine final {
+    std::size_t offset;
+    std::string_view prometheus_name;
+    std::string_view type;
+  };
+
+  std::string text;
+  std::vector<TypeLine> type_lines;
+  std::optional<std::chrono::steady_clock::time_point> rendered_at;
+  std::uint64_t scrape_id{0};
+};
+
+struct FormatCache final {
+  std::string request_key;
+  std::unordered_map<std::uint64_t, Fragment> fragments;
+  // Metric path to Prometheus name, the values are referenced from fragments
+  utils::impl::TransparentMap<std::string, std::string> names;
+};
+
+template <Typed IsTyped>
+class FragmentBuilder final : public utils::statistics::BaseFormatBuilder {
+ public:
+  explicit FragmentBuilder(FormatCache& cache) : cache_(cache) {}
+
+  void Reset(Fragment& fragment) {
+    fragment_ = &fragment;
+    fragment_->text.clear();
+    fragment_->type_lines.clear();
+    typed_names_.clear();
+  }
+
+  void HandleMetric(std::string_view path, utils::statistics::LabelsSpan labels,
+                    const MetricValue& value) override {
+    UASSERT(fragment_);
+    if (value.IsHistogram()) {
+      UASSERT_MSG(false,
+                  "Histogram metrics are not supported for Prometheus yet");
+      return;
+    }
+
+    const std::string_view prometheus_name = GetPrometheusName(path);
+    if (typed_names_.insert(prometheus_name).second) {
+      const auto type = GetMetricType<IsTyped>(value);
+      if (!type.empty()) {
+        fragment_->type_lines.push_back(
+            {fragment_->text.size(), prometheus_name, type});
+      }
+    }
+
+    auto& text = fragment_->text;
+    text.append(prometheus_name);
+    DumpLabels(text, labels);
+    DumpValue(text, value);
+  }
+
+ private:
+  const std::string& GetPrometheusName(std::string_view path) {
+    if (const auto* const converted =
+            utils::impl::FindTransparentOrNullptr(cache_.names, path)) {
+      return *converted;
     }
+    return cache_.names.emplace(path, impl::ToPrometheusName(path))
+        .first->second;
+  }
 
-    const auto type = value.Visit(utils::Overloaded{
-        [](std::int64_t) -> std::string_view { return "gauge"; },
-        [](double) -> std::string_view { return "gauge"; },
-        [](Rate) -> std::string_view { return "counter"; },
-        [](HistogramView) -> std::string_view {
-          UINVARIANT(false,
-                     "Histogram metrics are not supported for Prometheus yet");
-        },
-    });
-    fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("# TYPE {} {}\n"),
-                   prometheus_name, type);
+  FormatCache& cache_;
+  Fragment* fragment_{nullptr};
+  std::unordered_set<std::string_view> typed_names_;
+};
+
+template <Typed IsTyped>
+class CachingVisitor final : public impl::BaseEntryVisitor {
+ public:
+  CachingVisitor(FormatCache& cache, std::uint64_t scrape_id,
+                 std::chrono::milliseconds min_render_interval)
+      : cache_(cache),
+        builder_(cache),
+        scrape_id_(scrape_id),
+        now_(utils::datetime::SteadyNow()),
+        min_render_interval_(min_render_interval) {}
+
+  BaseFormatBuilder* StartEntry(std::uint64_t entry_id) override {
+    auto& fragment = cache_.fragments[entry_id];
+    fragment.scrape_id = scrape_id_;
+    order_.push_back(&fragment);
+
+    if (fragment.rendered_at &&
+        now_ - *fragment.rendered_at < min_render_interval_) {
+      ++cached_entries_;
+      return nullptr;
+    }
+
+    builder_.Reset(fragment);
+    return &builder_;
   }
 
-  void DumpLabels(utils::statistics::LabelsSpan labels) {
-    buf_.push_back('{');
-    bool sep = false;
-    for (const auto& label : labels) {
-      if (sep) {
-        buf_.push_back(',');
+  void FinishEntry(std::uint64_t entry_id) override {
+    cache_.fragments[entry_id].rendered_at = now_;
+    ++rendered_entries_;
+  }
+
+  std::string Release() {
+    // Entries that were unregistered or filtered out
+    for (auto it = cache_.fragments.begin(); it != cache_.fragments.end();) {
+      if (it->second.scrape_id != scrape_id_) {
+        it = cache_.fragments.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    std::size_t size = 0;
+    for (const auto* fragment : order_) size += fragment->text.size();
+
+    std::string result;
+    result.reserve(size);
+    std::unordered_set<std::string_view> typed_names;
+    for (const auto* fragment : order_) {
+      std::size_t pos = 0;
+      for (const auto& type_line : fragment->type_lines) {
+        if (!typed_names.insert(type_line.prometheus_name).second) continue;
+
+        result.append(fragment->text, pos, type_line.offset - pos);
+        pos = type_line.offset;
+        fmt::format_to(std::back_inserter(result),
+                       FMT_COMPILE("# TYPE {} {}\n"),
+                       type_line.prometheus_name, type_line.type);
       }
-      fmt::format_to(std::back_inserter(buf_), FMT_COMPILE("{}=\""),
-                     impl::ToPrometheusLabel(label.Name()));
-      const auto& value = label.Value();
-      std::replace_copy(value.cbegin(), value.cend(), std::back_inserter(buf_),
-                        '"', '\'');
-      buf_.push_back('"');
-      sep = true;
+      result.append(fragment->text, pos);
     }
-    buf_.push_back('}');
+    return result;
   }
 
-  fmt::memory_buffer buf_;
-  utils::impl::TransparentMap<std::string, std::string> metrics_;
+  std::uint64_t GetRenderedEntries() const { return rendered_entries_; }
+  std::uint64_t GetCachedEntries() const { return cached_entries_; }
+
+ private:
+  FormatCache& cache_;
+  FragmentBuilder<IsTyped> builder_;
+  const std::uint64_t scrape_id_;
+  const std::chrono::steady_clock::time_point now_;
+  const std::chrono::milliseconds min_render_interval_;
+  std::vector<const Fragment*> order_;
+  std::uint64_t rendered_entries_{0};
+  std::uint64_t cached_entries_{0};
 };
 
+std::string MakeRequestKey(const Request& request) {
+  std::string key = fmt::format("{}\n{}\n",
+                                static_cast<int>(request.prefix_match_type),
+                                request.prefix);
+  for (const auto& label : request.require_labels) {
+    key += fmt::format("r:{}={}\n", label.Name(), label.Value());
+  }
+
+  std::vector<std::pair<std::string_view, std::string_view>> add_labels(
+      request.add_labels.begin(), request.add_labels.end());
+  std::sort(add_labels.begin(), add_labels.end());
+  for (const auto& [name, value] : add_labels) {
+    key += fmt::format("a:{}={}\n", name, value);
+  }
+  return key;
+}
+
 }  // namespace
 
 std::string ToPrometheusName(std::string_view data) {
@@ -153,6 +336,74 @@ std::string ToPrometheusFormatUntyped(
   return builder.Release();
 }
 
+struct PrometheusFormatCache::Impl final {
+  explicit Impl(std::chrono::milliseconds min_render_interval)
+      : min_render_interval(min_render_interval) {}
+
+  template <impl::Typed IsTyped>
+  std::string Render(impl::FormatCache& cache, const Storage& statistics,
+                     const Request& request) {
+    const auto start = utils::datetime::SteadyNow();
+
+    auto request_key = impl::MakeRequestKey(request);
+    const std::lock_guard lock{mutex};
+    if (cache.request_key != request_key) {
+      cache = {};
+      cache.request_key = std::move(request_key);
+    }
+
+    impl::CachingVisitor<IsTyped> visitor{cache, ++scrape_id,
+                                          min_render_interval};
+    statistics.VisitMetricsByEntry(visitor, request);
+    auto result = visitor.Release();
+
+    ++scrapes;
+    rendered_entries += Rate{visitor.GetRenderedEntries()};
+    cached_entries += Rate{visitor.GetCachedEntries()};
+    last_scrape_duration_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            utils::datetime::SteadyNow() - start)
+            .count();
+    return result;
+  }
+
+  const std::chrono::milliseconds min_render_interval;
+
+  engine::Mutex mutex;
+  std::uint64_t scrape_id{0};
+  impl::FormatCache typed;
+  impl::FormatCache untyped;
+
+  RateCounter scrapes;
+  RateCounter rendered_entries;
+  RateCounter cached_entries;
+  std::atomic<std::int64_t> last_scrape_duration_ms{0};
+};
+
+PrometheusFormatCache::PrometheusFormatCache(
+    std::chrono::milliseconds min_render_interval)
+    : impl_(std::make_unique<Impl>(min_render_interval)) {}
+
+PrometheusFormatCache::~PrometheusFormatCache() = default;
+
+std::string PrometheusFormatCache::ToPrometheusFormat(const Storage& statistics,
+                                                      const Request& request) {
+  return impl_->Render<impl::Typed::kYes>(impl_->typed, statistics, request);
+}
+
+std::string PrometheusFormatCache::ToPrometheusFormatUntyped(
+    const Storage& statistics, const Request& request) {
+  return impl_->Render<impl::Typed::kNo>(impl_->untyped, statistics, request);
+}
+
+void DumpMetric(Writer& writer, const PrometheusFormatCache& cache) {
+  const auto& impl = *cache.impl_;
+  writer["scrapes"] = impl.scrapes;
+  writer["entries"]["rendered"] = impl.rendered_entries;
+  writer["entries"]["cached"] = impl.cached_entries;
+  writer["last-scrape-duration-ms"] = impl.last_scrape_duration_ms.load();
+}
+
 }  // namespace utils::statistics
 
 USERVER_NAMESPACE_END
@@ -1,7 +1,9 @@
 #include <userver/utest/utest.hpp>
 
 #include <userver/formats/json/serialize.hpp>
+#include <userver/utils/mock_now.hpp>
 #include <userver/utils/statistics/metadata.hpp>
+#include <userver/utils/statistics/rate.hpp>
 #include <userver/utils/statistics/storage.hpp>
 #include <userver/utils/text.hpp>
 
@@ -409,6 +411,62 @@ child{application="processing"} 8
   }
 }
 
+UTEST(MetricsPrometheus, CacheSameOutput) {
+  utils::statistics::Storage storage;
+  auto holder1 = storage.RegisterWriter(
+      "a", [](Writer& writer) {
+        writer["gauge"].ValueWithLabels(1, {"label", "x"});
+        writer["rate"] = utils::statistics::Rate{2};
+      });
+  auto holder2 = storage.RegisterWriter(
+      "a", [](Writer& writer) {
+        writer["gauge"].ValueWithLabels(3, {"label", "y"});
+        writer["rate"] = utils::statistics::Rate{4};
+        writer["other"] = 5.5;
+      });
+
+  PrometheusFormatCache cache{std::chrono::seconds{10}};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(cache.ToPrometheusFormat(storage), ToPrometheusFormat(storage));
+    EXPECT_EQ(cache.ToPrometheusFormatUntyped(storage),
+              ToPrometheusFormatUntyped(storage));
+  }
+
+  const auto request =
+      utils::statistics::Request::MakeWithPrefix("a.rate", {{"app", "test"}});
+  EXPECT_EQ(cache.ToPrometheusFormat(storage, request),
+            ToPrometheusFormat(storage, request));
+}
+
+UTEST(MetricsPrometheus, CacheInterval) {
+  utils::datetime::MockNowSet({});
+
+  int value = 1;
+  utils::statistics::Storage storage;
+  auto holder = storage.RegisterWriter(
+      "a", [&value](Writer& writer) { writer["value"] = value; });
+  auto other_holder = storage.RegisterWriter(
+      "b", [](Writer& writer) { writer["value"] = 42; });
+
+  PrometheusFormatCache cache{std::chrono::seconds{10}};
+  EXPECT_EQ(cache.ToPrometheusFormatUntyped(storage),
+            "a_value{} 1\nb_value{} 42\n");
+
+  value = 2;
+  utils::datetime::MockSleep(std::chrono::seconds{5});
+  EXPECT_EQ(cache.ToPrometheusFormatUntyped(storage),
+            "a_value{} 1\nb_value{} 42\n");
+
+  utils::datetime::MockSleep(std::chrono::seconds{5});
+  EXPECT_EQ(cache.ToPrometheusFormatUntyped(storage),
+            "a_value{} 2\nb_value{} 42\n");
+
+  other_holder.Unregister();
+  EXPECT_EQ(cache.ToPrometheusFormatUntyped(storage), "a_value{} 2\n");
+
+  utils::datetime::MockNowUnset();
+}
+
 }  // namespace utils::statistics::impl
 
 USERVER_NAMESPACE_END
@@ -0,0 +1,37 @@
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+#include <userver/compiler/impl/tls.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+namespace impl {
+
+namespace {
+
+std::atomic<std::size_t> next_counter_shard{0};
+
+std::size_t AssignCounterShardIndex() noexcept {
+  return next_counter_shard.fetch_add(1, std::memory_order_relaxed) %
+         kCounterShardCount;
+}
+
+}  // namespace
+
+std::size_t GetCounterShardIndex() noexcept {
+  return compiler::impl::ThreadLocal([] { return AssignCounterShardIndex(); });
+}
+
+}  // namespace impl
+
+void DumpMetric(Writer& writer, const ShardedRateCounter& value) {
+  writer = value.Load();
+}
+
+void ResetMetric(ShardedRateCounter& value) { value.Store(Rate{0}); }
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
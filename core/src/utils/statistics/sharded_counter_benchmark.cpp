@@ -0,0 +1,52 @@
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/relaxed_counter.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+template <typename Counter>
+void CounterIncrement(benchmark::State& state) {
+  static Counter counter;
+
+  for ([[maybe_unused]] auto _ : state) {
+    ++counter;
+  }
+
+  if (state.thread_index() == 0) {
+    benchmark::DoNotOptimize(counter.Load());
+  }
+}
+
+template <typename Counter>
+void CounterLoad(benchmark::State& state) {
+  Counter counter;
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(counter.Load());
+  }
+}
+
+using utils::statistics::RateCounter;
+using utils::statistics::RelaxedCounter;
+using utils::statistics::ShardedCounter;
+using utils::statistics::ShardedRateCounter;
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(CounterIncrement, RelaxedCounter<std::uint64_t>)
+    ->ThreadRange(1, 64);
+BENCHMARK_TEMPLATE(CounterIncrement, ShardedCounter<std::uint64_t>)
+    ->ThreadRange(1, 64);
+BENCHMARK_TEMPLATE(CounterIncrement, RateCounter)->ThreadRange(1, 64);
+BENCHMARK_TEMPLATE(CounterIncrement, ShardedRateCounter)->ThreadRange(1, 64);
+
+BENCHMARK_TEMPLATE(CounterLoad, RelaxedCounter<std::uint64_t>);
+BENCHMARK_TEMPLATE(CounterLoad, ShardedCounter<std::uint64_t>);
+
+USERVER_NAMESPACE_END
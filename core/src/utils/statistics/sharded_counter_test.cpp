@@ -0,0 +1,65 @@
+#include <userver/utils/statistics/sharded_counter.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/get_all.hpp>
+#include <userver/utest/utest.hpp>
+#include <userver/utils/statistics/storage.hpp>
+#include <userver/utils/statistics/testing.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace utils::statistics {
+
+TEST(ShardedCounter, Basic) {
+  ShardedCounter<std::int64_t> counter{10};
+  EXPECT_EQ(counter.Load(), 10);
+
+  ++counter;
+  counter += 5;
+  counter -= 2;
+  --counter;
+  EXPECT_EQ(counter.Load(), 13);
+
+  const ShardedCounter<std::int64_t> copy = counter;
+  EXPECT_EQ(copy.Load(), 13);
+
+  counter = 42;
+  EXPECT_EQ(counter.Load(), 42);
+}
+
+UTEST_MT(ShardedCounter, Concurrent, 4) {
+  constexpr std::size_t kTasks = 8;
+  constexpr std::uint64_t kIncrements = 10000;
+
+  ShardedCounter<std::uint64_t> counter;
+  std::vector<engine::TaskWithResult<void>> tasks;
+  for (std::size_t i = 0; i < kTasks; ++i) {
+    tasks.push_back(engine::AsyncNoSpan([&counter] {
+      for (std::uint64_t j = 0; j < kIncrements; ++j) ++counter;
+    }));
+  }
+  engine::GetAll(tasks);
+
+  EXPECT_EQ(counter.Load(), kTasks * kIncrements);
+}
+
+UTEST(ShardedRateCounter, DumpMetric) {
+  Storage storage;
+  ShardedRateCounter rate_counter{Rate{10}};
+  const auto rate_counter_scope = storage.RegisterWriter(
+      "test", [&rate_counter](Writer& writer) { writer = rate_counter; });
+
+  ++rate_counter;
+  rate_counter += Rate{4};
+  EXPECT_EQ(Snapshot{storage}.SingleMetric("test").AsRate(), 15);
+
+  ResetMetric(rate_counter);
+  EXPECT_EQ(rate_counter.Load(), Rate{0});
+}
+
+}  // namespace utils::statistics
+
+USERVER_NAMESPACE_END
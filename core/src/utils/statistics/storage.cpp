@@ -67,6 +67,31 @@ CheckDataUsedByCallbackHasNotBeenDestroyedBeforeUnregistering(
   }
 }
 
+// Writers keep a reference to the builder, this one allows to switch the
+// actual builder between the entries
+class ForwardingFormatBuilder final : public BaseFormatBuilder {
+ public:
+  void HandleMetric(std::string_view path, LabelsSpan labels,
+                    const MetricValue& value) override {
+    UASSERT(target);
+    target->HandleMetric(path, labels, value);
+  }
+
+  BaseFormatBuilder* target{nullptr};
+};
+
+class SingleBuilderVisitor final : public impl::BaseEntryVisitor {
+ public:
+  explicit SingleBuilderVisitor(BaseFormatBuilder& out) : out_(out) {}
+
+  BaseFormatBuilder* StartEntry(std::uint64_t) override { return &out_; }
+
+  void FinishEntry(std::uint64_t) override {}
+
+ private:
+  BaseFormatBuilder& out_;
+};
+
 }  // namespace
 
 Request Request::MakeWithPrefix(const std::string& prefix, AddLabels add_labels,
@@ -94,6 +119,8 @@ Request::Request(std::string prefix_in, PrefixMatch path_match_type_in,
 
 BaseFormatBuilder::~BaseFormatBuilder() = default;
 
+impl::BaseEntryVisitor::~BaseEntryVisitor() = default;
+
 Storage::Storage() : may_register_extenders_(true) {}
 
 formats::json::Value Storage::GetAsJson() const {
@@ -117,7 +144,14 @@ formats::json::Value Storage::GetAsJson() const {
 
 void Storage::VisitMetrics(BaseFormatBuilder& out,
                            const Request& request) const {
+  SingleBuilderVisitor visitor{out};
+  VisitMetricsByEntry(visitor, request);
+}
+
+void Storage::VisitMetricsByEntry(impl::BaseEntryVisitor& visitor,
+                                  const Request& request) const {
   {
+    ForwardingFormatBuilder out;
     impl::WriterState state{out, request, {}, {}};
     for (const auto& [name, value] : request.add_labels) {
       state.add_labels.emplace_back(name, value);
@@ -142,10 +176,13 @@ void Storage::VisitMetrics(BaseFormatBuilder& out,
             (entry.prefix_path.empty()
                  ? Writer{state, LabelsSpan{labels_vector}}
                  : Writer{state, LabelsSpan{labels_vector}}[entry.prefix_path]);
-        if (writer) {
-          LOG_DEBUG() << "Getting statistics for prefix=" << entry.prefix_path;
-          entry.writer(writer);
-        }
+        if (!writer) continue;
+
+        out.target = visitor.StartEntry(entry.id);
+        if (!out.target) continue;
+
+        LOG_DEBUG() << "Getting statistics for prefix=" << entry.prefix_path;
+        entry.writer(writer);
       } catch (const std::exception& e) {
         UASSERT_MSG(false,
                     fmt::format("Failed to write metrics for prefix '{}': {}",
@@ -153,10 +190,19 @@ void Storage::VisitMetrics(BaseFormatBuilder& out,
         LOG_ERROR() << "Failed to write metrics for prefix '"
                     << entry.prefix_path << "': " << e;
       }
+
+      if (out.target) {
+        out.target = nullptr;
+        visitor.FinishEntry(entry.id);
+      }
     }
   }
 
-  statistics::VisitMetrics(out, GetAsJson(), request);
+  auto* const legacy_out = visitor.StartEntry(impl::kLegacyExtendersEntryId);
+  if (legacy_out) {
+    statistics::VisitMetrics(*legacy_out, GetAsJson(), request);
+    visitor.FinishEntry(impl::kLegacyExtendersEntryId);
+  }
 }
 
 void Storage::StopRegisteringExtenders() { may_register_extenders_ = false; }
@@ -179,6 +225,7 @@ Entry Storage::DoRegisterExtender(impl::MetricsSource&& source) {
               "constructors");
 
   std::lock_guard lock(mutex_);
+  source.id = next_entry_id_++;
   const auto res =
       metrics_sources_.insert(metrics_sources_.end(), std::move(source));
   return Entry(Entry::Impl{this, res});
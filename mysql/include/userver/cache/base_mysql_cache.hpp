@@ -0,0 +1,436 @@
+#pragma once
+
+/// @file userver/cache/base_mysql_cache.hpp
+/// @brief @copybrief components::MySqlCache
+
+#include <userver/cache/base_mysql_cache_fwd.hpp>
+
+#include <chrono>
+#include <string_view>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include <userver/cache/cache_statistics.hpp>
+#include <userver/cache/caching_component_base.hpp>
+#include <userver/cache/impl/base_sql_cache.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+
+#include <userver/storages/mysql/cluster.hpp>
+#include <userver/storages/mysql/component.hpp>
+#include <userver/storages/mysql/dates.hpp>
+
+#include <userver/compiler/demangle.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/tracing/span.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/cpu_relax.hpp>
+#include <userver/utils/meta.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace components {
+
+// clang-format off
+
+/// @page mysql_cache Caching Component for MySQL
+///
+/// A typical components::MySqlCache usage consists of trait definition:
+///
+/// @snippet cache/mysql_cache_mysqltest.cpp MySql Cache Policy Trivial
+///
+/// and registration of the component in components::ComponentList:
+///
+/// @snippet cache/mysql_cache_mysqltest.cpp MySql Cache Trivial Usage
+///
+/// See @ref scripts/docs/en/userver/caches.md for introduction into caches.
+///
+///
+/// @section mysql_cc_configuration Configuration
+///
+/// components::MySqlCache static configuration file should have a MySQL
+/// component name specified in `mysql-component` configuration parameter.
+///
+/// Optionally the operation timeouts for cache loading can be specified.
+///
+/// Name | Description | Default value
+/// ---- | ----------- | -------------
+/// full-update-op-timeout | timeout for a full update | 1m
+/// incremental-update-op-timeout | timeout for an incremental update | 1s
+/// update-correction | incremental update window adjustment | - (0 for caches with defined GetLastKnownUpdated)
+/// chunk-size | number of rows to fetch from MySQL via cursor at once, 0 to fetch all rows in one request without a cursor | 1000
+///
+/// @section mysql_cc_cache_policy Cache policy
+///
+/// Cache policy is the template argument of components::MySqlCache component.
+/// Please see the following code snippet for documentation.
+///
+/// @snippet cache/mysql_cache_mysqltest.cpp MySql Cache Policy Example
+///
+/// Policy may have static function GetLastKnownUpdated. It should be used
+/// when new entries from database are taken via revision, identifier, or
+/// anything else, but not timestamp of the last update.
+/// If this function is supplied, new entries are taken from db with condition
+/// 'WHERE kUpdatedField >= GetLastKnownUpdated(cache_container)'.
+/// Otherwise, condition is
+/// 'WHERE kUpdatedField >= last_update - correction_'.
+///
+/// In case one provides a custom CacheContainer within Policy, it is notified
+/// of Update completion via its public member function OnWritesDone, if any.
+///
+/// @section mysql_cc_forward_declaration Forward Declaration
+///
+/// To forward declare a cache you can forward declare a trait and
+/// include userver/cache/base_mysql_cache_fwd.hpp header.
+
+// clang-format on
+
+namespace mysql_cache::detail {
+
+using namespace sql_cache::detail;
+
+template <typename T>
+using UpdatedFieldType = meta::DetectedOr<std::chrono::system_clock::time_point,
+                                          UpdatedFieldTypeImpl, T>;
+
+template <typename T>
+constexpr bool CheckUpdatedFieldType() {
+  if constexpr (kHasUpdatedFieldType<T>) {
+    static_assert(
+        std::is_same_v<typename T::UpdatedFieldType,
+                       std::chrono::system_clock::time_point> ||
+            std::is_same_v<typename T::UpdatedFieldType,
+                           storages::mysql::DateTime> ||
+            kHasCustomUpdated<T>,
+        "Invalid UpdatedFieldType, must be either "
+        "std::chrono::system_clock::time_point or storages::mysql::DateTime");
+  }
+  return true;
+}
+
+// Cluster host type policy
+template <typename T>
+using HasClusterHostTypeImpl = decltype(T::kClusterHostType);
+
+template <typename T>
+constexpr storages::mysql::ClusterHostType ClusterHostType() {
+  if constexpr (meta::kIsDetected<HasClusterHostTypeImpl, T>) {
+    return T::kClusterHostType;
+  } else {
+    return storages::mysql::ClusterHostType::kSecondary;
+  }
+}
+
+template <typename MySqlCachePolicy>
+struct PolicyChecker
+    : sql_cache::detail::PolicyChecker<MySqlCachePolicy,
+                                       storages::mysql::Query> {
+  static_assert(CheckUpdatedFieldType<MySqlCachePolicy>());
+};
+
+}  // namespace mysql_cache::detail
+
+/// @ingroup userver_components
+///
+/// @brief Caching component for MySQL. See @ref mysql_cache.
+///
+/// @see @ref mysql_cache, @ref scripts/docs/en/userver/caches.md
+template <typename MySqlCachePolicy>
+class MySqlCache final
+    : public mysql_cache::detail::PolicyChecker<MySqlCachePolicy>::BaseType {
+ public:
+  // Type aliases
+  using PolicyType = MySqlCachePolicy;
+  using ValueType = mysql_cache::detail::ValueType<PolicyType>;
+  using RawValueType = mysql_cache::detail::RawValueType<PolicyType>;
+  using DataType = mysql_cache::detail::DataCacheContainerType<PolicyType>;
+  using PolicyCheckerType = mysql_cache::detail::PolicyChecker<PolicyType>;
+  using UpdatedFieldType = mysql_cache::detail::UpdatedFieldType<PolicyType>;
+  using BaseType = typename PolicyCheckerType::BaseType;
+
+  // Calculated constants
+  constexpr static bool kIncrementalUpdates =
+      mysql_cache::detail::kWantIncrementalUpdates<PolicyType>;
+  constexpr static auto kClusterHostType =
+      mysql_cache::detail::ClusterHostType<PolicyType>();
+  constexpr static auto kName = PolicyType::kName;
+
+  MySqlCache(const ComponentConfig&, const ComponentContext&);
+  ~MySqlCache() override;
+
+  static yaml_config::Schema GetStaticConfigSchema();
+
+ private:
+  using CachedData = std::unique_ptr<DataType>;
+
+  UpdatedFieldType GetLastUpdated(
+      std::chrono::system_clock::time_point last_update,
+      const DataType& cache) const;
+
+  void Update(cache::UpdateType type,
+              const std::chrono::system_clock::time_point& last_update,
+              const std::chrono::system_clock::time_point& now,
+              cache::UpdateStatisticsScope& stats_scope) override;
+
+  bool MayReturnNull() const override;
+
+  CachedData GetDataSnapshot(cache::UpdateType type, tracing::ScopeTime& scope);
+  void CacheResult(RawValueType&& raw_value, DataType& data_cache,
+                   cache::UpdateStatisticsScope& stats_scope);
+
+  static storages::mysql::Query GetAllQuery();
+  static storages::mysql::Query GetDeltaQuery();
+
+  std::chrono::milliseconds ParseCorrection(const ComponentConfig& config);
+
+  std::shared_ptr<storages::mysql::Cluster> cluster_;
+
+  const std::chrono::system_clock::duration correction_;
+  const std::chrono::milliseconds full_update_timeout_;
+  const std::chrono::milliseconds incremental_update_timeout_;
+  const std::size_t chunk_size_;
+  std::size_t cpu_relax_iterations_parse_{0};
+  std::size_t cpu_relax_iterations_copy_{0};
+};
+
+template <typename MySqlCachePolicy>
+inline constexpr bool kHasValidate<MySqlCache<MySqlCachePolicy>> = true;
+
+template <typename MySqlCachePolicy>
+MySqlCache<MySqlCachePolicy>::MySqlCache(const ComponentConfig& config,
+                                         const ComponentContext& context)
+    : BaseType{config, context},
+      correction_{ParseCorrection(config)},
+      full_update_timeout_{
+          config["full-update-op-timeout"].As<std::chrono::milliseconds>(
+              mysql_cache::detail::kDefaultFullUpdateTimeout)},
+      incremental_update_timeout_{
+          config["incremental-update-op-timeout"].As<std::chrono::milliseconds>(
+              mysql_cache::detail::kDefaultIncrementalUpdateTimeout)},
+      chunk_size_{config["chunk-size"].As<size_t>(
+          mysql_cache::detail::kDefaultChunkSize)} {
+  if (this->GetAllowedUpdateTypes() ==
+          cache::AllowedUpdateTypes::kFullAndIncremental &&
+      !kIncrementalUpdates) {
+    throw std::logic_error(
+        "Incremental update support is requested in config but no update field "
+        "name is specified in traits of '" +
+        config.Name() + "' cache");
+  }
+  if (correction_.count() < 0) {
+    throw std::logic_error(
+        "Refusing to set forward (negative) update correction requested in "
+        "config for '" +
+        config.Name() + "' cache");
+  }
+
+  const auto mysql_alias = config["mysql-component"].As<std::string>("");
+  if (mysql_alias.empty()) {
+    throw std::logic_error{"No `mysql-component` entry in configuration of '" +
+                           config.Name() + "' cache"};
+  }
+  cluster_ = context.FindComponent<storages::mysql::Component>(mysql_alias)
+                 .GetCluster();
+
+  LOG_INFO() << "Cache " << kName << " full update query `"
+             << GetAllQuery().GetStatement() << "` incremental update query `"
+             << GetDeltaQuery().GetStatement() << "`";
+
+  this->StartPeriodicUpdates();
+}
+
+template <typename MySqlCachePolicy>
+MySqlCache<MySqlCachePolicy>::~MySqlCache() {
+  this->StopPeriodicUpdates();
+}
+
+template <typename MySqlCachePolicy>
+storages::mysql::Query MySqlCache<MySqlCachePolicy>::GetAllQuery() {
+  storages::mysql::Query query = PolicyCheckerType::GetQuery();
+  if constexpr (mysql_cache::detail::kHasWhere<MySqlCachePolicy>) {
+    return {fmt::format("{} where {}", query.GetStatement(),
+                        MySqlCachePolicy::kWhere),
+            query.GetName()};
+  } else {
+    return query;
+  }
+}
+
+template <typename MySqlCachePolicy>
+storages::mysql::Query MySqlCache<MySqlCachePolicy>::GetDeltaQuery() {
+  if constexpr (kIncrementalUpdates) {
+    storages::mysql::Query query = PolicyCheckerType::GetQuery();
+
+    if constexpr (mysql_cache::detail::kHasWhere<MySqlCachePolicy>) {
+      return {
+          fmt::format("{} where ({}) and {} >= ?", query.GetStatement(),
+                      MySqlCachePolicy::kWhere, PolicyType::kUpdatedField),
+          query.GetName()};
+    } else {
+      return {fmt::format("{} where {} >= ?", query.GetStatement(),
+                          PolicyType::kUpdatedField),
+              query.GetName()};
+    }
+  } else {
+    return GetAllQuery();
+  }
+}
+
+template <typename MySqlCachePolicy>
+std::chrono::milliseconds MySqlCache<MySqlCachePolicy>::ParseCorrection(
+    const ComponentConfig& config) {
+  static constexpr std::string_view kUpdateCorrection = "update-correction";
+  if (mysql_cache::detail::kHasCustomUpdated<MySqlCachePolicy> ||
+      this->GetAllowedUpdateTypes() == cache::AllowedUpdateTypes::kOnlyFull) {
+    return config[kUpdateCorrection].As<std::chrono::milliseconds>(0);
+  } else {
+    return config[kUpdateCorrection].As<std::chrono::milliseconds>();
+  }
+}
+
+template <typename MySqlCachePolicy>
+typename MySqlCache<MySqlCachePolicy>::UpdatedFieldType
+MySqlCache<MySqlCachePolicy>::GetLastUpdated(
+    [[maybe_unused]] std::chrono::system_clock::time_point last_update,
+    const DataType& cache) const {
+  if constexpr (mysql_cache::detail::kHasCustomUpdated<MySqlCachePolicy>) {
+    return MySqlCachePolicy::GetLastKnownUpdated(cache);
+  } else {
+    return UpdatedFieldType{last_update - correction_};
+  }
+}
+
+template <typename MySqlCachePolicy>
+void MySqlCache<MySqlCachePolicy>::Update(
+    cache::UpdateType type,
+    const std::chrono::system_clock::time_point& last_update,
+    const std::chrono::system_clock::time_point& /*now*/,
+    cache::UpdateStatisticsScope& stats_scope) {
+  namespace mysql = storages::mysql;
+  if constexpr (!kIncrementalUpdates) {
+    type = cache::UpdateType::kFull;
+  }
+  const bool is_full = type == cache::UpdateType::kFull;
+  const auto query = is_full ? GetAllQuery() : GetDeltaQuery();
+  const mysql::CommandControl command_control{
+      is_full ? full_update_timeout_ : incremental_update_timeout_};
+
+  // COPY current cached data
+  auto scope = tracing::Span::CurrentSpan().CreateScopeTime(
+      std::string{mysql_cache::detail::kCopyStage});
+  auto data_cache = GetDataSnapshot(type, scope);
+  [[maybe_unused]] const auto old_size = data_cache->size();
+
+  scope.Reset(std::string{mysql_cache::detail::kFetchStage});
+
+  size_t changes = 0;
+  utils::CpuRelax relax{cpu_relax_iterations_parse_, &scope};
+  const auto cache_row = [&](RawValueType&& raw_value) {
+    relax.Relax();
+    stats_scope.IncreaseDocumentsReadCount(1);
+    CacheResult(std::move(raw_value), *data_cache, stats_scope);
+    ++changes;
+  };
+
+  if (chunk_size_ > 0) {
+    // The cursor fetches the rows by chunks and parses them on the fly
+    const auto deadline =
+        engine::Deadline::FromDuration(command_control.execute);
+    if (is_full) {
+      cluster_
+          ->template GetCursor<RawValueType>(command_control, kClusterHostType,
+                                             chunk_size_, query)
+          .ForEach(cache_row, deadline);
+    } else {
+      cluster_
+          ->template GetCursor<RawValueType>(
+              command_control, kClusterHostType, chunk_size_, query,
+              GetLastUpdated(last_update, *data_cache))
+          .ForEach(cache_row, deadline);
+    }
+  } else {
+    auto result =
+        is_full ? cluster_->Execute(command_control, kClusterHostType, query)
+                : cluster_->Execute(command_control, kClusterHostType, query,
+                                    GetLastUpdated(last_update, *data_cache));
+    auto raw_values = std::move(result).template AsVector<RawValueType>();
+    for (auto& raw_value : raw_values) {
+      cache_row(std::move(raw_value));
+    }
+  }
+
+  scope.Reset();
+
+  if constexpr (mysql_cache::detail::kIsContainerCopiedByElement<DataType>) {
+    mysql_cache::detail::UpdateCpuRelaxIterations(
+        cpu_relax_iterations_copy_, old_size, scope,
+        mysql_cache::detail::kCopyStage, kName);
+  }
+  mysql_cache::detail::UpdateCpuRelaxIterations(
+      cpu_relax_iterations_parse_, changes, scope,
+      mysql_cache::detail::kFetchStage, kName);
+
+  if (changes > 0 || is_full) {
+    // Set current cache
+    stats_scope.Finish(data_cache->size());
+    mysql_cache::detail::OnWritesDone(*data_cache);
+    this->Set(std::move(data_cache));
+  } else {
+    stats_scope.FinishNoChanges();
+  }
+}
+
+template <typename MySqlCachePolicy>
+bool MySqlCache<MySqlCachePolicy>::MayReturnNull() const {
+  return mysql_cache::detail::MayReturnNull<PolicyType>();
+}
+
+template <typename MySqlCachePolicy>
+void MySqlCache<MySqlCachePolicy>::CacheResult(
+    RawValueType&& raw_value, DataType& data_cache,
+    cache::UpdateStatisticsScope& stats_scope) {
+  try {
+    using mysql_cache::detail::CacheInsertOrAssign;
+    CacheInsertOrAssign(
+        data_cache,
+        mysql_cache::detail::ExtractValue<MySqlCachePolicy>(
+            std::move(raw_value)),
+        MySqlCachePolicy::kKeyMember);
+  } catch (const std::exception& e) {
+    stats_scope.IncreaseDocumentsParseFailures(1);
+    LOG_ERROR() << "Error parsing data row in cache '" << kName << "' to '"
+                << compiler::GetTypeName<ValueType>() << "': " << e.what();
+  }
+}
+
+template <typename MySqlCachePolicy>
+typename MySqlCache<MySqlCachePolicy>::CachedData
+MySqlCache<MySqlCachePolicy>::GetDataSnapshot(cache::UpdateType type,
+                                              tracing::ScopeTime& scope) {
+  if (type == cache::UpdateType::kIncremental) {
+    auto data = this->Get();
+    if (data) {
+      return mysql_cache::detail::CopyContainer(
+          *data, cpu_relax_iterations_copy_, scope);
+    }
+  }
+  return std::make_unique<DataType>();
+}
+
+namespace impl {
+
+std::string GetMySqlCacheSchema();
+
+}  // namespace impl
+
+template <typename MySqlCachePolicy>
+yaml_config::Schema MySqlCache<MySqlCachePolicy>::GetStaticConfigSchema() {
+  return yaml_config::MergeSchemas<BaseType>(impl::GetMySqlCacheSchema());
+}
+
+}  // namespace components
+
+USERVER_NAMESPACE_END
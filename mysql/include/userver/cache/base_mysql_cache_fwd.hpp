@@ -0,0 +1,16 @@
+#pragma once
+
+/// @file userver/cache/base_mysql_cache_fwd.hpp
+/// @brief Forward declaration of the components::MySqlCache.
+/// @see @ref mysql_cache
+
+USERVER_NAMESPACE_BEGIN
+
+namespace components {
+
+template <typename MySqlCachePolicy>
+class MySqlCache;
+
+}  // namespace components
+
+USERVER_NAMESPACE_END
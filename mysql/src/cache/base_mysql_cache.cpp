@@ -0,0 +1,40 @@
+#include <userver/cache/base_mysql_cache.hpp>
+
+#include <userver/yaml_config/merge_schemas.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace components::impl {
+
+std::string GetMySqlCacheSchema() {
+  return R"(
+type: object
+description: Caching component for MySQL derived from components::CachingComponentBase.
+additionalProperties: false
+properties:
+    full-update-op-timeout:
+        type: string
+        description: timeout for a full update
+        defaultDescription: 1m
+    incremental-update-op-timeout:
+        type: string
+        description: timeout for an incremental update
+        defaultDescription: 1s
+    update-correction:
+        type: string
+        description: incremental update window adjustment
+        defaultDescription: 0 for caches with defined GetLastKnownUpdated
+    chunk-size:
+        type: integer
+        description: number of rows to fetch from MySQL via cursor at once, 0 to fetch all rows in one request
+        defaultDescription: 1000
+    mysql-component:
+        type: string
+        description: MySQL component name
+        defaultDescription: ""
+)";
+}
+
+}  // namespace components::impl
+
+USERVER_NAMESPACE_END
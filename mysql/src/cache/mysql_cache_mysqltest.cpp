@@ -0,0 +1,191 @@
+#include <userver/cache/base_mysql_cache.hpp>
+
+#include <userver/components/minimal_server_component_list.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+// This is a snippet for documentation
+/*! [MySql Cache Policy Example] */
+namespace example {
+
+struct MyStructure {
+  int id = 0;
+  std::string bar{};
+  std::chrono::system_clock::time_point updated;
+};
+
+struct MySqlExamplePolicy {
+  // Name of caching policy component.
+  //
+  // Required: **yes**
+  static constexpr std::string_view kName = "my-mysql-cache";
+
+  // Object type.
+  //
+  // Required: **yes**
+  using ValueType = MyStructure;
+
+  // Key by which the object must be identified in cache.
+  //
+  // One of:
+  // - A pointer-to-member in the object
+  // - A pointer-to-member-function in the object that returns the key
+  // - A pointer-to-function that takes the object and returns the key
+  // - A lambda that takes the object and returns the key
+  //
+  // Required: **yes**
+  static constexpr auto kKeyMember = &MyStructure::id;
+
+  // Data retrieve query.
+  //
+  // The query should not contain any clauses after the `from` clause. Either
+  // `kQuery` or `GetQuery` static member function must be defined.
+  //
+  // Required: **yes**
+  static constexpr const char* kQuery = "SELECT id, bar, updated FROM my_data";
+
+  // Name of the field containing timestamp of an object.
+  //
+  // To turn off incremental updates, set the value to `nullptr`.
+  //
+  // Required: **yes**
+  static constexpr const char* kUpdatedField = "updated";
+
+  // Type of the field containing timestamp of an object.
+  //
+  // Specifies whether updated field should be treated as a TIMESTAMP
+  // (std::chrono::system_clock::time_point) or as a DATETIME
+  // (storages::mysql::DateTime).
+  //
+  // Required: no
+  // Default value: std::chrono::system_clock::time_point
+  using UpdatedFieldType = std::chrono::system_clock::time_point;
+
+  // Where clause of the query. Will be appended after `where` in the query.
+  //
+  // Required: no
+  static constexpr const char* kWhere = "id > 10";
+
+  // Cluster host selection flags to use when retrieving data.
+  //
+  // Default value is storages::mysql::ClusterHostType::kSecondary.
+  //
+  // Required: no
+  static constexpr auto kClusterHostType =
+      storages::mysql::ClusterHostType::kSecondary;
+
+  // Whether Get() is expected to return nullptr.
+  //
+  // Default value is false, Get() will throw an exception instead of
+  // returning nullptr.
+  //
+  // Required: no
+  static constexpr bool kMayReturnNull = false;
+};
+
+}  // namespace example
+/*! [MySql Cache Policy Example] */
+
+namespace components::example {
+
+using USERVER_NAMESPACE::example::MySqlExamplePolicy;
+using USERVER_NAMESPACE::example::MyStructure;
+
+struct MySqlExamplePolicy2 {
+  using ValueType = MyStructure;
+  static constexpr std::string_view kName = "my-mysql-cache";
+  static constexpr const char* kQuery = "SELECT id, bar, updated FROM my_data";
+  static constexpr const char* kUpdatedField = "";  // Intentionally left blank
+  static constexpr auto kKeyMember = &MyStructure::id;
+  static constexpr auto kClusterHostType =
+      storages::mysql::ClusterHostType::kPrimary;
+};
+
+struct MyStructureWithRevision {
+  int id = 0;
+  std::string bar{};
+  std::chrono::system_clock::time_point updated;
+  int32_t revision = 0;
+};
+
+class UserSpecificCache {
+ public:
+  void insert_or_assign(int, MyStructureWithRevision&& item) {
+    latest_revision_ = std::max(latest_revision_, item.revision);
+  }
+  static size_t size() { return 0; }
+
+  int GetLatestRevision() const { return latest_revision_; }
+
+ private:
+  int latest_revision_ = 0;
+};
+
+struct MySqlExamplePolicy3 {
+  using ValueType = MyStructureWithRevision;
+  static constexpr std::string_view kName = "my-mysql-cache";
+  static constexpr auto kQuery =
+      "SELECT id, bar, updated, revision FROM my_data";
+  using CacheContainer = UserSpecificCache;
+  static constexpr const char* kUpdatedField = "revision";
+  using UpdatedFieldType = int32_t;
+  static constexpr auto kKeyMember = &MyStructureWithRevision::id;
+
+  // Function to get last known revision/time
+  //
+  // Optional
+  // If one wants to get cache updates not based on updated time, but, for
+  // example, based on revision > known_revision, this method should be used.
+  static int32_t GetLastKnownUpdated(const UserSpecificCache& container) {
+    return container.GetLatestRevision();
+  }
+};
+
+/*! [MySql Cache Policy Trivial] */
+struct MySqlTrivialPolicy {
+  static constexpr std::string_view kName = "my-mysql-cache";
+
+  using ValueType = MyStructure;
+  static constexpr auto kKeyMember = &MyStructure::id;
+  static constexpr const char* kQuery = "SELECT id, bar, updated FROM my_data";
+  static constexpr const char* kUpdatedField = "updated";
+};
+/*! [MySql Cache Policy Trivial] */
+
+// Instantiation test
+using MyCache1 = MySqlCache<MySqlExamplePolicy>;
+using MyCache2 = MySqlCache<MySqlExamplePolicy2>;
+using MyCache3 = MySqlCache<MySqlExamplePolicy3>;
+using MyTrivialCache = MySqlCache<MySqlTrivialPolicy>;
+
+// NB: field access required for actual instantiation
+static_assert(MyCache1::kIncrementalUpdates);
+static_assert(!MyCache2::kIncrementalUpdates);
+static_assert(MyCache3::kIncrementalUpdates);
+static_assert(MyTrivialCache::kIncrementalUpdates);
+
+namespace mysql = storages::mysql;
+static_assert(MyCache1::kClusterHostType == mysql::ClusterHostType::kSecondary);
+static_assert(MyCache2::kClusterHostType == mysql::ClusterHostType::kPrimary);
+static_assert(MyCache3::kClusterHostType == mysql::ClusterHostType::kSecondary);
+
+// Update() instantiation test
+[[maybe_unused]] void VerifyUpdateCompiles(
+    const components::ComponentConfig& config,
+    const components::ComponentContext& context) {
+  MyCache1 cache1{config, context};
+  MyCache2 cache2{config, context};
+  MyCache3 cache3{config, context};
+  MyTrivialCache my_trivial_cache{config, context};
+}
+
+inline auto SampleOfComponentRegistration() {
+  /*! [MySql Cache Trivial Usage] */
+  return components::MinimalServerComponentList()
+      .Append<components::MySqlCache<example::MySqlTrivialPolicy>>();
+  /*! [MySql Cache Trivial Usage] */
+}
+
+}  // namespace components::example
+
+USERVER_NAMESPACE_END
@@ -15,6 +15,7 @@
 
 #include <userver/cache/cache_statistics.hpp>
 #include <userver/cache/caching_component_base.hpp>
+#include <userver/cache/impl/base_sql_cache.hpp>
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
 
@@ -115,154 +116,8 @@ namespace components {
 
 namespace pg_cache::detail {
 
-template <typename T>
-using ValueType = typename T::ValueType;
-template <typename T>
-inline constexpr bool kHasValueType = meta::kIsDetected<ValueType, T>;
-
-template <typename T>
-using RawValueTypeImpl = typename T::RawValueType;
-template <typename T>
-inline constexpr bool kHasRawValueType = meta::kIsDetected<RawValueTypeImpl, T>;
-template <typename T>
-using RawValueType = meta::DetectedOr<ValueType<T>, RawValueTypeImpl, T>;
-
-template <typename PostgreCachePolicy>
-auto ExtractValue(RawValueType<PostgreCachePolicy>&& raw) {
-  if constexpr (kHasRawValueType<PostgreCachePolicy>) {
-    return Convert(std::move(raw),
-                   formats::parse::To<ValueType<PostgreCachePolicy>>());
-  } else {
-    return std::move(raw);
-  }
-}
-
-// Component name in policy
-template <typename T>
-using HasNameImpl = std::enable_if_t<!std::string_view{T::kName}.empty()>;
-template <typename T>
-inline constexpr bool kHasName = meta::kIsDetected<HasNameImpl, T>;
-
-// Component query in policy
-template <typename T>
-using HasQueryImpl = decltype(T::kQuery);
-template <typename T>
-inline constexpr bool kHasQuery = meta::kIsDetected<HasQueryImpl, T>;
-
-// Component GetQuery in policy
-template <typename T>
-using HasGetQueryImpl = decltype(T::GetQuery());
-template <typename T>
-inline constexpr bool kHasGetQuery = meta::kIsDetected<HasGetQueryImpl, T>;
-
-// Component kWhere in policy
-template <typename T>
-using HasWhere = decltype(T::kWhere);
-template <typename T>
-inline constexpr bool kHasWhere = meta::kIsDetected<HasWhere, T>;
-
-// Update field
-template <typename T>
-using HasUpdatedField = decltype(T::kUpdatedField);
-template <typename T>
-inline constexpr bool kHasUpdatedField = meta::kIsDetected<HasUpdatedField, T>;
-
-template <typename T>
-using WantIncrementalUpdates =
-    std::enable_if_t<!std::string_view{T::kUpdatedField}.empty()>;
-template <typename T>
-inline constexpr bool kWantIncrementalUpdates =
-    meta::kIsDetected<WantIncrementalUpdates, T>;
-
-// Key member in policy
-template <typename T>
-using KeyMemberTypeImpl =
-    std::decay_t<std::invoke_result_t<decltype(T::kKeyMember), ValueType<T>>>;
-template <typename T>
-inline constexpr bool kHasKeyMember = meta::kIsDetected<KeyMemberTypeImpl, T>;
-template <typename T>
-using KeyMemberType = meta::DetectedType<KeyMemberTypeImpl, T>;
-
-// Data container for cache
-template <typename T, typename = USERVER_NAMESPACE::utils::void_t<>>
-struct DataCacheContainer {
-  static_assert(meta::kIsStdHashable<KeyMemberType<T>>,
-                "With default CacheContainer, key type must be std::hash-able");
-
-  using type = std::unordered_map<KeyMemberType<T>, ValueType<T>>;
-};
-
-template <typename T>
-struct DataCacheContainer<
-    T, USERVER_NAMESPACE::utils::void_t<typename T::CacheContainer>> {
-  using type = typename T::CacheContainer;
-};
+using namespace sql_cache::detail;
 
-template <typename T>
-using DataCacheContainerType = typename DataCacheContainer<T>::type;
-
-// We have to whitelist container types, for which we perform by-element
-// copying, because it's not correct for certain custom containers.
-template <typename T>
-inline constexpr bool kIsContainerCopiedByElement =
-    meta::kIsInstantiationOf<std::unordered_map, T> ||
-    meta::kIsInstantiationOf<std::map, T>;
-
-template <typename T>
-std::unique_ptr<T> CopyContainer(
-    const T& container, [[maybe_unused]] std::size_t cpu_relax_iterations,
-    tracing::ScopeTime& scope) {
-  if constexpr (kIsContainerCopiedByElement<T>) {
-    auto copy = std::make_unique<T>();
-    if constexpr (meta::kIsReservable<T>) {
-      copy->reserve(container.size());
-    }
-
-    utils::CpuRelax relax{cpu_relax_iterations, &scope};
-    for (const auto& kv : container) {
-      relax.Relax();
-      copy->insert(kv);
-    }
-    return copy;
-  } else {
-    return std::make_unique<T>(container);
-  }
-}
-
-template <typename Container, typename Value, typename KeyMember,
-          typename... Args>
-void CacheInsertOrAssign(Container& container, Value&& value,
-                         const KeyMember& key_member, Args&&... /*args*/) {
-  // Args are only used to de-prioritize this default overload.
-  static_assert(sizeof...(Args) == 0);
-  // Copy 'key' to avoid aliasing issues in 'insert_or_assign'.
-  auto key = std::invoke(key_member, value);
-  container.insert_or_assign(std::move(key), std::forward<Value>(value));
-}
-
-template <typename T>
-using HasOnWritesDoneImpl = decltype(std::declval<T&>().OnWritesDone());
-
-template <typename T>
-void OnWritesDone(T& container) {
-  if constexpr (meta::kIsDetected<HasOnWritesDoneImpl, T>) {
-    container.OnWritesDone();
-  }
-}
-
-template <typename T>
-using HasCustomUpdatedImpl =
-    decltype(T::GetLastKnownUpdated(std::declval<DataCacheContainerType<T>>()));
-
-template <typename T>
-inline constexpr bool kHasCustomUpdated =
-    meta::kIsDetected<HasCustomUpdatedImpl, T>;
-
-template <typename T>
-using UpdatedFieldTypeImpl = typename T::UpdatedFieldType;
-template <typename T>
-inline constexpr bool kHasUpdatedFieldType =
-    meta::kIsDetected<UpdatedFieldTypeImpl, T>;
 template <typename T>
 using UpdatedFieldType =
     meta::DetectedOr<storages::postgres::TimePointTz, UpdatedFieldTypeImpl, T>;
@@ -298,76 +153,21 @@ constexpr storages::postgres::ClusterHostTypeFlags ClusterHostType() {
   }
 }
 
-// May return null policy
-template <typename T>
-using HasMayReturnNull = decltype(T::kMayReturnNull);
-
-template <typename T>
-constexpr bool MayReturnNull() {
-  if constexpr (meta::kIsDetected<HasMayReturnNull, T>) {
-    return T::kMayReturnNull;
-  } else {
-    return false;
-  }
-}
-
 template <typename PostgreCachePolicy>
-struct PolicyChecker {
-  // Static assertions for cache traits
-  static_assert(
-      kHasName<PostgreCachePolicy>,
-      "The PosgreSQL cache policy must contain a static member `kName`");
-  static_assert(
-      kHasValueType<PostgreCachePolicy>,
-      "The PosgreSQL cache policy must define a type alias `ValueType`");
-  static_assert(
-      kHasKeyMember<PostgreCachePolicy>,
-      "The PostgreSQL cache policy must contain a static member `kKeyMember` "
-      "with a pointer to a data or a function member with the object's key");
-  static_assert(kHasQuery<PostgreCachePolicy> ||
-                    kHasGetQuery<PostgreCachePolicy>,
-                "The PosgreSQL cache policy must contain a static data member "
-                "`kQuery` with a select statement or a static member function "
-                "`GetQuery` returning the query");
-  static_assert(!(kHasQuery<PostgreCachePolicy> &&
-                  kHasGetQuery<PostgreCachePolicy>),
-                "The PosgreSQL cache policy must define `kQuery` or "
-                "`GetQuery`, not both");
-  static_assert(
-      kHasUpdatedField<PostgreCachePolicy>,
-      "The PosgreSQL cache policy must contain a static member "
-      "`kUpdatedField`. If you don't want to use incremental updates, "
-      "please set its value to `nullptr`");
+struct PolicyChecker
+    : sql_cache::detail::PolicyChecker<PostgreCachePolicy,
+                                       storages::postgres::Query> {
   static_assert(CheckUpdatedFieldType<PostgreCachePolicy>());
 
   static_assert(ClusterHostType<PostgreCachePolicy>() &
                     storages::postgres::kClusterHostRolesMask,
                 "Cluster host role must be specified for caching component, "
                 "please be more specific");
-
-  static storages::postgres::Query GetQuery() {
-    if constexpr (kHasGetQuery<PostgreCachePolicy>) {
-      return PostgreCachePolicy::GetQuery();
-    } else {
-      return PostgreCachePolicy::kQuery;
-    }
-  }
-
-  using BaseType =
-      CachingComponentBase<DataCacheContainerType<PostgreCachePolicy>>;
 };
 
-inline constexpr std::chrono::minutes kDefaultFullUpdateTimeout{1};
-inline constexpr std::chrono::seconds kDefaultIncrementalUpdateTimeout{1};
 inline constexpr std::chrono::milliseconds kStatementTimeoutOff{0};
-inline constexpr std::chrono::milliseconds kCpuRelaxThreshold{10};
-inline constexpr std::chrono::milliseconds kCpuRelaxInterval{2};
 
-inline constexpr std::string_view kCopyStage = "copy_data";
-inline constexpr std::string_view kFetchStage = "fetch";
 inline constexpr std::string_view kParseStage = "parse";
-
-inline constexpr std::size_t kDefaultChunkSize = 1000;
 }  // namespace pg_cache::detail
 
 /// @ingroup userver_components
@@ -618,34 +418,14 @@ void PostgreCache<PostgreCachePolicy>::Update(
   scope.Reset();
 
   if constexpr (pg_cache::detail::kIsContainerCopiedByElement<DataType>) {
-    if (old_size > 0) {
-      const auto elapsed_copy =
-          scope.ElapsedTotal(std::string{pg_cache::detail::kCopyStage});
-      if (elapsed_copy > pg_cache::detail::kCpuRelaxThreshold) {
-        cpu_relax_iterations_copy_ = static_cast<std::size_t>(
-            static_cast<double>(old_size) /
-            (elapsed_copy / pg_cache::detail::kCpuRelaxInterval));
-        LOG_TRACE() << "Elapsed time for copying " << kName << " "
-                    << elapsed_copy.count() << " for " << changes
-                    << " data items is over threshold. Will relax CPU every "
-                    << cpu_relax_iterations_parse_ << " iterations";
-      }
-    }
-  }
-
-  if (changes > 0) {
-    const auto elapsed_parse =
-        scope.ElapsedTotal(std::string{pg_cache::detail::kParseStage});
-    if (elapsed_parse > pg_cache::detail::kCpuRelaxThreshold) {
-      cpu_relax_iterations_parse_ = static_cast<std::size_t>(
-          static_cast<double>(changes) /
-          (elapsed_parse / pg_cache::detail::kCpuRelaxInterval));
-      LOG_TRACE() << "Elapsed time for parsing " << kName << " "
-                  << elapsed_parse.count() << " for " << changes
-                  << " data items is over threshold. Will relax CPU every "
-                  << cpu_relax_iterations_parse_ << " iterations";
-    }
+    pg_cache::detail::UpdateCpuRelaxIterations(
+        cpu_relax_iterations_copy_, old_size, scope,
+        pg_cache::detail::kCopyStage, kName);
   }
+  pg_cache::detail::UpdateCpuRelaxIterations(cpu_relax_iterations_parse_,
+                                             changes, scope,
+                                             pg_cache::detail::kParseStage,
+                                             kName);
   if (changes > 0 || type == cache::UpdateType::kFull) {
     // Set current cache
     stats_scope.Finish(data_cache->size());
@@ -711,14 +491,4 @@ yaml_config::Schema PostgreCache<PostgreCachePolicy>::GetStaticConfigSchema() {
 
 }  // namespace components
 
-namespace utils::impl::projected_set {
-
-template <typename Set, typename Value, typename KeyMember>
-void CacheInsertOrAssign(Set& set, Value&& value,
-                         const KeyMember& /*key_member*/) {
-  DoInsert(set, std::forward<Value>(value));
-}
-
-}  // namespace utils::impl::projected_set
-
 USERVER_NAMESPACE_END
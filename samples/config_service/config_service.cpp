@@ -56,6 +56,7 @@ ConfigDistributor::ConfigDistributor(
     "USERVER_LOG_REQUEST_HEADERS": false,
     "USERVER_CANCEL_HANDLE_REQUEST_BY_DEADLINE": false,
     "USERVER_RPS_CCONTROL_CUSTOM_STATUS": {},
+    "USERVER_LOAD_SHEDDING": {},
     "USERVER_HTTP_PROXY": "",
     "USERVER_TASK_PROCESSOR_QOS": {
       "default-service": {
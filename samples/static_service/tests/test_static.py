@@ -27,3 +27,32 @@ async def test_hidden_file(service_client, service_source_dir):
     response = await service_client.get('/dir1/.hidden_file.txt')
     assert response.status == 404
     assert response.content.decode() == 'File not found'
+
+
+async def test_file_range(service_client):
+    response = await service_client.get(
+        '/dir1/dir2/data.html', headers={'Range': 'bytes=5-6'},
+    )
+    assert response.status == 206
+    assert response.headers['Content-Range'] == 'bytes 5-6/20'
+    assert response.headers['Accept-Ranges'] == 'bytes'
+    assert response.content == b'in'
+
+
+async def test_file_range_not_satisfiable(service_client):
+    response = await service_client.get(
+        '/dir1/dir2/data.html', headers={'Range': 'bytes=100-'},
+    )
+    assert response.status == 416
+    assert response.headers['Content-Range'] == 'bytes */20'
+    assert response.content == b''
+
+
+async def test_file_range_if_range(service_client):
+    # The static files have no validators, so If-Range never matches
+    response = await service_client.get(
+        '/dir1/dir2/data.html',
+        headers={'Range': 'bytes=5-6', 'If-Range': '"some-etag"'},
+    )
+    assert response.status == 200
+    assert response.content == b'file in recurse dir\n'
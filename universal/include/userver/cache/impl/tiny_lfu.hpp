@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <userver/cache/impl/lru.hpp>
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace cache::impl {
+
+// Count-min sketch of the key usage frequencies with 4-bit saturating
+// counters, 16 counters (8 bytes) per cached item. All the counters are halved
+// after 10 * capacity increments, so that the items that were popular long
+// ago are forgotten.
+//
+// All the counters of a key are in the same cache line.
+template <typename T, typename Hash = std::hash<T>>
+class FrequencySketch final {
+ public:
+  explicit FrequencySketch(std::size_t capacity, const Hash& hash = Hash())
+      : hash_(hash) {
+    Resize(capacity);
+  }
+
+  void Increment(const T& key) {
+    const auto hash = GetHash(key);
+    const auto min_frequency = MinFrequency(hash);
+    if (min_frequency == kMaxFrequency) return;
+
+    // Conservative update: only the smallest counters are incremented
+    for (std::size_t step = 0; step < kHashFunctionsCount; ++step) {
+      const auto index = GetIndex(hash, step);
+      if (GetCounter(index) == min_frequency) {
+        counters_[index / 2] += std::uint8_t{1} << GetShift(index);
+      }
+    }
+
+    if (++additions_ >= sample_size_) Age();
+  }
+
+  std::uint8_t Estimate(const T& key) const {
+    return MinFrequency(GetHash(key));
+  }
+
+  void Resize(std::size_t capacity) {
+    capacity = std::max<std::size_t>(capacity, 1);
+    std::size_t counters_count = kBlockSize;
+    while (counters_count < capacity * 16) counters_count *= 2;
+
+    // Two counters per byte
+    counters_.assign(counters_count / 2, 0);
+    sample_size_ = capacity * 10;
+    additions_ = 0;
+  }
+
+  void Clear() noexcept {
+    std::fill(counters_.begin(), counters_.end(), 0);
+    additions_ = 0;
+  }
+
+ private:
+  static constexpr std::size_t kHashFunctionsCount = 4;
+  static constexpr std::uint8_t kMaxFrequency = 15;
+  // 64 bytes
+  static constexpr std::size_t kBlockSize = 128;
+
+  std::uint64_t GetHash(const T& key) const {
+    // Mixes the bits, as std::hash of integers is an identity function
+    std::uint64_t hash = hash_(key);
+    hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdULL;
+    hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+    return hash ^ (hash >> 33);
+  }
+
+  std::size_t GetIndex(std::uint64_t hash, std::size_t step) const {
+    // The lower bits choose the block and each of the upper bytes chooses
+    // a counter in it. Unlike the double hashing of utils::FilterBloom, this
+    // gives independent positions for such a small block.
+    const auto block = hash & (counters_.size() * 2 - 1) & ~(kBlockSize - 1);
+    return block + ((hash >> (32 + 8 * step)) & (kBlockSize - 1));
+  }
+
+  static unsigned GetShift(std::size_t index) noexcept {
+    return (index % 2) * 4;
+  }
+
+  std::uint8_t GetCounter(std::size_t index) const noexcept {
+    return (counters_[index / 2] >> GetShift(index)) & kMaxFrequency;
+  }
+
+  std::uint8_t MinFrequency(std::uint64_t hash) const {
+    std::uint8_t result = kMaxFrequency;
+    for (std::size_t step = 0; step < kHashFunctionsCount; ++step) {
+      result = std::min(result, GetCounter(GetIndex(hash, step)));
+    }
+    return result;
+  }
+
+  void Age() noexcept {
+    // Halves both counters of each byte at once
+    for (auto& counters : counters_) counters = (counters >> 1) & 0x77;
+    additions_ /= 2;
+  }
+
+  std::vector<std::uint8_t> counters_;
+  std::size_t sample_size_{0};
+  std::size_t additions_{0};
+  Hash hash_;
+};
+
+// W-TinyLFU, see "TinyLFU: A Highly Efficient Cache Admission Policy" by
+// G. Einziger, R. Friedman and B. Manes.
+//
+// New items get into the window LRU that takes 1% of the capacity. An item
+// evicted from the window competes with the least recently used item of the
+// probation segment of the main SLRU part, and the one with the higher
+// estimated frequency stays. Items that are used again while in probation are
+// moved to the protected segment that takes 80% of the main part.
+template <typename T, typename U, typename Hash = std::hash<T>,
+          typename Equal = std::equal_to<T>>
+class TinyLfuBase final {
+ public:
+  using NodeType = std::unique_ptr<LruNode<T, U>>;
+
+  explicit TinyLfuBase(std::size_t max_size, const Hash& hash = Hash(),
+                       const Equal& equal = Equal())
+      : window_(1, hash, equal),
+        probation_(1, hash, equal),
+        protected_(1, hash, equal),
+        sketch_(max_size, hash) {
+    UASSERT(max_size > 0);
+    SetCapacities(max_size);
+    ResizeSegments();
+  }
+
+  TinyLfuBase(TinyLfuBase&& other) noexcept = default;
+  TinyLfuBase& operator=(TinyLfuBase&& other) noexcept = default;
+
+  TinyLfuBase(const TinyLfuBase&) = delete;
+  TinyLfuBase& operator=(const TinyLfuBase&) = delete;
+
+  bool Put(const T& key, U value);
+
+  template <typename... Args>
+  U* Emplace(const T& key, Args&&... args);
+
+  void Erase(const T& key);
+
+  U* Get(const T& key);
+
+  const T* GetLeastUsedKey() const;
+
+  U* GetLeastUsedValue();
+
+  void SetMaxSize(std::size_t new_max_size);
+
+  void Clear() noexcept;
+
+  template <typename Function>
+  void VisitAll(Function&& func) const;
+
+  template <typename Function>
+  void VisitAll(Function&& func);
+
+  std::size_t GetSize() const;
+
+  std::size_t GetCapacity() const;
+
+ private:
+  using Segment = LruBase<T, U, Hash, Equal>;
+
+  void SetCapacities(std::size_t max_size);
+  void ResizeSegments();
+  U* GetExisting(const T& key);
+  NodeType EvictForNewItem();
+  NodeType Admit(NodeType&& candidate);
+  Segment* GetVictimSegment();
+
+  // Segments are sized to their own capacities and never evict on their own,
+  // the items are moved between them and evicted here
+  Segment window_;
+  Segment probation_;
+  Segment protected_;
+  FrequencySketch<T, Hash> sketch_;
+
+  std::size_t capacity_{0};
+  std::size_t window_capacity_{0};
+  std::size_t main_capacity_{0};
+  std::size_t protected_capacity_{0};
+};
+
+template <typename T, typename U, typename Hash, typename Equal>
+bool TinyLfuBase<T, U, Hash, Equal>::Put(const T& key, U value) {
+  sketch_.Increment(key);
+  auto* existing = GetExisting(key);
+  if (existing) {
+    *existing = std::move(value);
+    return false;
+  }
+
+  auto node = EvictForNewItem();
+  if (node) {
+    node->SetKey(key);
+    node->SetValue(std::move(value));
+  } else {
+    node = std::make_unique<LruNode<T, U>>(T{key}, std::move(value));
+  }
+  window_.InsertNode(std::move(node));
+  return true;
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+template <typename... Args>
+U* TinyLfuBase<T, U, Hash, Equal>::Emplace(const T& key, Args&&... args) {
+  sketch_.Increment(key);
+  auto* existing = GetExisting(key);
+  if (existing) return existing;
+
+  EvictForNewItem();
+  return &window_.InsertNode(
+      std::make_unique<LruNode<T, U>>(T{key}, std::forward<Args>(args)...));
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+void TinyLfuBase<T, U, Hash, Equal>::Erase(const T& key) {
+  window_.Erase(key);
+  probation_.Erase(key);
+  protected_.Erase(key);
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+U* TinyLfuBase<T, U, Hash, Equal>::Get(const T& key) {
+  sketch_.Increment(key);
+  return GetExisting(key);
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+const T* TinyLfuBase<T, U, Hash, Equal>::GetLeastUsedKey() const {
+  if (probation_.GetSize() != 0) return probation_.GetLeastUsedKey();
+  if (window_.GetSize() != 0) return window_.GetLeastUsedKey();
+  return protected_.GetLeastUsedKey();
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+U* TinyLfuBase<T, U, Hash, Equal>::GetLeastUsedValue() {
+  auto* segment = GetVictimSegment();
+  return segment ? segment->GetLeastUsedValue() : nullptr;
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+void TinyLfuBase<T, U, Hash, Equal>::SetMaxSize(std::size_t new_max_size) {
+  UASSERT(new_max_size > 0);
+  if (!new_max_size) ++new_max_size;
+  if (new_max_size == capacity_) return;
+
+  SetCapacities(new_max_size);
+
+  // Rebalance the segments, the extra items go to probation and compete
+  // for the main part
+  while (window_.GetSize() > window_capacity_) {
+    probation_.InsertNode(window_.ExtractLeastUsedNode());
+  }
+  while (protected_.GetSize() > protected_capacity_) {
+    probation_.InsertNode(protected_.ExtractLeastUsedNode());
+  }
+  while (probation_.GetSize() + protected_.GetSize() > main_capacity_) {
+    if (probation_.GetSize() != 0) {
+      probation_.ExtractLeastUsedNode();
+    } else {
+      protected_.ExtractLeastUsedNode();
+    }
+  }
+
+  ResizeSegments();
+  sketch_.Resize(new_max_size);
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+void TinyLfuBase<T, U, Hash, Equal>::Clear() noexcept {
+  window_.Clear();
+  probation_.Clear();
+  protected_.Clear();
+  sketch_.Clear();
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+template <typename Function>
+void TinyLfuBase<T, U, Hash, Equal>::VisitAll(Function&& func) const {
+  window_.VisitAll(func);
+  probation_.VisitAll(func);
+  protected_.VisitAll(func);
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+template <typename Function>
+void TinyLfuBase<T, U, Hash, Equal>::VisitAll(Function&& func) {
+  window_.VisitAll(func);
+  probation_.VisitAll(func);
+  protected_.VisitAll(func);
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+std::size_t TinyLfuBase<T, U, Hash, Equal>::GetSize() const {
+  return window_.GetSize() + probation_.GetSize() + protected_.GetSize();
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+std::size_t TinyLfuBase<T, U, Hash, Equal>::GetCapacity() const {
+  return capacity_;
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+void TinyLfuBase<T, U, Hash, Equal>::SetCapacities(std::size_t max_size) {
+  capacity_ = max_size;
+  window_capacity_ = std::max<std::size_t>(max_size / 100, 1);
+  main_capacity_ = max_size - window_capacity_;
+  protected_capacity_ = main_capacity_ * 8 / 10;
+}
+
+// Segments must not exceed their capacities, or LruBase drops the extra items
+template <typename T, typename U, typename Hash, typename Equal>
+void TinyLfuBase<T, U, Hash, Equal>::ResizeSegments() {
+  window_.SetMaxSize(window_capacity_);
+  probation_.SetMaxSize(std::max<std::size_t>(main_capacity_, 1));
+  protected_.SetMaxSize(std::max<std::size_t>(protected_capacity_, 1));
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+U* TinyLfuBase<T, U, Hash, Equal>::GetExisting(const T& key) {
+  auto* value = window_.Get(key);
+  if (value) return value;
+
+  value = protected_.Get(key);
+  if (value) return value;
+
+  auto node = probation_.ExtractNode(key);
+  if (!node) return nullptr;
+
+  auto& result = protected_.InsertNode(std::move(node));
+  if (protected_.GetSize() > protected_capacity_) {
+    probation_.InsertNode(protected_.ExtractLeastUsedNode());
+  }
+  return &result;
+}
+
+// Makes room in the window for a new item, returns the evicted node if any
+template <typename T, typename U, typename Hash, typename Equal>
+typename TinyLfuBase<T, U, Hash, Equal>::NodeType
+TinyLfuBase<T, U, Hash, Equal>::EvictForNewItem() {
+  if (window_.GetSize() < window_capacity_) return {};
+  return Admit(window_.ExtractLeastUsedNode());
+}
+
+// Returns the node that lost the competition, if any
+template <typename T, typename U, typename Hash, typename Equal>
+typename TinyLfuBase<T, U, Hash, Equal>::NodeType
+TinyLfuBase<T, U, Hash, Equal>::Admit(NodeType&& candidate) {
+  UASSERT(candidate);
+  if (probation_.GetSize() + protected_.GetSize() < main_capacity_) {
+    probation_.InsertNode(std::move(candidate));
+    return {};
+  }
+  if (main_capacity_ == 0) return std::move(candidate);
+
+  // protected_capacity_ < main_capacity_, so probation is not empty
+  const auto* victim = probation_.GetLeastUsedKey();
+  UASSERT(victim);
+  if (sketch_.Estimate(candidate->GetKey()) <= sketch_.Estimate(*victim)) {
+    return std::move(candidate);
+  }
+
+  auto evicted = probation_.ExtractLeastUsedNode();
+  probation_.InsertNode(std::move(candidate));
+  return evicted;
+}
+
+template <typename T, typename U, typename Hash, typename Equal>
+typename TinyLfuBase<T, U, Hash, Equal>::Segment*
+TinyLfuBase<T, U, Hash, Equal>::GetVictimSegment() {
+  if (probation_.GetSize() != 0) return &probation_;
+  if (window_.GetSize() != 0) return &window_;
+  if (protected_.GetSize() != 0) return &protected_;
+  return nullptr;
+}
+
+}  // namespace cache::impl
+
+USERVER_NAMESPACE_END
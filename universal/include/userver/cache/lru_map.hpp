@@ -3,7 +3,11 @@
 /// @file userver/cache/lru_map.hpp
 /// @brief @copybrief cache::LruMap
 
+#include <type_traits>
+
 #include <userver/cache/impl/lru.hpp>
+#include <userver/cache/impl/tiny_lfu.hpp>
+#include <userver/cache/policy.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -14,8 +18,11 @@ namespace cache {
 ///
 /// LRU key value storage (LRU cache), thread safety matches Standard Library
 /// thread safety
+///
+/// @tparam Policy eviction policy, see cache::CachePolicy
 template <typename T, typename U, typename Hash = std::hash<T>,
-          typename Equal = std::equal_to<T>>
+          typename Equal = std::equal_to<T>,
+          CachePolicy Policy = CachePolicy::kLRU>
 class LruMap final {
  public:
   explicit LruMap(size_t max_size, const Hash& hash = Hash(),
@@ -85,7 +92,11 @@ class LruMap final {
   std::size_t GetCapacity() const { return impl_.GetCapacity(); }
 
  private:
-  impl::LruBase<T, U, Hash, Equal> impl_;
+  using Impl = std::conditional_t<Policy == CachePolicy::kTinyLFU,
+                                  impl::TinyLfuBase<T, U, Hash, Equal>,
+                                  impl::LruBase<T, U, Hash, Equal>>;
+
+  Impl impl_;
 };
 
 }  // namespace cache
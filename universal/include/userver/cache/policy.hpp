@@ -0,0 +1,25 @@
+#pragma once
+
+/// @file userver/cache/policy.hpp
+/// @brief @copybrief cache::CachePolicy
+
+USERVER_NAMESPACE_BEGIN
+
+namespace cache {
+
+/// @brief Eviction policy of cache::LruMap, cache::NWayLRU and
+/// cache::ExpirableLruCache
+enum class CachePolicy {
+  /// The least recently used item is evicted
+  kLRU,
+
+  /// W-TinyLFU: new items get into a small LRU window, an item leaves it for
+  /// the main segmented LRU part only if it was used more often than the item
+  /// it would evict. Frequencies are estimated by a count-min sketch.
+  /// Keeps the working set in cache during scans of rarely used keys.
+  kTinyLFU,
+};
+
+}  // namespace cache
+
+USERVER_NAMESPACE_END
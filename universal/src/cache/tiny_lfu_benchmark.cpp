@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <userver/cache/impl/slru.hpp>
+#include <userver/cache/lru_map.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr unsigned kKeysCount = 100'000;
+constexpr std::size_t kTraceSize = 1'000'000;
+
+using Lru = cache::LruMap<unsigned, unsigned>;
+using TinyLfu =
+    cache::LruMap<unsigned, unsigned, std::hash<unsigned>,
+                  std::equal_to<unsigned>, cache::CachePolicy::kTinyLFU>;
+
+// Adapts SlruBase to the LruMap interface used below
+class Slru final {
+ public:
+  explicit Slru(std::size_t size) : impl_(size / 5 + 1, size - size / 5) {}
+
+  unsigned* Get(unsigned key) { return impl_.Get(key); }
+  void Put(unsigned key, unsigned value) { impl_.Put(key, value); }
+
+ private:
+  cache::impl::SlruBase<unsigned, unsigned> impl_;
+};
+
+std::vector<unsigned> MakeZipfTrace(std::size_t size, double skew) {
+  std::vector<double> weights(kKeysCount);
+  for (unsigned i = 0; i < kKeysCount; ++i) {
+    weights[i] = 1.0 / std::pow(i + 1, skew);
+  }
+
+  // NOLINTNEXTLINE(cert-msc51-cpp)
+  std::mt19937 engine{42};
+  std::discrete_distribution<unsigned> distribution(weights.begin(),
+                                                    weights.end());
+  std::vector<unsigned> trace(size);
+  for (auto& key : trace) key = distribution(engine);
+  return trace;
+}
+
+// Zipf-distributed requests interleaved with sequential scans of keys that
+// are never requested again, like a bot crawling an id range
+std::vector<unsigned> MakeScanTrace(std::size_t size) {
+  const auto zipf = MakeZipfTrace(size / 2, 0.9);
+
+  std::vector<unsigned> trace;
+  trace.reserve(size);
+  unsigned scan_key = kKeysCount;
+  for (std::size_t i = 0; i < zipf.size(); ++i) {
+    trace.push_back(zipf[i]);
+    // Scans of 10'000 keys every 20'000 requests
+    if (i % 20'000 < 10'000) {
+      trace.push_back(scan_key++);
+    }
+  }
+  return trace;
+}
+
+const std::vector<unsigned>& GetTrace(int trace_type) {
+  static const std::vector<unsigned> kZipfTrace =
+      MakeZipfTrace(kTraceSize, 0.9);
+  static const std::vector<unsigned> kScanTrace = MakeScanTrace(kTraceSize);
+  return trace_type == 0 ? kZipfTrace : kScanTrace;
+}
+
+}  // namespace
+
+// Hit ratio is reported in the 'hit_ratio' counter, range(0) is the cache
+// size, range(1) is the trace: 0 - Zipf, 1 - Zipf with scans
+template <typename Cache>
+void CacheHitRatio(benchmark::State& state) {
+  const std::size_t cache_size = state.range(0);
+  const auto& trace = GetTrace(state.range(1));
+
+  std::size_t hits = 0;
+  std::size_t requests = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    Cache cache(cache_size);
+    for (const auto key : trace) {
+      if (cache.Get(key)) {
+        ++hits;
+      } else {
+        cache.Put(key, key);
+      }
+    }
+    requests += trace.size();
+  }
+
+  state.counters["hit_ratio"] =
+      static_cast<double>(hits) / static_cast<double>(requests);
+  state.SetItemsProcessed(requests);
+}
+BENCHMARK_TEMPLATE(CacheHitRatio, Lru)
+    ->ArgsProduct({{1000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(CacheHitRatio, Slru)
+    ->ArgsProduct({{1000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(CacheHitRatio, TinyLfu)
+    ->ArgsProduct({{1000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <userver/cache/impl/tiny_lfu.hpp>
+#include <userver/cache/lru_map.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using TinyLfu = cache::LruMap<int, int, std::hash<int>, std::equal_to<int>,
+                              cache::CachePolicy::kTinyLFU>;
+
+}  // namespace
+
+TEST(FrequencySketch, Estimate) {
+  cache::impl::FrequencySketch<std::string> sketch(100);
+  EXPECT_EQ(sketch.Estimate("a"), 0);
+
+  for (int i = 0; i < 5; ++i) sketch.Increment("a");
+  sketch.Increment("b");
+  EXPECT_GE(sketch.Estimate("a"), 5);
+  EXPECT_GE(sketch.Estimate("b"), 1);
+  EXPECT_LT(sketch.Estimate("b"), sketch.Estimate("a"));
+
+  // Counters saturate
+  for (int i = 0; i < 100; ++i) sketch.Increment("a");
+  EXPECT_EQ(sketch.Estimate("a"), 15);
+
+  sketch.Clear();
+  EXPECT_EQ(sketch.Estimate("a"), 0);
+}
+
+TEST(FrequencySketch, Aging) {
+  cache::impl::FrequencySketch<int> sketch(10);
+  for (int i = 0; i < 10; ++i) sketch.Increment(0);
+
+  // 10 * capacity increments halve all the counters
+  for (int i = 1; i < 91; ++i) sketch.Increment(i);
+  EXPECT_LT(sketch.Estimate(0), 10);
+  EXPECT_GE(sketch.Estimate(0), 5);
+}
+
+TEST(TinyLfu, SetGet) {
+  TinyLfu cache(10);
+  EXPECT_EQ(nullptr, cache.Get(1));
+  EXPECT_TRUE(cache.Put(1, 2));
+  EXPECT_EQ(2, cache.GetOr(1, -1));
+  EXPECT_FALSE(cache.Put(1, 3));
+  EXPECT_EQ(3, cache.GetOr(1, -1));
+  EXPECT_EQ(1, cache.GetSize());
+
+  cache.Erase(1);
+  EXPECT_EQ(nullptr, cache.Get(1));
+  EXPECT_EQ(0, cache.GetSize());
+}
+
+TEST(TinyLfu, Emplace) {
+  TinyLfu cache(10);
+  EXPECT_EQ(1, *cache.Emplace(1, 1));
+  EXPECT_EQ(1, *cache.Emplace(1, 2));
+  EXPECT_EQ(1, cache.GetSize());
+}
+
+TEST(TinyLfu, SizeIsLimited) {
+  for (const std::size_t capacity : {1, 2, 10, 1000}) {
+    TinyLfu cache(capacity);
+    for (int i = 0; i < 5000; ++i) {
+      cache.Put(i % 3 == 0 ? i % 7 : i, i);
+      EXPECT_LE(cache.GetSize(), capacity);
+    }
+    EXPECT_EQ(cache.GetSize(), capacity);
+    EXPECT_EQ(cache.GetCapacity(), capacity);
+  }
+}
+
+TEST(TinyLfu, ScanResistance) {
+  constexpr int kCapacity = 100;
+  constexpr int kHotKeys = 50;
+  TinyLfu cache(kCapacity);
+
+  for (int round = 0; round < 5; ++round) {
+    for (int key = 0; key < kHotKeys; ++key) {
+      if (!cache.Get(key)) cache.Put(key, key);
+    }
+  }
+
+  // Keys that are used once do not evict the frequently used ones
+  for (int key = 1000; key < 2000; ++key) cache.Put(key, key);
+
+  int hits = 0;
+  for (int key = 0; key < kHotKeys; ++key) {
+    if (cache.Get(key)) ++hits;
+  }
+  EXPECT_GE(hits, kHotKeys - 1);
+}
+
+TEST(TinyLfu, SetMaxSize) {
+  TinyLfu cache(100);
+  for (int i = 0; i < 100; ++i) {
+    cache.Put(i, i);
+    cache.Get(i);
+  }
+  EXPECT_EQ(cache.GetSize(), 100);
+
+  cache.SetMaxSize(10);
+  EXPECT_EQ(cache.GetSize(), 10);
+  for (int i = 100; i < 200; ++i) cache.Put(i, i);
+  EXPECT_EQ(cache.GetSize(), 10);
+
+  cache.SetMaxSize(50);
+  for (int i = 200; i < 300; ++i) cache.Put(i, i);
+  EXPECT_EQ(cache.GetSize(), 50);
+
+  std::size_t visited = 0;
+  cache.VisitAll([&visited](int key, int value) {
+    EXPECT_EQ(key, value);
+    ++visited;
+  });
+  EXPECT_EQ(visited, 50);
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetSize(), 0);
+}
+
+TEST(TinyLfu, SetMaxSizeWithEmptyWindow) {
+  TinyLfu cache(100);
+  for (int i = 0; i < 100; ++i) {
+    cache.Put(i, i);
+    cache.Get(i);
+  }
+  // The last item is the only one in the window
+  cache.Erase(99);
+  EXPECT_EQ(cache.GetSize(), 99);
+
+  // The main part must shrink to its own capacity, not just the whole cache
+  cache.SetMaxSize(10);
+  EXPECT_LE(cache.GetSize(), 10);
+  for (int i = 100; i < 200; ++i) {
+    cache.Put(i, i);
+    EXPECT_LE(cache.GetSize(), 10);
+  }
+  EXPECT_EQ(cache.GetSize(), 10);
+
+  // Items are not lost when growing
+  cache.SetMaxSize(1000);
+  EXPECT_EQ(cache.GetSize(), 10);
+  for (int i = 200; i < 2000; ++i) cache.Put(i, i);
+  EXPECT_EQ(cache.GetSize(), 1000);
+}
+
+USERVER_NAMESPACE_END